@@ -3,6 +3,7 @@
 #include "linalg_allocate.h"
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <initializer_list>
 
@@ -282,4 +283,20 @@ namespace linalg {
 	std::ostream& operator<<(std::ostream& outputStream, const Vectorr& outputVector);
 }
 
-#include "linalg_impl.h"
\ No newline at end of file
+#include "linalg_impl.h"
+#include "linalg_decompose.h"
+#include "linalg_solve.h"
+#include "linalg_triangular.h"
+#include "linalg_iterative.h"
+#include "linalg_precondition.h"
+#include "linalg_sparse.h"
+#include "linalg_banded.h"
+#include "linalg_symmetric.h"
+#include "linalg_diagonal.h"
+#include "linalg_toeplitz.h"
+#include "linalg_block.h"
+#include "linalg_hmatrix.h"
+#include "linalg_bitmatrix.h"
+#include "linalg_scalar.h"
+#include "linalg_quantized.h"
+#include "linalg_batch.h"
\ No newline at end of file
@@ -0,0 +1,653 @@
+#include "linalg_banded.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		constexpr size_t bandGrain = 16384; // Minimum stored entries read per parallel chunk of products and solves
+
+		/*
+		* Row-wise band storage shared by banded classes :
+		* row i keeps columns [i - lower, i + upper] contiguously, entry (i, j) is at i * leading() + (j + lower - i).
+		* Positions before column 0 and after column size - 1 are zero padding,
+		* so kernels may run over full band rows and factorizations may fill up to the stored upper bandwidth.
+		*/
+		class BandStorage {
+		public:
+			BandStorage(const size_t size, const size_t lower, const size_t upper); // throws std::length_error
+
+			size_t leading() const { return mLower + mUpper + 1; }
+			size_t columnBegin(const size_t row) const { return (row > mLower) ? row - mLower : 0; }
+			size_t columnEnd(const size_t row) const { return std::min(row + mUpper + 1, mSize); }
+			bool inBand(const size_t row, const size_t col) const { return col + mLower >= row && col <= row + mUpper; }
+			double& entry(const size_t row, const size_t col) { return mEntries[row * leading() + col + mLower - row]; }
+			double entry(const size_t row, const size_t col) const { return mEntries[row * leading() + col + mLower - row]; }
+			double* rowData(const size_t row) { return mEntries.data() + row * leading(); } // Column row - lower
+			const double* rowData(const size_t row) const { return mEntries.data() + row * leading(); }
+
+			double get(const size_t row, const size_t col) const; // throws std::out_of_range
+			void set(const size_t row, const size_t col, const double value); // throws std::out_of_range, std::logic_error
+
+			void assign(const Dense& dense); // throws std::logic_error
+			void assign(const BandStorage& band); // Band of argument must fit in this band
+			Dense toDense(const size_t beginRow, const size_t beginCol, const size_t height, const size_t width) const;
+			BandStorage transpose() const;
+
+			Dense multiply(const Dense& rightDense) const; // throws std::logic_error
+			void checkSolve(const Dense& rightDense) const; // throws std::logic_error
+
+			size_t mSize, mLower, mUpper;
+			std::vector<double> mEntries;
+		};
+
+		BandStorage::BandStorage(const size_t size, const size_t lower, const size_t upper)
+			: mSize(size), mLower(lower), mUpper(upper)
+		{
+			int exceptNum = ExceptionHandlerr::checkValidHeight(size);
+			if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+				LengthArgument lengthArg(size, size);
+				ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+				handler.addArgument(lengthArg);
+				handler.handleException();
+			}
+
+			mEntries.assign(size * leading(), 0.0);
+		}
+
+		double BandStorage::get(const size_t row, const size_t col) const
+		{
+			handleIndexException(row, col, mSize, mSize);
+			return inBand(row, col) ? entry(row, col) : 0.0;
+		}
+		void BandStorage::set(const size_t row, const size_t col, const double value)
+		{
+			handleIndexException(row, col, mSize, mSize);
+			if (!inBand(row, col)) {
+				handleEtcException("Cannot set entry outside band of banded matrix.");
+			}
+			entry(row, col) = value;
+		}
+
+		void BandStorage::assign(const Dense& dense)
+		{
+			// Entries outside band are compared with the same epsilon as Matrixx entries
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			for (size_t row = 0; row < mSize; row++) {
+				for (size_t col = 0; col < mSize; col++) {
+					if (inBand(row, col)) {
+						entry(row, col) = dense(row, col);
+					}
+					else if (std::abs(dense(row, col)) >= epsilon) {
+						handleEtcException("Cannot make banded matrix from matrix with nonzero entry outside band.");
+					}
+				}
+			}
+		}
+		void BandStorage::assign(const BandStorage& band)
+		{
+			for (size_t row = 0; row < mSize; row++) {
+				for (size_t col = band.columnBegin(row); col < band.columnEnd(row); col++) {
+					entry(row, col) = band.entry(row, col);
+				}
+			}
+		}
+
+		Dense BandStorage::toDense(const size_t beginRow, const size_t beginCol, const size_t height, const size_t width) const
+		{
+			Dense dense(height, width);
+			for (size_t row = beginRow; row < beginRow + height; row++) {
+				const size_t colBegin = std::max(columnBegin(row), beginCol), colEnd = std::min(columnEnd(row), beginCol + width);
+				for (size_t col = colBegin; col < colEnd; col++) {
+					dense(row - beginRow, col - beginCol) = entry(row, col);
+				}
+			}
+			return dense;
+		}
+
+		BandStorage BandStorage::transpose() const
+		{
+			BandStorage transposed(mSize, mUpper, mLower);
+			for (size_t row = 0; row < mSize; row++) {
+				for (size_t col = columnBegin(row); col < columnEnd(row); col++) {
+					transposed.entry(col, row) = entry(row, col);
+				}
+			}
+			return transposed;
+		}
+
+		Dense BandStorage::multiply(const Dense& rightDense) const
+		{
+			handleOperationException(ExceptionHandlerr::checkJoinLength(mSize, rightDense.height), '*',
+				LengthArgument(mSize, mSize), LengthArgument(rightDense.height, rightDense.width));
+
+			// Each row reads its band once, rows are independent
+			const size_t width = rightDense.width;
+			Dense product(mSize, width);
+			parallelFor(0, mSize, [&](const size_t rowBegin, const size_t rowEnd) {
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					const size_t colBegin = columnBegin(row), colEnd = columnEnd(row);
+					if (width == 1) {
+						product(row, 0) = dot(colEnd - colBegin, rowData(row) + (colBegin + mLower - row), rightDense.data() + colBegin);
+						continue;
+					}
+					double* target = product.row(row);
+					for (size_t col = colBegin; col < colEnd; col++) {
+						axpy(width, entry(row, col), rightDense.row(col), target);
+					}
+				}
+			}, std::max<size_t>(1, bandGrain / (leading() * width)));
+			return product;
+		}
+
+		void BandStorage::checkSolve(const Dense& rightDense) const
+		{
+			handleOperationException(ExceptionHandlerr::checkHeight(mSize, rightDense.height), '\\',
+				LengthArgument(mSize, mSize), LengthArgument(rightDense.height, rightDense.width));
+		}
+
+		size_t clampBandwidth(const size_t size, const size_t bandwidth)
+		{
+			return std::min(bandwidth, (size > 0) ? size - 1 : 0);
+		}
+
+		// Right-hand sides are split into column chunks, every chunk runs the whole sequential substitution
+		void solveColumns(const size_t size, const size_t leading, Dense& rightDense,
+			const std::function<void(const size_t, const size_t)>& substitute)
+		{
+			const size_t width = rightDense.width;
+			if (width == 1) {
+				substitute(0, 1);
+				return;
+			}
+			parallelFor(0, width, [&substitute](const size_t colBegin, const size_t colEnd) {
+				substitute(colBegin, colEnd);
+			}, std::max<size_t>(1, bandGrain / (size * leading)));
+		}
+
+		/*
+		* Banded LU with partial pivoting (as LAPACK gbtrf, unblocked and row-wise) on storage with upper = lower + upper of A.
+		* Multiplier of row i on step k stays at (i, k), and later interchanges move only columns from their own step,
+		* so L is kept as the sequence of Gauss transforms and interchanges applied on solve.
+		*/
+		bool bandLUFactor(BandStorage& lu, size_t* pivots)
+		{
+			const size_t size = lu.mSize, lower = lu.mLower;
+			for (size_t step = 0; step < size; step++) {
+				const size_t rowEnd = std::min(step + lower + 1, size), colEnd = lu.columnEnd(step);
+				size_t pivot = step;
+				for (size_t row = step + 1; row < rowEnd; row++) {
+					if (std::abs(lu.entry(row, step)) > std::abs(lu.entry(pivot, step))) {
+						pivot = row;
+					}
+				}
+				pivots[step] = pivot;
+				if (lu.entry(pivot, step) == 0.0) {
+					return false;
+				}
+				if (pivot != step) {
+					std::swap_ranges(&lu.entry(step, step), &lu.entry(step, step) + (colEnd - step), &lu.entry(pivot, step));
+				}
+
+				const double* pivotRow = &lu.entry(step, step + 1);
+				const double pivotValue = lu.entry(step, step);
+				for (size_t row = step + 1; row < rowEnd; row++) {
+					const double multiplier = lu.entry(row, step) / pivotValue;
+					lu.entry(row, step) = multiplier;
+					if (multiplier != 0.0) {
+						double* target = &lu.entry(row, step + 1);
+						for (size_t index = 0; index + step + 1 < colEnd; index++) {
+							target[index] -= multiplier * pivotRow[index];
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		// Thomas algorithm with partial pivoting (as LAPACK gttrf), lower = 1 and upper = 2, padding makes every step branch free
+		bool tridiagonalLUFactor(BandStorage& lu, size_t* pivots)
+		{
+			const size_t size = lu.mSize;
+			for (size_t step = 0; step + 1 < size; step++) {
+				double* current = lu.rowData(step) + 1; // (step, step), (step, step + 1), (step, step + 2)
+				double* next = lu.rowData(step + 1); // (step + 1, step), (step + 1, step + 1), (step + 1, step + 2)
+				if (std::abs(next[0]) > std::abs(current[0])) {
+					std::swap_ranges(current, current + 3, next);
+					pivots[step] = step + 1;
+				}
+				else {
+					pivots[step] = step;
+				}
+				if (current[0] == 0.0) {
+					return false;
+				}
+				const double multiplier = next[0] / current[0];
+				next[0] = multiplier;
+				next[1] -= multiplier * current[1];
+				next[2] -= multiplier * current[2];
+			}
+			pivots[size - 1] = size - 1;
+			return lu.entry(size - 1, size - 1) != 0.0;
+		}
+
+
+
+
+
+		/*
+		* Banded Cholesky A = L * L^T, row i of L is computed from rows [i - lower, i) (row-oriented, as LAPACK pbtrf with uplo = L).
+		* Both rows of each inner product are contiguous in band storage.
+		*/
+		bool bandCholeskyFactor(BandStorage& factor)
+		{
+			for (size_t row = 0; row < factor.mSize; row++) {
+				const size_t begin = factor.columnBegin(row);
+				for (size_t col = begin; col <= row; col++) {
+					const double value = factor.entry(row, col) - dot(col - begin, &factor.entry(row, begin), &factor.entry(col, begin));
+					if (col < row) {
+						factor.entry(row, col) = value / factor.entry(col, col);
+					}
+					else if (value > 0.0) {
+						factor.entry(row, row) = std::sqrt(value);
+					}
+					else {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+	}
+
+
+
+
+
+	class BandedMatrix::Impl : public BandStorage {
+	public:
+		Impl(const size_t size, const size_t lower, const size_t upper) // throws std::length_error
+			: BandStorage(size, clampBandwidth(size, lower), clampBandwidth(size, upper)) {}
+		Impl(const BandStorage& storage) : BandStorage(storage) {}
+	};
+
+	class BandedLU::Impl {
+	public:
+		Impl(const BandStorage& matrix); // throws std::logic_error
+
+		void solve(Dense& rightDense) const; // throws std::logic_error
+
+		BandStorage mFactor; // L multipliers below diagonal, U on and above diagonal up to lower + upper of A
+		std::vector<size_t> mPivots; // Row step was interchanged with row mPivots[step] on step
+	};
+
+	class BandedCholesky::Impl {
+	public:
+		Impl(const BandStorage& matrix); // throws std::logic_error
+
+		void solve(Dense& rightDense) const; // throws std::logic_error
+
+		BandStorage mFactor; // L, upper bandwidth 0
+	};
+
+
+
+
+
+	BandedMatrix::BandedMatrix(const size_t size, const size_t lowerBandwidth, const size_t upperBandwidth)
+		: impl(std::make_unique<Impl>(size, lowerBandwidth, upperBandwidth))
+	{
+	}
+	BandedMatrix::BandedMatrix(const Matrixx& matrix)
+	{
+		if (matrix.height() != matrix.width()) {
+			handleEtcException("Cannot make banded matrix from non-square matrix.");
+		}
+
+		const Dense dense = fromMatrix(matrix);
+		constexpr double epsilon = std::numeric_limits<double>::epsilon();
+		size_t lower = 0, upper = 0;
+		for (size_t row = 0; row < dense.height; row++) {
+			for (size_t col = 0; col < dense.width; col++) {
+				if (std::abs(dense(row, col)) >= epsilon) {
+					lower = std::max(lower, (row > col) ? row - col : 0);
+					upper = std::max(upper, (col > row) ? col - row : 0);
+				}
+			}
+		}
+		impl = std::make_unique<Impl>(dense.height, lower, upper);
+		impl->assign(dense);
+	}
+	BandedMatrix::BandedMatrix(const Matrixx& matrix, const size_t lowerBandwidth, const size_t upperBandwidth)
+	{
+		if (matrix.height() != matrix.width()) {
+			handleEtcException("Cannot make banded matrix from non-square matrix.");
+		}
+
+		impl = std::make_unique<Impl>(matrix.height(), lowerBandwidth, upperBandwidth);
+		impl->assign(fromMatrix(matrix));
+	}
+	BandedMatrix::BandedMatrix(const BandedMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	BandedMatrix::~BandedMatrix() = default;
+
+	BandedMatrix BandedMatrix::tridiagonal(const std::vector<double>& lower, const std::vector<double>& diagonal,
+		const std::vector<double>& upper)
+	{
+		BandedMatrix matrix(diagonal.size(), 1, 1);
+		if (lower.size() + 1 != diagonal.size() || upper.size() + 1 != diagonal.size()) {
+			handleEtcException("Off-diagonals of tridiagonal matrix must have one entry less than diagonal.");
+		}
+
+		for (size_t index = 0; index < diagonal.size(); index++) {
+			matrix.impl->entry(index, index) = diagonal[index];
+			if (index + 1 < diagonal.size()) {
+				matrix.impl->entry(index + 1, index) = lower[index];
+				matrix.impl->entry(index, index + 1) = upper[index];
+			}
+		}
+		return matrix;
+	}
+
+	const double BandedMatrix::operator()(const size_t row, const size_t col) const
+	{
+		return impl->get(row, col);
+	}
+	void BandedMatrix::set(const size_t row, const size_t col, const double value)
+	{
+		impl->set(row, col, value);
+	}
+
+	Vectorr BandedMatrix::solve(const Vectorr& rightVector) const
+	{
+		return BandedLU(*this).solve(rightVector);
+	}
+	Matrixx BandedMatrix::solve(const Matrixx& rightMatrix) const
+	{
+		return BandedLU(*this).solve(rightMatrix);
+	}
+
+	BandedMatrix BandedMatrix::transpose() const
+	{
+		BandedMatrix transposed(impl->mSize);
+		*(transposed.impl) = Impl(impl->transpose());
+		return transposed;
+	}
+	Matrixx BandedMatrix::block(const size_t beginRow, const size_t beginCol,
+		const size_t blockHeight, const size_t blockWidth) const
+	{
+		handleIndexException(beginRow, beginCol, impl->mSize, impl->mSize);
+		handleIndexException(beginRow + blockHeight - 1, beginCol + blockWidth - 1, impl->mSize, impl->mSize);
+		return kernel::toMatrix(impl->toDense(beginRow, beginCol, blockHeight, blockWidth));
+	}
+	Matrixx BandedMatrix::toMatrix() const
+	{
+		return kernel::toMatrix(impl->toDense(0, 0, impl->mSize, impl->mSize));
+	}
+	const size_t BandedMatrix::lowerBandwidth() const
+	{
+		return impl->mLower;
+	}
+	const size_t BandedMatrix::upperBandwidth() const
+	{
+		return impl->mUpper;
+	}
+	const size_t BandedMatrix::size() const
+	{
+		return impl->mSize;
+	}
+
+	BandedMatrix& BandedMatrix::operator=(const BandedMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	Vectorr BandedMatrix::operator*(const Vectorr& rightVector) const
+	{
+		return toVector(impl->multiply(fromColumns(rightVector)).entries);
+	}
+	Matrixx BandedMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+
+
+
+
+
+	BandedLU::Impl::Impl(const BandStorage& matrix)
+		: mFactor(matrix.mSize, matrix.mLower, matrix.mLower + matrix.mUpper), mPivots(matrix.mSize)
+	{
+		mFactor.assign(matrix);
+		const bool isRegular = (matrix.mLower == 1 && matrix.mUpper == 1)
+			? tridiagonalLUFactor(mFactor, mPivots.data()) : bandLUFactor(mFactor, mPivots.data());
+		if (!isRegular) {
+			handleEtcException("Cannot get LU factor of singular banded matrix.");
+		}
+	}
+
+	void BandedLU::Impl::solve(Dense& rightDense) const
+	{
+		mFactor.checkSolve(rightDense);
+
+		const size_t size = mFactor.mSize, lower = mFactor.mLower, width = rightDense.width;
+		solveColumns(size, mFactor.leading(), rightDense, [&](const size_t colBegin, const size_t colEnd) {
+			const size_t chunkWidth = colEnd - colBegin;
+			auto rowOf = [&](const size_t row) { return rightDense.data() + row * width + colBegin; };
+			// Forward : interchange and Gauss transform of every step
+			for (size_t step = 0; step < size; step++) {
+				double* source = rowOf(step);
+				if (mPivots[step] != step) {
+					std::swap_ranges(source, source + chunkWidth, rowOf(mPivots[step]));
+				}
+				const size_t rowEnd = std::min(step + lower + 1, size);
+				for (size_t row = step + 1; row < rowEnd; row++) {
+					const double multiplier = mFactor.entry(row, step);
+					double* target = rowOf(row);
+					for (size_t col = 0; col < chunkWidth; col++) {
+						target[col] -= multiplier * source[col];
+					}
+				}
+			}
+			// Backward : U rows from the last one
+			for (size_t row = size; row-- > 0;) {
+				double* target = rowOf(row);
+				for (size_t col = row + 1; col < mFactor.columnEnd(row); col++) {
+					const double value = mFactor.entry(row, col);
+					const double* source = rowOf(col);
+					for (size_t index = 0; index < chunkWidth; index++) {
+						target[index] -= value * source[index];
+					}
+				}
+				const double diagonal = mFactor.entry(row, row);
+				for (size_t col = 0; col < chunkWidth; col++) {
+					target[col] /= diagonal;
+				}
+			}
+		});
+	}
+
+
+
+
+
+	BandedLU::BandedLU(const BandedMatrix& matrix)
+		: impl(std::make_unique<Impl>(*(matrix.impl)))
+	{
+	}
+	BandedLU::BandedLU(const BandedLU& copyLU)
+		: impl(std::make_unique<Impl>(*(copyLU.impl)))
+	{
+	}
+	BandedLU::~BandedLU() = default;
+
+	Vectorr BandedLU::solve(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(solution);
+		return toVector(solution.entries);
+	}
+	Matrixx BandedLU::solve(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(solution);
+		return kernel::toMatrix(solution);
+	}
+
+	double BandedLU::determinant() const
+	{
+		double determinant = 1.0;
+		for (size_t index = 0; index < impl->mFactor.mSize; index++) {
+			determinant *= (impl->mPivots[index] == index) ? impl->mFactor.entry(index, index) : -impl->mFactor.entry(index, index);
+		}
+		return determinant;
+	}
+	const size_t BandedLU::size() const
+	{
+		return impl->mFactor.mSize;
+	}
+
+	BandedLU& BandedLU::operator=(const BandedLU& rightLU)
+	{
+		if (this == &rightLU) {
+			return *this;
+		}
+
+		*impl = *(rightLU.impl);
+		return *this;
+	}
+
+
+
+
+
+	BandedCholesky::Impl::Impl(const BandStorage& matrix)
+		: mFactor(matrix.mSize, std::max(matrix.mLower, matrix.mUpper), 0)
+	{
+		// Symmetry is compared as kernel::isSymmetric, relative to the largest entry
+		double maxAbsoluteEntry = 0.0;
+		for (const double entry : matrix.mEntries) {
+			maxAbsoluteEntry = std::max(maxAbsoluteEntry, std::abs(entry));
+		}
+		const double tolerance = 1e-12 * maxAbsoluteEntry;
+		for (size_t row = 0; row < matrix.mSize; row++) {
+			for (size_t col = mFactor.columnBegin(row); col <= row; col++) {
+				const double entry = matrix.inBand(row, col) ? matrix.entry(row, col) : 0.0;
+				const double mirror = matrix.inBand(col, row) ? matrix.entry(col, row) : 0.0;
+				if (std::abs(entry - mirror) > tolerance) {
+					handleEtcException("Cannot get Cholesky factor from non-symmetric matrix.");
+				}
+				mFactor.entry(row, col) = entry;
+			}
+		}
+
+		if (!bandCholeskyFactor(mFactor)) {
+			handleEtcException("The matrix is not positive-definite.");
+		}
+	}
+
+	void BandedCholesky::Impl::solve(Dense& rightDense) const
+	{
+		mFactor.checkSolve(rightDense);
+
+		const size_t size = mFactor.mSize, width = rightDense.width;
+		solveColumns(size, mFactor.leading(), rightDense, [&](const size_t colBegin, const size_t colEnd) {
+			const size_t chunkWidth = colEnd - colBegin;
+			auto rowOf = [&](const size_t row) { return rightDense.data() + row * width + colBegin; };
+			// Forward : L * y = b by rows
+			for (size_t row = 0; row < size; row++) {
+				double* target = rowOf(row);
+				for (size_t col = mFactor.columnBegin(row); col < row; col++) {
+					const double value = mFactor.entry(row, col);
+					const double* source = rowOf(col);
+					for (size_t index = 0; index < chunkWidth; index++) {
+						target[index] -= value * source[index];
+					}
+				}
+				const double diagonal = mFactor.entry(row, row);
+				for (size_t index = 0; index < chunkWidth; index++) {
+					target[index] /= diagonal;
+				}
+			}
+			// Backward : L^T * x = y, row i of L scatters x_i to earlier rows
+			for (size_t row = size; row-- > 0;) {
+				double* source = rowOf(row);
+				const double diagonal = mFactor.entry(row, row);
+				for (size_t index = 0; index < chunkWidth; index++) {
+					source[index] /= diagonal;
+				}
+				for (size_t col = mFactor.columnBegin(row); col < row; col++) {
+					const double value = mFactor.entry(row, col);
+					double* target = rowOf(col);
+					for (size_t index = 0; index < chunkWidth; index++) {
+						target[index] -= value * source[index];
+					}
+				}
+			}
+		});
+	}
+
+
+
+
+
+	BandedCholesky::BandedCholesky(const BandedMatrix& matrix)
+		: impl(std::make_unique<Impl>(*(matrix.impl)))
+	{
+	}
+	BandedCholesky::BandedCholesky(const BandedCholesky& copyCholesky)
+		: impl(std::make_unique<Impl>(*(copyCholesky.impl)))
+	{
+	}
+	BandedCholesky::~BandedCholesky() = default;
+
+	Vectorr BandedCholesky::solve(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(solution);
+		return toVector(solution.entries);
+	}
+	Matrixx BandedCholesky::solve(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(solution);
+		return kernel::toMatrix(solution);
+	}
+
+	double BandedCholesky::logDeterminant() const
+	{
+		double logDeterminant = 0.0;
+		for (size_t index = 0; index < impl->mFactor.mSize; index++) {
+			logDeterminant += 2.0 * std::log(impl->mFactor.entry(index, index));
+		}
+		return logDeterminant;
+	}
+	const size_t BandedCholesky::bandwidth() const
+	{
+		return impl->mFactor.mLower;
+	}
+	const size_t BandedCholesky::size() const
+	{
+		return impl->mFactor.mSize;
+	}
+
+	BandedCholesky& BandedCholesky::operator=(const BandedCholesky& rightCholesky)
+	{
+		if (this == &rightCholesky) {
+			return *this;
+		}
+
+		*impl = *(rightCholesky.impl);
+		return *this;
+	}
+}
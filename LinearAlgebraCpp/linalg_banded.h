@@ -0,0 +1,111 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <vector>
+
+namespace linalg {
+	// Banded matrix classes
+	// Implementations are in linalg_banded.cpp
+	class BandedMatrix;
+	class BandedLU;
+	class BandedCholesky;
+
+	/*
+	* Square banded matrix, entry (i, j) is zero unless i - lowerBandwidth <= j <= i + upperBandwidth.
+	*
+	* Only the diagonals inside the band are stored, row by row, so memory is O(n * (lower + upper + 1))
+	* and products read each stored entry once, rows in parallel.
+	* solve runs banded LU with partial pivoting in O(n * lower * (lower + upper)) instead of inverting a dense matrix,
+	* tridiagonal matrices (lower = upper = 1) take a Thomas algorithm fast path.
+	* Bandwidths above size - 1 are clamped.
+	*/
+	class BandedMatrix {
+		friend class BandedLU;
+		friend class BandedCholesky;
+	public:
+		explicit BandedMatrix(const size_t size = 1, const size_t lowerBandwidth = 0,
+			const size_t upperBandwidth = 0); // throws std::length_error, zero matrix
+		explicit BandedMatrix(const Matrixx& matrix); // throws std::logic_error : non-square, bandwidths of nonzero entries
+		BandedMatrix(const Matrixx& matrix, const size_t lowerBandwidth,
+			const size_t upperBandwidth); // throws std::logic_error : non-square or nonzero entry outside band
+		BandedMatrix(const BandedMatrix& copyMatrix);
+		virtual ~BandedMatrix();
+
+		// lower[i] is (i + 1, i), diagonal[i] is (i, i), upper[i] is (i, i + 1)
+		static BandedMatrix tridiagonal(const std::vector<double>& lower, const std::vector<double>& diagonal,
+			const std::vector<double>& upper); // throws std::length_error, std::logic_error : off-diagonal length is not size - 1
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range, zero outside band
+		void set(const size_t row, const size_t col, const double value); // throws std::out_of_range, std::logic_error : outside band
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error : singular matrix, A^-1 * b
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error : singular matrix, A^-1 * B
+
+		BandedMatrix transpose() const;
+		Matrixx block(const size_t beginRow, const size_t beginCol,
+			const size_t blockHeight, const size_t blockWidth) const; // throws std::out_of_range, dense block as Matrixx::block
+		Matrixx toMatrix() const;
+		const size_t lowerBandwidth() const;
+		const size_t upperBandwidth() const;
+		const size_t size() const;
+
+		BandedMatrix& operator=(const BandedMatrix& rightMatrix);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Banded LU factorization P * A = L * U with partial pivoting.
+	*
+	* L keeps the lower bandwidth and row interchanges widen U to lower + upper bandwidth,
+	* so factorization costs O(n * lower * (lower + upper)) and each solve O(n * (2 * lower + upper)) per right-hand side.
+	* Many right-hand sides are solved in parallel column chunks.
+	*/
+	class BandedLU {
+	public:
+		explicit BandedLU(const BandedMatrix& matrix); // throws std::logic_error : singular matrix
+		BandedLU(const BandedLU& copyLU);
+		virtual ~BandedLU();
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+		double determinant() const;
+		const size_t size() const;
+
+		BandedLU& operator=(const BandedLU& rightLU);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Banded Cholesky factorization A = L * L^T of symmetric positive-definite banded matrix.
+	*
+	* L keeps the bandwidth of A (no fill outside the band), factorization costs O(n * bandwidth^2)
+	* and each solve O(n * bandwidth) per right-hand side.
+	*/
+	class BandedCholesky {
+	public:
+		explicit BandedCholesky(const BandedMatrix& matrix); // throws std::logic_error : non-symmetric or not positive-definite
+		BandedCholesky(const BandedCholesky& copyCholesky);
+		virtual ~BandedCholesky();
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+		double logDeterminant() const;
+		const size_t bandwidth() const;
+		const size_t size() const;
+
+		BandedCholesky& operator=(const BandedCholesky& rightCholesky);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
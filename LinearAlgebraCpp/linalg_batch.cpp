@@ -0,0 +1,466 @@
+#include "linalg_batch.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		constexpr size_t lanes = 16; // Matrices interleaved in a group
+		constexpr size_t groupWork = 1 << 14; // Minimum multiply-adds per parallel chunk
+
+		void checkValidShape(const size_t count, const size_t height, const size_t width) // throws std::length_error, std::logic_error
+		{
+			int exceptNum = ExceptionHandlerr::checkValidHeight(height);
+			exceptNum += ExceptionHandlerr::checkValidWidth(width);
+			if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+				LengthArgument lengthArg(height, width);
+				ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+				handler.addArgument(lengthArg);
+				handler.handleException();
+			}
+			if (count == 0) {
+				handleEtcException("Matrix batch must hold at least one matrix.");
+			}
+		}
+
+		void checkCount(const size_t leftCount, const size_t rightCount) // throws std::logic_error
+		{
+			if (leftCount != rightCount) {
+				handleEtcException("Matrix batches must hold the same number of matrices.");
+			}
+		}
+
+		size_t groupGrain(const size_t work)
+		{
+			return std::max<size_t>(1, groupWork / (work * lanes + 1));
+		}
+	}
+
+
+
+
+
+	class MatrixBatch::Impl {
+	public:
+		Impl(const size_t count, const size_t height, const size_t width)
+			: mCount(count), mHeight(height), mWidth(width), mEntries(groupCount() * height * width * lanes, 0.0) {}
+
+		// Lanes of entry (row, col) in group, entry of matrix index is lane index % lanes of group index / lanes
+		double* lanesOf(const size_t group, const size_t row, const size_t col) { return mEntries.data() + ((group * mHeight + row) * mWidth + col) * lanes; }
+		const double* lanesOf(const size_t group, const size_t row, const size_t col) const { return mEntries.data() + ((group * mHeight + row) * mWidth + col) * lanes; }
+		double& at(const size_t index, const size_t row, const size_t col) { return lanesOf(index / lanes, row, col)[index % lanes]; }
+		const double& at(const size_t index, const size_t row, const size_t col) const { return lanesOf(index / lanes, row, col)[index % lanes]; }
+
+		const size_t groupCount() const { return (mCount + lanes - 1) / lanes; }
+		void checkIndex(const size_t index, const size_t row, const size_t col) const; // throws std::out_of_range
+		void checkSum(const char operation, const Impl& rightImpl) const; // throws std::logic_error
+		void add(const double sign, const Impl& rightImpl);
+		Impl multiply(const Impl& rightImpl) const;
+
+		size_t mCount, mHeight, mWidth;
+		std::vector<double> mEntries; // Groups of (height x width) entries, each a run of lanes
+	};
+
+	void MatrixBatch::Impl::checkIndex(const size_t index, const size_t row, const size_t col) const
+	{
+		handleIndexException(index, 0, mCount, 1);
+		handleIndexException(row, col, mHeight, mWidth);
+	}
+
+	void MatrixBatch::Impl::checkSum(const char operation, const Impl& rightImpl) const
+	{
+		checkCount(mCount, rightImpl.mCount);
+		const LengthArgument leftLengthArg(mHeight, mWidth), rightLengthArg(rightImpl.mHeight, rightImpl.mWidth);
+		handleOperationException(ExceptionHandlerr::checkHeight(mHeight, rightImpl.mHeight), operation, leftLengthArg, rightLengthArg);
+		handleOperationException(ExceptionHandlerr::checkWidth(mWidth, rightImpl.mWidth), operation, leftLengthArg, rightLengthArg);
+	}
+
+	void MatrixBatch::Impl::add(const double sign, const Impl& rightImpl)
+	{
+		const size_t groupLength = mHeight * mWidth * lanes;
+		parallelFor(0, groupCount(), [&](const size_t groupBegin, const size_t groupEnd) {
+			axpy((groupEnd - groupBegin) * groupLength, sign, rightImpl.mEntries.data() + groupBegin * groupLength,
+				mEntries.data() + groupBegin * groupLength);
+		}, groupGrain(mHeight * mWidth));
+	}
+
+	MatrixBatch::Impl MatrixBatch::Impl::multiply(const Impl& rightImpl) const
+	{
+		// C(row, :) += A(row, inner) * B(inner, :), every multiply-add runs across the lanes of a group
+		Impl product(mCount, mHeight, rightImpl.mWidth);
+		const size_t join = mWidth, width = rightImpl.mWidth;
+		parallelFor(0, groupCount(), [&](const size_t groupBegin, const size_t groupEnd) {
+			for (size_t group = groupBegin; group < groupEnd; group++) {
+				for (size_t row = 0; row < mHeight; row++) {
+					for (size_t inner = 0; inner < join; inner++) {
+						const double* left = lanesOf(group, row, inner);
+						for (size_t col = 0; col < width; col++) {
+							const double* right = rightImpl.lanesOf(group, inner, col);
+							double* target = product.lanesOf(group, row, col);
+							for (size_t lane = 0; lane < lanes; lane++) {
+								target[lane] += left[lane] * right[lane];
+							}
+						}
+					}
+				}
+			}
+		}, groupGrain(mHeight * join * width));
+		return product;
+	}
+
+	class BatchLU::Impl {
+	public:
+		Impl(const MatrixBatch::Impl& batchImpl); // throws std::logic_error
+
+		void solve(MatrixBatch::Impl& rightImpl) const; // In place, B -> A^-1 * B
+
+		MatrixBatch::Impl mFactor; // L below and U on and above diagonal, padding lanes hold identity
+		std::vector<size_t> mPivots; // Pivot row of step k of matrix index is mPivots[(group * size + k) * lanes + lane]
+	};
+
+	BatchLU::Impl::Impl(const MatrixBatch::Impl& batchImpl)
+		: mFactor(batchImpl), mPivots(batchImpl.groupCount() * batchImpl.mHeight * lanes)
+	{
+		if (mFactor.mHeight != mFactor.mWidth) {
+			handleEtcException("Cannot get LU factor of non-square matrix.");
+		}
+		const size_t length = mFactor.mHeight, groupCount = mFactor.groupCount();
+		for (size_t index = mFactor.mCount; index < groupCount * lanes; index++) {
+			for (size_t diagonal = 0; diagonal < length; diagonal++) {
+				mFactor.at(index, diagonal, diagonal) = 1.0;
+			}
+		}
+
+		std::vector<char> isSingular(groupCount, 0);
+		parallelFor(0, groupCount, [&](const size_t groupBegin, const size_t groupEnd) {
+			size_t pivotRows[lanes];
+			double pivotValues[lanes];
+			for (size_t group = groupBegin; group < groupEnd; group++) {
+				for (size_t step = 0; step < length; step++) {
+					// 1. Pivot row of each matrix, rows swapped matrix by matrix
+					const double* stepLanes = mFactor.lanesOf(group, step, step);
+					for (size_t lane = 0; lane < lanes; lane++) {
+						pivotRows[lane] = step;
+						pivotValues[lane] = std::abs(stepLanes[lane]);
+					}
+					for (size_t row = step + 1; row < length; row++) {
+						const double* rowLanes = mFactor.lanesOf(group, row, step);
+						for (size_t lane = 0; lane < lanes; lane++) {
+							if (std::abs(rowLanes[lane]) > pivotValues[lane]) {
+								pivotValues[lane] = std::abs(rowLanes[lane]);
+								pivotRows[lane] = row;
+							}
+						}
+					}
+					for (size_t lane = 0; lane < lanes; lane++) {
+						mPivots[(group * length + step) * lanes + lane] = pivotRows[lane];
+						if (pivotValues[lane] == 0.0) {
+							isSingular[group] = 1;
+						}
+						else if (pivotRows[lane] != step) {
+							for (size_t col = 0; col < length; col++) {
+								std::swap(mFactor.lanesOf(group, step, col)[lane], mFactor.lanesOf(group, pivotRows[lane], col)[lane]);
+							}
+						}
+					}
+					if (isSingular[group]) {
+						break;
+					}
+
+					// 2. Elimination below the pivot across lanes
+					const double* pivotLanes = mFactor.lanesOf(group, step, step);
+					for (size_t row = step + 1; row < length; row++) {
+						double* multipliers = mFactor.lanesOf(group, row, step);
+						for (size_t lane = 0; lane < lanes; lane++) {
+							multipliers[lane] /= pivotLanes[lane];
+						}
+						for (size_t col = step + 1; col < length; col++) {
+							const double* source = mFactor.lanesOf(group, step, col);
+							double* target = mFactor.lanesOf(group, row, col);
+							for (size_t lane = 0; lane < lanes; lane++) {
+								target[lane] -= multipliers[lane] * source[lane];
+							}
+						}
+					}
+				}
+			}
+		}, groupGrain(length * length * length));
+		if (std::find(isSingular.begin(), isSingular.end(), 1) != isSingular.end()) {
+			handleEtcException("Cannot get LU factor of singular matrix.");
+		}
+	}
+
+	void BatchLU::Impl::solve(MatrixBatch::Impl& rightImpl) const
+	{
+		const size_t length = mFactor.mHeight, width = rightImpl.mWidth;
+		parallelFor(0, mFactor.groupCount(), [&](const size_t groupBegin, const size_t groupEnd) {
+			for (size_t group = groupBegin; group < groupEnd; group++) {
+				// 1. P * B, matrix by matrix
+				for (size_t step = 0; step < length; step++) {
+					const size_t* pivotRows = mPivots.data() + (group * length + step) * lanes;
+					for (size_t lane = 0; lane < lanes; lane++) {
+						if (pivotRows[lane] != step) {
+							for (size_t col = 0; col < width; col++) {
+								std::swap(rightImpl.lanesOf(group, step, col)[lane], rightImpl.lanesOf(group, pivotRows[lane], col)[lane]);
+							}
+						}
+					}
+				}
+
+				// 2. L * Y = P * B and U * X = Y across lanes
+				auto eliminate = [&](const size_t row, const size_t inner) {
+					const double* factor = mFactor.lanesOf(group, row, inner);
+					for (size_t col = 0; col < width; col++) {
+						const double* source = rightImpl.lanesOf(group, inner, col);
+						double* target = rightImpl.lanesOf(group, row, col);
+						for (size_t lane = 0; lane < lanes; lane++) {
+							target[lane] -= factor[lane] * source[lane];
+						}
+					}
+				};
+				for (size_t row = 1; row < length; row++) {
+					for (size_t inner = 0; inner < row; inner++) {
+						eliminate(row, inner);
+					}
+				}
+				for (size_t row = length; row-- > 0;) {
+					for (size_t inner = row + 1; inner < length; inner++) {
+						eliminate(row, inner);
+					}
+					const double* diagonal = mFactor.lanesOf(group, row, row);
+					for (size_t col = 0; col < width; col++) {
+						double* target = rightImpl.lanesOf(group, row, col);
+						for (size_t lane = 0; lane < lanes; lane++) {
+							target[lane] /= diagonal[lane];
+						}
+					}
+				}
+			}
+		}, groupGrain(length * length * width));
+	}
+
+
+
+
+
+	MatrixBatch::MatrixBatch(const size_t count, const size_t height, const size_t width)
+	{
+		checkValidShape(count, height, width);
+		impl = std::make_unique<Impl>(count, height, width);
+	}
+	MatrixBatch::MatrixBatch(const std::vector<Matrixx>& matrices)
+	{
+		if (matrices.empty()) {
+			handleEtcException("Matrix batch must hold at least one matrix.");
+		}
+
+		impl = std::make_unique<Impl>(matrices.size(), matrices[0].height(), matrices[0].width());
+		for (size_t index = 0; index < matrices.size(); index++) {
+			setMatrix(index, matrices[index]);
+		}
+	}
+	MatrixBatch::MatrixBatch(const MatrixBatch& copyBatch)
+		: impl(std::make_unique<Impl>(*(copyBatch.impl)))
+	{
+	}
+	MatrixBatch::~MatrixBatch() = default;
+
+	MatrixBatch MatrixBatch::identity(const size_t count, const size_t length)
+	{
+		MatrixBatch identity(count, length, length);
+		for (size_t group = 0; group < identity.impl->groupCount(); group++) {
+			for (size_t diagonal = 0; diagonal < length; diagonal++) {
+				std::fill_n(identity.impl->lanesOf(group, diagonal, diagonal), lanes, 1.0);
+			}
+		}
+		return identity;
+	}
+
+	const double& MatrixBatch::operator()(const size_t index, const size_t row, const size_t col) const
+	{
+		impl->checkIndex(index, row, col);
+		return impl->at(index, row, col);
+	}
+	double& MatrixBatch::operator()(const size_t index, const size_t row, const size_t col)
+	{
+		impl->checkIndex(index, row, col);
+		return impl->at(index, row, col);
+	}
+	Matrixx MatrixBatch::matrix(const size_t index) const
+	{
+		impl->checkIndex(index, 0, 0);
+		Dense dense(impl->mHeight, impl->mWidth);
+		for (size_t row = 0; row < impl->mHeight; row++) {
+			for (size_t col = 0; col < impl->mWidth; col++) {
+				dense(row, col) = impl->at(index, row, col);
+			}
+		}
+		return toMatrix(dense);
+	}
+	void MatrixBatch::setMatrix(const size_t index, const Matrixx& matrix)
+	{
+		impl->checkIndex(index, 0, 0);
+		if (matrix.height() != impl->mHeight || matrix.width() != impl->mWidth) {
+			handleEtcException("Matrices of batch must have the same shape.");
+		}
+
+		const Dense dense = fromMatrix(matrix);
+		for (size_t row = 0; row < impl->mHeight; row++) {
+			for (size_t col = 0; col < impl->mWidth; col++) {
+				impl->at(index, row, col) = dense(row, col);
+			}
+		}
+	}
+
+	MatrixBatch MatrixBatch::transpose() const
+	{
+		MatrixBatch transposed(*this);
+		*(transposed.impl) = Impl(impl->mCount, impl->mWidth, impl->mHeight);
+		for (size_t group = 0; group < impl->groupCount(); group++) {
+			for (size_t row = 0; row < impl->mHeight; row++) {
+				for (size_t col = 0; col < impl->mWidth; col++) {
+					std::copy_n(impl->lanesOf(group, row, col), lanes, transposed.impl->lanesOf(group, col, row));
+				}
+			}
+		}
+		return transposed;
+	}
+	MatrixBatch MatrixBatch::inverse() const
+	{
+		return BatchLU(*this).inverse();
+	}
+	const size_t MatrixBatch::count() const
+	{
+		return impl->mCount;
+	}
+	const size_t MatrixBatch::height() const
+	{
+		return impl->mHeight;
+	}
+	const size_t MatrixBatch::width() const
+	{
+		return impl->mWidth;
+	}
+
+	MatrixBatch& MatrixBatch::operator=(const MatrixBatch& rightBatch)
+	{
+		if (this == &rightBatch) {
+			return *this;
+		}
+
+		*impl = *(rightBatch.impl);
+		return *this;
+	}
+	MatrixBatch& MatrixBatch::operator+=(const MatrixBatch& rightBatch)
+	{
+		impl->checkSum('+', *(rightBatch.impl));
+		impl->add(1.0, *(rightBatch.impl));
+		return *this;
+	}
+	MatrixBatch& MatrixBatch::operator-=(const MatrixBatch& rightBatch)
+	{
+		impl->checkSum('-', *(rightBatch.impl));
+		impl->add(-1.0, *(rightBatch.impl));
+		return *this;
+	}
+	MatrixBatch& MatrixBatch::operator*=(const double multiplier)
+	{
+		scale(impl->mEntries.size(), multiplier, impl->mEntries.data());
+		return *this;
+	}
+	MatrixBatch MatrixBatch::operator+(const MatrixBatch& rightBatch) const
+	{
+		MatrixBatch sum(*this);
+		sum += rightBatch;
+		return sum;
+	}
+	MatrixBatch MatrixBatch::operator-(const MatrixBatch& rightBatch) const
+	{
+		MatrixBatch difference(*this);
+		difference -= rightBatch;
+		return difference;
+	}
+	MatrixBatch MatrixBatch::operator*(const MatrixBatch& rightBatch) const
+	{
+		checkCount(impl->mCount, rightBatch.impl->mCount);
+		handleOperationException(ExceptionHandlerr::checkJoinLength(impl->mWidth, rightBatch.impl->mHeight), '*',
+			LengthArgument(impl->mHeight, impl->mWidth), LengthArgument(rightBatch.impl->mHeight, rightBatch.impl->mWidth));
+
+		MatrixBatch product(*this);
+		*(product.impl) = impl->multiply(*(rightBatch.impl));
+		return product;
+	}
+	MatrixBatch MatrixBatch::operator*(const double multiplier) const
+	{
+		MatrixBatch product(*this);
+		product *= multiplier;
+		return product;
+	}
+
+
+
+
+
+	BatchLU::BatchLU(const MatrixBatch& batch)
+		: impl(std::make_unique<Impl>(*(batch.impl)))
+	{
+	}
+	BatchLU::BatchLU(const BatchLU& copyLU)
+		: impl(std::make_unique<Impl>(*(copyLU.impl)))
+	{
+	}
+	BatchLU::~BatchLU() = default;
+
+	MatrixBatch BatchLU::solve(const MatrixBatch& rightBatch) const
+	{
+		const MatrixBatch::Impl& factor = impl->mFactor;
+		checkCount(factor.mCount, rightBatch.impl->mCount);
+		handleOperationException(ExceptionHandlerr::checkJoinLength(factor.mWidth, rightBatch.impl->mHeight), '\\',
+			LengthArgument(factor.mHeight, factor.mWidth), LengthArgument(rightBatch.impl->mHeight, rightBatch.impl->mWidth));
+
+		MatrixBatch solution(rightBatch);
+		impl->solve(*(solution.impl));
+		return solution;
+	}
+	MatrixBatch BatchLU::inverse() const
+	{
+		MatrixBatch inverse = MatrixBatch::identity(impl->mFactor.mCount, impl->mFactor.mHeight);
+		impl->solve(*(inverse.impl));
+		return inverse;
+	}
+	std::vector<double> BatchLU::determinants() const
+	{
+		const MatrixBatch::Impl& factor = impl->mFactor;
+		std::vector<double> determinants(factor.mCount, 1.0);
+		for (size_t index = 0; index < factor.mCount; index++) {
+			for (size_t step = 0; step < factor.mHeight; step++) {
+				determinants[index] *= factor.at(index, step, step);
+				if (impl->mPivots[((index / lanes) * factor.mHeight + step) * lanes + index % lanes] != step) {
+					determinants[index] = -determinants[index];
+				}
+			}
+		}
+		return determinants;
+	}
+	const size_t BatchLU::count() const
+	{
+		return impl->mFactor.mCount;
+	}
+	const size_t BatchLU::size() const
+	{
+		return impl->mFactor.mHeight;
+	}
+
+	BatchLU& BatchLU::operator=(const BatchLU& rightLU)
+	{
+		if (this == &rightLU) {
+			return *this;
+		}
+
+		*impl = *(rightLU.impl);
+		return *this;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <vector>
+
+namespace linalg {
+	// Batched small matrix classes
+	// Implementations are in linalg_batch.cpp
+	class MatrixBatch;
+	class BatchLU;
+
+	/*
+	* count matrices of the same (height x width) shape in one contiguous buffer.
+	*
+	* Matrices are interleaved in groups of 16 (lanes) : entry (row, col) of the 16 matrices of a group is contiguous,
+	* so every kernel loop runs across the batch with the same instruction sequence for each matrix and is vectorized,
+	* even for 2 x 2 or 6 x 6 matrices where loops along a row are too short. Groups are processed in parallel.
+	* The last group is padded up to 16 matrices.
+	*/
+	class MatrixBatch {
+		friend class BatchLU;
+	public:
+		explicit MatrixBatch(const size_t count = 1, const size_t height = 1, const size_t width = 1); // throws std::length_error, std::logic_error : zero count, zero matrices
+		explicit MatrixBatch(const std::vector<Matrixx>& matrices); // throws std::logic_error : no matrix or shapes differ
+		MatrixBatch(const MatrixBatch& copyBatch);
+		virtual ~MatrixBatch();
+
+		static MatrixBatch identity(const size_t count, const size_t length); // throws std::length_error, std::logic_error : zero count
+
+		const double& operator()(const size_t index, const size_t row, const size_t col) const; // throws std::out_of_range
+		double& operator()(const size_t index, const size_t row, const size_t col); // throws std::out_of_range
+		Matrixx matrix(const size_t index) const; // throws std::out_of_range
+		void setMatrix(const size_t index, const Matrixx& matrix); // throws std::out_of_range, std::logic_error : shape differs
+
+		MatrixBatch transpose() const;
+		MatrixBatch inverse() const; // throws std::logic_error : non-square or singular matrix
+		const size_t count() const;
+		const size_t height() const;
+		const size_t width() const;
+
+		MatrixBatch& operator=(const MatrixBatch& rightBatch);
+		MatrixBatch& operator+=(const MatrixBatch& rightBatch); // throws std::logic_error
+		MatrixBatch& operator-=(const MatrixBatch& rightBatch); // throws std::logic_error
+		MatrixBatch& operator*=(const double multiplier);
+		MatrixBatch operator+(const MatrixBatch& rightBatch) const; // throws std::logic_error
+		MatrixBatch operator-(const MatrixBatch& rightBatch) const; // throws std::logic_error
+		MatrixBatch operator*(const MatrixBatch& rightBatch) const; // throws std::logic_error, matrix-wise products
+		MatrixBatch operator*(const double multiplier) const;
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* LU factorization with partial pivoting P * A = L * U of every matrix in a square MatrixBatch.
+	*
+	* Pivot rows are chosen per matrix, row swaps are done per matrix and elimination runs across the batch.
+	*/
+	class BatchLU {
+	public:
+		explicit BatchLU(const MatrixBatch& batch); // throws std::logic_error : non-square or singular matrix
+		BatchLU(const BatchLU& copyLU);
+		virtual ~BatchLU();
+
+		MatrixBatch solve(const MatrixBatch& rightBatch) const; // throws std::logic_error, A^-1 * B for each pair
+		MatrixBatch inverse() const;
+		std::vector<double> determinants() const;
+		const size_t count() const;
+		const size_t size() const;
+
+		BatchLU& operator=(const BatchLU& rightLU);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,454 @@
+#include "linalg_bitmatrix.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		constexpr size_t wordBits = 64;
+		constexpr size_t tableBits = 8; // Rows combined in one lookup table (256 entries)
+		constexpr size_t rowGrain = 256; // Minimum rows per parallel chunk
+
+		size_t wordCount(const size_t width)
+		{
+			return (width + wordBits - 1) / wordBits;
+		}
+
+		bool parity(uint64_t word)
+		{
+			word ^= word >> 32;
+			word ^= word >> 16;
+			word ^= word >> 8;
+			word ^= word >> 4;
+			word ^= word >> 2;
+			word ^= word >> 1;
+			return (word & 1) != 0;
+		}
+
+		size_t lowestBit(uint64_t word) // word must not be zero
+		{
+			size_t index = 0;
+			while ((word & 0xFF) == 0) {
+				word >>= 8;
+				index += 8;
+			}
+			while ((word & 1) == 0) {
+				word >>= 1;
+				index++;
+			}
+			return index;
+		}
+
+		bool toBit(const double value) // throws std::logic_error
+		{
+			if (value != 0.0 && value != 1.0) {
+				handleEtcException("Entries of binary matrix must be 0 or 1.");
+			}
+			return value == 1.0;
+		}
+
+		// target ^= source on words [begin, end)
+		void xorWords(uint64_t* target, const uint64_t* source, const size_t begin, const size_t end)
+		{
+			for (size_t word = begin; word < end; word++) {
+				target[word] ^= source[word];
+			}
+		}
+	}
+
+
+
+
+
+	class BitMatrix::Impl {
+	public:
+		Impl(const size_t height, const size_t width)
+			: mHeight(height), mWidth(width), mWordCount(wordCount(width)), mWords(height * mWordCount, 0) {}
+
+		uint64_t* row(const size_t row) { return mWords.data() + row * mWordCount; }
+		const uint64_t* row(const size_t row) const { return mWords.data() + row * mWordCount; }
+		bool get(const size_t row, const size_t col) const { return ((mWords[row * mWordCount + col / wordBits] >> (col % wordBits)) & 1) != 0; }
+		void set(const size_t row, const size_t col, const bool value);
+
+		uint64_t window(const size_t row, const size_t col) const; // Bit j is column col + j, for columns [col, col + 64)
+		size_t leadingColumn(const size_t row) const; // mWidth for zero row
+		std::vector<size_t> eliminate(const bool isReduced); // Pivot columns, pivot i is on row i
+		bool isEchelonForm() const;
+		Impl multiply(const Impl& rightImpl) const;
+
+		size_t mHeight, mWidth, mWordCount;
+		std::vector<uint64_t> mWords; // Row-major, bit j of word w of a row is column 64 * w + j, padding bits are zero
+	};
+
+	void BitMatrix::Impl::set(const size_t row, const size_t col, const bool value)
+	{
+		const uint64_t mask = uint64_t(1) << (col % wordBits);
+		uint64_t& word = mWords[row * mWordCount + col / wordBits];
+		word = value ? (word | mask) : (word & ~mask);
+	}
+
+	uint64_t BitMatrix::Impl::window(const size_t row, const size_t col) const
+	{
+		const uint64_t* words = this->row(row);
+		const size_t word = col / wordBits, shift = col % wordBits;
+		uint64_t bits = words[word] >> shift;
+		if (shift > 0 && word + 1 < mWordCount) {
+			bits |= words[word + 1] << (wordBits - shift);
+		}
+		return bits;
+	}
+
+	size_t BitMatrix::Impl::leadingColumn(const size_t row) const
+	{
+		const uint64_t* words = this->row(row);
+		for (size_t word = 0; word < mWordCount; word++) {
+			if (words[word] != 0) {
+				return word * wordBits + lowestBit(words[word]);
+			}
+		}
+		return mWidth;
+	}
+
+	std::vector<size_t> BitMatrix::Impl::eliminate(const bool isReduced)
+	{
+		std::vector<size_t> pivotCols;
+		std::vector<uint64_t> table;
+		size_t col = 0;
+		while (col < mWidth && pivotCols.size() < mHeight) {
+			// 1. Up to tableBits pivots in columns [col, col + 64). Candidates are reduced on their window bits only,
+			// a found pivot row is reduced in full and clears its column from earlier pivots of this round
+			const size_t first = pivotCols.size(), beginWord = col / wordBits, windowEnd = std::min(col + wordBits, mWidth);
+			std::vector<size_t> roundCols;
+			std::vector<uint64_t> patterns; // Window bits of reduced pivot rows
+			size_t next = col;
+			for (; next < windowEnd && roundCols.size() < tableBits && first + roundCols.size() < mHeight; next++) {
+				const size_t pivotRow = first + roundCols.size();
+				for (size_t candidate = pivotRow; candidate < mHeight; candidate++) {
+					uint64_t bits = window(candidate, col);
+					for (size_t index = 0; index < roundCols.size(); index++) {
+						if ((bits >> (roundCols[index] - col)) & 1) {
+							bits ^= patterns[index];
+						}
+					}
+					if (((bits >> (next - col)) & 1) == 0) {
+						continue;
+					}
+
+					for (size_t index = 0; index < roundCols.size(); index++) {
+						if ((window(candidate, col) >> (roundCols[index] - col)) & 1) {
+							xorWords(row(candidate), row(first + index), beginWord, mWordCount);
+						}
+					}
+					if (candidate != pivotRow) {
+						std::swap_ranges(row(candidate), row(candidate) + mWordCount, row(pivotRow));
+					}
+					const uint64_t pattern = window(pivotRow, col);
+					for (size_t index = 0; index < roundCols.size(); index++) {
+						if ((patterns[index] >> (next - col)) & 1) {
+							xorWords(row(first + index), row(pivotRow), beginWord, mWordCount);
+							patterns[index] ^= pattern;
+						}
+					}
+					roundCols.push_back(next);
+					patterns.push_back(pattern);
+					break;
+				}
+			}
+			col = next;
+			if (roundCols.empty()) {
+				continue;
+			}
+
+			// 2. Every XOR combination of the round pivot rows, combination i holds pivot b when bit b of i is set
+			const size_t count = roundCols.size(), rowWords = mWordCount - beginWord;
+			table.assign((size_t(1) << count) * rowWords, 0);
+			for (size_t bit = 0; bit < count; bit++) {
+				const uint64_t* pivot = row(first + bit) + beginWord;
+				for (size_t index = 0; index < (size_t(1) << bit); index++) {
+					const uint64_t* source = table.data() + index * rowWords;
+					uint64_t* target = table.data() + ((size_t(1) << bit) + index) * rowWords;
+					for (size_t word = 0; word < rowWords; word++) {
+						target[word] = source[word] ^ pivot[word];
+					}
+				}
+			}
+
+			// 3. Clear pivot columns of rows below (and above when reduced) with one lookup each
+			const size_t rowBegin = isReduced ? 0 : first + count;
+			const size_t roundStart = roundCols[0];
+			parallelFor(rowBegin, mHeight, [&](const size_t chunkBegin, const size_t chunkEnd) {
+				for (size_t target = chunkBegin; target < chunkEnd; target++) {
+					if (target >= first && target < first + count) {
+						continue;
+					}
+					const uint64_t bits = window(target, roundStart);
+					size_t index = 0;
+					for (size_t bit = 0; bit < count; bit++) {
+						index |= static_cast<size_t>((bits >> (roundCols[bit] - roundStart)) & 1) << bit;
+					}
+					if (index != 0) {
+						xorWords(row(target) + beginWord, table.data() + index * rowWords, 0, rowWords);
+					}
+				}
+			}, rowGrain);
+			pivotCols.insert(pivotCols.end(), roundCols.begin(), roundCols.end());
+		}
+		return pivotCols;
+	}
+
+	bool BitMatrix::Impl::isEchelonForm() const
+	{
+		size_t preLeading = (mHeight > 0) ? leadingColumn(0) : mWidth;
+		for (size_t row = 1; row < mHeight; row++) {
+			const size_t curLeading = leadingColumn(row);
+			if (curLeading < mWidth && curLeading <= preLeading) {
+				return false;
+			}
+			preLeading = curLeading;
+		}
+		return true;
+	}
+
+	BitMatrix::Impl BitMatrix::Impl::multiply(const Impl& rightImpl) const
+	{
+		// M4RM : rows of the right operand are combined tableBits at a time, each chunk of output rows keeps its own table
+		Impl product(mHeight, rightImpl.mWidth);
+		const size_t rowWords = rightImpl.mWordCount;
+		parallelFor(0, mHeight, [&](const size_t rowBegin, const size_t rowEnd) {
+			std::vector<uint64_t> table((size_t(1) << tableBits) * rowWords);
+			for (size_t join = 0; join < mWidth; join += tableBits) {
+				const size_t count = std::min(tableBits, mWidth - join);
+				for (size_t bit = 0; bit < count; bit++) {
+					const uint64_t* source = rightImpl.row(join + bit);
+					for (size_t index = 0; index < (size_t(1) << bit); index++) {
+						const uint64_t* lower = table.data() + index * rowWords;
+						uint64_t* target = table.data() + ((size_t(1) << bit) + index) * rowWords;
+						for (size_t word = 0; word < rowWords; word++) {
+							target[word] = lower[word] ^ source[word];
+						}
+					}
+				}
+
+				const uint64_t mask = (uint64_t(1) << count) - 1;
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					const size_t index = static_cast<size_t>(window(row, join) & mask);
+					if (index != 0) {
+						xorWords(product.row(row), table.data() + index * rowWords, 0, rowWords);
+					}
+				}
+			}
+		}, rowGrain);
+		return product;
+	}
+
+
+
+
+
+	BitMatrix::BitMatrix(const size_t height, const size_t width)
+	{
+		int exceptNum = ExceptionHandlerr::checkValidHeight(height);
+		exceptNum += ExceptionHandlerr::checkValidWidth(width);
+		if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+			LengthArgument lengthArg(height, width);
+			ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+			handler.addArgument(lengthArg);
+			handler.handleException();
+		}
+
+		impl = std::make_unique<Impl>(height, width);
+	}
+	BitMatrix::BitMatrix(const Matrixx& matrix)
+	{
+		const Dense dense = fromMatrix(matrix);
+		impl = std::make_unique<Impl>(dense.height, dense.width);
+		for (size_t row = 0; row < dense.height; row++) {
+			for (size_t col = 0; col < dense.width; col++) {
+				if (toBit(dense(row, col))) {
+					impl->set(row, col, true);
+				}
+			}
+		}
+	}
+	BitMatrix::BitMatrix(const BitMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	BitMatrix::~BitMatrix() = default;
+
+	BitMatrix BitMatrix::identity(const size_t length)
+	{
+		BitMatrix identity(length, length);
+		for (size_t index = 0; index < length; index++) {
+			identity.impl->set(index, index, true);
+		}
+		return identity;
+	}
+
+	void BitMatrix::reduce()
+	{
+		impl->eliminate(true);
+	}
+	void BitMatrix::toEchelonForm()
+	{
+		impl->eliminate(false);
+	}
+	void BitMatrix::toReducedEchelonForm()
+	{
+		if (!impl->isEchelonForm()) {
+			handleEtcException("Cannot reduce non-echelon form matrix.");
+		}
+		impl->eliminate(true);
+	}
+
+	bool BitMatrix::isEchelonForm() const
+	{
+		return impl->isEchelonForm();
+	}
+
+	const size_t BitMatrix::rank() const
+	{
+		Impl echelon = *impl;
+		return echelon.eliminate(false).size();
+	}
+	BitMatrix BitMatrix::nullSpace() const
+	{
+		// Free column f gives x(f) = 1 and x(pivot i) = R(i, f) on reduced echelon form R
+		Impl reduced = *impl;
+		const std::vector<size_t> pivotCols = reduced.eliminate(true);
+		std::vector<char> isPivot(impl->mWidth, 0);
+		for (const size_t pivotCol : pivotCols) {
+			isPivot[pivotCol] = 1;
+		}
+
+		BitMatrix basis(*this);
+		*(basis.impl) = Impl(impl->mWidth - pivotCols.size(), impl->mWidth);
+		size_t basisRow = 0;
+		for (size_t col = 0; col < impl->mWidth; col++) {
+			if (isPivot[col]) {
+				continue;
+			}
+			basis.impl->set(basisRow, col, true);
+			for (size_t pivot = 0; pivot < pivotCols.size(); pivot++) {
+				if (reduced.get(pivot, col)) {
+					basis.impl->set(basisRow, pivotCols[pivot], true);
+				}
+			}
+			basisRow++;
+		}
+		return basis;
+	}
+
+	const bool BitMatrix::operator()(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, impl->mHeight, impl->mWidth);
+		return impl->get(row, col);
+	}
+	void BitMatrix::set(const size_t row, const size_t col, const bool value)
+	{
+		handleIndexException(row, col, impl->mHeight, impl->mWidth);
+		impl->set(row, col, value);
+	}
+
+	BitMatrix BitMatrix::transpose() const
+	{
+		BitMatrix transposed(*this);
+		*(transposed.impl) = Impl(impl->mWidth, impl->mHeight);
+		for (size_t row = 0; row < impl->mHeight; row++) {
+			const uint64_t* words = impl->row(row);
+			for (size_t word = 0; word < impl->mWordCount; word++) {
+				for (uint64_t bits = words[word]; bits != 0; bits &= bits - 1) {
+					transposed.impl->set(word * wordBits + lowestBit(bits), row, true);
+				}
+			}
+		}
+		return transposed;
+	}
+	Matrixx BitMatrix::toMatrix() const
+	{
+		Dense dense(impl->mHeight, impl->mWidth);
+		for (size_t row = 0; row < impl->mHeight; row++) {
+			for (size_t col = 0; col < impl->mWidth; col++) {
+				dense(row, col) = impl->get(row, col) ? 1.0 : 0.0;
+			}
+		}
+		return kernel::toMatrix(dense);
+	}
+	const size_t BitMatrix::height() const
+	{
+		return impl->mHeight;
+	}
+	const size_t BitMatrix::width() const
+	{
+		return impl->mWidth;
+	}
+
+	BitMatrix& BitMatrix::operator=(const BitMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	BitMatrix& BitMatrix::operator+=(const BitMatrix& rightMatrix)
+	{
+		const LengthArgument leftLengthArg(impl->mHeight, impl->mWidth), rightLengthArg(rightMatrix.impl->mHeight, rightMatrix.impl->mWidth);
+		handleOperationException(ExceptionHandlerr::checkHeight(impl->mHeight, rightMatrix.impl->mHeight), '+', leftLengthArg, rightLengthArg);
+		handleOperationException(ExceptionHandlerr::checkWidth(impl->mWidth, rightMatrix.impl->mWidth), '+', leftLengthArg, rightLengthArg);
+
+		xorWords(impl->mWords.data(), rightMatrix.impl->mWords.data(), 0, impl->mWords.size());
+		return *this;
+	}
+	BitMatrix BitMatrix::operator+(const BitMatrix& rightMatrix) const
+	{
+		BitMatrix sum(*this);
+		sum += rightMatrix;
+		return sum;
+	}
+	BitMatrix BitMatrix::operator*(const BitMatrix& rightMatrix) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(impl->mWidth, rightMatrix.impl->mHeight), '*',
+			LengthArgument(impl->mHeight, impl->mWidth), LengthArgument(rightMatrix.impl->mHeight, rightMatrix.impl->mWidth));
+
+		BitMatrix product(*this);
+		*(product.impl) = impl->multiply(*(rightMatrix.impl));
+		return product;
+	}
+	Vectorr BitMatrix::operator*(const Vectorr& rightVector) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(impl->mWidth, rightVector.size()), '*',
+			LengthArgument(impl->mHeight, impl->mWidth), LengthArgument(rightVector.size(), 1));
+
+		std::vector<uint64_t> packed(impl->mWordCount, 0);
+		for (size_t index = 0; index < rightVector.size(); index++) {
+			if (toBit(rightVector[index])) {
+				packed[index / wordBits] |= uint64_t(1) << (index % wordBits);
+			}
+		}
+		std::vector<double> product(impl->mHeight);
+		for (size_t row = 0; row < impl->mHeight; row++) {
+			const uint64_t* words = impl->row(row);
+			uint64_t sum = 0;
+			for (size_t word = 0; word < impl->mWordCount; word++) {
+				sum ^= words[word] & packed[word];
+			}
+			product[row] = parity(sum) ? 1.0 : 0.0;
+		}
+		return toVector(product);
+	}
+
+	bool BitMatrix::operator==(const BitMatrix& rightMatrix) const
+	{
+		return impl->mHeight == rightMatrix.impl->mHeight && impl->mWidth == rightMatrix.impl->mWidth &&
+			impl->mWords == rightMatrix.impl->mWords;
+	}
+	bool BitMatrix::operator!=(const BitMatrix& rightMatrix) const
+	{
+		return !(*this == rightMatrix);
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "linalg.h"
+
+namespace linalg {
+	// Binary matrix class
+	// Implementations are in linalg_bitmatrix.cpp
+	class BitMatrix;
+
+	/*
+	* Matrix over GF(2), entries are bits packed 64 per word in row-major order.
+	*
+	* Addition is XOR and row operations act on whole words, so memory is 1/64 of a Matrixx of 0/1 entries.
+	* Elimination follows the method of four Russians (M4RI) : pivots of a few columns are found at a time,
+	* every XOR combination of those pivot rows is tabulated once, and each other row is cleared with one table lookup.
+	* Products tabulate combinations of 8 rows of the right operand the same way (M4RM), output rows in parallel.
+	* Results with no rows (nullSpace of full column rank matrix) have height 0.
+	*/
+	class BitMatrix {
+	public:
+		explicit BitMatrix(const size_t height = 1, const size_t width = 1); // throws std::length_error, zero matrix
+		explicit BitMatrix(const Matrixx& matrix); // throws std::logic_error : entry other than 0 and 1
+		BitMatrix(const BitMatrix& copyMatrix);
+		virtual ~BitMatrix();
+
+		static BitMatrix identity(const size_t length); // throws std::length_error
+
+		void reduce(); // == toEchelonForm + toReducedEchelonForm
+		void toEchelonForm();
+		void toReducedEchelonForm(); // throws std::logic_error
+
+		bool isEchelonForm() const;
+
+		const size_t rank() const;
+		BitMatrix nullSpace() const; // Rows form a basis of {x : A * x = 0}, (nullity x width)
+
+		const bool operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		void set(const size_t row, const size_t col, const bool value); // throws std::out_of_range
+
+		BitMatrix transpose() const;
+		Matrixx toMatrix() const; // throws std::length_error : no rows
+		const size_t height() const;
+		const size_t width() const;
+
+		BitMatrix& operator=(const BitMatrix& rightMatrix);
+		BitMatrix& operator+=(const BitMatrix& rightMatrix); // throws std::logic_error, entrywise XOR
+		BitMatrix operator+(const BitMatrix& rightMatrix) const; // throws std::logic_error, entrywise XOR
+		BitMatrix operator*(const BitMatrix& rightMatrix) const; // throws std::logic_error
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error : length or entry other than 0 and 1
+
+		bool operator==(const BitMatrix& rightMatrix) const;
+		bool operator!=(const BitMatrix& rightMatrix) const;
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,576 @@
+#include "linalg_block.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		// Tiles in row-major grid order, tile (i, j) covers rows [rowOffsets[i], rowOffsets[i + 1]) and columns [colOffsets[j], colOffsets[j + 1])
+		struct TileGrid {
+			TileGrid(const std::vector<size_t>& rowOffsets = { 0, 1 }, const std::vector<size_t>& colOffsets = { 0, 1 });
+
+			Dense& tile(const size_t blockRow, const size_t blockCol) { return tiles[blockRow * blockCols() + blockCol]; }
+			const Dense& tile(const size_t blockRow, const size_t blockCol) const { return tiles[blockRow * blockCols() + blockCol]; }
+			size_t blockRows() const { return rowOffsets.size() - 1; }
+			size_t blockCols() const { return colOffsets.size() - 1; }
+			size_t height() const { return rowOffsets.back(); }
+			size_t width() const { return colOffsets.back(); }
+
+			double get(const size_t row, const size_t col) const; // throws std::out_of_range
+			void assign(const Dense& dense);
+			Dense toDense() const;
+			void swapRows(const size_t firstRow, const size_t secondRow);
+			void add(const double alpha, const TileGrid& rightGrid);
+			void scale(const double alpha);
+			TileGrid multiply(const TileGrid& rightGrid) const;
+			// C = A * B, B is (width x count) and C is (height x count)
+			void multiply(const size_t count, const double* b, const size_t ldb, double* c, const size_t ldc) const;
+			TileGrid transpose() const;
+
+			std::vector<size_t> rowOffsets, colOffsets;
+			std::vector<Dense> tiles;
+		};
+
+		// Block index holding entry index of given offsets
+		size_t blockOf(const std::vector<size_t>& offsets, const size_t index)
+		{
+			return static_cast<size_t>(std::upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin()) - 1;
+		}
+
+		std::vector<size_t> offsetsOf(const std::vector<size_t>& sizes, const size_t length) // throws std::logic_error
+		{
+			std::vector<size_t> offsets(1, 0);
+			for (const size_t size : sizes) {
+				if (size == 0) {
+					handleEtcException("Tile sizes of block matrix must be positive.");
+				}
+				offsets.push_back(offsets.back() + size);
+			}
+			if (offsets.back() != length) {
+				handleEtcException("Tile sizes of block matrix must sum to matrix size.");
+			}
+			return offsets;
+		}
+
+		std::vector<size_t> uniformOffsets(const size_t length, const size_t tileSize)
+		{
+			std::vector<size_t> offsets;
+			for (size_t offset = 0; offset < length; offset += tileSize) {
+				offsets.push_back(offset);
+			}
+			offsets.push_back(length);
+			return offsets;
+		}
+
+		std::vector<size_t> sizesOf(const std::vector<size_t>& offsets)
+		{
+			std::vector<size_t> sizes(offsets.size() - 1);
+			for (size_t index = 0; index < sizes.size(); index++) {
+				sizes[index] = offsets[index + 1] - offsets[index];
+			}
+			return sizes;
+		}
+
+		// Tiles in parallel when every thread gets one, otherwise in order so that kernels parallelize inside each tile
+		void forEachTile(const size_t count, const std::function<void(const size_t)>& body)
+		{
+			if (count >= threadCount()) {
+				parallelFor(0, count, [&](const size_t begin, const size_t end) {
+					for (size_t index = begin; index < end; index++) {
+						body(index);
+					}
+				});
+			}
+			else {
+				for (size_t index = 0; index < count; index++) {
+					body(index);
+				}
+			}
+		}
+
+		void checkSum(const TileGrid& leftGrid, const TileGrid& rightGrid) // throws std::logic_error
+		{
+			const LengthArgument leftLengthArg(leftGrid.height(), leftGrid.width()), rightLengthArg(rightGrid.height(), rightGrid.width());
+			handleOperationException(ExceptionHandlerr::checkHeight(leftGrid.height(), rightGrid.height()), '+', leftLengthArg, rightLengthArg);
+			handleOperationException(ExceptionHandlerr::checkWidth(leftGrid.width(), rightGrid.width()), '+', leftLengthArg, rightLengthArg);
+			if (leftGrid.rowOffsets != rightGrid.rowOffsets || leftGrid.colOffsets != rightGrid.colOffsets) {
+				handleEtcException("Cannot add block matrices with different tile partitions.");
+			}
+		}
+
+		TileGrid::TileGrid(const std::vector<size_t>& rowOffsets, const std::vector<size_t>& colOffsets)
+			: rowOffsets(rowOffsets), colOffsets(colOffsets)
+		{
+			tiles.reserve(blockRows() * blockCols());
+			for (size_t blockRow = 0; blockRow < blockRows(); blockRow++) {
+				for (size_t blockCol = 0; blockCol < blockCols(); blockCol++) {
+					tiles.emplace_back(rowOffsets[blockRow + 1] - rowOffsets[blockRow], colOffsets[blockCol + 1] - colOffsets[blockCol]);
+				}
+			}
+		}
+
+		double TileGrid::get(const size_t row, const size_t col) const
+		{
+			handleIndexException(row, col, height(), width());
+			const size_t blockRow = blockOf(rowOffsets, row), blockCol = blockOf(colOffsets, col);
+			return tile(blockRow, blockCol)(row - rowOffsets[blockRow], col - colOffsets[blockCol]);
+		}
+
+		void TileGrid::assign(const Dense& dense)
+		{
+			forEachTile(tiles.size(), [&](const size_t index) {
+				const size_t blockRow = index / blockCols(), blockCol = index % blockCols();
+				Dense& target = tiles[index];
+				for (size_t row = 0; row < target.height; row++) {
+					const double* source = dense.row(rowOffsets[blockRow] + row) + colOffsets[blockCol];
+					std::copy(source, source + target.width, target.row(row));
+				}
+			});
+		}
+
+		Dense TileGrid::toDense() const
+		{
+			Dense dense(height(), width());
+			forEachTile(tiles.size(), [&](const size_t index) {
+				const size_t blockRow = index / blockCols(), blockCol = index % blockCols();
+				const Dense& source = tiles[index];
+				for (size_t row = 0; row < source.height; row++) {
+					std::copy(source.row(row), source.row(row) + source.width, dense.row(rowOffsets[blockRow] + row) + colOffsets[blockCol]);
+				}
+			});
+			return dense;
+		}
+
+		void TileGrid::swapRows(const size_t firstRow, const size_t secondRow)
+		{
+			const size_t firstBlock = blockOf(rowOffsets, firstRow), secondBlock = blockOf(rowOffsets, secondRow);
+			for (size_t blockCol = 0; blockCol < blockCols(); blockCol++) {
+				double* first = tile(firstBlock, blockCol).row(firstRow - rowOffsets[firstBlock]);
+				double* second = tile(secondBlock, blockCol).row(secondRow - rowOffsets[secondBlock]);
+				std::swap_ranges(first, first + tile(firstBlock, blockCol).width, second);
+			}
+		}
+
+		void TileGrid::add(const double alpha, const TileGrid& rightGrid)
+		{
+			forEachTile(tiles.size(), [&](const size_t index) {
+				axpy(tiles[index].entries.size(), alpha, rightGrid.tiles[index].data(), tiles[index].data());
+			});
+		}
+
+		void TileGrid::scale(const double alpha)
+		{
+			forEachTile(tiles.size(), [&](const size_t index) {
+				kernel::scale(tiles[index].entries.size(), alpha, tiles[index].data());
+			});
+		}
+
+		TileGrid TileGrid::multiply(const TileGrid& rightGrid) const
+		{
+			TileGrid product(rowOffsets, rightGrid.colOffsets);
+			forEachTile(product.tiles.size(), [&](const size_t index) {
+				const size_t blockRow = index / product.blockCols(), blockCol = index % product.blockCols();
+				for (size_t join = 0; join < blockCols(); join++) {
+					gemm(Trans::NoTrans, Trans::NoTrans, 1.0, tile(blockRow, join), rightGrid.tile(join, blockCol),
+						(join == 0) ? 0.0 : 1.0, product.tiles[index]);
+				}
+			});
+			return product;
+		}
+
+		void TileGrid::multiply(const size_t count, const double* b, const size_t ldb, double* c, const size_t ldc) const
+		{
+			forEachTile(blockRows(), [&](const size_t blockRow) {
+				for (size_t join = 0; join < blockCols(); join++) {
+					const Dense& source = tile(blockRow, join);
+					gemm(Trans::NoTrans, Trans::NoTrans, source.height, count, source.width,
+						1.0, source.data(), source.width, b + colOffsets[join] * ldb, ldb,
+						(join == 0) ? 0.0 : 1.0, c + rowOffsets[blockRow] * ldc, ldc);
+				}
+			});
+		}
+
+		TileGrid TileGrid::transpose() const
+		{
+			TileGrid transposed(colOffsets, rowOffsets);
+			forEachTile(tiles.size(), [&](const size_t index) {
+				const size_t blockRow = index / blockCols(), blockCol = index % blockCols();
+				transposed.tile(blockCol, blockRow) = tiles[index].transpose();
+			});
+			return transposed;
+		}
+	}
+
+
+
+
+
+	class BlockMatrix::Impl {
+	public:
+		Impl(const TileGrid& grid) : mGrid(grid) {}
+
+		TileGrid mGrid;
+	};
+
+	class BlockLU::Impl {
+	public:
+		Impl(const TileGrid& grid); // throws std::logic_error
+
+		void solve(Dense& rightDense) const; // throws std::logic_error
+
+		TileGrid mFactor; // Unit lower L below diagonal and U on and above diagonal, in tiles
+		std::vector<size_t> mPivots; // Row i was swapped with row mPivots[i] (i <= mPivots[i])
+	};
+
+	BlockLU::Impl::Impl(const TileGrid& grid)
+		: mFactor(grid), mPivots(grid.height())
+	{
+		if (grid.rowOffsets != grid.colOffsets) {
+			handleEtcException("Cannot get LU factor of block matrix with non-square diagonal tiles.");
+		}
+
+		const size_t blockCount = mFactor.blockRows();
+		for (size_t step = 0; step < blockCount; step++) {
+			const size_t stepBegin = mFactor.rowOffsets[step], stepSize = mFactor.rowOffsets[step + 1] - stepBegin;
+			Dense& diagonal = mFactor.tile(step, step);
+
+			// 1. Block column : unblocked partial pivoting across tiles below the diagonal
+			for (size_t col = 0; col < stepSize; col++) {
+				size_t pivotRow = stepBegin + col;
+				double pivotValue = 0.0;
+				for (size_t blockRow = step; blockRow < blockCount; blockRow++) {
+					const Dense& panel = mFactor.tile(blockRow, step);
+					for (size_t row = (blockRow == step) ? col : 0; row < panel.height; row++) {
+						if (std::abs(panel(row, col)) > pivotValue) {
+							pivotValue = std::abs(panel(row, col));
+							pivotRow = mFactor.rowOffsets[blockRow] + row;
+						}
+					}
+				}
+				if (pivotValue == 0.0) {
+					handleEtcException("Cannot get LU factor of singular block matrix.");
+				}
+				mPivots[stepBegin + col] = pivotRow;
+				if (pivotRow != stepBegin + col) {
+					mFactor.swapRows(stepBegin + col, pivotRow);
+				}
+
+				const double* pivotTail = diagonal.row(col) + col + 1;
+				for (size_t blockRow = step; blockRow < blockCount; blockRow++) {
+					Dense& panel = mFactor.tile(blockRow, step);
+					for (size_t row = (blockRow == step) ? col + 1 : 0; row < panel.height; row++) {
+						const double multiplier = (panel(row, col) /= diagonal(col, col));
+						axpy(stepSize - col - 1, -multiplier, pivotTail, panel.row(row) + col + 1);
+					}
+				}
+			}
+
+			// 2. Block row : U(step, j) = L(step, step)^-1 * A(step, j)
+			const size_t trailingCount = blockCount - step - 1;
+			forEachTile(trailingCount, [&](const size_t index) {
+				Dense& target = mFactor.tile(step, step + 1 + index);
+				trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::Unit, stepSize, target.width,
+					diagonal.data(), stepSize, target.data(), target.width);
+			});
+
+			// 3. Trailing tiles : A(i, j) -= L(i, step) * U(step, j)
+			forEachTile(trailingCount * trailingCount, [&](const size_t index) {
+				const size_t blockRow = step + 1 + index / trailingCount, blockCol = step + 1 + index % trailingCount;
+				gemm(Trans::NoTrans, Trans::NoTrans, -1.0, mFactor.tile(blockRow, step), mFactor.tile(step, blockCol),
+					1.0, mFactor.tile(blockRow, blockCol));
+			});
+		}
+	}
+
+	void BlockLU::Impl::solve(Dense& rightDense) const
+	{
+		const size_t length = mFactor.height(), width = rightDense.width, blockCount = mFactor.blockRows();
+		handleOperationException(ExceptionHandlerr::checkHeight(length, rightDense.height), '\\',
+			LengthArgument(length, length), LengthArgument(rightDense.height, width));
+
+		for (size_t row = 0; row < length; row++) {
+			if (mPivots[row] != row) {
+				std::swap_ranges(rightDense.row(row), rightDense.row(row) + width, rightDense.row(mPivots[row]));
+			}
+		}
+
+		// L * Y = P * B by block forward substitution
+		for (size_t step = 0; step < blockCount; step++) {
+			const Dense& diagonal = mFactor.tile(step, step);
+			double* solved = rightDense.row(mFactor.rowOffsets[step]);
+			trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::Unit, diagonal.height, width, diagonal.data(), diagonal.width, solved, width);
+			forEachTile(blockCount - step - 1, [&](const size_t index) {
+				const size_t blockRow = step + 1 + index;
+				const Dense& lower = mFactor.tile(blockRow, step);
+				gemm(Trans::NoTrans, Trans::NoTrans, lower.height, width, lower.width, -1.0, lower.data(), lower.width,
+					solved, width, 1.0, rightDense.row(mFactor.rowOffsets[blockRow]), width);
+			});
+		}
+
+		// U * X = Y by block backward substitution
+		for (size_t step = blockCount; step-- > 0;) {
+			const Dense& diagonal = mFactor.tile(step, step);
+			double* solved = rightDense.row(mFactor.rowOffsets[step]);
+			trsm(Side::Left, Uplo::Upper, Trans::NoTrans, Diag::NonUnit, diagonal.height, width, diagonal.data(), diagonal.width, solved, width);
+			forEachTile(step, [&](const size_t blockRow) {
+				const Dense& upper = mFactor.tile(blockRow, step);
+				gemm(Trans::NoTrans, Trans::NoTrans, upper.height, width, upper.width, -1.0, upper.data(), upper.width,
+					solved, width, 1.0, rightDense.row(mFactor.rowOffsets[blockRow]), width);
+			});
+		}
+	}
+
+
+
+
+
+	BlockMatrix::BlockMatrix(const Matrixx& matrix, const size_t tileSize)
+	{
+		int exceptNum = ExceptionHandlerr::checkValidHeight(tileSize);
+		if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+			LengthArgument lengthArg(tileSize, tileSize);
+			ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+			handler.addArgument(lengthArg);
+			handler.handleException();
+		}
+
+		const Dense dense = fromMatrix(matrix);
+		impl = std::make_unique<Impl>(TileGrid(uniformOffsets(dense.height, tileSize), uniformOffsets(dense.width, tileSize)));
+		impl->mGrid.assign(dense);
+	}
+	BlockMatrix::BlockMatrix(const Matrixx& matrix, const std::vector<size_t>& rowSizes, const std::vector<size_t>& colSizes)
+	{
+		const Dense dense = fromMatrix(matrix);
+		impl = std::make_unique<Impl>(TileGrid(offsetsOf(rowSizes, dense.height), offsetsOf(colSizes, dense.width)));
+		impl->mGrid.assign(dense);
+	}
+	BlockMatrix::BlockMatrix(const std::vector<std::vector<Matrixx>>& tiles)
+	{
+		if (tiles.empty() || tiles[0].empty()) {
+			handleEtcException("Block matrix must have at least one tile.");
+		}
+
+		std::vector<size_t> rowOffsets(1, 0), colOffsets(1, 0);
+		for (const std::vector<Matrixx>& tileRow : tiles) {
+			rowOffsets.push_back(rowOffsets.back() + tileRow[0].height());
+		}
+		for (const Matrixx& tile : tiles[0]) {
+			colOffsets.push_back(colOffsets.back() + tile.width());
+		}
+		for (size_t blockRow = 0; blockRow < tiles.size(); blockRow++) {
+			if (tiles[blockRow].size() != tiles[0].size()) {
+				handleEtcException("Every block row of block matrix must have the same number of tiles.");
+			}
+			for (size_t blockCol = 0; blockCol < tiles[0].size(); blockCol++) {
+				const Matrixx& tile = tiles[blockRow][blockCol];
+				if (tile.height() != rowOffsets[blockRow + 1] - rowOffsets[blockRow] ||
+					tile.width() != colOffsets[blockCol + 1] - colOffsets[blockCol]) {
+					handleEtcException("Tiles of block matrix must share height along block rows and width along block columns.");
+				}
+			}
+		}
+
+		impl = std::make_unique<Impl>(TileGrid(rowOffsets, colOffsets));
+		for (size_t blockRow = 0; blockRow < tiles.size(); blockRow++) {
+			for (size_t blockCol = 0; blockCol < tiles[0].size(); blockCol++) {
+				impl->mGrid.tile(blockRow, blockCol) = fromMatrix(tiles[blockRow][blockCol]);
+			}
+		}
+	}
+	BlockMatrix::BlockMatrix(const BlockMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	BlockMatrix::~BlockMatrix() = default;
+
+	const double BlockMatrix::operator()(const size_t row, const size_t col) const
+	{
+		return impl->mGrid.get(row, col);
+	}
+	Matrixx BlockMatrix::tile(const size_t blockRow, const size_t blockCol) const
+	{
+		handleIndexException(blockRow, blockCol, impl->mGrid.blockRows(), impl->mGrid.blockCols());
+		return kernel::toMatrix(impl->mGrid.tile(blockRow, blockCol));
+	}
+	void BlockMatrix::setTile(const size_t blockRow, const size_t blockCol, const Matrixx& tile)
+	{
+		handleIndexException(blockRow, blockCol, impl->mGrid.blockRows(), impl->mGrid.blockCols());
+		Dense& target = impl->mGrid.tile(blockRow, blockCol);
+		if (tile.height() != target.height || tile.width() != target.width) {
+			handleEtcException("Tile size must match tile partition of block matrix.");
+		}
+		target = fromMatrix(tile);
+	}
+	std::vector<size_t> BlockMatrix::rowSizes() const
+	{
+		return sizesOf(impl->mGrid.rowOffsets);
+	}
+	std::vector<size_t> BlockMatrix::colSizes() const
+	{
+		return sizesOf(impl->mGrid.colOffsets);
+	}
+
+	BlockMatrix BlockMatrix::transpose() const
+	{
+		BlockMatrix transposed(*this);
+		transposed.impl->mGrid = impl->mGrid.transpose();
+		return transposed;
+	}
+	Matrixx BlockMatrix::toMatrix() const
+	{
+		return kernel::toMatrix(impl->mGrid.toDense());
+	}
+	const size_t BlockMatrix::blockRows() const
+	{
+		return impl->mGrid.blockRows();
+	}
+	const size_t BlockMatrix::blockCols() const
+	{
+		return impl->mGrid.blockCols();
+	}
+	const size_t BlockMatrix::height() const
+	{
+		return impl->mGrid.height();
+	}
+	const size_t BlockMatrix::width() const
+	{
+		return impl->mGrid.width();
+	}
+
+	BlockMatrix& BlockMatrix::operator=(const BlockMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	BlockMatrix& BlockMatrix::operator+=(const BlockMatrix& rightMatrix)
+	{
+		checkSum(impl->mGrid, rightMatrix.impl->mGrid);
+		impl->mGrid.add(1.0, rightMatrix.impl->mGrid);
+		return *this;
+	}
+	BlockMatrix& BlockMatrix::operator-=(const BlockMatrix& rightMatrix)
+	{
+		checkSum(impl->mGrid, rightMatrix.impl->mGrid);
+		impl->mGrid.add(-1.0, rightMatrix.impl->mGrid);
+		return *this;
+	}
+	BlockMatrix& BlockMatrix::operator*=(const double multiplier)
+	{
+		impl->mGrid.scale(multiplier);
+		return *this;
+	}
+	BlockMatrix BlockMatrix::operator+(const BlockMatrix& rightMatrix) const
+	{
+		BlockMatrix sum(*this);
+		sum += rightMatrix;
+		return sum;
+	}
+	BlockMatrix BlockMatrix::operator-(const BlockMatrix& rightMatrix) const
+	{
+		BlockMatrix difference(*this);
+		difference -= rightMatrix;
+		return difference;
+	}
+	BlockMatrix BlockMatrix::operator*(const BlockMatrix& rightMatrix) const
+	{
+		const TileGrid& leftGrid = impl->mGrid;
+		const TileGrid& rightGrid = rightMatrix.impl->mGrid;
+		handleOperationException(ExceptionHandlerr::checkJoinLength(leftGrid.width(), rightGrid.height()), '*',
+			LengthArgument(leftGrid.height(), leftGrid.width()), LengthArgument(rightGrid.height(), rightGrid.width()));
+		if (leftGrid.colOffsets != rightGrid.rowOffsets) {
+			handleEtcException("Cannot multiply block matrices with different inner tile partitions.");
+		}
+
+		BlockMatrix product(*this);
+		product.impl->mGrid = leftGrid.multiply(rightGrid);
+		return product;
+	}
+	BlockMatrix BlockMatrix::operator*(const double multiplier) const
+	{
+		BlockMatrix product(*this);
+		product *= multiplier;
+		return product;
+	}
+	Vectorr BlockMatrix::operator*(const Vectorr& rightVector) const
+	{
+		const TileGrid& grid = impl->mGrid;
+		handleOperationException(ExceptionHandlerr::checkJoinLength(grid.width(), rightVector.size()), '*',
+			LengthArgument(grid.height(), grid.width()), LengthArgument(rightVector.size(), 1));
+
+		const std::vector<double> right = fromVector(rightVector);
+		std::vector<double> product(grid.height());
+		grid.multiply(1, right.data(), 1, product.data(), 1);
+		return toVector(product);
+	}
+	Matrixx BlockMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		const TileGrid& grid = impl->mGrid;
+		handleOperationException(ExceptionHandlerr::checkJoinLength(grid.width(), rightMatrix.height()), '*',
+			LengthArgument(grid.height(), grid.width()), LengthArgument(rightMatrix.height(), rightMatrix.width()));
+
+		const Dense right = fromMatrix(rightMatrix);
+		Dense product(grid.height(), right.width);
+		grid.multiply(right.width, right.data(), right.width, product.data(), product.width);
+		return kernel::toMatrix(product);
+	}
+
+
+
+
+
+	BlockLU::BlockLU(const BlockMatrix& matrix)
+		: impl(std::make_unique<Impl>(matrix.impl->mGrid))
+	{
+	}
+	BlockLU::BlockLU(const BlockLU& copyLU)
+		: impl(std::make_unique<Impl>(*(copyLU.impl)))
+	{
+	}
+	BlockLU::~BlockLU() = default;
+
+	Vectorr BlockLU::solve(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(solution);
+		return toVector(solution.entries);
+	}
+	Matrixx BlockLU::solve(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(solution);
+		return kernel::toMatrix(solution);
+	}
+	double BlockLU::determinant() const
+	{
+		double determinant = 1.0;
+		for (size_t index = 0; index < impl->mPivots.size(); index++) {
+			const size_t block = blockOf(impl->mFactor.rowOffsets, index), local = index - impl->mFactor.rowOffsets[block];
+			determinant *= impl->mFactor.tile(block, block)(local, local);
+			if (impl->mPivots[index] != index) {
+				determinant = -determinant;
+			}
+		}
+		return determinant;
+	}
+	const size_t BlockLU::size() const
+	{
+		return impl->mFactor.height();
+	}
+
+	BlockLU& BlockLU::operator=(const BlockLU& rightLU)
+	{
+		if (this == &rightLU) {
+			return *this;
+		}
+
+		*impl = *(rightLU.impl);
+		return *this;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <vector>
+
+namespace linalg {
+	// Block matrix classes
+	// Implementations are in linalg_block.cpp
+	class BlockMatrix;
+	class BlockLU;
+
+	/*
+	* Matrix partitioned into a grid of dense tiles, tile (i, j) is (rowSizes[i] x colSizes[j]).
+	*
+	* Each tile is a contiguous buffer handled by the dense kernels, so block algorithms work on tiles in place
+	* instead of copying them out with block() and reassembling the result with '&' and '|'.
+	* Tile operations run in parallel over output tiles when there are enough of them,
+	* otherwise tiles are processed one at a time by the parallel kernels.
+	* Operands of +, - and * must agree on the partitions they share (rows and columns for sums, inner partition for products).
+	*/
+	class BlockMatrix {
+		friend class BlockLU;
+	public:
+		BlockMatrix(const Matrixx& matrix, const size_t tileSize); // throws std::length_error, square tiles except at the last block row and column
+		BlockMatrix(const Matrixx& matrix, const std::vector<size_t>& rowSizes,
+			const std::vector<size_t>& colSizes); // throws std::logic_error : zero size or sizes not summing to matrix size
+		explicit BlockMatrix(const std::vector<std::vector<Matrixx>>& tiles); // throws std::logic_error : tiles not aligned in a grid
+		BlockMatrix(const BlockMatrix& copyMatrix);
+		virtual ~BlockMatrix();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		Matrixx tile(const size_t blockRow, const size_t blockCol) const; // throws std::out_of_range
+		void setTile(const size_t blockRow, const size_t blockCol, const Matrixx& tile); // throws std::out_of_range, std::logic_error : tile size differs
+		std::vector<size_t> rowSizes() const;
+		std::vector<size_t> colSizes() const;
+
+		BlockMatrix transpose() const;
+		Matrixx toMatrix() const;
+		const size_t blockRows() const;
+		const size_t blockCols() const;
+		const size_t height() const;
+		const size_t width() const;
+
+		BlockMatrix& operator=(const BlockMatrix& rightMatrix);
+		BlockMatrix& operator+=(const BlockMatrix& rightMatrix); // throws std::logic_error
+		BlockMatrix& operator-=(const BlockMatrix& rightMatrix); // throws std::logic_error
+		BlockMatrix& operator*=(const double multiplier);
+		BlockMatrix operator+(const BlockMatrix& rightMatrix) const; // throws std::logic_error
+		BlockMatrix operator-(const BlockMatrix& rightMatrix) const; // throws std::logic_error
+		BlockMatrix operator*(const BlockMatrix& rightMatrix) const; // throws std::logic_error
+		BlockMatrix operator*(const double multiplier) const;
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Tile LU factorization P * A = L * U of square block matrix with square diagonal tiles.
+	*
+	* Right-looking at tile granularity : the block column is factorized with partial pivoting across its tiles,
+	* the block row is solved with the diagonal tile and trailing tiles are updated by one product each, in parallel.
+	* Factors stay in the tile layout of the input, so each solve is a sequence of tile triangular solves and products.
+	*/
+	class BlockLU {
+	public:
+		explicit BlockLU(const BlockMatrix& matrix); // throws std::logic_error : non-square diagonal tile or singular matrix
+		BlockLU(const BlockLU& copyLU);
+		virtual ~BlockLU();
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+		double determinant() const;
+		const size_t size() const;
+
+		BlockLU& operator=(const BlockLU& rightLU);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,1024 @@
+#include "linalg_decompose.h"
+#include "linalg_kernel.h"
+#include "linalg_symmetric.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace linalg {
+	using namespace kernel;
+
+	class Cholesky::Impl {
+	public:
+		Impl() = default;
+		Impl(const Matrixx& matrix); // throws std::logic_error
+
+		bool factorize(); // Returns false on first non-positive pivot
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+		double logDeterminant() const;
+
+		void update(const Vectorr& vector); // throws std::logic_error
+		void downdate(const Vectorr& vector); // throws std::logic_error
+
+
+		void checkLength(const char operation, const size_t height, const size_t width) const; // throws std::logic_error
+
+		Dense mFactor; // Lower triangle holds L, upper triangle is zero
+	};
+
+	Cholesky::Impl::Impl(const Matrixx& matrix)
+		: mFactor(fromMatrix(matrix))
+	{
+		if (mFactor.height != mFactor.width) {
+			handleEtcException("Cannot get Cholesky factor from non-square matrix.");
+		}
+		if (!isSymmetric(mFactor)) {
+			handleEtcException("Cannot get Cholesky factor from non-symmetric matrix.");
+		}
+		if (!factorize()) {
+			handleEtcException("The matrix is not positive-definite.");
+		}
+	}
+
+	bool Cholesky::Impl::factorize()
+	{
+		const size_t length = mFactor.height;
+		if (!choleskyFactor(length, mFactor.data(), length)) {
+			return false;
+		}
+
+		for (size_t row = 0; row < length; row++) {
+			std::fill(mFactor.row(row) + row + 1, mFactor.row(row) + length, 0.0);
+		}
+		return true;
+	}
+
+	void Cholesky::Impl::checkLength(const char operation, const size_t height, const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(mFactor.height, height), operation,
+			LengthArgument(mFactor.height, mFactor.width), LengthArgument(height, width));
+	}
+
+	Vectorr Cholesky::Impl::solve(const Vectorr& rightVector) const
+	{
+		checkLength('\\', rightVector.size(), 1);
+
+		std::vector<double> solution = fromVector(rightVector);
+		trsv(Uplo::Lower, Trans::NoTrans, Diag::NonUnit, mFactor.height, mFactor.data(), mFactor.width, solution.data());
+		trsv(Uplo::Lower, Trans::Trans, Diag::NonUnit, mFactor.height, mFactor.data(), mFactor.width, solution.data());
+		return toVector(solution);
+	}
+	Matrixx Cholesky::Impl::solve(const Matrixx& rightMatrix) const
+	{
+		checkLength('\\', rightMatrix.height(), rightMatrix.width());
+
+		Dense solution = fromMatrix(rightMatrix);
+		trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::NonUnit, solution.height, solution.width,
+			mFactor.data(), mFactor.width, solution.data(), solution.width);
+		trsm(Side::Left, Uplo::Lower, Trans::Trans, Diag::NonUnit, solution.height, solution.width,
+			mFactor.data(), mFactor.width, solution.data(), solution.width);
+		return toMatrix(solution);
+	}
+
+	double Cholesky::Impl::logDeterminant() const
+	{
+		double logDeterminant = 0.0;
+		for (size_t row = 0; row < mFactor.height; row++) {
+			logDeterminant += std::log(mFactor(row, row));
+		}
+		return 2.0 * logDeterminant;
+	}
+
+	void Cholesky::Impl::update(const Vectorr& vector)
+	{
+		checkLength('+', vector.size(), 1);
+
+		// Sequence of Givens rotations eliminating v against columns of L
+		const size_t length = mFactor.height;
+		std::vector<double> work = fromVector(vector);
+		for (size_t col = 0; col < length; col++) {
+			const double diagonal = mFactor(col, col);
+			const double radius = std::hypot(diagonal, work[col]);
+			const double cosine = radius / diagonal, sine = work[col] / diagonal;
+			mFactor(col, col) = radius;
+			for (size_t row = col + 1; row < length; row++) {
+				double& entry = mFactor(row, col);
+				entry = (entry + sine * work[row]) / cosine;
+				work[row] = cosine * work[row] - sine * entry;
+			}
+		}
+	}
+	void Cholesky::Impl::downdate(const Vectorr& vector)
+	{
+		checkLength('-', vector.size(), 1);
+
+		// Hyperbolic rotations on a copy, so the factor survives a failed downdate
+		const size_t length = mFactor.height;
+		Dense factor(mFactor);
+		std::vector<double> work = fromVector(vector);
+		for (size_t col = 0; col < length; col++) {
+			const double diagonal = factor(col, col);
+			const double squaredRadius = (diagonal - work[col]) * (diagonal + work[col]);
+			if (!(squaredRadius > 0.0)) {
+				handleEtcException("Downdated matrix is not positive-definite.");
+			}
+			const double radius = std::sqrt(squaredRadius);
+			const double cosine = radius / diagonal, sine = work[col] / diagonal;
+			factor(col, col) = radius;
+			for (size_t row = col + 1; row < length; row++) {
+				double& entry = factor(row, col);
+				entry = (entry - sine * work[row]) / cosine;
+				work[row] = cosine * work[row] - sine * entry;
+			}
+		}
+		std::swap(mFactor, factor);
+	}
+
+
+
+
+
+	Cholesky::Cholesky(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(matrix))
+	{
+	}
+	Cholesky::Cholesky(const SymmetricMatrix& matrix)
+		: impl(std::make_unique<Impl>())
+	{
+		// Half storage is symmetric by construction, only its lower triangle is copied
+		impl->mFactor = Dense(matrix.size(), matrix.size());
+		matrix.copyLower(impl->mFactor.data());
+		if (!impl->factorize()) {
+			handleEtcException("The matrix is not positive-definite.");
+		}
+	}
+	Cholesky::Cholesky(const Cholesky& copyCholesky)
+		: impl(std::make_unique<Impl>(*(copyCholesky.impl)))
+	{
+	}
+	Cholesky::~Cholesky() = default;
+
+	Vectorr Cholesky::solve(const Vectorr& rightVector) const
+	{
+		return impl->solve(rightVector);
+	}
+	Matrixx Cholesky::solve(const Matrixx& rightMatrix) const
+	{
+		return impl->solve(rightMatrix);
+	}
+	double Cholesky::logDeterminant() const
+	{
+		return impl->logDeterminant();
+	}
+	Matrixx Cholesky::inverse() const
+	{
+		return impl->solve(Matrixx::identity(impl->mFactor.height));
+	}
+
+	void Cholesky::update(const Vectorr& vector)
+	{
+		impl->update(vector);
+	}
+	void Cholesky::downdate(const Vectorr& vector)
+	{
+		impl->downdate(vector);
+	}
+
+	Matrixx Cholesky::lower() const
+	{
+		return toMatrix(impl->mFactor);
+	}
+	const size_t Cholesky::size() const
+	{
+		return impl->mFactor.height;
+	}
+
+	bool Cholesky::isPositiveDefinite(const Matrixx& matrix)
+	{
+		Impl probeImpl;
+		probeImpl.mFactor = fromMatrix(matrix);
+		return isSymmetric(probeImpl.mFactor) && probeImpl.factorize();
+	}
+
+	Cholesky& Cholesky::operator=(const Cholesky& rightCholesky)
+	{
+		if (this == &rightCholesky) {
+			return *this;
+		}
+
+		*impl = *(rightCholesky.impl);
+		return *this;
+	}
+
+
+
+
+
+	class QR::Impl {
+	public:
+		Impl(const Matrixx& matrix, const bool columnPivoting);
+
+		void factorizePivoted();
+		void formReflectorFactors();
+
+		void applyQ(Dense& rightDense, const bool transpose) const;
+		Dense solveLeastSquares(const Dense& rightDense) const; // throws std::logic_error
+		const size_t rank() const;
+
+		void checkHeight(const char operation, const size_t height, const size_t width) const; // throws std::logic_error
+
+		const size_t reflectorCount() const;
+
+		Dense mFactor; // R on and above diagonal, Householder vectors below diagonal
+		std::vector<double> mTau;
+		std::vector<size_t> mPermutation;
+		std::vector<Dense> mReflectorFactors; // T of each reflector block
+		bool mColumnPivoting;
+	};
+
+	QR::Impl::Impl(const Matrixx& matrix, const bool columnPivoting)
+		: mFactor(fromMatrix(matrix)), mColumnPivoting(columnPivoting)
+	{
+		mTau.assign(reflectorCount(), 0.0);
+		mPermutation.resize(mFactor.width);
+		for (size_t col = 0; col < mFactor.width; col++) {
+			mPermutation[col] = col;
+		}
+
+		if (mColumnPivoting) {
+			factorizePivoted();
+		}
+		else {
+			householderQR(mFactor.height, mFactor.width, mFactor.data(), mFactor.width, mTau.data());
+		}
+		formReflectorFactors();
+	}
+
+	const size_t QR::Impl::reflectorCount() const
+	{
+		return std::min(mFactor.height, mFactor.width);
+	}
+
+	void QR::Impl::factorizePivoted()
+	{
+		const size_t height = mFactor.height, width = mFactor.width;
+		constexpr double epsilon = std::numeric_limits<double>::epsilon();
+
+		// Partial column norms, downdated after each reflection and recomputed when cancellation is suspected
+		std::vector<double> partialNorms(width), exactNorms(width), column(height);
+		for (size_t col = 0; col < width; col++) {
+			for (size_t row = 0; row < height; row++) {
+				column[row] = mFactor(row, col);
+			}
+			partialNorms[col] = exactNorms[col] = norm2(height, column.data());
+		}
+
+		std::vector<double> work(width);
+		for (size_t col = 0; col < reflectorCount(); col++) {
+			// 1. Move largest remaining column forward
+			const size_t pivot = static_cast<size_t>(std::max_element(partialNorms.begin() + col, partialNorms.end())
+				- partialNorms.begin());
+			if (pivot != col) {
+				for (size_t row = 0; row < height; row++) {
+					std::swap(mFactor(row, col), mFactor(row, pivot));
+				}
+				std::swap(mPermutation[col], mPermutation[pivot]);
+				std::swap(partialNorms[col], partialNorms[pivot]);
+				std::swap(exactNorms[col], exactNorms[pivot]);
+			}
+
+			// 2. Reflect column and apply H to trailing columns
+			mTau[col] = householder(height - col - 1, mFactor(col, col),
+				mFactor.row(col) + col + ((col + 1 < height) ? width : 0), width);
+			const size_t restWidth = width - col - 1;
+			if (mTau[col] != 0.0 && restWidth > 0) {
+				const double tau = mTau[col];
+				parallelFor(col + 1, width, [&](const size_t colBegin, const size_t colEnd) {
+					const size_t chunkWidth = colEnd - colBegin;
+					double* chunkWork = work.data() + colBegin;
+					std::copy(mFactor.row(col) + colBegin, mFactor.row(col) + colEnd, chunkWork);
+					for (size_t row = col + 1; row < height; row++) {
+						axpy(chunkWidth, mFactor(row, col), mFactor.row(row) + colBegin, chunkWork);
+					}
+					axpy(chunkWidth, -tau, chunkWork, mFactor.row(col) + colBegin);
+					for (size_t row = col + 1; row < height; row++) {
+						axpy(chunkWidth, -tau * mFactor(row, col), chunkWork, mFactor.row(row) + colBegin);
+					}
+				}, std::max<size_t>(16, 65536 / (height - col + 1)));
+			}
+
+			// 3. Downdate partial norms
+			for (size_t rest = col + 1; rest < width; rest++) {
+				if (partialNorms[rest] == 0.0) {
+					continue;
+				}
+				const double ratio = std::abs(mFactor(col, rest)) / partialNorms[rest];
+				const double remainder = std::max(0.0, (1.0 + ratio) * (1.0 - ratio));
+				const double relative = partialNorms[rest] / exactNorms[rest];
+				if (remainder * relative * relative <= std::sqrt(epsilon)) {
+					for (size_t row = col + 1; row < height; row++) {
+						column[row] = mFactor(row, rest);
+					}
+					partialNorms[rest] = exactNorms[rest] = norm2(height - col - 1, column.data() + col + 1);
+				}
+				else {
+					partialNorms[rest] *= std::sqrt(remainder);
+				}
+			}
+		}
+	}
+
+	void QR::Impl::formReflectorFactors()
+	{
+		mReflectorFactors.clear();
+		for (size_t blockBegin = 0; blockBegin < reflectorCount(); blockBegin += blockSize) {
+			const size_t blockEnd = std::min(blockBegin + blockSize, reflectorCount());
+			mReflectorFactors.push_back(reflectorFactor(mFactor.height - blockBegin, blockEnd - blockBegin,
+				mFactor.row(blockBegin) + blockBegin, mFactor.width, mTau.data() + blockBegin));
+		}
+	}
+
+	void QR::Impl::applyQ(Dense& rightDense, const bool transpose) const
+	{
+		// Q = H1 * ... * Hk, so Q^T applies blocks forward and Q applies blocks backward
+		const size_t blockCount = mReflectorFactors.size();
+		for (size_t step = 0; step < blockCount; step++) {
+			const size_t block = transpose ? step : blockCount - 1 - step;
+			const size_t blockBegin = block * blockSize;
+			applyReflectorBlock(transpose ? Trans::Trans : Trans::NoTrans,
+				mFactor.height - blockBegin, rightDense.width, mReflectorFactors[block].height,
+				mFactor.row(blockBegin) + blockBegin, mFactor.width, mReflectorFactors[block],
+				rightDense.row(blockBegin), rightDense.width);
+		}
+	}
+
+	const size_t QR::Impl::rank() const
+	{
+		if (!mColumnPivoting) {
+			// Diagonal of R is not ordered, count every entry above tolerance
+			size_t rank = 0;
+			double maxDiagonal = 0.0;
+			for (size_t index = 0; index < reflectorCount(); index++) {
+				maxDiagonal = std::max(maxDiagonal, std::abs(mFactor(index, index)));
+			}
+			const double tolerance = std::max(mFactor.height, mFactor.width) * std::numeric_limits<double>::epsilon() * maxDiagonal;
+			for (size_t index = 0; index < reflectorCount(); index++) {
+				rank += (std::abs(mFactor(index, index)) > tolerance) ? 1 : 0;
+			}
+			return rank;
+		}
+
+		const double tolerance = std::max(mFactor.height, mFactor.width) * std::numeric_limits<double>::epsilon()
+			* std::abs(mFactor(0, 0));
+		size_t rank = 0;
+		while (rank < reflectorCount() && std::abs(mFactor(rank, rank)) > tolerance) {
+			rank++;
+		}
+		return rank;
+	}
+
+	void QR::Impl::checkHeight(const char operation, const size_t height, const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(mFactor.height, height), operation,
+			LengthArgument(mFactor.height, mFactor.width), LengthArgument(height, width));
+	}
+
+	Dense QR::Impl::solveLeastSquares(const Dense& rightDense) const
+	{
+		checkHeight('\\', rightDense.height, rightDense.width);
+
+		const size_t solvedLength = mColumnPivoting ? rank() : reflectorCount();
+		if (!mColumnPivoting && rank() < reflectorCount()) {
+			handleEtcException("Cannot solve rank deficient least squares problem without column pivoting.");
+		}
+
+		// 1. c = Q^T * b
+		Dense transformed(rightDense);
+		applyQ(transformed, true);
+
+		// 2. Solve R11 * y = c1 and scatter y through P
+		trsm(Side::Left, Uplo::Upper, Trans::NoTrans, Diag::NonUnit, solvedLength, transformed.width,
+			mFactor.data(), mFactor.width, transformed.data(), transformed.width);
+		Dense solution(mFactor.width, rightDense.width);
+		for (size_t row = 0; row < solvedLength; row++) {
+			std::copy(transformed.row(row), transformed.row(row) + transformed.width, solution.row(mPermutation[row]));
+		}
+		return solution;
+	}
+
+
+
+
+
+	QR::QR(const Matrixx& matrix, const bool columnPivoting)
+		: impl(std::make_unique<Impl>(matrix, columnPivoting))
+	{
+	}
+	QR::QR(const QR& copyQR)
+		: impl(std::make_unique<Impl>(*(copyQR.impl)))
+	{
+	}
+	QR::~QR() = default;
+
+	Vectorr QR::solveLeastSquares(const Vectorr& rightVector) const
+	{
+		const Dense solution = impl->solveLeastSquares(fromColumns(rightVector));
+		return toVector(solution.entries);
+	}
+	Matrixx QR::solveLeastSquares(const Matrixx& rightMatrix) const
+	{
+		return toMatrix(impl->solveLeastSquares(fromMatrix(rightMatrix)));
+	}
+
+	Vectorr QR::applyQ(const Vectorr& rightVector) const
+	{
+		impl->checkHeight('*', rightVector.size(), 1);
+		Dense product = fromColumns(rightVector);
+		impl->applyQ(product, false);
+		return toVector(product.entries);
+	}
+	Matrixx QR::applyQ(const Matrixx& rightMatrix) const
+	{
+		impl->checkHeight('*', rightMatrix.height(), rightMatrix.width());
+		Dense product = fromMatrix(rightMatrix);
+		impl->applyQ(product, false);
+		return toMatrix(product);
+	}
+	Vectorr QR::applyQTranspose(const Vectorr& rightVector) const
+	{
+		impl->checkHeight('*', rightVector.size(), 1);
+		Dense product = fromColumns(rightVector);
+		impl->applyQ(product, true);
+		return toVector(product.entries);
+	}
+	Matrixx QR::applyQTranspose(const Matrixx& rightMatrix) const
+	{
+		impl->checkHeight('*', rightMatrix.height(), rightMatrix.width());
+		Dense product = fromMatrix(rightMatrix);
+		impl->applyQ(product, true);
+		return toMatrix(product);
+	}
+
+	Matrixx QR::R() const
+	{
+		Dense upper(impl->reflectorCount(), impl->mFactor.width);
+		for (size_t row = 0; row < upper.height; row++) {
+			std::copy(impl->mFactor.row(row) + row, impl->mFactor.row(row) + upper.width, upper.row(row) + row);
+		}
+		return toMatrix(upper);
+	}
+	Matrixx QR::Q() const
+	{
+		Dense thinQ(impl->mFactor.height, impl->reflectorCount());
+		for (size_t index = 0; index < thinQ.width; index++) {
+			thinQ(index, index) = 1.0;
+		}
+		impl->applyQ(thinQ, false);
+		return toMatrix(thinQ);
+	}
+	std::vector<size_t> QR::permutation() const
+	{
+		return impl->mPermutation;
+	}
+	const size_t QR::rank() const
+	{
+		return impl->rank();
+	}
+
+	const size_t QR::height() const
+	{
+		return impl->mFactor.height;
+	}
+	const size_t QR::width() const
+	{
+		return impl->mFactor.width;
+	}
+
+	QR& QR::operator=(const QR& rightQR)
+	{
+		if (this == &rightQR) {
+			return *this;
+		}
+
+		*impl = *(rightQR.impl);
+		return *this;
+	}
+
+
+
+
+
+	class SymmetricEigen::Impl {
+	public:
+		Impl(const Matrixx& matrix, const size_t count, const bool computeVectors); // throws std::logic_error
+		Impl(const SymmetricMatrix& matrix, const size_t count, const bool computeVectors); // throws std::logic_error
+
+		void decompose(Dense& dense, const size_t count); // Lower triangle of dense is referenced and overwritten
+		void checkVectors() const; // throws std::logic_error
+
+		std::vector<double> mValues; // Descending
+		Dense mVectors; // size x count
+		size_t mSize;
+		bool mHasVectors;
+	};
+
+	SymmetricEigen::Impl::Impl(const Matrixx& matrix, const size_t count, const bool computeVectors)
+		: mSize(matrix.height()), mHasVectors(computeVectors)
+	{
+		Dense dense = fromMatrix(matrix);
+		if (dense.height != dense.width) {
+			handleEtcException("Cannot get eigendecomposition of non-square matrix.");
+		}
+		if (!isSymmetric(dense)) {
+			handleEtcException("Cannot get eigendecomposition of non-symmetric matrix.");
+		}
+		decompose(dense, count);
+	}
+	SymmetricEigen::Impl::Impl(const SymmetricMatrix& matrix, const size_t count, const bool computeVectors)
+		: mSize(matrix.size()), mHasVectors(computeVectors)
+	{
+		Dense dense(mSize, mSize);
+		matrix.copyLower(dense.data());
+		decompose(dense, count);
+	}
+
+	void SymmetricEigen::Impl::decompose(Dense& dense, const size_t count)
+	{
+		if (count == 0 || count > mSize) {
+			handleEtcException("Eigenpair count must be in range [1, size].");
+		}
+
+		// 1. Q^T * A * Q = T
+		std::vector<double> diagonal(mSize), subdiagonal(mSize), tau(mSize);
+		tridiagonalize(mSize, dense.data(), mSize, diagonal.data(), subdiagonal.data(), tau.data());
+
+		// 2. Largest count eigenpairs of T in ascending order
+		// Subset by bisection and inverse iteration is cheaper only for a small part of the spectrum
+		const bool subset = (4 * count < mSize);
+		std::vector<double> values;
+		Dense tridiagonalVectors;
+		if (subset) {
+			values = tridiagonalBisection(mSize, diagonal.data(), subdiagonal.data(), mSize - count, mSize);
+			if (mHasVectors) {
+				tridiagonalVectors = tridiagonalInverseIteration(mSize, diagonal.data(), subdiagonal.data(), values);
+			}
+		}
+		else if (mHasVectors) {
+			Dense allVectors;
+			tridiagonalDivideConquer(mSize, diagonal.data(), subdiagonal.data(), allVectors);
+			values.assign(diagonal.end() - count, diagonal.end());
+			tridiagonalVectors = Dense(mSize, count);
+			for (size_t row = 0; row < mSize; row++) {
+				std::copy(allVectors.row(row) + mSize - count, allVectors.row(row) + mSize, tridiagonalVectors.row(row));
+			}
+		}
+		else {
+			tridiagonalQL(mSize, diagonal.data(), subdiagonal.data(), nullptr, 0);
+			values.assign(diagonal.end() - count, diagonal.end());
+		}
+
+		// 3. X = Q * Z, reversed to descending order
+		mValues.assign(values.rbegin(), values.rend());
+		if (mHasVectors) {
+			applyTridiagonalQ(mSize, dense.data(), mSize, tau.data(), count, tridiagonalVectors.data(), count);
+			mVectors = Dense(mSize, count);
+			for (size_t row = 0; row < mSize; row++) {
+				std::reverse_copy(tridiagonalVectors.row(row), tridiagonalVectors.row(row) + count, mVectors.row(row));
+			}
+		}
+	}
+
+	void SymmetricEigen::Impl::checkVectors() const
+	{
+		if (!mHasVectors) {
+			handleEtcException("Eigenvectors are not computed.");
+		}
+	}
+
+
+
+
+
+	SymmetricEigen::SymmetricEigen(const Matrixx& matrix, const bool computeVectors)
+		: impl(std::make_unique<Impl>(matrix, matrix.height(), computeVectors))
+	{
+	}
+	SymmetricEigen::SymmetricEigen(const SymmetricMatrix& matrix, const bool computeVectors)
+		: impl(std::make_unique<Impl>(matrix, matrix.size(), computeVectors))
+	{
+	}
+	SymmetricEigen::SymmetricEigen(const SymmetricEigen& copyEigen)
+		: impl(std::make_unique<Impl>(*(copyEigen.impl)))
+	{
+	}
+	SymmetricEigen::SymmetricEigen(std::unique_ptr<Impl> eigenImpl)
+		: impl(std::move(eigenImpl))
+	{
+	}
+	SymmetricEigen::~SymmetricEigen() = default;
+
+	Vectorr SymmetricEigen::eigenvalues() const
+	{
+		return toVector(impl->mValues);
+	}
+	Matrixx SymmetricEigen::eigenvectors() const
+	{
+		impl->checkVectors();
+		return toMatrix(impl->mVectors);
+	}
+	Vectorr SymmetricEigen::eigenvector(const size_t index) const
+	{
+		handleIndexException(0, index, impl->mSize, impl->mValues.size());
+		impl->checkVectors();
+
+		Vectorr vector(impl->mSize);
+		for (size_t row = 0; row < impl->mSize; row++) {
+			vector[row] = impl->mVectors(row, index);
+		}
+		return vector;
+	}
+
+	const size_t SymmetricEigen::size() const
+	{
+		return impl->mSize;
+	}
+	const size_t SymmetricEigen::count() const
+	{
+		return impl->mValues.size();
+	}
+	bool SymmetricEigen::hasVectors() const
+	{
+		return impl->mHasVectors;
+	}
+
+	SymmetricEigen SymmetricEigen::largest(const Matrixx& matrix, const size_t count, const bool computeVectors)
+	{
+		return SymmetricEigen(std::make_unique<Impl>(matrix, count, computeVectors));
+	}
+	SymmetricEigen SymmetricEigen::largest(const SymmetricMatrix& matrix, const size_t count, const bool computeVectors)
+	{
+		return SymmetricEigen(std::make_unique<Impl>(matrix, count, computeVectors));
+	}
+
+	SymmetricEigen& SymmetricEigen::operator=(const SymmetricEigen& rightEigen)
+	{
+		if (this == &rightEigen) {
+			return *this;
+		}
+
+		*impl = *(rightEigen.impl);
+		return *this;
+	}
+
+
+
+
+
+	class SVD::Impl {
+	public:
+		Impl(const Matrixx& matrix, const Mode mode);
+
+		Dense solve(const Dense& rightDense) const; // throws std::logic_error
+		void checkVectors() const; // throws std::logic_error
+		const size_t rank(const double tolerance) const;
+		double defaultTolerance() const;
+
+		size_t mHeight, mWidth;
+		Mode mMode;
+		std::vector<double> mValues; // Descending
+		Dense mU, mV;
+	};
+
+	SVD::Impl::Impl(const Matrixx& matrix, const Mode mode)
+		: mHeight(matrix.height()), mWidth(matrix.width()), mMode(mode)
+	{
+		// Work on tall (long x short) matrix, A^T = V * S * U^T when A is wide
+		const bool transposed = (mHeight < mWidth);
+		Dense tall = transposed ? fromMatrix(matrix).transpose() : fromMatrix(matrix);
+		const size_t longLength = tall.height, shortLength = tall.width;
+
+		// 1. Q^T * A * P = B (upper bidiagonal)
+		mValues.resize(shortLength);
+		std::vector<double> superdiagonal(shortLength), leftTau(shortLength), rightTau(shortLength);
+		bidiagonalize(longLength, shortLength, tall.data(), tall.width,
+			mValues.data(), superdiagonal.data(), leftTau.data(), rightTau.data());
+
+		// 2. B = Ub * S * Vb^T
+		if (mode == Mode::ValuesOnly) {
+			bidiagonalSVD(shortLength, mValues.data(), superdiagonal.data(), nullptr, 0, nullptr, 0);
+			return;
+		}
+		Dense leftTransposed(shortLength, shortLength), rightTransposed(shortLength, shortLength);
+		for (size_t index = 0; index < shortLength; index++) {
+			leftTransposed(index, index) = rightTransposed(index, index) = 1.0;
+		}
+		bidiagonalSVD(shortLength, mValues.data(), superdiagonal.data(),
+			leftTransposed.data(), shortLength, rightTransposed.data(), shortLength);
+
+		// 3. A = (Q * Ub) * S * (P * Vb)^T
+		const size_t leftWidth = (mode == Mode::Full) ? longLength : shortLength;
+		Dense left(longLength, leftWidth);
+		for (size_t row = 0; row < shortLength; row++) {
+			for (size_t col = 0; col < shortLength; col++) {
+				left(row, col) = leftTransposed(col, row);
+			}
+		}
+		for (size_t index = shortLength; index < leftWidth; index++) {
+			left(index, index) = 1.0;
+		}
+		Dense right = rightTransposed.transpose();
+		applyBidiagonalQ(longLength, shortLength, tall.data(), tall.width, leftTau.data(), leftWidth, left.data(), left.width);
+		applyBidiagonalP(shortLength, tall.data(), tall.width, rightTau.data(), shortLength, right.data(), right.width);
+
+		mU = transposed ? std::move(right) : std::move(left);
+		mV = transposed ? std::move(left) : std::move(right);
+	}
+
+	void SVD::Impl::checkVectors() const
+	{
+		if (mMode == Mode::ValuesOnly) {
+			handleEtcException("Singular vectors are not computed.");
+		}
+	}
+
+	double SVD::Impl::defaultTolerance() const
+	{
+		return static_cast<double>(std::max(mHeight, mWidth)) * std::numeric_limits<double>::epsilon() * mValues[0];
+	}
+
+	const size_t SVD::Impl::rank(const double tolerance) const
+	{
+		return std::count_if(mValues.begin(), mValues.end(), [tolerance](const double value) { return value > tolerance; });
+	}
+
+	Dense SVD::Impl::solve(const Dense& rightDense) const
+	{
+		checkVectors();
+		handleOperationException(ExceptionHandlerr::checkHeight(mHeight, rightDense.height), '\\',
+			LengthArgument(mHeight, mWidth), LengthArgument(rightDense.height, rightDense.width));
+
+		// x = V * S^+ * U^T * b over singular values above tolerance
+		const size_t count = rank(defaultTolerance()), width = rightDense.width;
+		Dense projected(count, width);
+		gemm(Trans::Trans, Trans::NoTrans, count, width, mHeight, 1.0, mU.data(), mU.width,
+			rightDense.data(), width, 0.0, projected.data(), width);
+		for (size_t row = 0; row < count; row++) {
+			scale(width, 1.0 / mValues[row], projected.row(row));
+		}
+		Dense solution(mWidth, width);
+		gemm(Trans::NoTrans, Trans::NoTrans, mWidth, width, count, 1.0, mV.data(), mV.width,
+			projected.data(), width, 0.0, solution.data(), width);
+		return solution;
+	}
+
+
+
+
+
+	SVD::SVD(const Matrixx& matrix, const Mode mode)
+		: impl(std::make_unique<Impl>(matrix, mode))
+	{
+	}
+	SVD::SVD(const SVD& copySVD)
+		: impl(std::make_unique<Impl>(*(copySVD.impl)))
+	{
+	}
+	SVD::~SVD() = default;
+
+	Vectorr SVD::singularValues() const
+	{
+		return toVector(impl->mValues);
+	}
+	Matrixx SVD::U() const
+	{
+		impl->checkVectors();
+		return toMatrix(impl->mU);
+	}
+	Matrixx SVD::V() const
+	{
+		impl->checkVectors();
+		return toMatrix(impl->mV);
+	}
+
+	Vectorr SVD::solve(const Vectorr& rightVector) const
+	{
+		return toVector(impl->solve(fromColumns(rightVector)).entries);
+	}
+	Matrixx SVD::solve(const Matrixx& rightMatrix) const
+	{
+		return toMatrix(impl->solve(fromMatrix(rightMatrix)));
+	}
+	Matrixx SVD::pseudoinverse() const
+	{
+		Dense identity(impl->mHeight, impl->mHeight);
+		for (size_t index = 0; index < impl->mHeight; index++) {
+			identity(index, index) = 1.0;
+		}
+		return toMatrix(impl->solve(identity));
+	}
+
+	const size_t SVD::rank() const
+	{
+		return impl->rank(impl->defaultTolerance());
+	}
+	const size_t SVD::rank(const double tolerance) const
+	{
+		return impl->rank(tolerance);
+	}
+	double SVD::conditionNumber() const
+	{
+		const double smallest = impl->mValues.back();
+		return (smallest > 0.0) ? impl->mValues.front() / smallest : std::numeric_limits<double>::infinity();
+	}
+
+	const size_t SVD::height() const
+	{
+		return impl->mHeight;
+	}
+	const size_t SVD::width() const
+	{
+		return impl->mWidth;
+	}
+
+	SVD& SVD::operator=(const SVD& rightSVD)
+	{
+		if (this == &rightSVD) {
+			return *this;
+		}
+
+		*impl = *(rightSVD.impl);
+		return *this;
+	}
+
+
+
+
+
+	class RandomizedSVD::Impl {
+	public:
+		Impl(const Dense& matrix, const size_t rank, const size_t oversampling, const size_t powerIterations, const unsigned int seed);
+
+		Dense multiply(const Dense& rightDense) const; // throws std::logic_error
+
+		static void checkCount(const size_t count, const size_t height, const size_t width); // throws std::logic_error
+		static Dense rangeFinder(const Dense& matrix, const size_t count, const size_t powerIterations, const unsigned int seed);
+
+		size_t mHeight, mWidth;
+		std::vector<double> mValues; // Descending
+		Dense mU, mV;
+	};
+
+	RandomizedSVD::Impl::Impl(const Dense& matrix, const size_t rank, const size_t oversampling,
+		const size_t powerIterations, const unsigned int seed)
+		: mHeight(matrix.height), mWidth(matrix.width)
+	{
+		checkCount(rank, mHeight, mWidth);
+		const size_t sampleCount = std::min(rank + oversampling, std::min(mHeight, mWidth));
+
+		// 1. Q (m x l) with range of A
+		const Dense basis = rangeFinder(matrix, sampleCount, powerIterations, seed);
+
+		// 2. B = Q^T * A (l x n) = Ub * S * V^T, then U = Q * Ub
+		const Dense projected = kernel::multiply(basis, matrix, Trans::Trans);
+		const SVD smallSVD(kernel::toMatrix(projected));
+		const Dense smallU = fromMatrix(smallSVD.U()), smallV = fromMatrix(smallSVD.V());
+		const Vectorr values = smallSVD.singularValues();
+		mValues.resize(rank);
+		for (size_t index = 0; index < rank; index++) {
+			mValues[index] = values[index];
+		}
+		mU = Dense(mHeight, rank);
+		gemm(Trans::NoTrans, Trans::NoTrans, mHeight, rank, sampleCount, 1.0, basis.data(), basis.width,
+			smallU.data(), smallU.width, 0.0, mU.data(), rank);
+		mV = Dense(mWidth, rank);
+		for (size_t row = 0; row < mWidth; row++) {
+			std::copy(smallV.row(row), smallV.row(row) + rank, mV.row(row));
+		}
+	}
+
+	void RandomizedSVD::Impl::checkCount(const size_t count, const size_t height, const size_t width)
+	{
+		if (count == 0 || count > std::min(height, width)) {
+			handleEtcException("Approximation rank must be in range [1, min(height, width)].");
+		}
+	}
+
+	Dense RandomizedSVD::Impl::rangeFinder(const Dense& matrix, const size_t count, const size_t powerIterations, const unsigned int seed)
+	{
+		std::mt19937_64 generator(seed);
+		std::normal_distribution<double> distribution;
+		Dense test(matrix.width, count);
+		for (double& entry : test.entries) {
+			entry = distribution(generator);
+		}
+
+		// Power iterations Q <- orth(A * orth(A^T * Q)) sharpen the decay of singular values
+		Dense basis = orthonormalColumns(kernel::multiply(matrix, test));
+		for (size_t iteration = 0; iteration < powerIterations; iteration++) {
+			const Dense coBasis = orthonormalColumns(kernel::multiply(matrix, basis, Trans::Trans));
+			basis = orthonormalColumns(kernel::multiply(matrix, coBasis));
+		}
+		return basis;
+	}
+
+	Dense RandomizedSVD::Impl::multiply(const Dense& rightDense) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mWidth, rightDense.height), '*',
+			LengthArgument(mHeight, mWidth), LengthArgument(rightDense.height, rightDense.width));
+
+		// U * (S * (V^T * X))
+		if (rightDense.width == 1) {
+			std::vector<double> projected(mValues.size());
+			gemv(Trans::Trans, mWidth, mValues.size(), 1.0, mV.data(), mV.width, rightDense.data(), 0.0, projected.data());
+			for (size_t index = 0; index < mValues.size(); index++) {
+				projected[index] *= mValues[index];
+			}
+			Dense product(mHeight, 1);
+			gemv(Trans::NoTrans, mHeight, mValues.size(), 1.0, mU.data(), mU.width, projected.data(), 0.0, product.data());
+			return product;
+		}
+		Dense projected = kernel::multiply(mV, rightDense, Trans::Trans);
+		for (size_t row = 0; row < mValues.size(); row++) {
+			scale(projected.width, mValues[row], projected.row(row));
+		}
+		return kernel::multiply(mU, projected);
+	}
+
+
+
+
+
+	RandomizedSVD::RandomizedSVD(const Matrixx& matrix, const size_t rank, const size_t oversampling,
+		const size_t powerIterations, const unsigned int seed)
+		: impl(std::make_unique<Impl>(fromMatrix(matrix), rank, oversampling, powerIterations, seed))
+	{
+	}
+	RandomizedSVD::RandomizedSVD(const RandomizedSVD& copySVD)
+		: impl(std::make_unique<Impl>(*(copySVD.impl)))
+	{
+	}
+	RandomizedSVD::~RandomizedSVD() = default;
+
+	Vectorr RandomizedSVD::singularValues() const
+	{
+		return toVector(impl->mValues);
+	}
+	Matrixx RandomizedSVD::U() const
+	{
+		return kernel::toMatrix(impl->mU);
+	}
+	Matrixx RandomizedSVD::V() const
+	{
+		return kernel::toMatrix(impl->mV);
+	}
+	Matrixx RandomizedSVD::toMatrix() const
+	{
+		Dense scaledU = impl->mU;
+		for (size_t row = 0; row < scaledU.height; row++) {
+			for (size_t col = 0; col < scaledU.width; col++) {
+				scaledU(row, col) *= impl->mValues[col];
+			}
+		}
+		return kernel::toMatrix(kernel::multiply(scaledU, impl->mV, Trans::NoTrans, Trans::Trans));
+	}
+
+	Matrixx RandomizedSVD::rangeFinder(const Matrixx& matrix, const size_t count, const size_t powerIterations, const unsigned int seed)
+	{
+		Impl::checkCount(count, matrix.height(), matrix.width());
+		return kernel::toMatrix(Impl::rangeFinder(fromMatrix(matrix), count, powerIterations, seed));
+	}
+
+	const size_t RandomizedSVD::rank() const
+	{
+		return impl->mValues.size();
+	}
+	const size_t RandomizedSVD::height() const
+	{
+		return impl->mHeight;
+	}
+	const size_t RandomizedSVD::width() const
+	{
+		return impl->mWidth;
+	}
+
+	RandomizedSVD& RandomizedSVD::operator=(const RandomizedSVD& rightSVD)
+	{
+		if (this == &rightSVD) {
+			return *this;
+		}
+
+		*impl = *(rightSVD.impl);
+		return *this;
+	}
+	Vectorr RandomizedSVD::operator*(const Vectorr& rightVector) const
+	{
+		return toVector(impl->multiply(fromColumns(rightVector)).entries);
+	}
+	Matrixx RandomizedSVD::operator*(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+}
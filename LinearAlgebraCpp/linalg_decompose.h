@@ -0,0 +1,213 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <vector>
+
+namespace linalg {
+	// Matrix decomposition classes
+	// Implementations are in linalg_decompose.cpp
+	class Cholesky;
+	class QR;
+	class SymmetricEigen;
+	class SVD;
+	class RandomizedSVD;
+	class SymmetricMatrix; // linalg_symmetric.h
+
+	/*
+	* Cholesky factorization A = L * L^T of symmetric positive-definite matrix.
+	*
+	* Factorization is blocked (right-looking) and trailing updates run in parallel.
+	* Non-SPD input is rejected early : asymmetry is checked before factorization,
+	* and factorization stops at the first non-positive pivot.
+	*
+	* update/downdate refresh the factor in O(n^2) when a data point is added to or removed from A.
+	*/
+	class Cholesky {
+	public:
+		explicit Cholesky(const Matrixx& matrix); // throws std::logic_error : non-square, non-symmetric or not positive-definite
+		explicit Cholesky(const SymmetricMatrix& matrix); // throws std::logic_error : not positive-definite
+		Cholesky(const Cholesky& copyCholesky);
+		virtual ~Cholesky();
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+		double logDeterminant() const;
+		Matrixx inverse() const;
+
+		void update(const Vectorr& vector); // throws std::logic_error, A + v * v^T
+		void downdate(const Vectorr& vector); // throws std::logic_error, A - v * v^T (factor is kept when result is not positive-definite)
+
+		Matrixx lower() const; // L
+		const size_t size() const;
+
+		static bool isPositiveDefinite(const Matrixx& matrix);
+
+		Cholesky& operator=(const Cholesky& rightCholesky);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Householder QR factorization A * P = Q * R of (m x n) matrix.
+	*
+	* Reflectors are accumulated in compact WY form (H1 * ... * Hk = I - V * T * V^T),
+	* so trailing updates and every application of Q run as matrix-matrix products.
+	* Q is never formed : applyQ/applyQTranspose use the stored reflectors.
+	*
+	* With column pivoting, the largest remaining column is moved forward on each step (rank-revealing QR),
+	* P is given by permutation() and rank() counts diagonal entries of R above tolerance.
+	* Without column pivoting, P is identity.
+	*/
+	class QR {
+	public:
+		explicit QR(const Matrixx& matrix, const bool columnPivoting = false);
+		QR(const QR& copyQR);
+		virtual ~QR();
+
+		// Minimize |A * x - b| (basic solution with rank() nonzero entries when pivoting)
+		Vectorr solveLeastSquares(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solveLeastSquares(const Matrixx& rightMatrix) const; // throws std::logic_error
+
+		Vectorr applyQ(const Vectorr& rightVector) const; // throws std::logic_error, Q * v
+		Matrixx applyQ(const Matrixx& rightMatrix) const; // throws std::logic_error, Q * B
+		Vectorr applyQTranspose(const Vectorr& rightVector) const; // throws std::logic_error, Q^T * v
+		Matrixx applyQTranspose(const Matrixx& rightMatrix) const; // throws std::logic_error, Q^T * B
+
+		Matrixx R() const; // min(m, n) x n upper triangular
+		Matrixx Q() const; // m x min(m, n) orthonormal columns (thin Q)
+		std::vector<size_t> permutation() const; // Column j of A * P is column permutation()[j] of A
+		const size_t rank() const;
+
+		const size_t height() const;
+		const size_t width() const;
+
+		QR& operator=(const QR& rightQR);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Eigendecomposition A = X * diag(lambda) * X^T of symmetric matrix.
+	*
+	* A is reduced to tridiagonal form by blocked Householder transformations, whose trailing updates
+	* run as parallel matrix-matrix products. Eigenpairs of the tridiagonal matrix are found by divide and conquer.
+	* When only the largest count eigenpairs are requested, they are found by bisection and inverse iteration,
+	* and only count eigenvectors are transformed back. Without eigenvectors, only eigenvalues are iterated.
+	*
+	* Eigenvalues are in descending order, column i of eigenvectors() belongs to eigenvalues()[i].
+	*/
+	class SymmetricEigen {
+	public:
+		explicit SymmetricEigen(const Matrixx& matrix, const bool computeVectors = true); // throws std::logic_error : non-square or non-symmetric
+		explicit SymmetricEigen(const SymmetricMatrix& matrix, const bool computeVectors = true);
+		SymmetricEigen(const SymmetricEigen& copyEigen);
+		virtual ~SymmetricEigen();
+
+		Vectorr eigenvalues() const;
+		Matrixx eigenvectors() const; // throws std::logic_error : eigenvectors are not computed
+		Vectorr eigenvector(const size_t index) const; // throws std::out_of_range, std::logic_error
+
+		const size_t size() const;
+		const size_t count() const;
+		bool hasVectors() const;
+
+		// Largest count eigenpairs only
+		static SymmetricEigen largest(const Matrixx& matrix, const size_t count, const bool computeVectors = true); // throws std::logic_error
+		static SymmetricEigen largest(const SymmetricMatrix& matrix, const size_t count, const bool computeVectors = true); // throws std::logic_error
+
+		SymmetricEigen& operator=(const SymmetricEigen& rightEigen);
+	private:
+		class Impl;
+
+		SymmetricEigen(std::unique_ptr<Impl> eigenImpl);
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Singular value decomposition A = U * diag(sigma) * V^T of (m x n) matrix.
+	*
+	* A (or A^T when m < n) is reduced to upper bidiagonal form by blocked Householder transformations,
+	* whose trailing updates run as parallel matrix-matrix products. Bidiagonal SVD runs implicit shifted QR,
+	* and its rotations are collected over several steps and applied to singular vectors in parallel column tiles.
+	*
+	* Singular values are in descending order. With Mode::Thin, U is m x min(m, n) and V is n x min(m, n),
+	* with Mode::Full both are square. Mode::ValuesOnly skips singular vectors.
+	* rank() and solve() treat singular values below max(m, n) * epsilon * sigma_max as zero,
+	* a tolerance relative to the matrix scale unlike the fixed epsilonTest of Matrixx::reduce.
+	*/
+	class SVD {
+	public:
+		enum class Mode { ValuesOnly, Thin, Full };
+
+		explicit SVD(const Matrixx& matrix, const Mode mode = Mode::Thin);
+		SVD(const SVD& copySVD);
+		virtual ~SVD();
+
+		Vectorr singularValues() const;
+		Matrixx U() const; // throws std::logic_error : singular vectors are not computed
+		Matrixx V() const; // throws std::logic_error : singular vectors are not computed
+
+		// Minimum norm least squares solution A^+ * b
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+		Matrixx pseudoinverse() const; // throws std::logic_error, n x m
+
+		const size_t rank() const;
+		const size_t rank(const double tolerance) const; // Count of singular values above tolerance
+		double conditionNumber() const; // sigma_max / sigma_min, infinity when singular
+
+		const size_t height() const;
+		const size_t width() const;
+
+		SVD& operator=(const SVD& rightSVD);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Randomized rank-k approximation A ~ U * diag(sigma) * V^T of (m x n) matrix.
+	*
+	* Range of A is sampled by a Gaussian test matrix with (rank + oversampling) columns, refined by power iterations
+	* (orthonormalized after every product), and A is projected onto it for a small SVD. Nearly all work is
+	* blocked matrix-matrix products with A, O(m * n * (rank + oversampling)) per pass.
+	*
+	* Only the factors are kept (U is m x rank, V is n x rank), so operator* costs O((m + n) * rank).
+	* The same seed gives the same approximation.
+	*/
+	class RandomizedSVD {
+	public:
+		explicit RandomizedSVD(const Matrixx& matrix, const size_t rank, const size_t oversampling = 10,
+			const size_t powerIterations = 2, const unsigned int seed = 0); // throws std::logic_error : rank out of [1, min(m, n)]
+		RandomizedSVD(const RandomizedSVD& copySVD);
+		virtual ~RandomizedSVD();
+
+		Vectorr singularValues() const; // Descending, rank entries
+		Matrixx U() const;
+		Matrixx V() const;
+		Matrixx toMatrix() const; // U * diag(sigma) * V^T
+
+		// Orthonormal (m x count) basis approximating the range of A
+		static Matrixx rangeFinder(const Matrixx& matrix, const size_t count, const size_t powerIterations = 2,
+			const unsigned int seed = 0); // throws std::logic_error : count out of [1, min(m, n)]
+
+		const size_t rank() const;
+		const size_t height() const;
+		const size_t width() const;
+
+		RandomizedSVD& operator=(const RandomizedSVD& rightSVD);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
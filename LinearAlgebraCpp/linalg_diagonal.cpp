@@ -0,0 +1,577 @@
+#include "linalg_diagonal.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		void checkValidSize(const size_t size) // throws std::length_error
+		{
+			int exceptNum = ExceptionHandlerr::checkValidHeight(size);
+			if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+				LengthArgument lengthArg(size, size);
+				ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+				handler.addArgument(lengthArg);
+				handler.handleException();
+			}
+		}
+
+		void checkSum(const size_t size, const Dense& dense) // throws std::logic_error
+		{
+			handleOperationException(ExceptionHandlerr::checkHeight(size, dense.height), '+',
+				LengthArgument(size, size), LengthArgument(dense.height, dense.width));
+			handleOperationException(ExceptionHandlerr::checkWidth(size, dense.width), '+',
+				LengthArgument(size, size), LengthArgument(dense.height, dense.width));
+		}
+
+		// rows[i] *= scales[i], or columns when scaleColumns
+		void scaleDense(const double* scales, Dense& dense, const bool scaleColumns)
+		{
+			for (size_t row = 0; row < dense.height; row++) {
+				double* target = dense.row(row);
+				if (scaleColumns) {
+					for (size_t col = 0; col < dense.width; col++) {
+						target[col] *= scales[col];
+					}
+				}
+				else {
+					scale(dense.width, scales[row], target);
+				}
+			}
+		}
+
+		// matrixSign * A + diagonalSign * diag(diagonal), or value * I when diagonal is null
+		Matrixx addDiagonal(const Matrixx& matrix, const double matrixSign, const double diagonalSign,
+			const double* diagonal, const double value, const size_t size)
+		{
+			Dense sum = fromMatrix(matrix);
+			checkSum(size, sum);
+
+			if (matrixSign != 1.0) {
+				scale(sum.entries.size(), matrixSign, sum.data());
+			}
+			for (size_t index = 0; index < size; index++) {
+				sum(index, index) += diagonalSign * ((diagonal != nullptr) ? diagonal[index] : value);
+			}
+			return kernel::toMatrix(sum);
+		}
+	}
+
+
+
+
+
+	class DiagonalMatrix::Impl {
+	public:
+		Impl(const size_t size, const double value); // throws std::length_error
+		Impl(const std::vector<double>& diagonal) : mDiagonal(diagonal) {}
+
+		void checkLength(const char operation, const size_t length, const size_t width) const; // throws std::logic_error
+
+		std::vector<double> mDiagonal;
+	};
+
+	DiagonalMatrix::Impl::Impl(const size_t size, const double value)
+	{
+		checkValidSize(size);
+		mDiagonal.assign(size, value);
+	}
+
+	void DiagonalMatrix::Impl::checkLength(const char operation, const size_t length, const size_t width) const
+	{
+		const size_t size = mDiagonal.size();
+		const int exceptNum = (operation == '*') ? ExceptionHandlerr::checkJoinLength(size, length) : ExceptionHandlerr::checkHeight(size, length);
+		handleOperationException(exceptNum, operation, LengthArgument(size, size), LengthArgument(length, width));
+	}
+
+	class ScaledIdentity::Impl {
+	public:
+		Impl(const size_t size, const double scale); // throws std::length_error
+
+		void checkLength(const char operation, const size_t length, const size_t width) const; // throws std::logic_error
+
+		size_t mSize;
+		double mScale;
+	};
+
+	ScaledIdentity::Impl::Impl(const size_t size, const double scale)
+		: mSize(size), mScale(scale)
+	{
+		checkValidSize(size);
+	}
+
+	void ScaledIdentity::Impl::checkLength(const char operation, const size_t length, const size_t width) const
+	{
+		const int exceptNum = (operation == '*') ? ExceptionHandlerr::checkJoinLength(mSize, length) : ExceptionHandlerr::checkHeight(mSize, length);
+		handleOperationException(exceptNum, operation, LengthArgument(mSize, mSize), LengthArgument(length, width));
+	}
+
+	class PermutationMatrix::Impl {
+	public:
+		Impl(const size_t size); // throws std::length_error
+		Impl(const std::vector<size_t>& permutation); // throws std::length_error, std::logic_error
+
+		std::vector<size_t> inverse() const;
+		void checkLength(const size_t length, const size_t width) const; // throws std::logic_error
+
+		std::vector<size_t> mPermutation; // P(i, mPermutation[i]) = 1
+	};
+
+	PermutationMatrix::Impl::Impl(const size_t size)
+	{
+		checkValidSize(size);
+		mPermutation.resize(size);
+		for (size_t index = 0; index < size; index++) {
+			mPermutation[index] = index;
+		}
+	}
+	PermutationMatrix::Impl::Impl(const std::vector<size_t>& permutation)
+		: mPermutation(permutation)
+	{
+		checkValidSize(permutation.size());
+		std::vector<char> isUsed(permutation.size(), 0);
+		for (const size_t index : permutation) {
+			if (index >= permutation.size() || isUsed[index]) {
+				handleEtcException("Permutation must hold every index in [0, size) once.");
+			}
+			isUsed[index] = 1;
+		}
+	}
+
+	std::vector<size_t> PermutationMatrix::Impl::inverse() const
+	{
+		std::vector<size_t> inversePermutation(mPermutation.size());
+		for (size_t index = 0; index < mPermutation.size(); index++) {
+			inversePermutation[mPermutation[index]] = index;
+		}
+		return inversePermutation;
+	}
+
+	void PermutationMatrix::Impl::checkLength(const size_t length, const size_t width) const
+	{
+		const size_t size = mPermutation.size();
+		handleOperationException(ExceptionHandlerr::checkJoinLength(size, length), '*',
+			LengthArgument(size, size), LengthArgument(length, width));
+	}
+
+
+
+
+
+	DiagonalMatrix::DiagonalMatrix(const size_t size, const double value)
+		: impl(std::make_unique<Impl>(size, value))
+	{
+	}
+	DiagonalMatrix::DiagonalMatrix(const Vectorr& diagonal)
+		: impl(std::make_unique<Impl>(fromVector(diagonal)))
+	{
+	}
+	DiagonalMatrix::DiagonalMatrix(const DiagonalMatrix& copyDiagonal)
+		: impl(std::make_unique<Impl>(*(copyDiagonal.impl)))
+	{
+	}
+	DiagonalMatrix::~DiagonalMatrix() = default;
+
+	const double DiagonalMatrix::operator()(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, impl->mDiagonal.size(), impl->mDiagonal.size());
+		return (row == col) ? impl->mDiagonal[row] : 0.0;
+	}
+	void DiagonalMatrix::set(const size_t index, const double value)
+	{
+		handleIndexException(index, index, impl->mDiagonal.size(), impl->mDiagonal.size());
+		impl->mDiagonal[index] = value;
+	}
+	Vectorr DiagonalMatrix::diagonal() const
+	{
+		return toVector(impl->mDiagonal);
+	}
+
+	DiagonalMatrix DiagonalMatrix::inverse() const
+	{
+		DiagonalMatrix inverseDiagonal(*this);
+		for (double& entry : inverseDiagonal.impl->mDiagonal) {
+			if (entry == 0.0) {
+				handleEtcException("The matrix is not reversible.");
+			}
+			entry = 1.0 / entry;
+		}
+		return inverseDiagonal;
+	}
+	double DiagonalMatrix::determinant() const
+	{
+		double determinant = 1.0;
+		for (const double entry : impl->mDiagonal) {
+			determinant *= entry;
+		}
+		return determinant;
+	}
+	Matrixx DiagonalMatrix::toMatrix() const
+	{
+		const size_t size = impl->mDiagonal.size();
+		Dense dense(size, size);
+		for (size_t index = 0; index < size; index++) {
+			dense(index, index) = impl->mDiagonal[index];
+		}
+		return kernel::toMatrix(dense);
+	}
+	const size_t DiagonalMatrix::size() const
+	{
+		return impl->mDiagonal.size();
+	}
+
+	DiagonalMatrix& DiagonalMatrix::operator=(const DiagonalMatrix& rightDiagonal)
+	{
+		if (this == &rightDiagonal) {
+			return *this;
+		}
+
+		*impl = *(rightDiagonal.impl);
+		return *this;
+	}
+	DiagonalMatrix& DiagonalMatrix::operator+=(const DiagonalMatrix& rightDiagonal)
+	{
+		impl->checkLength('+', rightDiagonal.size(), rightDiagonal.size());
+		axpy(impl->mDiagonal.size(), 1.0, rightDiagonal.impl->mDiagonal.data(), impl->mDiagonal.data());
+		return *this;
+	}
+	DiagonalMatrix& DiagonalMatrix::operator-=(const DiagonalMatrix& rightDiagonal)
+	{
+		impl->checkLength('-', rightDiagonal.size(), rightDiagonal.size());
+		axpy(impl->mDiagonal.size(), -1.0, rightDiagonal.impl->mDiagonal.data(), impl->mDiagonal.data());
+		return *this;
+	}
+	DiagonalMatrix& DiagonalMatrix::operator*=(const DiagonalMatrix& rightDiagonal)
+	{
+		impl->checkLength('*', rightDiagonal.size(), rightDiagonal.size());
+		for (size_t index = 0; index < impl->mDiagonal.size(); index++) {
+			impl->mDiagonal[index] *= rightDiagonal.impl->mDiagonal[index];
+		}
+		return *this;
+	}
+	DiagonalMatrix& DiagonalMatrix::operator*=(const double multiplier)
+	{
+		scale(impl->mDiagonal.size(), multiplier, impl->mDiagonal.data());
+		return *this;
+	}
+	DiagonalMatrix DiagonalMatrix::operator+(const DiagonalMatrix& rightDiagonal) const
+	{
+		DiagonalMatrix sum(*this);
+		sum += rightDiagonal;
+		return sum;
+	}
+	DiagonalMatrix DiagonalMatrix::operator-(const DiagonalMatrix& rightDiagonal) const
+	{
+		DiagonalMatrix difference(*this);
+		difference -= rightDiagonal;
+		return difference;
+	}
+	DiagonalMatrix DiagonalMatrix::operator*(const DiagonalMatrix& rightDiagonal) const
+	{
+		DiagonalMatrix product(*this);
+		product *= rightDiagonal;
+		return product;
+	}
+	DiagonalMatrix DiagonalMatrix::operator*(const double multiplier) const
+	{
+		DiagonalMatrix product(*this);
+		product *= multiplier;
+		return product;
+	}
+	Vectorr DiagonalMatrix::operator*(const Vectorr& rightVector) const
+	{
+		std::vector<double> product = fromVector(rightVector);
+		impl->checkLength('*', product.size(), 1);
+		for (size_t index = 0; index < product.size(); index++) {
+			product[index] *= impl->mDiagonal[index];
+		}
+		return toVector(product);
+	}
+	Matrixx DiagonalMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		Dense product = fromMatrix(rightMatrix);
+		impl->checkLength('*', product.height, product.width);
+		scaleDense(impl->mDiagonal.data(), product, false);
+		return kernel::toMatrix(product);
+	}
+
+	Matrixx operator*(const Matrixx& leftMatrix, const DiagonalMatrix& rightDiagonal)
+	{
+		Dense product = fromMatrix(leftMatrix);
+		const size_t size = rightDiagonal.size();
+		handleOperationException(ExceptionHandlerr::checkJoinLength(product.width, size), '*',
+			LengthArgument(product.height, product.width), LengthArgument(size, size));
+		scaleDense(rightDiagonal.impl->mDiagonal.data(), product, true);
+		return kernel::toMatrix(product);
+	}
+	Matrixx operator+(const Matrixx& leftMatrix, const DiagonalMatrix& rightDiagonal)
+	{
+		return addDiagonal(leftMatrix, 1.0, 1.0, rightDiagonal.impl->mDiagonal.data(), 0.0, rightDiagonal.size());
+	}
+	Matrixx operator+(const DiagonalMatrix& leftDiagonal, const Matrixx& rightMatrix)
+	{
+		return addDiagonal(rightMatrix, 1.0, 1.0, leftDiagonal.impl->mDiagonal.data(), 0.0, leftDiagonal.size());
+	}
+	Matrixx operator-(const Matrixx& leftMatrix, const DiagonalMatrix& rightDiagonal)
+	{
+		return addDiagonal(leftMatrix, 1.0, -1.0, rightDiagonal.impl->mDiagonal.data(), 0.0, rightDiagonal.size());
+	}
+	Matrixx operator-(const DiagonalMatrix& leftDiagonal, const Matrixx& rightMatrix)
+	{
+		return addDiagonal(rightMatrix, -1.0, 1.0, leftDiagonal.impl->mDiagonal.data(), 0.0, leftDiagonal.size());
+	}
+
+
+
+
+
+	ScaledIdentity::ScaledIdentity(const size_t size, const double scale)
+		: impl(std::make_unique<Impl>(size, scale))
+	{
+	}
+	ScaledIdentity::ScaledIdentity(const ScaledIdentity& copyIdentity)
+		: impl(std::make_unique<Impl>(*(copyIdentity.impl)))
+	{
+	}
+	ScaledIdentity::~ScaledIdentity() = default;
+
+	const double ScaledIdentity::operator()(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, impl->mSize, impl->mSize);
+		return (row == col) ? impl->mScale : 0.0;
+	}
+	const double ScaledIdentity::scale() const
+	{
+		return impl->mScale;
+	}
+
+	ScaledIdentity ScaledIdentity::inverse() const
+	{
+		if (impl->mScale == 0.0) {
+			handleEtcException("The matrix is not reversible.");
+		}
+		return ScaledIdentity(impl->mSize, 1.0 / impl->mScale);
+	}
+	double ScaledIdentity::determinant() const
+	{
+		return std::pow(impl->mScale, static_cast<double>(impl->mSize));
+	}
+	DiagonalMatrix ScaledIdentity::toDiagonal() const
+	{
+		return DiagonalMatrix(impl->mSize, impl->mScale);
+	}
+	Matrixx ScaledIdentity::toMatrix() const
+	{
+		return toDiagonal().toMatrix();
+	}
+	const size_t ScaledIdentity::size() const
+	{
+		return impl->mSize;
+	}
+
+	ScaledIdentity& ScaledIdentity::operator=(const ScaledIdentity& rightIdentity)
+	{
+		if (this == &rightIdentity) {
+			return *this;
+		}
+
+		*impl = *(rightIdentity.impl);
+		return *this;
+	}
+	ScaledIdentity ScaledIdentity::operator+(const ScaledIdentity& rightIdentity) const
+	{
+		impl->checkLength('+', rightIdentity.size(), rightIdentity.size());
+		return ScaledIdentity(impl->mSize, impl->mScale + rightIdentity.impl->mScale);
+	}
+	ScaledIdentity ScaledIdentity::operator-(const ScaledIdentity& rightIdentity) const
+	{
+		impl->checkLength('-', rightIdentity.size(), rightIdentity.size());
+		return ScaledIdentity(impl->mSize, impl->mScale - rightIdentity.impl->mScale);
+	}
+	ScaledIdentity ScaledIdentity::operator*(const ScaledIdentity& rightIdentity) const
+	{
+		impl->checkLength('*', rightIdentity.size(), rightIdentity.size());
+		return ScaledIdentity(impl->mSize, impl->mScale * rightIdentity.impl->mScale);
+	}
+	ScaledIdentity ScaledIdentity::operator*(const double multiplier) const
+	{
+		return ScaledIdentity(impl->mSize, impl->mScale * multiplier);
+	}
+	DiagonalMatrix ScaledIdentity::operator*(const DiagonalMatrix& rightDiagonal) const
+	{
+		impl->checkLength('*', rightDiagonal.size(), rightDiagonal.size());
+		return rightDiagonal * impl->mScale;
+	}
+	Vectorr ScaledIdentity::operator*(const Vectorr& rightVector) const
+	{
+		std::vector<double> product = fromVector(rightVector);
+		impl->checkLength('*', product.size(), 1);
+		kernel::scale(product.size(), impl->mScale, product.data());
+		return toVector(product);
+	}
+	Matrixx ScaledIdentity::operator*(const Matrixx& rightMatrix) const
+	{
+		Dense product = fromMatrix(rightMatrix);
+		impl->checkLength('*', product.height, product.width);
+		kernel::scale(product.entries.size(), impl->mScale, product.data());
+		return kernel::toMatrix(product);
+	}
+
+	Matrixx operator*(const Matrixx& leftMatrix, const ScaledIdentity& rightIdentity)
+	{
+		Dense product = fromMatrix(leftMatrix);
+		const size_t size = rightIdentity.size();
+		handleOperationException(ExceptionHandlerr::checkJoinLength(product.width, size), '*',
+			LengthArgument(product.height, product.width), LengthArgument(size, size));
+		kernel::scale(product.entries.size(), rightIdentity.impl->mScale, product.data());
+		return kernel::toMatrix(product);
+	}
+	Matrixx operator+(const Matrixx& leftMatrix, const ScaledIdentity& rightIdentity)
+	{
+		return addDiagonal(leftMatrix, 1.0, 1.0, nullptr, rightIdentity.impl->mScale, rightIdentity.size());
+	}
+	Matrixx operator+(const ScaledIdentity& leftIdentity, const Matrixx& rightMatrix)
+	{
+		return addDiagonal(rightMatrix, 1.0, 1.0, nullptr, leftIdentity.impl->mScale, leftIdentity.size());
+	}
+	Matrixx operator-(const Matrixx& leftMatrix, const ScaledIdentity& rightIdentity)
+	{
+		return addDiagonal(leftMatrix, 1.0, -1.0, nullptr, rightIdentity.impl->mScale, rightIdentity.size());
+	}
+	Matrixx operator-(const ScaledIdentity& leftIdentity, const Matrixx& rightMatrix)
+	{
+		return addDiagonal(rightMatrix, -1.0, 1.0, nullptr, leftIdentity.impl->mScale, leftIdentity.size());
+	}
+
+
+
+
+
+	PermutationMatrix::PermutationMatrix(const size_t size)
+		: impl(std::make_unique<Impl>(size))
+	{
+	}
+	PermutationMatrix::PermutationMatrix(const std::vector<size_t>& permutation)
+		: impl(std::make_unique<Impl>(permutation))
+	{
+	}
+	PermutationMatrix::PermutationMatrix(const PermutationMatrix& copyPermutation)
+		: impl(std::make_unique<Impl>(*(copyPermutation.impl)))
+	{
+	}
+	PermutationMatrix::~PermutationMatrix() = default;
+
+	const double PermutationMatrix::operator()(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, impl->mPermutation.size(), impl->mPermutation.size());
+		return (impl->mPermutation[row] == col) ? 1.0 : 0.0;
+	}
+	std::vector<size_t> PermutationMatrix::permutation() const
+	{
+		return impl->mPermutation;
+	}
+
+	PermutationMatrix PermutationMatrix::inverse() const
+	{
+		return PermutationMatrix(impl->inverse());
+	}
+	PermutationMatrix PermutationMatrix::transpose() const
+	{
+		return PermutationMatrix(impl->inverse());
+	}
+	double PermutationMatrix::determinant() const
+	{
+		// Sign is (-1)^(size - cycle count)
+		const size_t size = impl->mPermutation.size();
+		std::vector<char> isVisited(size, 0);
+		size_t cycleCount = 0;
+		for (size_t index = 0; index < size; index++) {
+			if (isVisited[index]) {
+				continue;
+			}
+			cycleCount++;
+			for (size_t next = index; !isVisited[next]; next = impl->mPermutation[next]) {
+				isVisited[next] = 1;
+			}
+		}
+		return ((size - cycleCount) % 2 == 0) ? 1.0 : -1.0;
+	}
+	Matrixx PermutationMatrix::toMatrix() const
+	{
+		const size_t size = impl->mPermutation.size();
+		Dense dense(size, size);
+		for (size_t row = 0; row < size; row++) {
+			dense(row, impl->mPermutation[row]) = 1.0;
+		}
+		return kernel::toMatrix(dense);
+	}
+	const size_t PermutationMatrix::size() const
+	{
+		return impl->mPermutation.size();
+	}
+
+	PermutationMatrix& PermutationMatrix::operator=(const PermutationMatrix& rightPermutation)
+	{
+		if (this == &rightPermutation) {
+			return *this;
+		}
+
+		*impl = *(rightPermutation.impl);
+		return *this;
+	}
+	PermutationMatrix PermutationMatrix::operator*(const PermutationMatrix& rightPermutation) const
+	{
+		// Row i of P * Q is row permutation[i] of Q
+		impl->checkLength(rightPermutation.size(), rightPermutation.size());
+		std::vector<size_t> product(impl->mPermutation.size());
+		for (size_t index = 0; index < product.size(); index++) {
+			product[index] = rightPermutation.impl->mPermutation[impl->mPermutation[index]];
+		}
+		PermutationMatrix permutation(product.size());
+		permutation.impl->mPermutation = std::move(product);
+		return permutation;
+	}
+	Vectorr PermutationMatrix::operator*(const Vectorr& rightVector) const
+	{
+		const std::vector<double> vector = fromVector(rightVector);
+		impl->checkLength(vector.size(), 1);
+		std::vector<double> product(vector.size());
+		for (size_t index = 0; index < product.size(); index++) {
+			product[index] = vector[impl->mPermutation[index]];
+		}
+		return toVector(product);
+	}
+	Matrixx PermutationMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		const Dense dense = fromMatrix(rightMatrix);
+		impl->checkLength(dense.height, dense.width);
+		Dense product(dense.height, dense.width);
+		for (size_t row = 0; row < dense.height; row++) {
+			const double* source = dense.row(impl->mPermutation[row]);
+			std::copy(source, source + dense.width, product.row(row));
+		}
+		return kernel::toMatrix(product);
+	}
+
+	Matrixx operator*(const Matrixx& leftMatrix, const PermutationMatrix& rightPermutation)
+	{
+		// Column j of A * P is column inverse[j] of A, so column permutation[i] of A goes to column i
+		const Dense dense = fromMatrix(leftMatrix);
+		const size_t size = rightPermutation.size();
+		handleOperationException(ExceptionHandlerr::checkJoinLength(dense.width, size), '*',
+			LengthArgument(dense.height, dense.width), LengthArgument(size, size));
+		const std::vector<size_t>& permutation = rightPermutation.impl->mPermutation;
+		Dense product(dense.height, dense.width);
+		for (size_t row = 0; row < dense.height; row++) {
+			const double* source = dense.row(row);
+			double* target = product.row(row);
+			for (size_t index = 0; index < size; index++) {
+				target[permutation[index]] = source[index];
+			}
+		}
+		return kernel::toMatrix(product);
+	}
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <vector>
+
+namespace linalg {
+	// Diagonal and permutation matrix classes
+	// Implementations are in linalg_diagonal.cpp
+	class DiagonalMatrix;
+	class ScaledIdentity;
+	class PermutationMatrix;
+
+	/*
+	* Square diagonal matrix D = diag(d), only the n diagonal entries are stored.
+	*
+	* D * A scales rows and A * D scales columns of A in O(n^2), products with vectors and other diagonals cost O(n),
+	* and sums with Matrixx copy A once and add the diagonal. Dense entries are made only by toMatrix.
+	*/
+	class DiagonalMatrix {
+	public:
+		explicit DiagonalMatrix(const size_t size = 1, const double value = 0.0); // throws std::length_error, value * I
+		explicit DiagonalMatrix(const Vectorr& diagonal);
+		DiagonalMatrix(const DiagonalMatrix& copyDiagonal);
+		virtual ~DiagonalMatrix();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		void set(const size_t index, const double value); // throws std::out_of_range, entry (index, index)
+		Vectorr diagonal() const;
+
+		DiagonalMatrix inverse() const; // throws std::logic_error : zero diagonal entry
+		double determinant() const;
+		Matrixx toMatrix() const;
+		const size_t size() const;
+
+		DiagonalMatrix& operator=(const DiagonalMatrix& rightDiagonal);
+		DiagonalMatrix& operator+=(const DiagonalMatrix& rightDiagonal); // throws std::logic_error
+		DiagonalMatrix& operator-=(const DiagonalMatrix& rightDiagonal); // throws std::logic_error
+		DiagonalMatrix& operator*=(const DiagonalMatrix& rightDiagonal); // throws std::logic_error
+		DiagonalMatrix& operator*=(const double multiplier);
+		DiagonalMatrix operator+(const DiagonalMatrix& rightDiagonal) const; // throws std::logic_error
+		DiagonalMatrix operator-(const DiagonalMatrix& rightDiagonal) const; // throws std::logic_error
+		DiagonalMatrix operator*(const DiagonalMatrix& rightDiagonal) const; // throws std::logic_error
+		DiagonalMatrix operator*(const double multiplier) const;
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error, scales rows
+
+		friend Matrixx operator*(const Matrixx& leftMatrix, const DiagonalMatrix& rightDiagonal); // throws std::logic_error, scales columns
+		friend Matrixx operator+(const Matrixx& leftMatrix, const DiagonalMatrix& rightDiagonal); // throws std::logic_error
+		friend Matrixx operator+(const DiagonalMatrix& leftDiagonal, const Matrixx& rightMatrix); // throws std::logic_error
+		friend Matrixx operator-(const Matrixx& leftMatrix, const DiagonalMatrix& rightDiagonal); // throws std::logic_error
+		friend Matrixx operator-(const DiagonalMatrix& leftDiagonal, const Matrixx& rightMatrix); // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Scaled identity matrix s * I, only size and scale are stored.
+	*
+	* Products scale every entry and sums add s to the diagonal of a copy, without making the identity matrix.
+	*/
+	class ScaledIdentity {
+	public:
+		explicit ScaledIdentity(const size_t size = 1, const double scale = 1.0); // throws std::length_error
+		ScaledIdentity(const ScaledIdentity& copyIdentity);
+		virtual ~ScaledIdentity();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		const double scale() const;
+
+		ScaledIdentity inverse() const; // throws std::logic_error : zero scale
+		double determinant() const;
+		DiagonalMatrix toDiagonal() const;
+		Matrixx toMatrix() const;
+		const size_t size() const;
+
+		ScaledIdentity& operator=(const ScaledIdentity& rightIdentity);
+		ScaledIdentity operator+(const ScaledIdentity& rightIdentity) const; // throws std::logic_error
+		ScaledIdentity operator-(const ScaledIdentity& rightIdentity) const; // throws std::logic_error
+		ScaledIdentity operator*(const ScaledIdentity& rightIdentity) const; // throws std::logic_error
+		ScaledIdentity operator*(const double multiplier) const;
+		DiagonalMatrix operator*(const DiagonalMatrix& rightDiagonal) const; // throws std::logic_error
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+
+		friend Matrixx operator*(const Matrixx& leftMatrix, const ScaledIdentity& rightIdentity); // throws std::logic_error
+		friend Matrixx operator+(const Matrixx& leftMatrix, const ScaledIdentity& rightIdentity); // throws std::logic_error
+		friend Matrixx operator+(const ScaledIdentity& leftIdentity, const Matrixx& rightMatrix); // throws std::logic_error
+		friend Matrixx operator-(const Matrixx& leftMatrix, const ScaledIdentity& rightIdentity); // throws std::logic_error
+		friend Matrixx operator-(const ScaledIdentity& leftIdentity, const Matrixx& rightMatrix); // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Permutation matrix P with P(i, permutation[i]) = 1, only the index array is stored.
+	*
+	* Row i of P * A is row permutation[i] of A and column j of A * P^T is column permutation[j] of A,
+	* so SparseAnalysis::permutation() gives P of P * A * P^T, and P of A * P in QR is PermutationMatrix(QR::permutation()).transpose().
+	* Products move rows or columns in O(n^2) (O(n) with vectors), composition and inverse cost O(n).
+	*/
+	class PermutationMatrix {
+	public:
+		explicit PermutationMatrix(const size_t size = 1); // throws std::length_error, identity
+		explicit PermutationMatrix(const std::vector<size_t>& permutation); // throws std::length_error, std::logic_error : not a permutation
+		PermutationMatrix(const PermutationMatrix& copyPermutation);
+		virtual ~PermutationMatrix();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		std::vector<size_t> permutation() const;
+
+		PermutationMatrix inverse() const; // P^-1 = P^T
+		PermutationMatrix transpose() const;
+		double determinant() const; // Sign of permutation
+		Matrixx toMatrix() const;
+		const size_t size() const;
+
+		PermutationMatrix& operator=(const PermutationMatrix& rightPermutation);
+		PermutationMatrix operator*(const PermutationMatrix& rightPermutation) const; // throws std::logic_error
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error, permutes rows
+
+		friend Matrixx operator*(const Matrixx& leftMatrix, const PermutationMatrix& rightPermutation); // throws std::logic_error, permutes columns
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -1,5 +1,7 @@
 #include "linalg_exception.h"
 
+#include <limits>
+
 namespace linalg {
 	ExceptionHandlerr::ExceptionHandlerr(const ExceptionState exceptionState, const int exceptionNumber)
 		: mExceptionState(exceptionState), mExceptionNumber(exceptionNumber)
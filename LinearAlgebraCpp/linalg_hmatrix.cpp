@@ -0,0 +1,640 @@
+#include "linalg_hmatrix.h"
+#include "linalg_precondition.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		constexpr size_t rowGrain = 1024; // Minimum rows per parallel chunk of permutation and reduction
+
+		// Cluster of indices order[begin, end), clusters are stored in pre-order so that a subtree occupies nodes [node, nodeEnd)
+		struct Cluster {
+			size_t begin, end, depth, nodeEnd;
+			bool isLeaf;
+			size_t children[2];
+			std::vector<double> lower, upper; // Bounding box of points, empty without points
+		};
+
+		// Leaf block of H-matrix on rows [rowBegin, rowEnd) and columns [colBegin, colEnd) of clustered order
+		struct Block {
+			size_t storage() const { return dense.entries.size() + u.entries.size() + vt.entries.size(); }
+
+			size_t rowBegin, rowEnd, colBegin, colEnd;
+			bool isLowRank;
+			Dense dense; // Entries of inadmissible or incompressible block
+			Dense u, vt; // Block ~ u * vt, u is (rows x rank) and vt is (rank x cols)
+		};
+
+		void checkValidLength(const size_t length) // throws std::length_error
+		{
+			int exceptNum = ExceptionHandlerr::checkValidHeight(length);
+			if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+				LengthArgument lengthArg(length, length);
+				ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+				handler.addArgument(lengthArg);
+				handler.handleException();
+			}
+		}
+
+		size_t splitCluster(std::vector<Cluster>& clusters, std::vector<size_t>& order, const Dense* points,
+			const size_t begin, const size_t end, const size_t depth, const size_t leafSize)
+		{
+			const size_t node = clusters.size();
+			clusters.push_back(Cluster{ begin, end, depth, 0, true, { 0, 0 }, {}, {} });
+
+			size_t axis = 0;
+			if (points != nullptr) {
+				std::vector<double> lower(points->width, HUGE_VAL), upper(points->width, -HUGE_VAL);
+				for (size_t index = begin; index < end; index++) {
+					const double* point = points->row(order[index]);
+					for (size_t dim = 0; dim < points->width; dim++) {
+						lower[dim] = std::min(lower[dim], point[dim]);
+						upper[dim] = std::max(upper[dim], point[dim]);
+					}
+				}
+				for (size_t dim = 1; dim < points->width; dim++) {
+					if (upper[dim] - lower[dim] > upper[axis] - lower[axis]) {
+						axis = dim;
+					}
+				}
+				clusters[node].lower = std::move(lower);
+				clusters[node].upper = std::move(upper);
+			}
+
+			if (end - begin > leafSize) {
+				// Median split along the longest side of bounding box, or halves of index range without points
+				const size_t middle = begin + (end - begin) / 2;
+				if (points != nullptr) {
+					std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+						[points, axis](const size_t left, const size_t right) { return (*points)(left, axis) < (*points)(right, axis); });
+				}
+				const size_t first = splitCluster(clusters, order, points, begin, middle, depth + 1, leafSize);
+				const size_t second = splitCluster(clusters, order, points, middle, end, depth + 1, leafSize);
+				clusters[node].isLeaf = false;
+				clusters[node].children[0] = first;
+				clusters[node].children[1] = second;
+			}
+			clusters[node].nodeEnd = clusters.size();
+			return node;
+		}
+
+		bool isAdmissible(const Cluster& rowCluster, const Cluster& colCluster, const double admissibility)
+		{
+			if (rowCluster.lower.empty()) {
+				return rowCluster.begin != colCluster.begin;
+			}
+
+			double rowDiameter = 0.0, colDiameter = 0.0, distance = 0.0;
+			for (size_t dim = 0; dim < rowCluster.lower.size(); dim++) {
+				const double rowSide = rowCluster.upper[dim] - rowCluster.lower[dim], colSide = colCluster.upper[dim] - colCluster.lower[dim];
+				const double gap = std::max({ 0.0, rowCluster.lower[dim] - colCluster.upper[dim], colCluster.lower[dim] - rowCluster.upper[dim] });
+				rowDiameter += rowSide * rowSide;
+				colDiameter += colSide * colSide;
+				distance += gap * gap;
+			}
+			return distance > 0.0 && std::sqrt(std::min(rowDiameter, colDiameter)) <= admissibility * std::sqrt(distance);
+		}
+
+		void partitionBlocks(const std::vector<Cluster>& clusters, const size_t row, const size_t col,
+			const double admissibility, std::vector<Block>& blocks)
+		{
+			const Cluster& rowCluster = clusters[row];
+			const Cluster& colCluster = clusters[col];
+			const bool admissible = isAdmissible(rowCluster, colCluster, admissibility);
+			if (admissible || rowCluster.isLeaf || colCluster.isLeaf) {
+				blocks.push_back(Block{ rowCluster.begin, rowCluster.end, colCluster.begin, colCluster.end, admissible, {}, {}, {} });
+				return;
+			}
+			for (const size_t rowChild : rowCluster.children) {
+				for (const size_t colChild : colCluster.children) {
+					partitionBlocks(clusters, rowChild, colChild, admissibility, blocks);
+				}
+			}
+		}
+
+		/*
+		* Adaptive cross approximation with partial pivoting of (height x width) block entry(i, j) ~ u * vt.
+		* Each cross costs one residual row and one residual column, and stops when the last cross |u_k| * |v_k| is below
+		* tolerance * |u * vt|_F (norm updated incrementally). Returns false when maxRank crosses do not reach tolerance,
+		* u and vt hold the crosses found in either case.
+		*/
+		template <typename Entry>
+		bool crossApproximation(const Entry& entry, const size_t height, const size_t width, const double tolerance,
+			const size_t maxRank, Dense& u, Dense& vt)
+		{
+			std::vector<std::vector<double>> columns, rows;
+			std::vector<char> isUsed(height, 0);
+			double normSquared = 0.0;
+			bool converged = false;
+			size_t pivotRow = 0;
+			while (columns.size() < maxRank) {
+				isUsed[pivotRow] = 1;
+				std::vector<double> row(width);
+				for (size_t col = 0; col < width; col++) {
+					row[col] = entry(pivotRow, col);
+				}
+				for (size_t cross = 0; cross < columns.size(); cross++) {
+					axpy(width, -columns[cross][pivotRow], rows[cross].data(), row.data());
+				}
+				size_t pivotCol = 0;
+				for (size_t col = 1; col < width; col++) {
+					if (std::abs(row[col]) > std::abs(row[pivotCol])) {
+						pivotCol = col;
+					}
+				}
+
+				// Next pivot row : largest residual of the new column, or the first unused row after a vanishing residual row
+				const auto unused = std::find(isUsed.begin(), isUsed.end(), 0);
+				if (row[pivotCol] == 0.0) {
+					if (!columns.empty() || unused == isUsed.end()) {
+						converged = true;
+						break;
+					}
+					pivotRow = static_cast<size_t>(unused - isUsed.begin());
+					continue;
+				}
+				kernel::scale(width, 1.0 / row[pivotCol], row.data());
+				std::vector<double> column(height);
+				for (size_t index = 0; index < height; index++) {
+					column[index] = entry(index, pivotCol);
+				}
+				for (size_t cross = 0; cross < columns.size(); cross++) {
+					axpy(height, -rows[cross][pivotCol], columns[cross].data(), column.data());
+				}
+
+				// |S_k|^2 = |S_k-1|^2 + 2 * sum_l (u_l . u_k) * (v_l . v_k) + |u_k|^2 * |v_k|^2
+				const double crossNorm = norm2(height, column.data()) * norm2(width, row.data());
+				for (size_t cross = 0; cross < columns.size(); cross++) {
+					normSquared += 2.0 * dot(height, columns[cross].data(), column.data()) * dot(width, rows[cross].data(), row.data());
+				}
+				normSquared += crossNorm * crossNorm;
+				columns.push_back(std::move(column));
+				rows.push_back(std::move(row));
+				if (crossNorm <= tolerance * std::sqrt(std::max(normSquared, 0.0)) || unused == isUsed.end()) {
+					converged = true;
+					break;
+				}
+
+				const std::vector<double>& lastColumn = columns.back();
+				pivotRow = static_cast<size_t>(unused - isUsed.begin());
+				for (size_t index = pivotRow + 1; index < height; index++) {
+					if (!isUsed[index] && std::abs(lastColumn[index]) > std::abs(lastColumn[pivotRow])) {
+						pivotRow = index;
+					}
+				}
+			}
+
+			const size_t rank = columns.size();
+			u = Dense(height, rank);
+			vt = Dense(rank, width);
+			for (size_t cross = 0; cross < rank; cross++) {
+				for (size_t index = 0; index < height; index++) {
+					u(index, cross) = columns[cross][index];
+				}
+				std::copy(rows[cross].begin(), rows[cross].end(), vt.row(cross));
+			}
+			return converged;
+		}
+
+		// y += block * x on clustered order, x and y are (size x width)
+		void addBlockProduct(const Block& block, const Dense& x, Dense& y)
+		{
+			const size_t rows = block.rowEnd - block.rowBegin, cols = block.colEnd - block.colBegin, width = x.width;
+			if (!block.isLowRank) {
+				gemm(Trans::NoTrans, Trans::NoTrans, rows, width, cols, 1.0, block.dense.data(), cols,
+					x.row(block.colBegin), width, 1.0, y.row(block.rowBegin), width);
+				return;
+			}
+			const size_t rank = block.vt.height;
+			if (rank == 0) {
+				return;
+			}
+			Dense projected(rank, width);
+			gemm(Trans::NoTrans, Trans::NoTrans, rank, width, cols, 1.0, block.vt.data(), cols,
+				x.row(block.colBegin), width, 0.0, projected.data(), width);
+			gemm(Trans::NoTrans, Trans::NoTrans, rows, width, rank, 1.0, block.u.data(), rank,
+				projected.data(), width, 1.0, y.row(block.rowBegin), width);
+		}
+
+		// Factors of one cluster of HMatrixPreconditioner
+		struct FactorNode {
+			Dense lu; // Leaf : LU factor of diagonal block
+			std::vector<size_t> pivots;
+			Dense topU, topVt, bottomU, bottomVt; // A(first, second) ~ topU * topVt, A(second, first) ~ bottomU * bottomVt
+			Dense topZ, bottomZ; // A(first, first)^-1 * topU, A(second, second)^-1 * bottomU
+			Dense capacitance; // LU factor of [I, topVt * bottomZ; bottomVt * topZ, I]
+			std::vector<size_t> capacitancePivots;
+			mutable std::vector<double> workspace; // Capacitance right-hand side of single vector solve
+		};
+	}
+
+
+
+
+
+	class HMatrix::Impl {
+	public:
+		Impl(const size_t size, const Dense* points, const Generator& generator,
+			const double tolerance, const size_t leafSize, const double admissibility); // throws std::length_error, std::logic_error
+
+		void multiply(const Dense& rightDense, Dense& product) const; // throws std::logic_error
+		Dense toDense() const;
+
+		Generator mGenerator;
+		std::vector<Cluster> mClusters;
+		std::vector<size_t> mOrder; // Clustered position i holds original index mOrder[i]
+		std::vector<Block> mBlocks;
+	};
+
+	HMatrix::Impl::Impl(const size_t size, const Dense* points, const Generator& generator,
+		const double tolerance, const size_t leafSize, const double admissibility)
+		: mGenerator(generator), mOrder(size)
+	{
+		checkValidLength(size);
+		checkValidLength(leafSize);
+		if (!(tolerance > 0.0)) {
+			handleEtcException("Tolerance of H-matrix must be positive.");
+		}
+		if (!(admissibility > 0.0)) {
+			handleEtcException("Admissibility of H-matrix must be positive.");
+		}
+
+		for (size_t index = 0; index < size; index++) {
+			mOrder[index] = index;
+		}
+		splitCluster(mClusters, mOrder, points, 0, size, 0, leafSize);
+		partitionBlocks(mClusters, 0, 0, admissibility, mBlocks);
+
+		// Blocks are compressed independently, generator is called from every thread
+		parallelFor(0, mBlocks.size(), [&](const size_t blockBegin, const size_t blockEnd) {
+			for (size_t index = blockBegin; index < blockEnd; index++) {
+				Block& block = mBlocks[index];
+				const size_t rows = block.rowEnd - block.rowBegin, cols = block.colEnd - block.colBegin;
+				const auto entry = [&](const size_t row, const size_t col) {
+					return mGenerator(mOrder[block.rowBegin + row], mOrder[block.colBegin + col]);
+				};
+				if (block.isLowRank && !crossApproximation(entry, rows, cols, tolerance, rows * cols / (rows + cols), block.u, block.vt)) {
+					block.isLowRank = false;
+					block.u = Dense();
+					block.vt = Dense();
+				}
+				if (!block.isLowRank) {
+					block.dense = Dense(rows, cols);
+					for (size_t row = 0; row < rows; row++) {
+						for (size_t col = 0; col < cols; col++) {
+							block.dense(row, col) = entry(row, col);
+						}
+					}
+				}
+			}
+		});
+	}
+
+	void HMatrix::Impl::multiply(const Dense& rightDense, Dense& product) const
+	{
+		const size_t length = mOrder.size(), width = rightDense.width;
+		handleOperationException(ExceptionHandlerr::checkJoinLength(length, rightDense.height), '*',
+			LengthArgument(length, length), LengthArgument(rightDense.height, width));
+
+		Dense clustered(length, width);
+		parallelFor(0, length, [&](const size_t rowBegin, const size_t rowEnd) {
+			for (size_t row = rowBegin; row < rowEnd; row++) {
+				std::copy(rightDense.row(mOrder[row]), rightDense.row(mOrder[row]) + width, clustered.row(row));
+			}
+		}, rowGrain);
+
+		// Blocks overlap in rows across levels, so chunks of about equal storage sum into their own buffers
+		const size_t chunkCount = std::min(threadCount(), mBlocks.size());
+		size_t totalStorage = 0;
+		for (const Block& block : mBlocks) {
+			totalStorage += block.storage();
+		}
+		std::vector<size_t> chunkBegins(chunkCount + 1, mBlocks.size());
+		chunkBegins[0] = 0;
+		size_t storage = 0, chunk = 1;
+		for (size_t index = 0; index < mBlocks.size() && chunk < chunkCount; index++) {
+			storage += mBlocks[index].storage();
+			while (chunk < chunkCount && storage * chunkCount >= totalStorage * chunk) {
+				chunkBegins[chunk++] = index + 1;
+			}
+		}
+		std::vector<Dense> partials(chunkCount);
+		parallelFor(0, chunkCount, [&](const size_t first, const size_t last) {
+			for (size_t chunkIndex = first; chunkIndex < last; chunkIndex++) {
+				partials[chunkIndex] = Dense(length, width);
+				for (size_t index = chunkBegins[chunkIndex]; index < chunkBegins[chunkIndex + 1]; index++) {
+					addBlockProduct(mBlocks[index], clustered, partials[chunkIndex]);
+				}
+			}
+		});
+
+		product = Dense(length, width);
+		parallelFor(0, length, [&](const size_t rowBegin, const size_t rowEnd) {
+			for (size_t row = rowBegin; row < rowEnd; row++) {
+				double* target = product.row(mOrder[row]);
+				for (const Dense& partial : partials) {
+					axpy(width, 1.0, partial.row(row), target);
+				}
+			}
+		}, rowGrain);
+	}
+
+	Dense HMatrix::Impl::toDense() const
+	{
+		const size_t length = mOrder.size();
+		Dense dense(length, length);
+		for (const Block& block : mBlocks) {
+			const size_t rows = block.rowEnd - block.rowBegin, cols = block.colEnd - block.colBegin;
+			Dense entries = block.dense;
+			if (block.isLowRank) {
+				entries = Dense(rows, cols);
+				gemm(Trans::NoTrans, Trans::NoTrans, rows, cols, block.u.width, 1.0, block.u.data(), block.u.width,
+					block.vt.data(), cols, 0.0, entries.data(), cols);
+			}
+			for (size_t row = 0; row < rows; row++) {
+				for (size_t col = 0; col < cols; col++) {
+					dense(mOrder[block.rowBegin + row], mOrder[block.colBegin + col]) = entries(row, col);
+				}
+			}
+		}
+		return dense;
+	}
+
+	class HMatrixPreconditioner::Impl {
+	public:
+		Impl(const HMatrix::Generator& generator, const std::vector<Cluster>& clusters, const std::vector<size_t>& order,
+			const double tolerance, const size_t maxRank, const bool isSymmetric); // throws std::logic_error
+
+		bool factorize(const size_t node, const HMatrix::Generator& generator, const double tolerance,
+			const size_t maxRank, const bool isSymmetric);
+		// Solve with the factors of cluster root in place, x holds the (rows x width) rows of root
+		void solveSubtree(const size_t root, double* x, const size_t width) const;
+		void correct(const size_t node, double* x, const size_t width) const;
+
+		std::vector<Cluster> mClusters;
+		std::vector<size_t> mOrder;
+		std::vector<FactorNode> mNodes;
+		size_t mMaxDepth;
+		mutable std::vector<double> mBuffer; // Clustered vector of apply
+	};
+
+	HMatrixPreconditioner::Impl::Impl(const HMatrix::Generator& generator, const std::vector<Cluster>& clusters,
+		const std::vector<size_t>& order, const double tolerance, const size_t maxRank, const bool isSymmetric)
+		: mClusters(clusters), mOrder(order), mNodes(clusters.size()), mMaxDepth(0), mBuffer(order.size())
+	{
+		if (!(tolerance > 0.0)) {
+			handleEtcException("Tolerance of H-matrix preconditioner must be positive.");
+		}
+
+		for (const Cluster& cluster : mClusters) {
+			mMaxDepth = std::max(mMaxDepth, cluster.depth);
+		}
+
+		// Bottom-up : a cluster needs the factors of its children, clusters of one level are independent
+		std::vector<char> isRegular(mClusters.size(), 1);
+		for (size_t depth = mMaxDepth + 1; depth-- > 0;) {
+			parallelFor(0, mClusters.size(), [&](const size_t nodeBegin, const size_t nodeEnd) {
+				for (size_t node = nodeBegin; node < nodeEnd; node++) {
+					if (mClusters[node].depth == depth) {
+						isRegular[node] = factorize(node, generator, tolerance, maxRank, isSymmetric);
+					}
+				}
+			});
+			if (std::find(isRegular.begin(), isRegular.end(), 0) != isRegular.end()) {
+				handleEtcException("Cannot build H-matrix preconditioner with singular diagonal block.");
+			}
+		}
+	}
+
+	bool HMatrixPreconditioner::Impl::factorize(const size_t node, const HMatrix::Generator& generator,
+		const double tolerance, const size_t maxRank, const bool isSymmetric)
+	{
+		const Cluster& cluster = mClusters[node];
+		FactorNode& factor = mNodes[node];
+		if (cluster.isLeaf) {
+			const size_t length = cluster.end - cluster.begin;
+			factor.lu = Dense(length, length);
+			for (size_t row = 0; row < length; row++) {
+				for (size_t col = 0; col < length; col++) {
+					factor.lu(row, col) = generator(mOrder[cluster.begin + row], mOrder[cluster.begin + col]);
+				}
+			}
+			factor.pivots.resize(length);
+			return luFactor(length, factor.lu.data(), length, factor.pivots.data());
+		}
+
+		// Off-diagonal blocks, truncated at maxRank when tolerance is not reached
+		const Cluster& first = mClusters[cluster.children[0]];
+		const Cluster& second = mClusters[cluster.children[1]];
+		const size_t firstSize = first.end - first.begin, secondSize = second.end - second.begin;
+		const size_t rankLimit = std::min({ maxRank, firstSize, secondSize });
+		crossApproximation([&](const size_t row, const size_t col) { return generator(mOrder[first.begin + row], mOrder[second.begin + col]); },
+			firstSize, secondSize, tolerance, rankLimit, factor.topU, factor.topVt);
+		if (isSymmetric) {
+			factor.bottomU = factor.topVt.transpose();
+			factor.bottomVt = factor.topU.transpose();
+		}
+		else {
+			crossApproximation([&](const size_t row, const size_t col) { return generator(mOrder[second.begin + row], mOrder[first.begin + col]); },
+				secondSize, firstSize, tolerance, rankLimit, factor.bottomU, factor.bottomVt);
+		}
+		const size_t topRank = factor.topU.width, bottomRank = factor.bottomU.width, rank = topRank + bottomRank;
+
+		// Woodbury : A^-1 = D^-1 - Z * C^-1 * W * D^-1 with D = blkdiag(A11, A22), Z = D^-1 * blkdiag(topU, bottomU),
+		// W = [0, topVt; bottomVt, 0] and C = I + W * Z
+		factor.topZ = factor.topU;
+		factor.bottomZ = factor.bottomU;
+		if (topRank > 0) {
+			solveSubtree(cluster.children[0], factor.topZ.data(), topRank);
+		}
+		if (bottomRank > 0) {
+			solveSubtree(cluster.children[1], factor.bottomZ.data(), bottomRank);
+		}
+		factor.capacitance = Dense(rank, rank);
+		gemm(Trans::NoTrans, Trans::NoTrans, topRank, bottomRank, secondSize, 1.0, factor.topVt.data(), secondSize,
+			factor.bottomZ.data(), bottomRank, 0.0, factor.capacitance.data() + topRank, rank);
+		gemm(Trans::NoTrans, Trans::NoTrans, bottomRank, topRank, firstSize, 1.0, factor.bottomVt.data(), firstSize,
+			factor.topZ.data(), topRank, 0.0, factor.capacitance.row(topRank), rank);
+		for (size_t index = 0; index < rank; index++) {
+			factor.capacitance(index, index) = 1.0;
+		}
+		factor.capacitancePivots.resize(rank);
+		factor.workspace.resize(rank);
+		return rank == 0 || luFactor(rank, factor.capacitance.data(), rank, factor.capacitancePivots.data());
+	}
+
+	void HMatrixPreconditioner::Impl::solveSubtree(const size_t root, double* x, const size_t width) const
+	{
+		const size_t offset = mClusters[root].begin, nodeEnd = mClusters[root].nodeEnd;
+
+		// Leaf solves x = D^-1 * x, then corrections from the deepest level up, clusters of each level in parallel
+		parallelFor(root, nodeEnd, [&](const size_t nodeBegin, const size_t nodeLast) {
+			for (size_t node = nodeBegin; node < nodeLast; node++) {
+				const Cluster& cluster = mClusters[node];
+				if (cluster.isLeaf) {
+					const size_t length = cluster.end - cluster.begin;
+					luSolve(Trans::NoTrans, length, mNodes[node].lu.data(), length, mNodes[node].pivots.data(),
+						width, x + (cluster.begin - offset) * width, width);
+				}
+			}
+		});
+		for (size_t depth = mMaxDepth; depth-- > mClusters[root].depth;) {
+			parallelFor(root, nodeEnd, [&](const size_t nodeBegin, const size_t nodeLast) {
+				for (size_t node = nodeBegin; node < nodeLast; node++) {
+					const Cluster& cluster = mClusters[node];
+					if (!cluster.isLeaf && cluster.depth == depth) {
+						correct(node, x + (cluster.begin - offset) * width, width);
+					}
+				}
+			});
+		}
+	}
+
+	void HMatrixPreconditioner::Impl::correct(const size_t node, double* x, const size_t width) const
+	{
+		const FactorNode& factor = mNodes[node];
+		const Cluster& first = mClusters[mClusters[node].children[0]];
+		const size_t firstSize = first.end - first.begin, secondSize = mClusters[node].end - first.end;
+		const size_t topRank = factor.topU.width, bottomRank = factor.bottomU.width, rank = topRank + bottomRank;
+		if (rank == 0) {
+			return;
+		}
+
+		// x -= Z * C^-1 * W * x, where x already holds D^-1 * b
+		std::vector<double> buffer;
+		double* projected = factor.workspace.data();
+		if (width > 1) {
+			buffer.resize(rank * width);
+			projected = buffer.data();
+		}
+		double* firstX = x;
+		double* secondX = x + firstSize * width;
+		gemm(Trans::NoTrans, Trans::NoTrans, topRank, width, secondSize, 1.0, factor.topVt.data(), secondSize,
+			secondX, width, 0.0, projected, width);
+		gemm(Trans::NoTrans, Trans::NoTrans, bottomRank, width, firstSize, 1.0, factor.bottomVt.data(), firstSize,
+			firstX, width, 0.0, projected + topRank * width, width);
+		luSolve(Trans::NoTrans, rank, factor.capacitance.data(), rank, factor.capacitancePivots.data(), width, projected, width);
+		gemm(Trans::NoTrans, Trans::NoTrans, firstSize, width, topRank, -1.0, factor.topZ.data(), topRank,
+			projected, width, 1.0, firstX, width);
+		gemm(Trans::NoTrans, Trans::NoTrans, secondSize, width, bottomRank, -1.0, factor.bottomZ.data(), bottomRank,
+			projected + topRank * width, width, 1.0, secondX, width);
+	}
+
+
+
+
+
+	HMatrix::HMatrix(const size_t size, const Generator& generator, const double tolerance, const size_t leafSize)
+		: impl(std::make_unique<Impl>(size, nullptr, generator, tolerance, leafSize, 1.0))
+	{
+	}
+	HMatrix::HMatrix(const Matrixx& points, const Generator& generator, const double tolerance,
+		const size_t leafSize, const double admissibility)
+	{
+		const Dense coordinates = fromMatrix(points);
+		impl = std::make_unique<Impl>(coordinates.height, &coordinates, generator, tolerance, leafSize, admissibility);
+	}
+	HMatrix::HMatrix(const HMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	HMatrix::~HMatrix() = default;
+
+	Matrixx HMatrix::toMatrix() const
+	{
+		return kernel::toMatrix(impl->toDense());
+	}
+	const size_t HMatrix::storage() const
+	{
+		size_t storage = 0;
+		for (const Block& block : impl->mBlocks) {
+			storage += block.storage();
+		}
+		return storage;
+	}
+	const size_t HMatrix::maxRank() const
+	{
+		size_t rank = 0;
+		for (const Block& block : impl->mBlocks) {
+			rank = std::max(rank, block.u.width);
+		}
+		return rank;
+	}
+	const size_t HMatrix::size() const
+	{
+		return impl->mOrder.size();
+	}
+
+	HMatrix& HMatrix::operator=(const HMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	Vectorr HMatrix::operator*(const Vectorr& rightVector) const
+	{
+		Dense product;
+		impl->multiply(fromColumns(rightVector), product);
+		return toVector(product.entries);
+	}
+	Matrixx HMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		Dense product;
+		impl->multiply(fromMatrix(rightMatrix), product);
+		return kernel::toMatrix(product);
+	}
+
+
+
+
+
+	HMatrixPreconditioner::HMatrixPreconditioner(const HMatrix& matrix, const double tolerance, const size_t maxRank,
+		const bool isSymmetric)
+		: impl(std::make_unique<Impl>(matrix.impl->mGenerator, matrix.impl->mClusters, matrix.impl->mOrder,
+			tolerance, maxRank, isSymmetric))
+	{
+	}
+	HMatrixPreconditioner::HMatrixPreconditioner(const HMatrixPreconditioner& copyPreconditioner)
+		: impl(std::make_unique<Impl>(*(copyPreconditioner.impl)))
+	{
+	}
+	HMatrixPreconditioner::~HMatrixPreconditioner() = default;
+
+	void HMatrixPreconditioner::apply(const std::vector<double>& vector, std::vector<double>& result) const
+	{
+		const size_t length = size();
+		handleOperationException(ExceptionHandlerr::checkHeight(length, vector.size()), '\\',
+			LengthArgument(length, length), LengthArgument(vector.size(), 1));
+		result.resize(length);
+
+		double* clustered = impl->mBuffer.data();
+		for (size_t index = 0; index < length; index++) {
+			clustered[index] = vector[impl->mOrder[index]];
+		}
+		impl->solveSubtree(0, clustered, 1);
+		for (size_t index = 0; index < length; index++) {
+			result[impl->mOrder[index]] = clustered[index];
+		}
+	}
+	const size_t HMatrixPreconditioner::size() const
+	{
+		return impl->mOrder.size();
+	}
+
+	HMatrixPreconditioner& HMatrixPreconditioner::operator=(const HMatrixPreconditioner& rightPreconditioner)
+	{
+		if (this == &rightPreconditioner) {
+			return *this;
+		}
+
+		*impl = *(rightPreconditioner.impl);
+		return *this;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <functional>
+
+namespace linalg {
+	// Hierarchical matrix class
+	// Implementations are in linalg_hmatrix.cpp
+	class HMatrix;
+	class HMatrixPreconditioner; // linalg_precondition.h
+
+	/*
+	* Hierarchical matrix (H-matrix) approximation of dense (size x size) kernel matrix A(i, j) = generator(i, j).
+	*
+	* Indices are clustered by recursive bisection : with points (row i holds coordinates of index i), clusters are split
+	* at the median of their longest bounding box side and a block is admissible when
+	* min(diameter(rows), diameter(cols)) <= admissibility * distance(rows, cols) (strong admissibility).
+	* Without points, index ranges are halved and every off-diagonal block is admissible (weak admissibility, HODLR).
+	* Admissible blocks are compressed to U * V^T by adaptive cross approximation (ACA) with partial pivoting,
+	* which evaluates only O(rank * (m + n)) entries of the block, the others are stored dense down to leafSize.
+	* A block whose approximation does not reach tolerance before rank m * n / (m + n) is stored dense as well.
+	*
+	* The dense matrix is never formed : memory and matrix-vector products cost O(rank * n * log(n)).
+	* generator is kept for HMatrixPreconditioner and is called from several threads at once,
+	* an exception it throws is rethrown by the constructor of HMatrix or HMatrixPreconditioner once every thread has stopped.
+	* HMatrixOperator and HMatrixPreconditioner (linalg_iterative.h, linalg_precondition.h) hand it to KrylovSolver.
+	*/
+	class HMatrix {
+		friend class HMatrixPreconditioner;
+	public:
+		using Generator = std::function<double(const size_t row, const size_t col)>;
+
+		HMatrix(const size_t size, const Generator& generator, const double tolerance = 1e-8,
+			const size_t leafSize = 64); // throws std::length_error, std::logic_error : non-positive tolerance, exception of generator
+		HMatrix(const Matrixx& points, const Generator& generator, const double tolerance = 1e-8,
+			const size_t leafSize = 64, const double admissibility = 2.0); // throws std::length_error, std::logic_error : non-positive tolerance or admissibility, exception of generator
+		HMatrix(const HMatrix& copyMatrix);
+		virtual ~HMatrix();
+
+		Matrixx toMatrix() const;
+		const size_t storage() const; // Number of stored entries
+		const size_t maxRank() const; // Largest rank of compressed blocks
+		const size_t size() const;
+
+		HMatrix& operator=(const HMatrix& rightMatrix);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -1,5 +1,7 @@
 #include "linalg_impl.h"
 
+#include <limits>
+
 namespace linalg {
 
 	Tensorr::Impl::Impl(const int size)
@@ -213,11 +215,16 @@ namespace linalg {
 		Impl appendedMatrixImpl = *this & identityMatrixImpl;
 		appendedMatrixImpl.reduce();
 
-		if (appendedMatrixImpl.block(0, 0, length, length) != identityMatrixImpl) {
-			EtcArgument etcArg("The matrix is not reversible.");
-			ExceptionHandlerr handler(ExceptionState::EtcException, static_cast<int>(EtcState::Exception));
-			handler.addArgument(etcArg);
-			handler.handleException();
+		// Reduced left half must be the identity
+		for (size_t row = 0; row < length; row++) {
+			for (size_t col = 0; col < length; col++) {
+				if (appendedMatrixImpl.mRows[row][col] != ((row == col) ? 1.0 : 0.0)) {
+					EtcArgument etcArg("The matrix is not reversible.");
+					ExceptionHandlerr handler(ExceptionState::EtcException, static_cast<int>(EtcState::Exception));
+					handler.addArgument(etcArg);
+					handler.handleException();
+				}
+			}
 		}
 
 		return appendedMatrixImpl.block(0, length, length, length);
@@ -8,11 +8,6 @@
 
 namespace linalg {
 	// Function implemented classes
-	class Tensorr::Impl;
-	class Matrixx::Impl;
-	class Roww::Impl;
-	class Vectorr::Impl;
-
 	class Tensorr::Impl {
 	public:
 		virtual ~Impl() = default;
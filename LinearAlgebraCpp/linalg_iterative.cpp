@@ -0,0 +1,1524 @@
+#include "linalg_iterative.h"
+#include "linalg_precondition.h"
+#include "linalg_sparse.h"
+#include "linalg_hmatrix.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		// y = A * x on raw buffers, result length is checked against operator height
+		std::vector<double> applyOperator(const LinearOperator& linearOperator, const double* x)
+		{
+			const Vectorr product = linearOperator.apply(toVector(x, linearOperator.width()));
+			if (product.size() != linearOperator.height()) {
+				handleEtcException("Operator result length does not match operator height.");
+			}
+			return fromVector(product);
+		}
+
+		/*
+		* Krylov decomposition A * V^T = V^T * H + v_m * h^T shared by restarted eigensolvers :
+		* rows of basis V are orthonormal, H is (m + 1) x m and its row m couples the next basis vector v_m.
+		* Right after a restart H is full on the kept block, and expand appends Arnoldi columns.
+		*/
+		class KrylovDecomposition {
+		public:
+			KrylovDecomposition(const LinearOperator& linearOperator, const size_t subspaceSize, const unsigned int seed);
+
+			void expand(const size_t begin); // Arnoldi steps from begin basis vectors up to subspaceSize
+			// Keep rows Z^T * V (Z is m x keep, orthonormal columns) with projected matrix Z^T * H * Z, v_m moves to row keep
+			void restart(const Dense& directions, const Dense& projected);
+			Dense combine(const Dense& coefficients) const; // V^T * Y, (size x count)
+			Dense projectedSquare() const; // H without coupling row, (m x m)
+			double coupling() const; // Last entry of coupling row
+
+			size_t mSize, mSubspaceSize, mOperatorCount;
+		private:
+			void orthogonalize(const size_t count, double* vector, double* coefficients) const; // Classical Gram-Schmidt twice
+			void setRandomVector(const size_t row);
+
+			const LinearOperator& mOperator;
+			Dense mBasis, mProjected;
+			std::mt19937_64 mGenerator;
+		};
+
+		KrylovDecomposition::KrylovDecomposition(const LinearOperator& linearOperator, const size_t subspaceSize, const unsigned int seed)
+			: mSize(linearOperator.width()), mSubspaceSize(subspaceSize), mOperatorCount(0), mOperator(linearOperator),
+			mBasis(subspaceSize + 1, linearOperator.width()), mProjected(subspaceSize + 1, subspaceSize), mGenerator(seed)
+		{
+			setRandomVector(0);
+		}
+
+		void KrylovDecomposition::orthogonalize(const size_t count, double* vector, double* coefficients) const
+		{
+			std::vector<double> correction(count);
+			std::fill(coefficients, coefficients + count, 0.0);
+			for (size_t pass = 0; pass < 2; pass++) {
+				gemv(Trans::NoTrans, count, mSize, 1.0, mBasis.data(), mSize, vector, 0.0, correction.data());
+				gemv(Trans::Trans, count, mSize, -1.0, mBasis.data(), mSize, correction.data(), 1.0, vector);
+				axpy(count, 1.0, correction.data(), coefficients);
+			}
+		}
+
+		void KrylovDecomposition::setRandomVector(const size_t row)
+		{
+			// Random direction orthogonal to previous rows, zero when the whole space is spanned
+			std::normal_distribution<double> distribution;
+			double* vector = mBasis.row(row);
+			for (size_t index = 0; index < mSize; index++) {
+				vector[index] = distribution(mGenerator);
+			}
+			std::vector<double> coefficients(row);
+			orthogonalize(row, vector, coefficients.data());
+			const double vectorNorm = norm2(mSize, vector);
+			const double tolerance = std::sqrt(static_cast<double>(mSize)) * std::numeric_limits<double>::epsilon();
+			scale(mSize, (vectorNorm > tolerance) ? 1.0 / vectorNorm : 0.0, vector);
+		}
+
+		void KrylovDecomposition::expand(const size_t begin)
+		{
+			const double epsilon = std::numeric_limits<double>::epsilon();
+			std::vector<double> coefficients(mSubspaceSize);
+			for (size_t step = begin; step < mSubspaceSize; step++) {
+				std::vector<double> product = applyOperator(mOperator, mBasis.row(step));
+				mOperatorCount++;
+				const double productNorm = norm2(mSize, product.data());
+				orthogonalize(step + 1, product.data(), coefficients.data());
+				for (size_t row = 0; row <= step; row++) {
+					mProjected(row, step) = coefficients[row];
+				}
+
+				const double residualNorm = norm2(mSize, product.data());
+				double* next = mBasis.row(step + 1);
+				if (residualNorm > static_cast<double>(mSize) * epsilon * productNorm) {
+					mProjected(step + 1, step) = residualNorm;
+					for (size_t index = 0; index < mSize; index++) {
+						next[index] = product[index] / residualNorm;
+					}
+				}
+				else {
+					// Invariant subspace found, continue with a new direction
+					mProjected(step + 1, step) = 0.0;
+					if (step + 1 < mSubspaceSize) {
+						setRandomVector(step + 1);
+					}
+					else {
+						std::fill(next, next + mSize, 0.0);
+					}
+				}
+			}
+		}
+
+		void KrylovDecomposition::restart(const Dense& directions, const Dense& projected)
+		{
+			const size_t keep = directions.width;
+			Dense kept(keep, mSize);
+			gemm(Trans::Trans, Trans::NoTrans, keep, mSize, mSubspaceSize, 1.0, directions.data(), keep,
+				mBasis.data(), mSize, 0.0, kept.data(), mSize);
+			std::copy(mBasis.row(mSubspaceSize), mBasis.row(mSubspaceSize) + mSize, mBasis.row(keep));
+			std::copy(kept.entries.begin(), kept.entries.end(), mBasis.row(0));
+
+			const double lastCoupling = coupling();
+			std::fill(mProjected.entries.begin(), mProjected.entries.end(), 0.0);
+			for (size_t row = 0; row < keep; row++) {
+				std::copy(projected.row(row), projected.row(row) + keep, mProjected.row(row));
+			}
+			for (size_t col = 0; col < keep; col++) {
+				mProjected(keep, col) = lastCoupling * directions(mSubspaceSize - 1, col);
+			}
+		}
+
+		Dense KrylovDecomposition::combine(const Dense& coefficients) const
+		{
+			Dense vectors(mSize, coefficients.width);
+			gemm(Trans::Trans, Trans::NoTrans, mSize, coefficients.width, mSubspaceSize, 1.0, mBasis.data(), mSize,
+				coefficients.data(), coefficients.width, 0.0, vectors.data(), vectors.width);
+			return vectors;
+		}
+
+		Dense KrylovDecomposition::projectedSquare() const
+		{
+			Dense square(mSubspaceSize, mSubspaceSize);
+			std::copy(mProjected.data(), mProjected.data() + mSubspaceSize * mSubspaceSize, square.data());
+			return square;
+		}
+
+		double KrylovDecomposition::coupling() const
+		{
+			return mProjected(mSubspaceSize, mSubspaceSize - 1);
+		}
+
+		// Check square operator and count range, returns subspace size
+		size_t checkEigenArguments(const LinearOperator& linearOperator, const size_t count, const size_t subspaceSize)
+		{
+			if (linearOperator.height() != linearOperator.width()) {
+				handleEtcException("Cannot get eigendecomposition of non-square operator.");
+			}
+			const size_t size = linearOperator.width();
+			if (count == 0 || count > size) {
+				handleEtcException("Eigenpair count must be in range [1, size].");
+			}
+			const size_t requested = (subspaceSize == 0) ? std::max<size_t>(2 * count + 1, 20) : subspaceSize;
+			return std::min(size, std::max(requested, count + 2));
+		}
+
+		bool isConverged(const double residual, const double value, const double tolerance)
+		{
+			const double floor = std::pow(std::numeric_limits<double>::epsilon(), 2.0 / 3.0);
+			return residual <= tolerance * std::max(std::abs(value), floor);
+		}
+	}
+
+
+
+
+
+	Matrixx LinearOperator::applyBlock(const Matrixx& matrix) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(width(), matrix.height()), '*',
+			LengthArgument(height(), width()), LengthArgument(matrix.height(), matrix.width()));
+
+		const Dense columns = fromMatrix(matrix).transpose();
+		Dense products(matrix.width(), height());
+		for (size_t col = 0; col < columns.height; col++) {
+			const std::vector<double> product = applyOperator(*this, columns.row(col));
+			std::copy(product.begin(), product.end(), products.row(col));
+		}
+		return toMatrix(products.transpose());
+	}
+
+
+
+
+
+	class DenseOperator::Impl {
+	public:
+		Impl(const Matrixx& matrix) : mMatrix(fromMatrix(matrix)) {}
+
+		void checkLength(const size_t height, const size_t width) const; // throws std::logic_error
+
+		Dense mMatrix;
+	};
+
+	void DenseOperator::Impl::checkLength(const size_t height, const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mMatrix.width, height), '*',
+			LengthArgument(mMatrix.height, mMatrix.width), LengthArgument(height, width));
+	}
+
+
+
+
+
+	DenseOperator::DenseOperator(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(matrix))
+	{
+	}
+	DenseOperator::DenseOperator(const DenseOperator& copyOperator)
+		: impl(std::make_unique<Impl>(*(copyOperator.impl)))
+	{
+	}
+	DenseOperator::~DenseOperator() = default;
+
+	Vectorr DenseOperator::apply(const Vectorr& vector) const
+	{
+		impl->checkLength(vector.size(), 1);
+		const std::vector<double> entries = fromVector(vector);
+		std::vector<double> product(impl->mMatrix.height);
+		gemv(Trans::NoTrans, impl->mMatrix.height, impl->mMatrix.width, 1.0, impl->mMatrix.data(), impl->mMatrix.width,
+			entries.data(), 0.0, product.data());
+		return toVector(product);
+	}
+	Matrixx DenseOperator::applyBlock(const Matrixx& matrix) const
+	{
+		impl->checkLength(matrix.height(), matrix.width());
+		return toMatrix(multiply(impl->mMatrix, fromMatrix(matrix)));
+	}
+
+	const size_t DenseOperator::height() const
+	{
+		return impl->mMatrix.height;
+	}
+	const size_t DenseOperator::width() const
+	{
+		return impl->mMatrix.width;
+	}
+
+	DenseOperator& DenseOperator::operator=(const DenseOperator& rightOperator)
+	{
+		if (this == &rightOperator) {
+			return *this;
+		}
+
+		*impl = *(rightOperator.impl);
+		return *this;
+	}
+
+
+
+
+
+	class SparseOperator::Impl {
+	public:
+		Impl(const SparseMatrix& matrix) : mMatrix(fromSparse(matrix)) {}
+
+		void checkLength(const size_t height, const size_t width) const; // throws std::logic_error
+
+		Compressed mMatrix;
+	};
+
+	void SparseOperator::Impl::checkLength(const size_t height, const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mMatrix.width, height), '*',
+			LengthArgument(mMatrix.height, mMatrix.width), LengthArgument(height, width));
+	}
+
+
+
+
+
+	SparseOperator::SparseOperator(const SparseMatrix& matrix)
+		: impl(std::make_unique<Impl>(matrix))
+	{
+	}
+	SparseOperator::SparseOperator(const SparseOperator& copyOperator)
+		: impl(std::make_unique<Impl>(*(copyOperator.impl)))
+	{
+	}
+	SparseOperator::~SparseOperator() = default;
+
+	Vectorr SparseOperator::apply(const Vectorr& vector) const
+	{
+		impl->checkLength(vector.size(), 1);
+		const std::vector<double> entries = fromVector(vector);
+		std::vector<double> product(impl->mMatrix.height);
+		spmv(1.0, impl->mMatrix, entries.data(), 0.0, product.data());
+		return toVector(product);
+	}
+	Matrixx SparseOperator::applyBlock(const Matrixx& matrix) const
+	{
+		impl->checkLength(matrix.height(), matrix.width());
+		const Dense right = fromMatrix(matrix);
+		Dense product(impl->mMatrix.height, right.width);
+		spmm(right.width, 1.0, impl->mMatrix, right.data(), right.width, 0.0, product.data(), product.width);
+		return toMatrix(product);
+	}
+
+	const size_t SparseOperator::height() const
+	{
+		return impl->mMatrix.height;
+	}
+	const size_t SparseOperator::width() const
+	{
+		return impl->mMatrix.width;
+	}
+
+	SparseOperator& SparseOperator::operator=(const SparseOperator& rightOperator)
+	{
+		if (this == &rightOperator) {
+			return *this;
+		}
+
+		*impl = *(rightOperator.impl);
+		return *this;
+	}
+
+
+
+
+
+	class HMatrixOperator::Impl {
+	public:
+		Impl(const HMatrix& matrix) : mMatrix(matrix) {}
+
+		HMatrix mMatrix;
+	};
+
+
+
+
+
+	HMatrixOperator::HMatrixOperator(const HMatrix& matrix)
+		: impl(std::make_unique<Impl>(matrix))
+	{
+	}
+	HMatrixOperator::HMatrixOperator(const HMatrixOperator& copyOperator)
+		: impl(std::make_unique<Impl>(*(copyOperator.impl)))
+	{
+	}
+	HMatrixOperator::~HMatrixOperator() = default;
+
+	Vectorr HMatrixOperator::apply(const Vectorr& vector) const
+	{
+		return impl->mMatrix * vector;
+	}
+	Matrixx HMatrixOperator::applyBlock(const Matrixx& matrix) const
+	{
+		return impl->mMatrix * matrix;
+	}
+
+	const size_t HMatrixOperator::height() const
+	{
+		return impl->mMatrix.size();
+	}
+	const size_t HMatrixOperator::width() const
+	{
+		return impl->mMatrix.size();
+	}
+
+	HMatrixOperator& HMatrixOperator::operator=(const HMatrixOperator& rightOperator)
+	{
+		if (this == &rightOperator) {
+			return *this;
+		}
+
+		*impl = *(rightOperator.impl);
+		return *this;
+	}
+
+
+
+
+
+	class FunctionOperator::Impl {
+	public:
+		Impl(const size_t height, const size_t width, const std::function<Vectorr(const Vectorr&)>& function); // throws std::length_error
+
+		size_t mHeight, mWidth;
+		std::function<Vectorr(const Vectorr&)> mFunction;
+	};
+
+	FunctionOperator::Impl::Impl(const size_t height, const size_t width, const std::function<Vectorr(const Vectorr&)>& function)
+		: mHeight(height), mWidth(width), mFunction(function)
+	{
+		int exceptNum = std::max(ExceptionHandlerr::checkValidHeight(height), ExceptionHandlerr::checkValidWidth(width));
+		if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+			LengthArgument lengthArg(height, width);
+			ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+			handler.addArgument(lengthArg);
+			handler.handleException();
+		}
+	}
+
+
+
+
+
+	FunctionOperator::FunctionOperator(const size_t height, const size_t width, const std::function<Vectorr(const Vectorr&)>& function)
+		: impl(std::make_unique<Impl>(height, width, function))
+	{
+	}
+	FunctionOperator::FunctionOperator(const size_t size, const std::function<Vectorr(const Vectorr&)>& function)
+		: impl(std::make_unique<Impl>(size, size, function))
+	{
+	}
+	FunctionOperator::FunctionOperator(const FunctionOperator& copyOperator)
+		: impl(std::make_unique<Impl>(*(copyOperator.impl)))
+	{
+	}
+	FunctionOperator::~FunctionOperator() = default;
+
+	Vectorr FunctionOperator::apply(const Vectorr& vector) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(impl->mWidth, vector.size()), '*',
+			LengthArgument(impl->mHeight, impl->mWidth), LengthArgument(vector.size(), 1));
+		Vectorr product = impl->mFunction(vector);
+		if (product.size() != impl->mHeight) {
+			handleEtcException("Operator result length does not match operator height.");
+		}
+		return product;
+	}
+
+	const size_t FunctionOperator::height() const
+	{
+		return impl->mHeight;
+	}
+	const size_t FunctionOperator::width() const
+	{
+		return impl->mWidth;
+	}
+
+	FunctionOperator& FunctionOperator::operator=(const FunctionOperator& rightOperator)
+	{
+		if (this == &rightOperator) {
+			return *this;
+		}
+
+		*impl = *(rightOperator.impl);
+		return *this;
+	}
+
+
+
+
+
+	class LanczosEigen::Impl {
+	public:
+		Impl(const LinearOperator& symmetricOperator, const size_t count, const Which which,
+			const size_t subspaceSize, const double tolerance, const size_t maxRestarts, const unsigned int seed); // throws std::logic_error
+
+		std::vector<double> mValues;
+		Dense mVectors; // size x count
+		bool mConverged;
+		size_t mRestartCount, mOperatorCount;
+	};
+
+	LanczosEigen::Impl::Impl(const LinearOperator& symmetricOperator, const size_t count, const Which which,
+		const size_t subspaceSize, const double tolerance, const size_t maxRestarts, const unsigned int seed)
+		: mConverged(false), mRestartCount(0), mOperatorCount(0)
+	{
+		const size_t length = checkEigenArguments(symmetricOperator, count, subspaceSize);
+		KrylovDecomposition krylov(symmetricOperator, length, seed);
+
+		size_t kept = 0;
+		std::vector<double> values(length), e(length), tau(length);
+		std::vector<size_t> order(length);
+		Dense ritzVectors;
+		while (true) {
+			krylov.expand(kept);
+
+			// Ritz pairs of symmetric part of H (ascending)
+			Dense projected = krylov.projectedSquare();
+			for (size_t row = 0; row < length; row++) {
+				for (size_t col = 0; col < row; col++) {
+					projected(row, col) = 0.5 * (projected(row, col) + projected(col, row));
+				}
+			}
+			tridiagonalize(length, projected.data(), length, values.data(), e.data(), tau.data());
+			ritzVectors = Dense(length, length);
+			for (size_t index = 0; index < length; index++) {
+				ritzVectors(index, index) = 1.0;
+			}
+			tridiagonalQL(length, values.data(), e.data(), ritzVectors.data(), length);
+			applyTridiagonalQ(length, projected.data(), length, tau.data(), length, ritzVectors.data(), length);
+
+			for (size_t index = 0; index < length; index++) {
+				order[index] = index;
+			}
+			auto wanted = [&values, which](const size_t left, const size_t right) {
+				switch (which) {
+				case Which::Largest:
+					return values[left] > values[right];
+				case Which::Smallest:
+					return values[left] < values[right];
+				default:
+					return std::abs(values[left]) > std::abs(values[right]);
+				}
+			};
+			std::stable_sort(order.begin(), order.end(), wanted);
+
+			// Residual norm of Ritz pair is |h_m * y_(m - 1)|
+			mConverged = true;
+			for (size_t index = 0; index < count; index++) {
+				const double residual = std::abs(krylov.coupling() * ritzVectors(length - 1, order[index]));
+				mConverged = mConverged && isConverged(residual, values[order[index]], tolerance);
+			}
+			if (mConverged || mRestartCount >= maxRestarts || length == krylov.mSize) {
+				break;
+			}
+
+			// Thick restart on the wanted half of Ritz vectors, H becomes diagonal with coupling row
+			kept = std::min(count + (length - count) / 2, length - 1);
+			Dense directions(length, kept), diagonal(kept, kept);
+			for (size_t col = 0; col < kept; col++) {
+				for (size_t row = 0; row < length; row++) {
+					directions(row, col) = ritzVectors(row, order[col]);
+				}
+				diagonal(col, col) = values[order[col]];
+			}
+			krylov.restart(directions, diagonal);
+			mRestartCount++;
+		}
+
+		Dense coefficients(length, count);
+		mValues.resize(count);
+		for (size_t col = 0; col < count; col++) {
+			for (size_t row = 0; row < length; row++) {
+				coefficients(row, col) = ritzVectors(row, order[col]);
+			}
+			mValues[col] = values[order[col]];
+		}
+		mVectors = krylov.combine(coefficients);
+		mOperatorCount = krylov.mOperatorCount;
+	}
+
+
+
+
+
+	LanczosEigen::LanczosEigen(const LinearOperator& symmetricOperator, const size_t count, const Which which,
+		const size_t subspaceSize, const double tolerance, const size_t maxRestarts, const unsigned int seed)
+		: impl(std::make_unique<Impl>(symmetricOperator, count, which, subspaceSize, tolerance, maxRestarts, seed))
+	{
+	}
+	LanczosEigen::LanczosEigen(const Matrixx& matrix, const size_t count, const Which which)
+		: impl(std::make_unique<Impl>(DenseOperator(matrix), count, which, 0, 1e-10, 1000, 0))
+	{
+	}
+	LanczosEigen::LanczosEigen(const LanczosEigen& copyEigen)
+		: impl(std::make_unique<Impl>(*(copyEigen.impl)))
+	{
+	}
+	LanczosEigen::~LanczosEigen() = default;
+
+	Vectorr LanczosEigen::eigenvalues() const
+	{
+		return toVector(impl->mValues);
+	}
+	Matrixx LanczosEigen::eigenvectors() const
+	{
+		return toMatrix(impl->mVectors);
+	}
+	Vectorr LanczosEigen::eigenvector(const size_t index) const
+	{
+		if (index >= impl->mValues.size()) {
+			handleIndexException(0, index, impl->mVectors.height, impl->mVectors.width);
+		}
+		Vectorr vector(impl->mVectors.height);
+		for (size_t row = 0; row < impl->mVectors.height; row++) {
+			vector[row] = impl->mVectors(row, index);
+		}
+		return vector;
+	}
+
+	bool LanczosEigen::converged() const
+	{
+		return impl->mConverged;
+	}
+	const size_t LanczosEigen::restartCount() const
+	{
+		return impl->mRestartCount;
+	}
+	const size_t LanczosEigen::operatorCount() const
+	{
+		return impl->mOperatorCount;
+	}
+	const size_t LanczosEigen::count() const
+	{
+		return impl->mValues.size();
+	}
+	const size_t LanczosEigen::size() const
+	{
+		return impl->mVectors.height;
+	}
+
+	LanczosEigen& LanczosEigen::operator=(const LanczosEigen& rightEigen)
+	{
+		if (this == &rightEigen) {
+			return *this;
+		}
+
+		*impl = *(rightEigen.impl);
+		return *this;
+	}
+
+
+
+
+
+	class ArnoldiEigen::Impl {
+	public:
+		Impl(const LinearOperator& linearOperator, const size_t count, const Which which,
+			const size_t subspaceSize, const double tolerance, const size_t maxRestarts, const unsigned int seed); // throws std::logic_error
+
+		std::vector<double> mReal, mImaginary;
+		Dense mVectorsReal, mVectorsImaginary; // size x count
+		bool mConverged;
+		size_t mRestartCount, mOperatorCount;
+	};
+
+	ArnoldiEigen::Impl::Impl(const LinearOperator& linearOperator, const size_t count, const Which which,
+		const size_t subspaceSize, const double tolerance, const size_t maxRestarts, const unsigned int seed)
+		: mConverged(false), mRestartCount(0), mOperatorCount(0)
+	{
+		const size_t length = checkEigenArguments(linearOperator, count, subspaceSize);
+		KrylovDecomposition krylov(linearOperator, length, seed);
+
+		size_t kept = 0;
+		std::vector<double> real(length), imaginary(length);
+		std::vector<size_t> order(length);
+		Dense projected, ritzReal(length, length), ritzImaginary(length, length);
+		while (true) {
+			krylov.expand(kept);
+
+			// Ritz pairs of H, eigenvectors normalized in complex sense
+			projected = krylov.projectedSquare();
+			Dense hessenberg = projected, vectors(length, length);
+			generalEigen(length, hessenberg.data(), length, real.data(), imaginary.data(), vectors.data(), length);
+			for (size_t col = 0; col < length; col++) {
+				const bool pairFirst = (imaginary[col] > 0.0), pairSecond = (imaginary[col] < 0.0);
+				const size_t realCol = pairSecond ? col - 1 : col;
+				const double imaginarySign = pairSecond ? -1.0 : 1.0;
+				double squareSum = 0.0;
+				for (size_t row = 0; row < length; row++) {
+					ritzReal(row, col) = vectors(row, realCol);
+					ritzImaginary(row, col) = (pairFirst || pairSecond) ? imaginarySign * vectors(row, realCol + 1) : 0.0;
+					squareSum += ritzReal(row, col) * ritzReal(row, col) + ritzImaginary(row, col) * ritzImaginary(row, col);
+				}
+				const double inverseNorm = (squareSum > 0.0) ? 1.0 / std::sqrt(squareSum) : 0.0;
+				for (size_t row = 0; row < length; row++) {
+					ritzReal(row, col) *= inverseNorm;
+					ritzImaginary(row, col) *= inverseNorm;
+				}
+			}
+
+			for (size_t index = 0; index < length; index++) {
+				order[index] = index;
+			}
+			// Conjugate pairs stay adjacent, positive imaginary part first
+			auto wanted = [&real, &imaginary, which](const size_t left, const size_t right) {
+				double leftKey, rightKey;
+				switch (which) {
+				case Which::LargestReal:
+					leftKey = real[left];
+					rightKey = real[right];
+					break;
+				case Which::SmallestReal:
+					leftKey = -real[left];
+					rightKey = -real[right];
+					break;
+				default:
+					leftKey = std::hypot(real[left], imaginary[left]);
+					rightKey = std::hypot(real[right], imaginary[right]);
+					break;
+				}
+				return (leftKey != rightKey) ? leftKey > rightKey : imaginary[left] > imaginary[right];
+			};
+			std::stable_sort(order.begin(), order.end(), wanted);
+
+			mConverged = true;
+			for (size_t index = 0; index < count; index++) {
+				const size_t col = order[index];
+				const double residual = std::abs(krylov.coupling()) * std::hypot(ritzReal(length - 1, col), ritzImaginary(length - 1, col));
+				mConverged = mConverged && isConverged(residual, std::hypot(real[col], imaginary[col]), tolerance);
+			}
+			if (mConverged || mRestartCount >= maxRestarts || length == krylov.mSize) {
+				break;
+			}
+
+			// Restart on orthonormal basis of wanted Ritz vectors, a conjugate pair contributes real and imaginary parts
+			const size_t target = std::min(count + (length - count) / 2, length - 2);
+			std::vector<std::vector<double>> columns;
+			for (size_t index = 0; index < length && columns.size() < target; index++) {
+				const size_t col = order[index];
+				if (imaginary[col] < 0.0 && index > 0 && order[index - 1] == col - 1) {
+					continue;
+				}
+				std::vector<double> column(length);
+				for (size_t row = 0; row < length; row++) {
+					column[row] = ritzReal(row, col);
+				}
+				columns.push_back(column);
+				if (imaginary[col] != 0.0) {
+					for (size_t row = 0; row < length; row++) {
+						column[row] = ritzImaginary(row, col);
+					}
+					columns.push_back(column);
+				}
+			}
+			kept = columns.size();
+			Dense directions(length, kept);
+			for (size_t col = 0; col < kept; col++) {
+				for (size_t row = 0; row < length; row++) {
+					directions(row, col) = columns[col][row];
+				}
+			}
+			directions = orthonormalColumns(std::move(directions));
+			const Dense compressed = multiply(directions, multiply(projected, directions), Trans::Trans);
+			krylov.restart(directions, compressed);
+			mRestartCount++;
+		}
+
+		Dense coefficientsReal(length, count), coefficientsImaginary(length, count);
+		mReal.resize(count);
+		mImaginary.resize(count);
+		for (size_t col = 0; col < count; col++) {
+			for (size_t row = 0; row < length; row++) {
+				coefficientsReal(row, col) = ritzReal(row, order[col]);
+				coefficientsImaginary(row, col) = ritzImaginary(row, order[col]);
+			}
+			mReal[col] = real[order[col]];
+			mImaginary[col] = imaginary[order[col]];
+		}
+		mVectorsReal = krylov.combine(coefficientsReal);
+		mVectorsImaginary = krylov.combine(coefficientsImaginary);
+		mOperatorCount = krylov.mOperatorCount;
+	}
+
+
+
+
+
+	ArnoldiEigen::ArnoldiEigen(const LinearOperator& linearOperator, const size_t count, const Which which,
+		const size_t subspaceSize, const double tolerance, const size_t maxRestarts, const unsigned int seed)
+		: impl(std::make_unique<Impl>(linearOperator, count, which, subspaceSize, tolerance, maxRestarts, seed))
+	{
+	}
+	ArnoldiEigen::ArnoldiEigen(const Matrixx& matrix, const size_t count, const Which which)
+		: impl(std::make_unique<Impl>(DenseOperator(matrix), count, which, 0, 1e-10, 1000, 0))
+	{
+	}
+	ArnoldiEigen::ArnoldiEigen(const ArnoldiEigen& copyEigen)
+		: impl(std::make_unique<Impl>(*(copyEigen.impl)))
+	{
+	}
+	ArnoldiEigen::~ArnoldiEigen() = default;
+
+	Vectorr ArnoldiEigen::eigenvaluesReal() const
+	{
+		return toVector(impl->mReal);
+	}
+	Vectorr ArnoldiEigen::eigenvaluesImaginary() const
+	{
+		return toVector(impl->mImaginary);
+	}
+	Matrixx ArnoldiEigen::eigenvectorsReal() const
+	{
+		return toMatrix(impl->mVectorsReal);
+	}
+	Matrixx ArnoldiEigen::eigenvectorsImaginary() const
+	{
+		return toMatrix(impl->mVectorsImaginary);
+	}
+
+	bool ArnoldiEigen::converged() const
+	{
+		return impl->mConverged;
+	}
+	const size_t ArnoldiEigen::restartCount() const
+	{
+		return impl->mRestartCount;
+	}
+	const size_t ArnoldiEigen::operatorCount() const
+	{
+		return impl->mOperatorCount;
+	}
+	const size_t ArnoldiEigen::count() const
+	{
+		return impl->mReal.size();
+	}
+	const size_t ArnoldiEigen::size() const
+	{
+		return impl->mVectorsReal.height;
+	}
+
+	ArnoldiEigen& ArnoldiEigen::operator=(const ArnoldiEigen& rightEigen)
+	{
+		if (this == &rightEigen) {
+			return *this;
+		}
+
+		*impl = *(rightEigen.impl);
+		return *this;
+	}
+
+
+
+
+
+	class KrylovSolver::Impl {
+	public:
+		Impl(const LinearOperator& linearOperator, const Method method, const double tolerance, const size_t maxIterations); // throws std::logic_error
+
+		// Rows of rightRows and solutionRows are right-hand sides and initial guesses
+		Dense solve(const Dense& rightRows, Dense solutionRows); // throws std::logic_error
+		void checkLength(const size_t height, const size_t width) const; // throws std::logic_error
+		void checkInitial(const size_t rightWidth, const size_t height, const size_t width) const; // throws std::logic_error
+		void setTolerance(const double tolerance); // throws std::logic_error
+		void setRestart(const size_t restart); // throws std::logic_error
+		void setPreconditioner(const Preconditioner& preconditioner); // throws std::logic_error
+
+		const LinearOperator* mOperator;
+		const Preconditioner* mPreconditioner; // nullptr when not preconditioned
+		Method mMethod;
+		double mTolerance;
+		size_t mMaxIterations, mRestart;
+		Monitor mMonitor;
+
+		bool mConverged;
+		size_t mIterationCount;
+		std::vector<double> mHistory;
+	private:
+		void conjugateGradient(const Dense& rightRows, Dense& solutionRows);
+		void minimalResidual(const Dense& rightRows, Dense& solutionRows);
+		void generalizedMinimalResidual(const Dense& rightRows, Dense& solutionRows);
+		void stabilizedBiconjugateGradient(const Dense& rightRows, Dense& solutionRows);
+
+		// Operator products of selected rows in one pass, products.row(i) = A * rows.row(i)
+		void applyRows(const Dense& rows, const std::vector<char>& selected, Dense& products) const;
+		void residualRows(const Dense& rightRows, const Dense& solutionRows, const std::vector<char>& selected, Dense& residuals) const;
+		// results.row(i) = M^-1 * rows.row(i) on selected rows (copy without preconditioner)
+		void preconditionRows(const Dense& rows, const std::vector<char>& selected, Dense& results);
+		// Initial residuals, columns with zero right-hand side are solved by x = 0. Returns whether any column is active
+		bool start(const Dense& rightRows, Dense& solutionRows, Dense& residuals);
+		void updateResidual(const size_t column, const double residualNorm); // Converged column becomes inactive
+		bool advance(); // Count and report iteration, returns whether iteration continues
+
+		std::vector<double> mRightNorms, mRelative;
+		std::vector<char> mActive, mColumnConverged;
+		std::vector<double> mVector, mResult; // Preconditioner buffers
+	};
+
+	KrylovSolver::Impl::Impl(const LinearOperator& linearOperator, const Method method, const double tolerance, const size_t maxIterations)
+		: mOperator(&linearOperator), mPreconditioner(nullptr), mMethod(method), mMaxIterations(maxIterations), mRestart(30),
+		mConverged(false), mIterationCount(0)
+	{
+		if (linearOperator.height() != linearOperator.width()) {
+			handleEtcException("Cannot solve with non-square operator.");
+		}
+		setTolerance(tolerance);
+	}
+
+	Dense KrylovSolver::Impl::solve(const Dense& rightRows, Dense solutionRows)
+	{
+		switch (mMethod) {
+		case Method::CG:
+			conjugateGradient(rightRows, solutionRows);
+			break;
+		case Method::MINRES:
+			minimalResidual(rightRows, solutionRows);
+			break;
+		case Method::GMRES:
+			generalizedMinimalResidual(rightRows, solutionRows);
+			break;
+		default:
+			stabilizedBiconjugateGradient(rightRows, solutionRows);
+			break;
+		}
+		mConverged = std::find(mColumnConverged.begin(), mColumnConverged.end(), 0) == mColumnConverged.end();
+		return solutionRows;
+	}
+
+	void KrylovSolver::Impl::checkLength(const size_t height, const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(mOperator->height(), height), '\\',
+			LengthArgument(mOperator->height(), mOperator->width()), LengthArgument(height, width));
+	}
+
+	void KrylovSolver::Impl::checkInitial(const size_t rightWidth, const size_t height, const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mOperator->width(), height), '*',
+			LengthArgument(mOperator->height(), mOperator->width()), LengthArgument(height, width));
+		if (width != rightWidth) {
+			handleEtcException("Initial guess must have as many columns as right-hand side.");
+		}
+	}
+
+	void KrylovSolver::Impl::setTolerance(const double tolerance)
+	{
+		if (!(tolerance >= 0.0)) {
+			handleEtcException("Tolerance must not be negative.");
+		}
+		mTolerance = tolerance;
+	}
+
+	void KrylovSolver::Impl::setRestart(const size_t restart)
+	{
+		if (restart == 0) {
+			handleEtcException("Restart length must be positive.");
+		}
+		mRestart = restart;
+	}
+
+	void KrylovSolver::Impl::setPreconditioner(const Preconditioner& preconditioner)
+	{
+		if (preconditioner.size() != mOperator->width()) {
+			handleEtcException("Preconditioner size does not match operator size.");
+		}
+		mPreconditioner = &preconditioner;
+	}
+
+	void KrylovSolver::Impl::applyRows(const Dense& rows, const std::vector<char>& selected, Dense& products) const
+	{
+		std::vector<size_t> indices;
+		for (size_t row = 0; row < rows.height; row++) {
+			if (selected[row]) {
+				indices.push_back(row);
+			}
+		}
+		if (indices.size() == 1) {
+			const std::vector<double> product = applyOperator(*mOperator, rows.row(indices[0]));
+			std::copy(product.begin(), product.end(), products.row(indices[0]));
+			return;
+		}
+		if (indices.empty()) {
+			return;
+		}
+
+		Dense columns(rows.width, indices.size());
+		for (size_t index = 0; index < indices.size(); index++) {
+			for (size_t entry = 0; entry < rows.width; entry++) {
+				columns(entry, index) = rows(indices[index], entry);
+			}
+		}
+		const Dense result = fromMatrix(mOperator->applyBlock(toMatrix(columns)));
+		if (result.height != rows.width || result.width != indices.size()) {
+			handleEtcException("Operator result length does not match operator height.");
+		}
+		for (size_t index = 0; index < indices.size(); index++) {
+			for (size_t entry = 0; entry < rows.width; entry++) {
+				products(indices[index], entry) = result(entry, index);
+			}
+		}
+	}
+
+	void KrylovSolver::Impl::residualRows(const Dense& rightRows, const Dense& solutionRows, const std::vector<char>& selected, Dense& residuals) const
+	{
+		applyRows(solutionRows, selected, residuals);
+		for (size_t row = 0; row < rightRows.height; row++) {
+			if (selected[row]) {
+				double* residual = residuals.row(row);
+				const double* right = rightRows.row(row);
+				for (size_t entry = 0; entry < rightRows.width; entry++) {
+					residual[entry] = right[entry] - residual[entry];
+				}
+			}
+		}
+	}
+
+	void KrylovSolver::Impl::preconditionRows(const Dense& rows, const std::vector<char>& selected, Dense& results)
+	{
+		for (size_t row = 0; row < rows.height; row++) {
+			if (!selected[row]) {
+				continue;
+			}
+			if (mPreconditioner == nullptr) {
+				if (&rows != &results) {
+					std::copy(rows.row(row), rows.row(row) + rows.width, results.row(row));
+				}
+				continue;
+			}
+			std::copy(rows.row(row), rows.row(row) + rows.width, mVector.begin());
+			mPreconditioner->apply(mVector, mResult);
+			std::copy(mResult.begin(), mResult.end(), results.row(row));
+		}
+	}
+
+	bool KrylovSolver::Impl::start(const Dense& rightRows, Dense& solutionRows, Dense& residuals)
+	{
+		const size_t count = rightRows.height, size = rightRows.width;
+		mRightNorms.assign(count, 0.0);
+		mRelative.assign(count, 0.0);
+		mActive.assign(count, 1);
+		mColumnConverged.assign(count, 0);
+		mVector.assign((mPreconditioner != nullptr) ? size : 0, 0.0);
+		mResult.assign(mVector.size(), 0.0);
+		for (size_t col = 0; col < count; col++) {
+			mRightNorms[col] = norm2(size, rightRows.row(col));
+			if (mRightNorms[col] == 0.0) {
+				std::fill(solutionRows.row(col), solutionRows.row(col) + size, 0.0);
+				mActive[col] = 0;
+				mColumnConverged[col] = 1;
+			}
+		}
+
+		residualRows(rightRows, solutionRows, mActive, residuals);
+		for (size_t col = 0; col < count; col++) {
+			if (mActive[col]) {
+				updateResidual(col, norm2(size, residuals.row(col)));
+			}
+		}
+		mIterationCount = 0;
+		mHistory.assign(1, *std::max_element(mRelative.begin(), mRelative.end()));
+		return std::find(mActive.begin(), mActive.end(), 1) != mActive.end() && mMaxIterations > 0;
+	}
+
+	void KrylovSolver::Impl::updateResidual(const size_t column, const double residualNorm)
+	{
+		mRelative[column] = residualNorm / mRightNorms[column];
+		if (mRelative[column] <= mTolerance) {
+			mActive[column] = 0;
+			mColumnConverged[column] = 1;
+		}
+	}
+
+	bool KrylovSolver::Impl::advance()
+	{
+		mIterationCount++;
+		const double relative = *std::max_element(mRelative.begin(), mRelative.end());
+		mHistory.push_back(relative);
+		const bool proceed = !mMonitor || mMonitor(mIterationCount, relative);
+		return proceed && mIterationCount < mMaxIterations && std::find(mActive.begin(), mActive.end(), 1) != mActive.end();
+	}
+
+	void KrylovSolver::Impl::conjugateGradient(const Dense& rightRows, Dense& solutionRows)
+	{
+		const size_t count = rightRows.height, size = rightRows.width;
+		Dense residuals(count, size), products(count, size);
+		bool proceed = start(rightRows, solutionRows, residuals);
+
+		// z = M^-1 * r, search directions are M-conjugate
+		Dense preconditioned(count, size);
+		preconditionRows(residuals, mActive, preconditioned);
+		Dense directions = preconditioned;
+		std::vector<double> residualProducts(count); // r^T * z
+		for (size_t col = 0; col < count; col++) {
+			residualProducts[col] = dot(size, residuals.row(col), preconditioned.row(col));
+		}
+		while (proceed) {
+			applyRows(directions, mActive, products);
+			for (size_t col = 0; col < count; col++) {
+				if (!mActive[col]) {
+					continue;
+				}
+				const double curvature = dot(size, directions.row(col), products.row(col));
+				if (!(curvature > 0.0)) {
+					// Operator is not positive-definite along the direction
+					mActive[col] = 0;
+					continue;
+				}
+
+				const double step = residualProducts[col] / curvature;
+				axpy(size, step, directions.row(col), solutionRows.row(col));
+				axpy(size, -step, products.row(col), residuals.row(col));
+				updateResidual(col, norm2(size, residuals.row(col)));
+			}
+			preconditionRows(residuals, mActive, preconditioned);
+
+			for (size_t col = 0; col < count; col++) {
+				if (!mActive[col]) {
+					continue;
+				}
+				const double product = dot(size, residuals.row(col), preconditioned.row(col));
+				const double ratio = product / residualProducts[col];
+				double* direction = directions.row(col);
+				const double* next = preconditioned.row(col);
+				for (size_t entry = 0; entry < size; entry++) {
+					direction[entry] = next[entry] + ratio * direction[entry];
+				}
+				residualProducts[col] = product;
+			}
+			proceed = advance();
+		}
+	}
+
+	void KrylovSolver::Impl::minimalResidual(const Dense& rightRows, Dense& solutionRows)
+	{
+		// Paige-Saunders MINRES : Lanczos vectors r1, r2 (z = M^-1 * r2) with short recurrence of search directions w, w2
+		const size_t count = rightRows.height, size = rightRows.width;
+		Dense current(count, size), products(count, size);
+		bool proceed = start(rightRows, solutionRows, current);
+
+		Dense previous = current, preconditioned(count, size), lanczos(count, size), directions(count, size), lastDirections(count, size);
+		std::vector<double> alpha(count), beta(count), oldBeta(count, 0.0), epsilon(count, 0.0), deltaBar(count, 0.0),
+			phiBar(count), cosine(count, -1.0), sine(count, 0.0);
+		preconditionRows(current, mActive, preconditioned);
+		for (size_t col = 0; col < count; col++) {
+			beta[col] = std::sqrt(std::max(dot(size, current.row(col), preconditioned.row(col)), 0.0));
+			phiBar[col] = beta[col];
+		}
+		if (mPreconditioner != nullptr && proceed) {
+			// Residuals are measured in M^-1 norm
+			preconditionRows(rightRows, mActive, products);
+			for (size_t col = 0; col < count; col++) {
+				if (mActive[col]) {
+					mRightNorms[col] = std::sqrt(std::max(dot(size, rightRows.row(col), products.row(col)), 0.0));
+					updateResidual(col, beta[col]);
+				}
+			}
+			mHistory.back() = *std::max_element(mRelative.begin(), mRelative.end());
+			proceed = std::find(mActive.begin(), mActive.end(), 1) != mActive.end();
+		}
+		while (proceed) {
+			for (size_t col = 0; col < count; col++) {
+				if (mActive[col]) {
+					const double* from = preconditioned.row(col);
+					double* to = lanczos.row(col);
+					for (size_t entry = 0; entry < size; entry++) {
+						to[entry] = from[entry] / beta[col];
+					}
+				}
+			}
+			applyRows(lanczos, mActive, products);
+
+			for (size_t col = 0; col < count; col++) {
+				if (!mActive[col]) {
+					continue;
+				}
+				double* product = products.row(col);
+				if (mIterationCount > 0) {
+					axpy(size, -beta[col] / oldBeta[col], previous.row(col), product);
+				}
+				alpha[col] = dot(size, lanczos.row(col), product);
+				axpy(size, -alpha[col] / beta[col], current.row(col), product);
+				std::copy(current.row(col), current.row(col) + size, previous.row(col));
+				std::copy(product, product + size, current.row(col));
+			}
+			preconditionRows(current, mActive, preconditioned);
+
+			for (size_t col = 0; col < count; col++) {
+				if (!mActive[col]) {
+					continue;
+				}
+				oldBeta[col] = beta[col];
+				beta[col] = std::sqrt(std::max(dot(size, current.row(col), preconditioned.row(col)), 0.0));
+
+				// Next rotation of the tridiagonal QR factorization
+				const double oldEpsilon = epsilon[col];
+				const double delta = cosine[col] * deltaBar[col] + sine[col] * alpha[col];
+				const double gammaBar = sine[col] * deltaBar[col] - cosine[col] * alpha[col];
+				epsilon[col] = sine[col] * beta[col];
+				deltaBar[col] = -cosine[col] * beta[col];
+				const double gamma = std::max(std::hypot(gammaBar, beta[col]), std::numeric_limits<double>::epsilon());
+				cosine[col] = gammaBar / gamma;
+				sine[col] = beta[col] / gamma;
+				const double phi = cosine[col] * phiBar[col];
+				phiBar[col] *= sine[col];
+
+				const double* vector = lanczos.row(col);
+				double* direction = directions.row(col);
+				double* lastDirection = lastDirections.row(col);
+				for (size_t entry = 0; entry < size; entry++) {
+					const double older = direction[entry];
+					direction[entry] = (vector[entry] - oldEpsilon * lastDirection[entry] - delta * older) / gamma;
+					lastDirection[entry] = older;
+				}
+				axpy(size, phi, direction, solutionRows.row(col));
+				updateResidual(col, std::abs(phiBar[col]));
+				if (beta[col] == 0.0) {
+					// Krylov subspace is invariant, no further progress
+					mActive[col] = 0;
+				}
+			}
+			proceed = advance();
+		}
+	}
+
+	void KrylovSolver::Impl::generalizedMinimalResidual(const Dense& rightRows, Dense& solutionRows)
+	{
+		// Restarted GMRES, each column keeps Arnoldi basis (rows) and Givens-reduced Hessenberg matrix of its cycle
+		const size_t count = rightRows.height, size = rightRows.width, length = std::min(mRestart, size);
+		const double epsilon = std::numeric_limits<double>::epsilon();
+		Dense residuals(count, size), current(count, size), products(count, size);
+		bool proceed = start(rightRows, solutionRows, residuals);
+
+		std::vector<Dense> bases(count), hessenbergs(count);
+		std::vector<std::vector<double>> cosines(count), sines(count), projected(count);
+		std::vector<size_t> steps(count, 0);
+		std::vector<double> coefficients(length + 1), correction(length + 1);
+		while (proceed) {
+			std::vector<char> cycle = mActive;
+			for (size_t col = 0; col < count; col++) {
+				if (cycle[col]) {
+					bases[col] = Dense(length + 1, size);
+					hessenbergs[col] = Dense(length + 1, length);
+					cosines[col].assign(length, 1.0);
+					sines[col].assign(length, 0.0);
+					projected[col].assign(length + 1, 0.0);
+					projected[col][0] = norm2(size, residuals.row(col));
+					const double* residual = residuals.row(col);
+					double* first = bases[col].row(0);
+					for (size_t entry = 0; entry < size; entry++) {
+						first[entry] = residual[entry] / projected[col][0];
+					}
+				}
+			}
+
+			for (size_t step = 0; step < length && proceed && std::find(cycle.begin(), cycle.end(), 1) != cycle.end(); step++) {
+				for (size_t col = 0; col < count; col++) {
+					if (cycle[col]) {
+						std::copy(bases[col].row(step), bases[col].row(step) + size, current.row(col));
+					}
+				}
+				preconditionRows(current, cycle, current);
+				applyRows(current, cycle, products);
+
+				for (size_t col = 0; col < count; col++) {
+					if (!cycle[col]) {
+						continue;
+					}
+					Dense& basis = bases[col];
+					Dense& hessenberg = hessenbergs[col];
+					std::vector<double>& g = projected[col];
+					double* product = products.row(col);
+
+					// Classical Gram-Schmidt twice against basis rows 0..step
+					const double productNorm = norm2(size, product);
+					std::fill(coefficients.begin(), coefficients.end(), 0.0);
+					for (size_t pass = 0; pass < 2; pass++) {
+						gemv(Trans::NoTrans, step + 1, size, 1.0, basis.data(), size, product, 0.0, correction.data());
+						gemv(Trans::Trans, step + 1, size, -1.0, basis.data(), size, correction.data(), 1.0, product);
+						axpy(step + 1, 1.0, correction.data(), coefficients.data());
+					}
+					const double nextNorm = norm2(size, product);
+					for (size_t row = 0; row <= step; row++) {
+						hessenberg(row, step) = coefficients[row];
+					}
+					hessenberg(step + 1, step) = nextNorm;
+					if (nextNorm > 0.0) {
+						double* next = basis.row(step + 1);
+						for (size_t entry = 0; entry < size; entry++) {
+							next[entry] = product[entry] / nextNorm;
+						}
+					}
+
+					// Previous rotations on new column, then a new rotation eliminating the subdiagonal
+					for (size_t row = 0; row < step; row++) {
+						const double upper = hessenberg(row, step), lower = hessenberg(row + 1, step);
+						hessenberg(row, step) = cosines[col][row] * upper + sines[col][row] * lower;
+						hessenberg(row + 1, step) = -sines[col][row] * upper + cosines[col][row] * lower;
+					}
+					const double radius = std::hypot(hessenberg(step, step), hessenberg(step + 1, step));
+					if (radius > 0.0) {
+						cosines[col][step] = hessenberg(step, step) / radius;
+						sines[col][step] = hessenberg(step + 1, step) / radius;
+					}
+					hessenberg(step, step) = radius;
+					hessenberg(step + 1, step) = 0.0;
+					g[step + 1] = -sines[col][step] * g[step];
+					g[step] *= cosines[col][step];
+
+					steps[col] = step + 1;
+					updateResidual(col, std::abs(g[step + 1]));
+					if (!mActive[col] || nextNorm <= static_cast<double>(size) * epsilon * productNorm) {
+						cycle[col] = 0;
+					}
+				}
+				proceed = advance();
+			}
+
+			// x += M^-1 * V^T * y with upper triangular H * y = g
+			std::vector<char> updated(count, 0);
+			for (size_t col = 0; col < count; col++) {
+				if (steps[col] == 0) {
+					continue;
+				}
+				const Dense& hessenberg = hessenbergs[col];
+				std::vector<double>& g = projected[col];
+				for (size_t row = steps[col]; row-- > 0;) {
+					double sum = g[row];
+					for (size_t index = row + 1; index < steps[col]; index++) {
+						sum -= hessenberg(row, index) * g[index];
+					}
+					g[row] = (hessenberg(row, row) != 0.0) ? sum / hessenberg(row, row) : 0.0;
+				}
+				gemv(Trans::Trans, steps[col], size, 1.0, bases[col].data(), size, g.data(), 0.0, current.row(col));
+				updated[col] = 1;
+				steps[col] = 0;
+			}
+			preconditionRows(current, updated, current);
+			for (size_t col = 0; col < count; col++) {
+				if (updated[col]) {
+					axpy(size, 1.0, current.row(col), solutionRows.row(col));
+				}
+			}
+
+			// Restart from true residual
+			if (proceed) {
+				residualRows(rightRows, solutionRows, mActive, residuals);
+				for (size_t col = 0; col < count; col++) {
+					if (mActive[col]) {
+						updateResidual(col, norm2(size, residuals.row(col)));
+					}
+				}
+				proceed = std::find(mActive.begin(), mActive.end(), 1) != mActive.end();
+			}
+		}
+	}
+
+	void KrylovSolver::Impl::stabilizedBiconjugateGradient(const Dense& rightRows, Dense& solutionRows)
+	{
+		const size_t count = rightRows.height, size = rightRows.width;
+		Dense residuals(count, size);
+		bool proceed = start(rightRows, solutionRows, residuals);
+
+		// Right preconditioned : p^ = M^-1 * p and s^ = M^-1 * s enter products and solution update
+		Dense shadows = residuals, directions(count, size), preconditioned(count, size), products(count, size),
+			halfPreconditioned(count, size), halfProducts(count, size);
+		std::vector<double> rho(count, 1.0), alpha(count, 1.0), omega(count, 1.0);
+		while (proceed) {
+			for (size_t col = 0; col < count; col++) {
+				if (!mActive[col]) {
+					continue;
+				}
+				const double nextRho = dot(size, shadows.row(col), residuals.row(col));
+				if (nextRho == 0.0) {
+					// Breakdown : residual is orthogonal to shadow residual
+					mActive[col] = 0;
+					continue;
+				}
+				const double beta = (nextRho / rho[col]) * (alpha[col] / omega[col]);
+				rho[col] = nextRho;
+				double* direction = directions.row(col);
+				const double* residual = residuals.row(col);
+				const double* product = products.row(col);
+				for (size_t entry = 0; entry < size; entry++) {
+					direction[entry] = residual[entry] + beta * (direction[entry] - omega[col] * product[entry]);
+				}
+			}
+			preconditionRows(directions, mActive, preconditioned);
+			applyRows(preconditioned, mActive, products);
+
+			// Half step s = r - alpha * A * p^ (kept in residuals), then stabilizing step on columns not yet converged
+			std::vector<char> stabilize = mActive;
+			for (size_t col = 0; col < count; col++) {
+				if (!mActive[col]) {
+					continue;
+				}
+				const double denominator = dot(size, shadows.row(col), products.row(col));
+				if (denominator == 0.0) {
+					mActive[col] = 0;
+					stabilize[col] = 0;
+					continue;
+				}
+				alpha[col] = rho[col] / denominator;
+				axpy(size, -alpha[col], products.row(col), residuals.row(col));
+				updateResidual(col, norm2(size, residuals.row(col)));
+				if (!mActive[col]) {
+					axpy(size, alpha[col], preconditioned.row(col), solutionRows.row(col));
+					stabilize[col] = 0;
+				}
+			}
+			preconditionRows(residuals, stabilize, halfPreconditioned);
+			applyRows(halfPreconditioned, stabilize, halfProducts);
+
+			for (size_t col = 0; col < count; col++) {
+				if (!stabilize[col]) {
+					continue;
+				}
+				double* residual = residuals.row(col);
+				const double* halfProduct = halfProducts.row(col);
+				const double squareNorm = dot(size, halfProduct, halfProduct);
+				omega[col] = (squareNorm > 0.0) ? dot(size, halfProduct, residual) / squareNorm : 0.0;
+				axpy(size, alpha[col], preconditioned.row(col), solutionRows.row(col));
+				axpy(size, omega[col], halfPreconditioned.row(col), solutionRows.row(col));
+				axpy(size, -omega[col], halfProduct, residual);
+				updateResidual(col, norm2(size, residual));
+				if (omega[col] == 0.0) {
+					mActive[col] = 0;
+				}
+			}
+			proceed = advance();
+		}
+	}
+
+
+
+
+
+	KrylovSolver::KrylovSolver(const LinearOperator& linearOperator, const Method method, const double tolerance, const size_t maxIterations)
+		: impl(std::make_unique<Impl>(linearOperator, method, tolerance, maxIterations))
+	{
+	}
+	KrylovSolver::KrylovSolver(const KrylovSolver& copySolver)
+		: impl(std::make_unique<Impl>(*(copySolver.impl)))
+	{
+	}
+	KrylovSolver::~KrylovSolver() = default;
+
+	Vectorr KrylovSolver::solve(const Vectorr& rightVector)
+	{
+		impl->checkLength(rightVector.size(), 1);
+		const Dense rightRows = fromColumns(rightVector).transpose();
+		const Dense solutionRows = impl->solve(rightRows, Dense(1, rightVector.size()));
+		return toVector(solutionRows.entries);
+	}
+	Vectorr KrylovSolver::solve(const Vectorr& rightVector, const Vectorr& initialVector)
+	{
+		impl->checkLength(rightVector.size(), 1);
+		impl->checkInitial(1, initialVector.size(), 1);
+		const Dense rightRows = fromColumns(rightVector).transpose();
+		const Dense solutionRows = impl->solve(rightRows, fromColumns(initialVector).transpose());
+		return toVector(solutionRows.entries);
+	}
+	Matrixx KrylovSolver::solve(const Matrixx& rightMatrix)
+	{
+		impl->checkLength(rightMatrix.height(), rightMatrix.width());
+		const Dense rightRows = fromMatrix(rightMatrix).transpose();
+		return toMatrix(impl->solve(rightRows, Dense(rightRows.height, rightRows.width)).transpose());
+	}
+	Matrixx KrylovSolver::solve(const Matrixx& rightMatrix, const Matrixx& initialMatrix)
+	{
+		impl->checkLength(rightMatrix.height(), rightMatrix.width());
+		impl->checkInitial(rightMatrix.width(), initialMatrix.height(), initialMatrix.width());
+		const Dense rightRows = fromMatrix(rightMatrix).transpose();
+		return toMatrix(impl->solve(rightRows, fromMatrix(initialMatrix).transpose()).transpose());
+	}
+
+	bool KrylovSolver::converged() const
+	{
+		return impl->mConverged;
+	}
+	const size_t KrylovSolver::iterationCount() const
+	{
+		return impl->mIterationCount;
+	}
+	double KrylovSolver::residualNorm() const
+	{
+		return impl->mHistory.empty() ? 0.0 : impl->mHistory.back();
+	}
+	std::vector<double> KrylovSolver::residualHistory() const
+	{
+		return impl->mHistory;
+	}
+
+	void KrylovSolver::setMethod(const Method method)
+	{
+		impl->mMethod = method;
+	}
+	void KrylovSolver::setTolerance(const double tolerance)
+	{
+		impl->setTolerance(tolerance);
+	}
+	void KrylovSolver::setMaxIterations(const size_t maxIterations)
+	{
+		impl->mMaxIterations = maxIterations;
+	}
+	void KrylovSolver::setRestart(const size_t restart)
+	{
+		impl->setRestart(restart);
+	}
+	void KrylovSolver::setMonitor(const Monitor& monitor)
+	{
+		impl->mMonitor = monitor;
+	}
+	void KrylovSolver::setPreconditioner(const Preconditioner& preconditioner)
+	{
+		impl->setPreconditioner(preconditioner);
+	}
+	void KrylovSolver::removePreconditioner()
+	{
+		impl->mPreconditioner = nullptr;
+	}
+	const KrylovSolver::Method KrylovSolver::method() const
+	{
+		return impl->mMethod;
+	}
+	const double KrylovSolver::tolerance() const
+	{
+		return impl->mTolerance;
+	}
+	const size_t KrylovSolver::maxIterations() const
+	{
+		return impl->mMaxIterations;
+	}
+	const size_t KrylovSolver::restart() const
+	{
+		return impl->mRestart;
+	}
+	bool KrylovSolver::hasPreconditioner() const
+	{
+		return impl->mPreconditioner != nullptr;
+	}
+	const size_t KrylovSolver::size() const
+	{
+		return impl->mOperator->width();
+	}
+
+	KrylovSolver& KrylovSolver::operator=(const KrylovSolver& rightSolver)
+	{
+		if (this == &rightSolver) {
+			return *this;
+		}
+
+		*impl = *(rightSolver.impl);
+		return *this;
+	}
+}
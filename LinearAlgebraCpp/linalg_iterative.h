@@ -0,0 +1,263 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <functional>
+
+namespace linalg {
+	// Matrix-free operators and Krylov subspace methods
+	// Implementations are in linalg_iterative.cpp
+	class LinearOperator;
+	class DenseOperator;
+	class SparseOperator;
+	class HMatrixOperator;
+	class FunctionOperator;
+	class Preconditioner; // linalg_precondition.h
+	class SparseMatrix; // linalg_sparse.h
+	class HMatrix; // linalg_hmatrix.h
+	class LanczosEigen;
+	class ArnoldiEigen;
+	class KrylovSolver;
+
+	/*
+	* Linear operator y = A * x of (height x width) matrix which does not need to be formed.
+	*
+	* Iterative methods only call apply (and applyBlock for several vectors at once),
+	* so an implicitly defined matrix only has to override apply, height and width.
+	*/
+	class LinearOperator {
+	public:
+		virtual ~LinearOperator() = default;
+
+		virtual Vectorr apply(const Vectorr& vector) const = 0; // throws std::logic_error
+		virtual Matrixx applyBlock(const Matrixx& matrix) const; // throws std::logic_error, column by column unless overridden
+
+		virtual const size_t height() const = 0;
+		virtual const size_t width() const = 0;
+	};
+
+	/*
+	* Adapter of dense Matrixx, products run as parallel matrix-vector and matrix-matrix kernels.
+	*/
+	class DenseOperator : public LinearOperator {
+	public:
+		explicit DenseOperator(const Matrixx& matrix);
+		DenseOperator(const DenseOperator& copyOperator);
+		virtual ~DenseOperator();
+
+		Vectorr apply(const Vectorr& vector) const override; // throws std::logic_error
+		Matrixx applyBlock(const Matrixx& matrix) const override; // throws std::logic_error
+
+		const size_t height() const override;
+		const size_t width() const override;
+
+		DenseOperator& operator=(const DenseOperator& rightOperator);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Adapter of SparseMatrix, products run as parallel sparse matrix-vector and sparse matrix-dense kernels.
+	*/
+	class SparseOperator : public LinearOperator {
+	public:
+		explicit SparseOperator(const SparseMatrix& matrix);
+		SparseOperator(const SparseOperator& copyOperator);
+		virtual ~SparseOperator();
+
+		Vectorr apply(const Vectorr& vector) const override; // throws std::logic_error
+		Matrixx applyBlock(const Matrixx& matrix) const override; // throws std::logic_error
+
+		const size_t height() const override;
+		const size_t width() const override;
+
+		SparseOperator& operator=(const SparseOperator& rightOperator);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Adapter of HMatrix, products run as parallel H-matrix block products in O(rank * n * log(n)).
+	*/
+	class HMatrixOperator : public LinearOperator {
+	public:
+		explicit HMatrixOperator(const HMatrix& matrix);
+		HMatrixOperator(const HMatrixOperator& copyOperator);
+		virtual ~HMatrixOperator();
+
+		Vectorr apply(const Vectorr& vector) const override; // throws std::logic_error
+		Matrixx applyBlock(const Matrixx& matrix) const override; // throws std::logic_error
+
+		const size_t height() const override;
+		const size_t width() const override;
+
+		HMatrixOperator& operator=(const HMatrixOperator& rightOperator);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Adapter of user callback y = function(x).
+	*/
+	class FunctionOperator : public LinearOperator {
+	public:
+		FunctionOperator(const size_t height, const size_t width,
+			const std::function<Vectorr(const Vectorr&)>& function); // throws std::length_error
+		FunctionOperator(const size_t size, const std::function<Vectorr(const Vectorr&)>& function); // throws std::length_error, square
+		FunctionOperator(const FunctionOperator& copyOperator);
+		virtual ~FunctionOperator();
+
+		Vectorr apply(const Vectorr& vector) const override; // throws std::logic_error : length mismatch of argument or result
+
+		const size_t height() const override;
+		const size_t width() const override;
+
+		FunctionOperator& operator=(const FunctionOperator& rightOperator);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* A few extreme eigenpairs of symmetric operator by thick-restart Lanczos.
+	*
+	* The Krylov basis is fully reorthogonalized and, at every restart, compressed to the wanted half of its Ritz vectors,
+	* so memory is O(size * subspaceSize) and only operator products touch the whole problem.
+	* subspaceSize 0 selects max(2 * count + 1, 20), clamped to size.
+	* A pair is converged when its residual norm is below tolerance * max(|lambda|, epsilon^(2/3)).
+	*
+	* Eigenvalues are ordered as requested by which, column i of eigenvectors() belongs to eigenvalues()[i].
+	*/
+	class LanczosEigen {
+	public:
+		enum class Which { Largest, Smallest, LargestMagnitude };
+
+		LanczosEigen(const LinearOperator& symmetricOperator, const size_t count, const Which which = Which::Largest,
+			const size_t subspaceSize = 0, const double tolerance = 1e-10, const size_t maxRestarts = 1000,
+			const unsigned int seed = 0); // throws std::logic_error : non-square operator or count out of [1, size]
+		explicit LanczosEigen(const Matrixx& matrix, const size_t count, const Which which = Which::Largest); // throws std::logic_error
+		LanczosEigen(const LanczosEigen& copyEigen);
+		virtual ~LanczosEigen();
+
+		Vectorr eigenvalues() const;
+		Matrixx eigenvectors() const; // size x count
+		Vectorr eigenvector(const size_t index) const; // throws std::out_of_range
+
+		bool converged() const; // Every requested pair met tolerance within maxRestarts
+		const size_t restartCount() const;
+		const size_t operatorCount() const; // Number of operator applications
+		const size_t count() const;
+		const size_t size() const;
+
+		LanczosEigen& operator=(const LanczosEigen& rightEigen);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* A few eigenpairs of general operator by Krylov-Schur style restarted Arnoldi.
+	*
+	* Same restart scheme as LanczosEigen : the basis is compressed to an orthonormal basis of the wanted Ritz vectors
+	* (real and imaginary parts together for complex pairs), so memory is O(size * subspaceSize).
+	* subspaceSize 0 selects max(2 * count + 1, 20), clamped to size.
+	*
+	* Eigenvalue i is eigenvaluesReal()[i] + i * eigenvaluesImaginary()[i], ordered as requested by which,
+	* and its eigenvector is column i of eigenvectorsReal() + i * eigenvectorsImaginary() with unit norm.
+	*/
+	class ArnoldiEigen {
+	public:
+		enum class Which { LargestMagnitude, LargestReal, SmallestReal };
+
+		ArnoldiEigen(const LinearOperator& linearOperator, const size_t count, const Which which = Which::LargestMagnitude,
+			const size_t subspaceSize = 0, const double tolerance = 1e-10, const size_t maxRestarts = 1000,
+			const unsigned int seed = 0); // throws std::logic_error : non-square operator or count out of [1, size]
+		explicit ArnoldiEigen(const Matrixx& matrix, const size_t count, const Which which = Which::LargestMagnitude); // throws std::logic_error
+		ArnoldiEigen(const ArnoldiEigen& copyEigen);
+		virtual ~ArnoldiEigen();
+
+		Vectorr eigenvaluesReal() const;
+		Vectorr eigenvaluesImaginary() const;
+		Matrixx eigenvectorsReal() const; // size x count
+		Matrixx eigenvectorsImaginary() const; // size x count
+
+		bool converged() const;
+		const size_t restartCount() const;
+		const size_t operatorCount() const;
+		const size_t count() const;
+		const size_t size() const;
+
+		ArnoldiEigen& operator=(const ArnoldiEigen& rightEigen);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Iterative solution of A * x = b by Krylov subspace methods :
+	* CG (symmetric positive-definite), MINRES (symmetric), GMRES(restart) and BiCGSTAB (general square operator).
+	*
+	* Iteration stops when the residual norm |b - A * x| is below tolerance * |b| (estimated by the method's recurrence),
+	* after maxIterations, or when the monitor returns false. The monitor is called after every iteration with
+	* the relative residual, and residualHistory() keeps the same values (initial residual first).
+	*
+	* Several right-hand sides are iterated together : each column keeps its own recurrence, but the
+	* operator is applied to all unconverged columns with a single applyBlock per step.
+	* With several columns, the reported residual is the largest one.
+	*
+	* With a preconditioner, CG and MINRES need it symmetric positive-definite, and GMRES and BiCGSTAB apply it from the right
+	* so that their residual stays the residual of A * x = b. MINRES then measures residuals in the M^-1 norm.
+	*
+	* The operator is referenced, not copied, and must outlive the solver.
+	*/
+	class KrylovSolver {
+	public:
+		enum class Method { CG, MINRES, GMRES, BiCGSTAB };
+		using Monitor = std::function<bool(const size_t iteration, const double relativeResidual)>;
+
+		explicit KrylovSolver(const LinearOperator& linearOperator, const Method method = Method::GMRES,
+			const double tolerance = 1e-10, const size_t maxIterations = 1000); // throws std::logic_error : non-square operator
+		KrylovSolver(const KrylovSolver& copySolver);
+		virtual ~KrylovSolver();
+
+		Vectorr solve(const Vectorr& rightVector); // throws std::logic_error, starts from x = 0
+		Vectorr solve(const Vectorr& rightVector, const Vectorr& initialVector); // throws std::logic_error, warm start
+		Matrixx solve(const Matrixx& rightMatrix); // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix, const Matrixx& initialMatrix); // throws std::logic_error
+
+		// Result of last solve
+		bool converged() const; // Every column met tolerance
+		const size_t iterationCount() const;
+		double residualNorm() const; // Relative residual |b - A * x| / |b|
+		std::vector<double> residualHistory() const;
+
+		void setMethod(const Method method);
+		void setTolerance(const double tolerance); // throws std::logic_error : negative
+		void setMaxIterations(const size_t maxIterations);
+		void setRestart(const size_t restart); // throws std::logic_error : zero, GMRES subspace size before restart (30 by default)
+		void setMonitor(const Monitor& monitor); // Empty function removes monitor
+		void setPreconditioner(const Preconditioner& preconditioner); // throws std::logic_error : size mismatch, referenced like the operator
+		void removePreconditioner();
+		const Method method() const;
+		const double tolerance() const;
+		const size_t maxIterations() const;
+		const size_t restart() const;
+		bool hasPreconditioner() const;
+		const size_t size() const;
+
+		KrylovSolver& operator=(const KrylovSolver& rightSolver);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
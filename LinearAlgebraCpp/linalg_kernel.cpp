@@ -0,0 +1,2854 @@
+#include "linalg_kernel.h"
+
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace linalg {
+	namespace kernel {
+
+		template <typename Scalar>
+		BasicDense<Scalar>::BasicDense(const size_t height, const size_t width, const Scalar value)
+			: height(height), width(width), entries(height * width, value)
+		{
+		}
+
+		template <typename Scalar>
+		BasicDense<Scalar> BasicDense<Scalar>::transpose() const
+		{
+			BasicDense transposed(width, height);
+			for (size_t row = 0; row < height; row++) {
+				for (size_t col = 0; col < width; col++) {
+					transposed(col, row) = (*this)(row, col);
+				}
+			}
+			return transposed;
+		}
+
+		template struct BasicDense<double>;
+		template struct BasicDense<float>;
+
+		Compressed::Compressed(const size_t height, const size_t width)
+			: height(height), width(width), offsets(height + 1, 0)
+		{
+		}
+
+		Compressed Compressed::transpose() const
+		{
+			// Counting sort by column keeps row indices ascending in each transposed row
+			Compressed transposed(width, height);
+			for (const size_t col : indices) {
+				transposed.offsets[col + 1]++;
+			}
+			for (size_t col = 0; col < width; col++) {
+				transposed.offsets[col + 1] += transposed.offsets[col];
+			}
+			transposed.indices.resize(indices.size());
+			transposed.values.resize(values.size());
+			std::vector<size_t> next(transposed.offsets.begin(), transposed.offsets.end() - 1);
+			for (size_t row = 0; row < height; row++) {
+				for (size_t index = offsets[row]; index < offsets[row + 1]; index++) {
+					const size_t position = next[indices[index]]++;
+					transposed.indices[position] = row;
+					transposed.values[position] = values[index];
+				}
+			}
+			return transposed;
+		}
+
+		void handleEtcException(const std::string& what)
+		{
+			EtcArgument etcArg(what);
+			ExceptionHandlerr handler(ExceptionState::EtcException, static_cast<int>(EtcState::Exception));
+			handler.addArgument(etcArg);
+			handler.handleException();
+		}
+		void handleOperationException(const int exceptNum, const char operation,
+			const LengthArgument& leftLengthArg, const LengthArgument& rightLengthArg)
+		{
+			if (exceptNum > static_cast<int>(OperationState::NoExcept)) {
+				OperationArgument operationArg(operation, leftLengthArg, rightLengthArg);
+				ExceptionHandlerr handler(ExceptionState::ArithmeticException, exceptNum);
+				handler.addArgument(operationArg);
+				handler.handleException();
+			}
+		}
+
+		void handleIndexException(const size_t row, const size_t col, const size_t height, const size_t width)
+		{
+			int exceptNum = ExceptionHandlerr::checkRowIndex(row, height);
+			exceptNum += ExceptionHandlerr::checkColumnIndex(col, width);
+			if (exceptNum > static_cast<int>(IndexState::NoExcept)) {
+				RowIndexArgument rowIndexArg(row, height);
+				ColumnIndexArgument colIndexArg(col, width);
+				ExceptionHandlerr handler(ExceptionState::OutOfRange, exceptNum);
+				handler.addArgument(rowIndexArg);
+				handler.addArgument(colIndexArg);
+				handler.handleException();
+			}
+		}
+
+		Dense fromMatrix(const Matrixx& matrix)
+		{
+			Dense dense(matrix.height(), matrix.width());
+			for (size_t row = 0; row < dense.height; row++) {
+				const Roww& matrixRow = matrix[row];
+				double* denseRow = dense.row(row);
+				for (size_t col = 0; col < dense.width; col++) {
+					denseRow[col] = matrixRow[col];
+				}
+			}
+			return dense;
+		}
+		Dense fromColumns(const Vectorr& vector)
+		{
+			Dense dense(vector.size(), 1);
+			for (size_t row = 0; row < dense.height; row++) {
+				dense.entries[row] = vector[row];
+			}
+			return dense;
+		}
+		Matrixx toMatrix(const Dense& dense)
+		{
+			Matrixx matrix(dense.height, dense.width);
+			for (size_t row = 0; row < dense.height; row++) {
+				Roww& matrixRow = matrix[row];
+				const double* denseRow = dense.row(row);
+				for (size_t col = 0; col < dense.width; col++) {
+					matrixRow[col] = denseRow[col];
+				}
+			}
+			return matrix;
+		}
+		std::vector<double> fromVector(const Vectorr& vector)
+		{
+			std::vector<double> entries(vector.size());
+			for (size_t row = 0; row < entries.size(); row++) {
+				entries[row] = vector[row];
+			}
+			return entries;
+		}
+		Vectorr toVector(const std::vector<double>& entries)
+		{
+			return toVector(entries.data(), entries.size());
+		}
+		Vectorr toVector(const double* entries, const size_t size)
+		{
+			Vectorr vector(size);
+			for (size_t row = 0; row < size; row++) {
+				vector[row] = entries[row];
+			}
+			return vector;
+		}
+		bool isSymmetric(const Dense& dense)
+		{
+			if (dense.height != dense.width) {
+				return false;
+			}
+			double maxAbsoluteEntry = 0.0;
+			for (const double entry : dense.entries) {
+				maxAbsoluteEntry = std::max(maxAbsoluteEntry, std::abs(entry));
+			}
+			const double tolerance = 1e-12 * maxAbsoluteEntry;
+			for (size_t row = 0; row < dense.height; row++) {
+				for (size_t col = 0; col < row; col++) {
+					if (std::abs(dense(row, col) - dense(col, row)) > tolerance) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+		Compressed compress(const Dense& dense, const bool keepDiagonal)
+		{
+			Compressed compressed(dense.height, dense.width);
+			for (size_t row = 0; row < dense.height; row++) {
+				const double* denseRow = dense.row(row);
+				for (size_t col = 0; col < dense.width; col++) {
+					if (denseRow[col] != 0.0 || (keepDiagonal && row == col)) {
+						compressed.indices.push_back(col);
+						compressed.values.push_back(denseRow[col]);
+					}
+				}
+				compressed.offsets[row + 1] = compressed.indices.size();
+			}
+			return compressed;
+		}
+		Compressed fromSparse(const SparseMatrix& sparse)
+		{
+			Compressed compressed(sparse.height(), sparse.width());
+			compressed.offsets = sparse.rowOffsets();
+			compressed.indices = sparse.columnIndices();
+			compressed.values = sparse.values();
+			return compressed;
+		}
+		SparseMatrix toSparse(const Compressed& compressed)
+		{
+			return SparseMatrix::fromCompressedRows(compressed.height, compressed.width,
+				compressed.offsets, compressed.indices, compressed.values);
+		}
+
+		namespace {
+			template <typename From, typename To>
+			void convertOf(const size_t length, const From* x, To* y)
+			{
+				parallelFor(0, length, [&](const size_t begin, const size_t end) {
+					for (size_t index = begin; index < end; index++) {
+						y[index] = static_cast<To>(x[index]);
+					}
+				}, 1 << 16);
+			}
+		}
+
+		void convert(const size_t length, const double* x, float* y)
+		{
+			convertOf(length, x, y);
+		}
+		void convert(const size_t length, const float* x, double* y)
+		{
+			convertOf(length, x, y);
+		}
+		DenseF toSingle(const Dense& dense)
+		{
+			DenseF single(dense.height, dense.width);
+			convert(dense.entries.size(), dense.data(), single.data());
+			return single;
+		}
+		Dense toDouble(const DenseF& dense)
+		{
+			Dense converted(dense.height, dense.width);
+			convert(dense.entries.size(), dense.data(), converted.data());
+			return converted;
+		}
+
+
+
+
+
+		namespace {
+			// Nested parallel loops run serially on the calling worker to avoid oversubscription
+			thread_local bool insideParallelRegion = false;
+			std::atomic<size_t> threadCountOverride(0);
+
+			// Marks the current thread as a parallel worker and restores the flag when the chunk ends or throws
+			class ParallelRegionGuard {
+			public:
+				ParallelRegionGuard() : mOuter(insideParallelRegion)
+				{
+					insideParallelRegion = true;
+				}
+				~ParallelRegionGuard()
+				{
+					insideParallelRegion = mOuter;
+				}
+			private:
+				bool mOuter;
+			};
+		}
+
+		size_t threadCount()
+		{
+			static const size_t count = std::max<size_t>(1, std::thread::hardware_concurrency());
+			const size_t forced = threadCountOverride.load();
+			return (forced > 0) ? forced : count;
+		}
+		void setThreadCount(const size_t count)
+		{
+			threadCountOverride = count;
+		}
+
+		void parallelFor(const size_t begin, const size_t end,
+			const std::function<void(const size_t, const size_t)>& body, const size_t grain)
+		{
+			if (end <= begin) {
+				return;
+			}
+			const size_t length = end - begin;
+			const size_t chunkCount = std::min(threadCount(), (length + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1));
+			if (chunkCount <= 1 || insideParallelRegion) {
+				body(begin, end);
+				return;
+			}
+
+			// Exceptions of each chunk are caught on its thread and the first one is rethrown after every thread is joined
+			const size_t chunkLength = (length + chunkCount - 1) / chunkCount;
+			std::vector<std::exception_ptr> exceptions(chunkCount);
+			auto worker = [&body, &exceptions](const size_t chunk, const size_t chunkBegin, const size_t chunkEnd) {
+				ParallelRegionGuard guard;
+				try {
+					body(chunkBegin, chunkEnd);
+				}
+				catch (...) {
+					exceptions[chunk] = std::current_exception();
+				}
+			};
+
+			// Chunks left without a thread (thread creation failed) run on the calling thread
+			std::vector<std::thread> workers;
+			workers.reserve(chunkCount - 1);
+			size_t chunk = 1;
+			for (; chunk < chunkCount && begin + chunk * chunkLength < end; chunk++) {
+				try {
+					workers.emplace_back(worker, chunk, begin + chunk * chunkLength, std::min(begin + (chunk + 1) * chunkLength, end));
+				}
+				catch (const std::system_error&) {
+					break;
+				}
+			}
+			worker(0, begin, begin + chunkLength);
+			for (; chunk < chunkCount && begin + chunk * chunkLength < end; chunk++) {
+				worker(chunk, begin + chunk * chunkLength, std::min(begin + (chunk + 1) * chunkLength, end));
+			}
+			for (std::thread& thread : workers) {
+				thread.join();
+			}
+			for (const std::exception_ptr& exception : exceptions) {
+				if (exception) {
+					std::rethrow_exception(exception);
+				}
+			}
+		}
+
+
+
+
+
+		namespace {
+			template <typename Scalar>
+			Scalar dotOf(const size_t length, const Scalar* x, const Scalar* y)
+			{
+				Scalar sum = 0;
+				for (size_t index = 0; index < length; index++) {
+					sum += x[index] * y[index];
+				}
+				return sum;
+			}
+			template <typename Scalar>
+			void axpyOf(const size_t length, const Scalar alpha, const Scalar* x, Scalar* y)
+			{
+				for (size_t index = 0; index < length; index++) {
+					y[index] += alpha * x[index];
+				}
+			}
+			template <typename Scalar>
+			void scaleOf(const size_t length, const Scalar alpha, Scalar* x)
+			{
+				for (size_t index = 0; index < length; index++) {
+					x[index] *= alpha;
+				}
+			}
+		}
+
+		double dot(const size_t length, const double* x, const double* y)
+		{
+			return dotOf(length, x, y);
+		}
+		float dot(const size_t length, const float* x, const float* y)
+		{
+			return dotOf(length, x, y);
+		}
+		void axpy(const size_t length, const double alpha, const double* x, double* y)
+		{
+			axpyOf(length, alpha, x, y);
+		}
+		void axpy(const size_t length, const float alpha, const float* x, float* y)
+		{
+			axpyOf(length, alpha, x, y);
+		}
+		void scale(const size_t length, const double alpha, double* x)
+		{
+			scaleOf(length, alpha, x);
+		}
+		void scale(const size_t length, const float alpha, float* x)
+		{
+			scaleOf(length, alpha, x);
+		}
+		double norm2(const size_t length, const double* x)
+		{
+			double maxAbsolute = 0.0;
+			for (size_t index = 0; index < length; index++) {
+				maxAbsolute = std::max(maxAbsolute, std::abs(x[index]));
+			}
+			if (maxAbsolute == 0.0 || !std::isfinite(maxAbsolute)) {
+				return maxAbsolute;
+			}
+			double sum = 0.0;
+			for (size_t index = 0; index < length; index++) {
+				const double scaled = x[index] / maxAbsolute;
+				sum += scaled * scaled;
+			}
+			return maxAbsolute * std::sqrt(sum);
+		}
+		double oneNorm(const size_t height, const size_t width, const double* a, const size_t lda)
+		{
+			std::vector<double> columnSums(width, 0.0);
+			for (size_t row = 0; row < height; row++) {
+				for (size_t col = 0; col < width; col++) {
+					columnSums[col] += std::abs(a[row * lda + col]);
+				}
+			}
+			return width == 0 ? 0.0 : *std::max_element(columnSums.begin(), columnSums.end());
+		}
+
+
+
+
+
+		namespace {
+			template <typename Scalar>
+			void gemvOf(const Trans trans, const size_t height, const size_t width,
+				const Scalar alpha, const Scalar* a, const size_t lda,
+				const Scalar* x, const Scalar beta, Scalar* y)
+			{
+				if (trans == Trans::NoTrans) {
+					parallelFor(0, height, [&](const size_t rowBegin, const size_t rowEnd) {
+						for (size_t row = rowBegin; row < rowEnd; row++) {
+							const Scalar product = alpha * dot(width, a + row * lda, x);
+							y[row] = (beta == 0) ? product : beta * y[row] + product;
+						}
+					}, std::max<size_t>(1, 8192 / (width + 1)));
+				}
+				else {
+					// y is (width), accumulate rows of A to keep access contiguous, parallel over column chunks
+					parallelFor(0, width, [&](const size_t colBegin, const size_t colEnd) {
+						const size_t chunkWidth = colEnd - colBegin;
+						if (beta == 0) {
+							std::fill(y + colBegin, y + colEnd, Scalar(0));
+						}
+						else if (beta != 1) {
+							scale(chunkWidth, beta, y + colBegin);
+						}
+						for (size_t row = 0; row < height; row++) {
+							axpy(chunkWidth, alpha * x[row], a + row * lda + colBegin, y + colBegin);
+						}
+					}, std::max<size_t>(256, 8192 / (height + 1)));
+				}
+			}
+		}
+
+		void gemv(const Trans trans, const size_t height, const size_t width,
+			const double alpha, const double* a, const size_t lda,
+			const double* x, const double beta, double* y)
+		{
+			gemvOf(trans, height, width, alpha, a, lda, x, beta, y);
+		}
+		void gemv(const Trans trans, const size_t height, const size_t width,
+			const float alpha, const float* a, const size_t lda,
+			const float* x, const float beta, float* y)
+		{
+			gemvOf(trans, height, width, alpha, a, lda, x, beta, y);
+		}
+
+		void symv(const size_t length, const double alpha, const double* a, const size_t lda,
+			const double* x, const double beta, double* y)
+		{
+			// Each stored entry is read once for both (row, col) and (col, row) contributions,
+			// contributions to other rows go to a buffer per part and are summed afterwards
+			const size_t partCount = std::min(threadCount(), length / 256 + 1);
+			std::vector<std::vector<double>> buffers(partCount, std::vector<double>(length, 0.0));
+			parallelFor(0, partCount, [&](const size_t partBegin, const size_t partEnd) {
+				for (size_t part = partBegin; part < partEnd; part++) {
+					double* buffer = buffers[part].data();
+					// Rows are dealt in pairs (i, length - 1 - i) so that parts hold the same area
+					for (size_t pair = part; pair < (length + 1) / 2; pair += partCount) {
+						const size_t rows[2] = { pair, length - 1 - pair };
+						for (size_t index = 0; index < ((rows[0] == rows[1]) ? 1u : 2u); index++) {
+							const size_t row = rows[index];
+							const double* aRow = a + row * lda;
+							const double xRow = x[row];
+							double sum = 0.0;
+							for (size_t col = 0; col < row; col++) {
+								sum += aRow[col] * x[col];
+								buffer[col] += aRow[col] * xRow;
+							}
+							buffer[row] += sum + aRow[row] * xRow;
+						}
+					}
+				}
+			});
+			for (size_t row = 0; row < length; row++) {
+				double sum = 0.0;
+				for (size_t part = 0; part < partCount; part++) {
+					sum += buffers[part][row];
+				}
+				y[row] = (beta == 0.0) ? alpha * sum : beta * y[row] + alpha * sum;
+			}
+		}
+
+		void trsv(const Uplo uplo, const Trans trans, const Diag diag, const size_t length,
+			const double* a, const size_t lda, double* x)
+		{
+			const bool unit = (diag == Diag::Unit);
+
+			// Unblocked substitution of diagonal block [blockBegin, blockEnd) of op(A)
+			auto solveDiagonalBlock = [&](const size_t blockBegin, const size_t blockEnd) {
+				const double* block = a + blockBegin * lda + blockBegin;
+				double* part = x + blockBegin;
+				const size_t blockLength = blockEnd - blockBegin;
+				if (trans == Trans::NoTrans) {
+					// Row oriented substitution
+					if (uplo == Uplo::Lower) {
+						for (size_t row = 0; row < blockLength; row++) {
+							part[row] -= dot(row, block + row * lda, part);
+							if (!unit) {
+								part[row] /= block[row * lda + row];
+							}
+						}
+					}
+					else {
+						for (size_t row = blockLength; row-- > 0;) {
+							part[row] -= dot(blockLength - row - 1, block + row * lda + row + 1, part + row + 1);
+							if (!unit) {
+								part[row] /= block[row * lda + row];
+							}
+						}
+					}
+				}
+				else {
+					// Column oriented substitution reads rows of A contiguously
+					if (uplo == Uplo::Lower) {
+						for (size_t row = blockLength; row-- > 0;) {
+							if (!unit) {
+								part[row] /= block[row * lda + row];
+							}
+							axpy(row, -part[row], block + row * lda, part);
+						}
+					}
+					else {
+						for (size_t row = 0; row < blockLength; row++) {
+							if (!unit) {
+								part[row] /= block[row * lda + row];
+							}
+							axpy(blockLength - row - 1, -part[row], block + row * lda + row + 1, part + row + 1);
+						}
+					}
+				}
+			};
+
+			// Blocks of op(A) off the diagonal are applied with (parallel) gemv
+			auto offDiagonalOf = [&](const size_t row, const size_t col) {
+				return (trans == Trans::NoTrans) ? a + row * lda + col : a + col * lda + row;
+			};
+			auto update = [&](const size_t blockBegin, const size_t blockEnd, const size_t joinBegin, const size_t joinEnd) {
+				const size_t blockLength = blockEnd - blockBegin, joinLength = joinEnd - joinBegin;
+				if (trans == Trans::NoTrans) {
+					gemv(Trans::NoTrans, blockLength, joinLength, -1.0, offDiagonalOf(blockBegin, joinBegin), lda,
+						x + joinBegin, 1.0, x + blockBegin);
+				}
+				else {
+					gemv(Trans::Trans, joinLength, blockLength, -1.0, offDiagonalOf(blockBegin, joinBegin), lda,
+						x + joinBegin, 1.0, x + blockBegin);
+				}
+			};
+
+			if ((uplo == Uplo::Lower) == (trans == Trans::NoTrans)) {
+				for (size_t blockBegin = 0; blockBegin < length; blockBegin += blockSize) {
+					const size_t blockEnd = std::min(blockBegin + blockSize, length);
+					if (blockBegin > 0) {
+						update(blockBegin, blockEnd, 0, blockBegin);
+					}
+					solveDiagonalBlock(blockBegin, blockEnd);
+				}
+			}
+			else {
+				for (size_t blockEnd = length; blockEnd > 0;) {
+					const size_t blockBegin = (blockEnd > blockSize) ? blockEnd - blockSize : 0;
+					if (blockEnd < length) {
+						update(blockBegin, blockEnd, blockEnd, length);
+					}
+					solveDiagonalBlock(blockBegin, blockEnd);
+					blockEnd = blockBegin;
+				}
+			}
+		}
+
+
+
+
+
+		namespace {
+			template <typename Scalar>
+			void gemmOf(const Trans transA, const Trans transB, const size_t height, const size_t width, const size_t join,
+				const Scalar alpha, const Scalar* a, const size_t lda, const Scalar* b, const size_t ldb,
+				const Scalar beta, Scalar* c, const size_t ldc)
+			{
+				if (height == 0 || width == 0) {
+					return;
+				}
+
+				// Pack transposed operands so that the inner loop always streams contiguous rows
+				std::vector<Scalar> packedA, packedB;
+				const Scalar* opA = a;
+				const Scalar* opB = b;
+				size_t ldOpA = lda, ldOpB = ldb;
+				if (transA == Trans::Trans && alpha != 0) {
+					packedA.resize(height * join);
+					for (size_t inner = 0; inner < join; inner++) {
+						for (size_t row = 0; row < height; row++) {
+							packedA[row * join + inner] = a[inner * lda + row];
+						}
+					}
+					opA = packedA.data();
+					ldOpA = join;
+				}
+				if (transB == Trans::Trans && alpha != 0) {
+					packedB.resize(join * width);
+					for (size_t col = 0; col < width; col++) {
+						for (size_t inner = 0; inner < join; inner++) {
+							packedB[inner * width + col] = b[col * ldb + inner];
+						}
+					}
+					opB = packedB.data();
+					ldOpB = width;
+				}
+
+				constexpr size_t joinBlock = 128, widthBlock = 512;
+				const size_t grain = std::max<size_t>(1, (1 << 16) / (width * join + 1));
+				parallelFor(0, height, [&](const size_t rowBegin, const size_t rowEnd) {
+					for (size_t row = rowBegin; row < rowEnd; row++) {
+						Scalar* cRow = c + row * ldc;
+						if (beta == 0) {
+							std::fill(cRow, cRow + width, Scalar(0));
+						}
+						else if (beta != 1) {
+							scale(width, beta, cRow);
+						}
+					}
+					if (alpha == 0) {
+						return;
+					}
+					for (size_t colBegin = 0; colBegin < width; colBegin += widthBlock) {
+						const size_t colEnd = std::min(colBegin + widthBlock, width);
+						for (size_t innerBegin = 0; innerBegin < join; innerBegin += joinBlock) {
+							const size_t innerEnd = std::min(innerBegin + joinBlock, join);
+							for (size_t row = rowBegin; row < rowEnd; row++) {
+								Scalar* cRow = c + row * ldc;
+								const Scalar* aRow = opA + row * ldOpA;
+								for (size_t inner = innerBegin; inner < innerEnd; inner++) {
+									const Scalar multiplier = alpha * aRow[inner];
+									if (multiplier == 0) {
+										continue;
+									}
+									const Scalar* bRow = opB + inner * ldOpB;
+									for (size_t col = colBegin; col < colEnd; col++) {
+										cRow[col] += multiplier * bRow[col];
+									}
+								}
+							}
+						}
+					}
+				}, grain);
+			}
+
+			template <typename Scalar>
+			BasicDense<Scalar> multiplyOf(const BasicDense<Scalar>& a, const BasicDense<Scalar>& b, const Trans transA, const Trans transB)
+			{
+				const size_t height = (transA == Trans::NoTrans) ? a.height : a.width;
+				const size_t width = (transB == Trans::NoTrans) ? b.width : b.height;
+				const size_t join = (transA == Trans::NoTrans) ? a.width : a.height;
+				BasicDense<Scalar> c(height, width);
+				gemmOf(transA, transB, height, width, join, Scalar(1), a.data(), a.width, b.data(), b.width, Scalar(0), c.data(), c.width);
+				return c;
+			}
+		}
+
+		void gemm(const Trans transA, const Trans transB, const size_t height, const size_t width, const size_t join,
+			const double alpha, const double* a, const size_t lda, const double* b, const size_t ldb,
+			const double beta, double* c, const size_t ldc)
+		{
+			gemmOf(transA, transB, height, width, join, alpha, a, lda, b, ldb, beta, c, ldc);
+		}
+		void gemm(const Trans transA, const Trans transB, const size_t height, const size_t width, const size_t join,
+			const float alpha, const float* a, const size_t lda, const float* b, const size_t ldb,
+			const float beta, float* c, const size_t ldc)
+		{
+			gemmOf(transA, transB, height, width, join, alpha, a, lda, b, ldb, beta, c, ldc);
+		}
+		void gemm(const Trans transA, const Trans transB,
+			const double alpha, const Dense& a, const Dense& b, const double beta, Dense& c)
+		{
+			const size_t join = (transA == Trans::NoTrans) ? a.width : a.height;
+			gemm(transA, transB, c.height, c.width, join,
+				alpha, a.data(), a.width, b.data(), b.width, beta, c.data(), c.width);
+		}
+		void gemm(const Trans transA, const Trans transB,
+			const float alpha, const DenseF& a, const DenseF& b, const float beta, DenseF& c)
+		{
+			const size_t join = (transA == Trans::NoTrans) ? a.width : a.height;
+			gemm(transA, transB, c.height, c.width, join,
+				alpha, a.data(), a.width, b.data(), b.width, beta, c.data(), c.width);
+		}
+		Dense multiply(const Dense& a, const Dense& b, const Trans transA, const Trans transB)
+		{
+			return multiplyOf(a, b, transA, transB);
+		}
+		DenseF multiply(const DenseF& a, const DenseF& b, const Trans transA, const Trans transB)
+		{
+			return multiplyOf(a, b, transA, transB);
+		}
+
+		namespace {
+			template <typename Scalar>
+			void syrkOf(const size_t length, const size_t join,
+				const Scalar alpha, const Scalar* a, const size_t lda, const Scalar beta, Scalar* c, const size_t ldc)
+			{
+				// Row i holds i + 1 entries, so pair row i with row (length - 1 - i) to balance workers
+				const size_t pairCount = (length + 1) / 2;
+				parallelFor(0, pairCount, [&](const size_t pairBegin, const size_t pairEnd) {
+					for (size_t pair = pairBegin; pair < pairEnd; pair++) {
+						const size_t rows[2] = { pair, length - 1 - pair };
+						for (size_t index = 0; index < ((rows[0] == rows[1]) ? 1u : 2u); index++) {
+							const size_t row = rows[index];
+							Scalar* cRow = c + row * ldc;
+							const Scalar* aRow = a + row * lda;
+							for (size_t col = 0; col <= row; col++) {
+								const Scalar product = alpha * dot(join, aRow, a + col * lda);
+								cRow[col] = (beta == Scalar(0)) ? product : beta * cRow[col] + product;
+							}
+						}
+					}
+				}, std::max<size_t>(1, 8192 / (length * join + 1)));
+			}
+		}
+
+		void syrk(const size_t length, const size_t join,
+			const double alpha, const double* a, const size_t lda, const double beta, double* c, const size_t ldc)
+		{
+			syrkOf(length, join, alpha, a, lda, beta, c, ldc);
+		}
+		void syrk(const size_t length, const size_t join,
+			const float alpha, const float* a, const size_t lda, const float beta, float* c, const size_t ldc)
+		{
+			syrkOf(length, join, alpha, a, lda, beta, c, ldc);
+		}
+
+		void gemmt(const size_t length, const size_t join, const double alpha, const double* a, const size_t lda,
+			const double* b, const size_t ldb, const double beta, double* c, const size_t ldc)
+		{
+			// Row block i covers (i + 1) column blocks, so pair block i with block (count - 1 - i) to balance workers
+			const size_t blockCount = (length + blockSize - 1) / blockSize, pairCount = (blockCount + 1) / 2;
+			parallelFor(0, pairCount, [&](const size_t pairBegin, const size_t pairEnd) {
+				Dense diagonal(blockSize, blockSize);
+				for (size_t pair = pairBegin; pair < pairEnd; pair++) {
+					const size_t blocks[2] = { pair, blockCount - 1 - pair };
+					for (size_t index = 0; index < ((blocks[0] == blocks[1]) ? 1u : 2u); index++) {
+						const size_t rowBegin = blocks[index] * blockSize, height = std::min(blockSize, length - rowBegin);
+						// Strictly lower block row, then lower part of diagonal block through a buffer
+						gemm(Trans::NoTrans, Trans::Trans, height, rowBegin, join, alpha, a + rowBegin * lda, lda,
+							b, ldb, beta, c + rowBegin * ldc, ldc);
+						gemm(Trans::NoTrans, Trans::Trans, height, height, join, alpha, a + rowBegin * lda, lda,
+							b + rowBegin * ldb, ldb, 0.0, diagonal.data(), blockSize);
+						for (size_t row = 0; row < height; row++) {
+							double* cRow = c + (rowBegin + row) * ldc + rowBegin;
+							for (size_t col = 0; col <= row; col++) {
+								cRow[col] = (beta == 0.0) ? diagonal(row, col) : beta * cRow[col] + diagonal(row, col);
+							}
+						}
+					}
+				}
+			});
+		}
+
+		namespace {
+			template <typename Scalar>
+			void trsmOf(const Side side, const Uplo uplo, const Trans trans, const Diag diag,
+				const size_t height, const size_t width,
+				const Scalar* a, const size_t lda, Scalar* b, const size_t ldb)
+			{
+				if (height == 0 || width == 0) {
+					return;
+				}
+				if (side == Side::Right) {
+					// X * op(A) = B  <=>  op(A)^T * X^T = B^T
+					BasicDense<Scalar> transposed(width, height);
+					for (size_t row = 0; row < height; row++) {
+						for (size_t col = 0; col < width; col++) {
+							transposed(col, row) = b[row * ldb + col];
+						}
+					}
+					const Trans flipped = (trans == Trans::NoTrans) ? Trans::Trans : Trans::NoTrans;
+					trsmOf(Side::Left, uplo, flipped, diag, width, height, a, lda, transposed.data(), transposed.width);
+					for (size_t row = 0; row < height; row++) {
+						for (size_t col = 0; col < width; col++) {
+							b[row * ldb + col] = transposed(col, row);
+						}
+					}
+					return;
+				}
+
+				// Entry (row, col) of op(A) and the sub-block pointer starting from it
+				auto entry = [&](const size_t row, const size_t col) {
+					return (trans == Trans::NoTrans) ? a[row * lda + col] : a[col * lda + row];
+				};
+				auto blockOf = [&](const size_t row, const size_t col) {
+					return (trans == Trans::NoTrans) ? a + row * lda + col : a + col * lda + row;
+				};
+				const bool forward = ((uplo == Uplo::Lower) == (trans == Trans::NoTrans));
+				const bool unit = (diag == Diag::Unit);
+
+				// Unblocked substitution of a diagonal block, parallel over column chunks of B
+				auto solveDiagonalBlock = [&](const size_t blockBegin, const size_t blockEnd) {
+					parallelFor(0, width, [&](const size_t colBegin, const size_t colEnd) {
+						const size_t chunkWidth = colEnd - colBegin;
+						if (forward) {
+							for (size_t row = blockBegin; row < blockEnd; row++) {
+								Scalar* bRow = b + row * ldb + colBegin;
+								for (size_t inner = blockBegin; inner < row; inner++) {
+									axpy(chunkWidth, -entry(row, inner), b + inner * ldb + colBegin, bRow);
+								}
+								if (!unit) {
+									scale(chunkWidth, Scalar(1) / entry(row, row), bRow);
+								}
+							}
+						}
+						else {
+							for (size_t row = blockEnd; row-- > blockBegin;) {
+								Scalar* bRow = b + row * ldb + colBegin;
+								for (size_t inner = row + 1; inner < blockEnd; inner++) {
+									axpy(chunkWidth, -entry(row, inner), b + inner * ldb + colBegin, bRow);
+								}
+								if (!unit) {
+									scale(chunkWidth, Scalar(1) / entry(row, row), bRow);
+								}
+							}
+						}
+					}, std::max<size_t>(16, 4096 / (blockEnd - blockBegin + 1)));
+				};
+
+				if (forward) {
+					for (size_t blockBegin = 0; blockBegin < height; blockBegin += blockSize) {
+						const size_t blockEnd = std::min(blockBegin + blockSize, height);
+						if (blockBegin > 0) {
+							gemm(trans, Trans::NoTrans, blockEnd - blockBegin, width, blockBegin,
+								Scalar(-1), blockOf(blockBegin, 0), lda, b, ldb, Scalar(1), b + blockBegin * ldb, ldb);
+						}
+						solveDiagonalBlock(blockBegin, blockEnd);
+					}
+				}
+				else {
+					for (size_t blockEnd = height; blockEnd > 0;) {
+						const size_t blockBegin = (blockEnd > blockSize) ? blockEnd - blockSize : 0;
+						if (blockEnd < height) {
+							gemm(trans, Trans::NoTrans, blockEnd - blockBegin, width, height - blockEnd,
+								Scalar(-1), blockOf(blockBegin, blockEnd), lda, b + blockEnd * ldb, ldb, Scalar(1), b + blockBegin * ldb, ldb);
+						}
+						solveDiagonalBlock(blockBegin, blockEnd);
+						blockEnd = blockBegin;
+					}
+				}
+			}
+		}
+
+		void trsm(const Side side, const Uplo uplo, const Trans trans, const Diag diag,
+			const size_t height, const size_t width,
+			const double* a, const size_t lda, double* b, const size_t ldb)
+		{
+			trsmOf(side, uplo, trans, diag, height, width, a, lda, b, ldb);
+		}
+		void trsm(const Side side, const Uplo uplo, const Trans trans, const Diag diag,
+			const size_t height, const size_t width,
+			const float* a, const size_t lda, float* b, const size_t ldb)
+		{
+			trsmOf(side, uplo, trans, diag, height, width, a, lda, b, ldb);
+		}
+
+
+
+
+		namespace {
+			constexpr size_t integerBlock = 1 << 16; // 128 * 128 * 2^16 = 2^30 fits int32
+			constexpr size_t integerColumnBlock = 64; // Rows of B kept in cache while rows of A stream
+		}
+
+		int64_t dot(const size_t length, const int8_t* x, const int8_t* y)
+		{
+			int64_t sum = 0;
+			for (size_t blockBegin = 0; blockBegin < length; blockBegin += integerBlock) {
+				const size_t blockEnd = std::min(blockBegin + integerBlock, length);
+				int32_t blockSum = 0;
+				for (size_t index = blockBegin; index < blockEnd; index++) {
+					blockSum += static_cast<int32_t>(x[index]) * static_cast<int32_t>(y[index]);
+				}
+				sum += blockSum;
+			}
+			return sum;
+		}
+
+		void gemmInt8(const size_t height, const size_t width, const size_t join,
+			const int8_t* a, const size_t lda, const int8_t* b, const size_t ldb, int64_t* c, const size_t ldc)
+		{
+			parallelFor(0, height, [&](const size_t rowBegin, const size_t rowEnd) {
+				for (size_t colBegin = 0; colBegin < width; colBegin += integerColumnBlock) {
+					const size_t colEnd = std::min(colBegin + integerColumnBlock, width);
+					for (size_t row = rowBegin; row < rowEnd; row++) {
+						for (size_t col = colBegin; col < colEnd; col++) {
+							c[row * ldc + col] = dot(join, a + row * lda, b + col * ldb);
+						}
+					}
+				}
+			}, std::max<size_t>(1, (1 << 16) / (width * join + 1)));
+		}
+
+
+
+
+
+		namespace {
+			constexpr size_t sparseGrain = 8192; // Minimum nonzero products per parallel chunk
+
+			// Runs body over row chunks of A with about equal nonzero count, work is the cost of one nonzero
+			void parallelRows(const Compressed& a, const size_t work, const std::function<void(const size_t, const size_t)>& body)
+			{
+				const size_t nonZeroCount = a.offsets[a.height];
+				const size_t chunkCount = std::max<size_t>(1, std::min(threadCount(), nonZeroCount * work / sparseGrain));
+				std::vector<size_t> bounds(chunkCount + 1, a.height);
+				bounds[0] = 0;
+				for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+					bounds[chunk] = std::lower_bound(a.offsets.begin(), a.offsets.end(), nonZeroCount * chunk / chunkCount) - a.offsets.begin();
+				}
+				parallelFor(0, chunkCount, [&bounds, &body](const size_t chunkBegin, const size_t chunkEnd) {
+					for (size_t chunk = chunkBegin; chunk < chunkEnd; chunk++) {
+						body(bounds[chunk], bounds[chunk + 1]);
+					}
+				});
+			}
+		}
+
+		void sortCompressed(Compressed& a)
+		{
+			// 1. Every row is sorted and merged at the front of its own range
+			std::vector<size_t> lengths(a.height);
+			auto mergeRows = [&](const size_t rowBegin, const size_t rowEnd) {
+				std::vector<std::pair<size_t, double>> entries;
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					const size_t begin = a.offsets[row], end = a.offsets[row + 1];
+					if (std::is_sorted(a.indices.begin() + begin, a.indices.begin() + end, std::less_equal<size_t>())) {
+						lengths[row] = end - begin;
+						continue;
+					}
+					entries.clear();
+					for (size_t index = begin; index < end; index++) {
+						entries.emplace_back(a.indices[index], a.values[index]);
+					}
+					std::sort(entries.begin(), entries.end(),
+						[](const std::pair<size_t, double>& left, const std::pair<size_t, double>& right) { return left.first < right.first; });
+					size_t position = begin;
+					for (size_t index = 0; index < entries.size(); index++) {
+						if (position > begin && a.indices[position - 1] == entries[index].first) {
+							a.values[position - 1] += entries[index].second;
+						}
+						else {
+							a.indices[position] = entries[index].first;
+							a.values[position++] = entries[index].second;
+						}
+					}
+					lengths[row] = position - begin;
+				}
+			};
+			parallelRows(a, 4, [&mergeRows](const size_t rowBegin, const size_t rowEnd) { mergeRows(rowBegin, rowEnd); });
+
+			// 2. Close the gaps left by merged duplicates
+			std::vector<size_t> offsets(a.height + 1, 0);
+			for (size_t row = 0; row < a.height; row++) {
+				offsets[row + 1] = offsets[row] + lengths[row];
+			}
+			if (offsets[a.height] == a.offsets[a.height]) {
+				return;
+			}
+			std::vector<size_t> indices(offsets[a.height]);
+			std::vector<double> values(offsets[a.height]);
+			auto compactRows = [&](const size_t rowBegin, const size_t rowEnd) {
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					std::copy_n(a.indices.begin() + a.offsets[row], lengths[row], indices.begin() + offsets[row]);
+					std::copy_n(a.values.begin() + a.offsets[row], lengths[row], values.begin() + offsets[row]);
+				}
+			};
+			parallelRows(a, 1, [&compactRows](const size_t rowBegin, const size_t rowEnd) { compactRows(rowBegin, rowEnd); });
+			a.offsets.swap(offsets);
+			a.indices.swap(indices);
+			a.values.swap(values);
+		}
+		void spmv(const double alpha, const Compressed& a, const double* x, const double beta, double* y)
+		{
+			auto multiplyRows = [&](const size_t rowBegin, const size_t rowEnd) {
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					double sum = 0.0;
+					for (size_t index = a.offsets[row]; index < a.offsets[row + 1]; index++) {
+						sum += a.values[index] * x[a.indices[index]];
+					}
+					y[row] = (beta == 0.0) ? alpha * sum : alpha * sum + beta * y[row];
+				}
+			};
+			parallelRows(a, 1, [&multiplyRows](const size_t rowBegin, const size_t rowEnd) { multiplyRows(rowBegin, rowEnd); });
+		}
+		void spmm(const size_t width, const double alpha, const Compressed& a, const double* b, const size_t ldb,
+			const double beta, double* c, const size_t ldc)
+		{
+			auto multiplyRows = [&](const size_t rowBegin, const size_t rowEnd) {
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					double* productRow = c + row * ldc;
+					if (beta == 0.0) {
+						std::fill(productRow, productRow + width, 0.0);
+					}
+					else if (beta != 1.0) {
+						scale(width, beta, productRow);
+					}
+					for (size_t index = a.offsets[row]; index < a.offsets[row + 1]; index++) {
+						axpy(width, alpha * a.values[index], b + a.indices[index] * ldb, productRow);
+					}
+				}
+			};
+			parallelRows(a, width, [&multiplyRows](const size_t rowBegin, const size_t rowEnd) { multiplyRows(rowBegin, rowEnd); });
+		}
+		Compressed spgemm(const Compressed& a, const Compressed& b)
+		{
+			constexpr size_t unmarked = std::numeric_limits<size_t>::max();
+			Compressed product(a.height, b.width);
+
+			// 1. Symbolic : distinct columns of every product row
+			std::vector<size_t> lengths(a.height);
+			auto countRows = [&](const size_t rowBegin, const size_t rowEnd) {
+				std::vector<size_t> marker(b.width, unmarked);
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					size_t length = 0;
+					for (size_t index = a.offsets[row]; index < a.offsets[row + 1]; index++) {
+						const size_t join = a.indices[index];
+						for (size_t rightIndex = b.offsets[join]; rightIndex < b.offsets[join + 1]; rightIndex++) {
+							if (marker[b.indices[rightIndex]] != row) {
+								marker[b.indices[rightIndex]] = row;
+								length++;
+							}
+						}
+					}
+					lengths[row] = length;
+				}
+			};
+			parallelRows(a, 4, [&countRows](const size_t rowBegin, const size_t rowEnd) { countRows(rowBegin, rowEnd); });
+			for (size_t row = 0; row < a.height; row++) {
+				product.offsets[row + 1] = product.offsets[row] + lengths[row];
+			}
+			product.indices.resize(product.offsets[a.height]);
+			product.values.resize(product.offsets[a.height]);
+
+			// 2. Numeric : accumulate each row in a dense workspace, then gather its columns in ascending order
+			auto multiplyRows = [&](const size_t rowBegin, const size_t rowEnd) {
+				std::vector<size_t> marker(b.width, unmarked);
+				std::vector<double> accumulator(b.width);
+				for (size_t row = rowBegin; row < rowEnd; row++) {
+					size_t* rowIndices = product.indices.data() + product.offsets[row];
+					size_t length = 0;
+					for (size_t index = a.offsets[row]; index < a.offsets[row + 1]; index++) {
+						const size_t join = a.indices[index];
+						for (size_t rightIndex = b.offsets[join]; rightIndex < b.offsets[join + 1]; rightIndex++) {
+							const size_t col = b.indices[rightIndex];
+							if (marker[col] != row) {
+								marker[col] = row;
+								accumulator[col] = a.values[index] * b.values[rightIndex];
+								rowIndices[length++] = col;
+							}
+							else {
+								accumulator[col] += a.values[index] * b.values[rightIndex];
+							}
+						}
+					}
+					std::sort(rowIndices, rowIndices + length);
+					for (size_t position = 0; position < length; position++) {
+						product.values[product.offsets[row] + position] = accumulator[rowIndices[position]];
+					}
+				}
+			};
+			parallelRows(a, 4, [&multiplyRows](const size_t rowBegin, const size_t rowEnd) { multiplyRows(rowBegin, rowEnd); });
+			return product;
+		}
+
+
+
+
+
+		double householder(const size_t length, double& alpha, double* x, const size_t increment)
+		{
+			if (length == 0) {
+				return 0.0;
+			}
+			double maxAbsolute = 0.0;
+			for (size_t index = 0; index < length; index++) {
+				maxAbsolute = std::max(maxAbsolute, std::abs(x[index * increment]));
+			}
+			if (maxAbsolute == 0.0) {
+				return 0.0;
+			}
+			double sum = 0.0;
+			for (size_t index = 0; index < length; index++) {
+				const double scaled = x[index * increment] / maxAbsolute;
+				sum += scaled * scaled;
+			}
+			const double tailNorm = maxAbsolute * std::sqrt(sum);
+			const double beta = -std::copysign(std::hypot(alpha, tailNorm), alpha);
+			const double tau = (beta - alpha) / beta;
+			const double multiplier = 1.0 / (alpha - beta);
+			for (size_t index = 0; index < length; index++) {
+				x[index * increment] *= multiplier;
+			}
+			alpha = beta;
+			return tau;
+		}
+
+		Dense reflectorFactor(const size_t height, const size_t count, const double* v, const size_t ldv, const double* tau)
+		{
+			Dense t(count, count);
+			std::vector<double> projection(count);
+			for (size_t col = 0; col < count; col++) {
+				t(col, col) = tau[col];
+				if (col == 0 || tau[col] == 0.0) {
+					continue;
+				}
+				// projection = V(:, 0:col)^T * v_col, v_col has implicit unit entry on row col
+				std::fill(projection.begin(), projection.begin() + col, 0.0);
+				axpy(col, 1.0, v + col * ldv, projection.data());
+				for (size_t row = col + 1; row < height; row++) {
+					axpy(col, v[row * ldv + col], v + row * ldv, projection.data());
+				}
+				// T(0:col, col) = -tau * T(0:col, 0:col) * projection
+				for (size_t row = 0; row < col; row++) {
+					t(row, col) = -tau[col] * dot(col - row, t.row(row) + row, projection.data() + row);
+				}
+			}
+			return t;
+		}
+
+		void applyReflectorBlock(const Trans trans, const size_t height, const size_t width, const size_t count,
+			const double* v, const size_t ldv, const Dense& t, double* b, const size_t ldb)
+		{
+			if (height == 0 || width == 0 || count == 0) {
+				return;
+			}
+			// Explicit unit lower trapezoidal V
+			Dense reflectors(height, count);
+			for (size_t row = 0; row < height; row++) {
+				for (size_t col = 0; col < std::min(row, count); col++) {
+					reflectors(row, col) = v[row * ldv + col];
+				}
+				if (row < count) {
+					reflectors(row, row) = 1.0;
+				}
+			}
+
+			// W = op(T) * V^T * B
+			Dense work(count, width);
+			gemm(Trans::Trans, Trans::NoTrans, count, width, height,
+				1.0, reflectors.data(), count, b, ldb, 0.0, work.data(), width);
+			if (trans == Trans::NoTrans) {
+				for (size_t row = 0; row < count; row++) {
+					double* workRow = work.row(row);
+					scale(width, t(row, row), workRow);
+					for (size_t inner = row + 1; inner < count; inner++) {
+						axpy(width, t(row, inner), work.row(inner), workRow);
+					}
+				}
+			}
+			else {
+				for (size_t row = count; row-- > 0;) {
+					double* workRow = work.row(row);
+					scale(width, t(row, row), workRow);
+					for (size_t inner = 0; inner < row; inner++) {
+						axpy(width, t(inner, row), work.row(inner), workRow);
+					}
+				}
+			}
+
+			// B -= V * W
+			gemm(Trans::NoTrans, Trans::NoTrans, height, width, count,
+				-1.0, reflectors.data(), count, work.data(), width, 1.0, b, ldb);
+		}
+
+
+		void householderQR(const size_t height, const size_t width, double* a, const size_t lda, double* tau)
+		{
+			const size_t reflectorCount = std::min(height, width);
+			std::vector<double> work(blockSize);
+			for (size_t blockBegin = 0; blockBegin < reflectorCount; blockBegin += blockSize) {
+				const size_t blockEnd = std::min(blockBegin + blockSize, reflectorCount);
+
+				// 1. Unblocked factorization of panel columns
+				for (size_t col = blockBegin; col < blockEnd; col++) {
+					double* diagonal = a + col * lda + col;
+					tau[col] = householder(height - col - 1, *diagonal, diagonal + ((col + 1 < height) ? lda : 0), lda);
+					if (tau[col] == 0.0 || col + 1 == blockEnd) {
+						continue;
+					}
+
+					// Apply H to the rest of panel row by row : w = A^T * v, A -= tau * v * w^T
+					const size_t restWidth = blockEnd - col - 1;
+					std::copy(diagonal + 1, diagonal + 1 + restWidth, work.begin());
+					for (size_t row = col + 1; row < height; row++) {
+						axpy(restWidth, a[row * lda + col], a + row * lda + col + 1, work.data());
+					}
+					axpy(restWidth, -tau[col], work.data(), diagonal + 1);
+					for (size_t row = col + 1; row < height; row++) {
+						axpy(restWidth, -tau[col] * a[row * lda + col], work.data(), a + row * lda + col + 1);
+					}
+				}
+				if (blockEnd == width) {
+					continue;
+				}
+
+				// 2. Trailing update with compact WY block : A2 = (I - V * T^T * V^T) * A2
+				const Dense t = reflectorFactor(height - blockBegin, blockEnd - blockBegin,
+					a + blockBegin * lda + blockBegin, lda, tau + blockBegin);
+				applyReflectorBlock(Trans::Trans, height - blockBegin, width - blockEnd, blockEnd - blockBegin,
+					a + blockBegin * lda + blockBegin, lda, t, a + blockBegin * lda + blockEnd, lda);
+			}
+		}
+
+
+
+
+
+		namespace {
+			template <typename Scalar>
+			bool choleskyFactorOf(const size_t length, Scalar* a, const size_t lda)
+			{
+				for (size_t blockBegin = 0; blockBegin < length; blockBegin += blockSize) {
+					const size_t blockEnd = std::min(blockBegin + blockSize, length);
+
+					// 1. Factor diagonal block (unblocked, left-looking inside the block)
+					for (size_t col = blockBegin; col < blockEnd; col++) {
+						Scalar* colRow = a + col * lda;
+						const Scalar pivot = colRow[col] - dot(col - blockBegin, colRow + blockBegin, colRow + blockBegin);
+						if (!(pivot > Scalar(0)) || !std::isfinite(pivot)) {
+							return false;
+						}
+						colRow[col] = std::sqrt(pivot);
+						for (size_t row = col + 1; row < blockEnd; row++) {
+							Scalar* factorRow = a + row * lda;
+							factorRow[col] = (factorRow[col] - dot(col - blockBegin, factorRow + blockBegin, colRow + blockBegin)) / colRow[col];
+						}
+					}
+					if (blockEnd == length) {
+						break;
+					}
+
+					// 2. Panel under diagonal block : L21 = A21 * L11^-T
+					const size_t trailing = length - blockEnd;
+					trsm(Side::Right, Uplo::Lower, Trans::Trans, Diag::NonUnit, trailing, blockEnd - blockBegin,
+						a + blockBegin * lda + blockBegin, lda, a + blockEnd * lda + blockBegin, lda);
+
+					// 3. Trailing update on lower triangle : A22 -= L21 * L21^T
+					syrk(trailing, blockEnd - blockBegin, Scalar(-1), a + blockEnd * lda + blockBegin, lda,
+						Scalar(1), a + blockEnd * lda + blockEnd, lda);
+				}
+				return true;
+			}
+			template <typename Scalar>
+			bool luFactorOf(const size_t length, Scalar* a, const size_t lda, size_t* pivots)
+			{
+				bool nonsingular = true;
+				for (size_t blockBegin = 0; blockBegin < length; blockBegin += blockSize) {
+					const size_t blockEnd = std::min(blockBegin + blockSize, length);
+
+					// 1. Unblocked factorization of panel columns, swapping whole rows
+					for (size_t col = blockBegin; col < blockEnd; col++) {
+						size_t pivot = col;
+						for (size_t row = col + 1; row < length; row++) {
+							if (std::abs(a[row * lda + col]) > std::abs(a[pivot * lda + col])) {
+								pivot = row;
+							}
+						}
+						pivots[col] = pivot;
+						if (pivot != col) {
+							std::swap_ranges(a + col * lda, a + col * lda + length, a + pivot * lda);
+						}
+						const Scalar pivotEntry = a[col * lda + col];
+						if (pivotEntry == Scalar(0)) {
+							nonsingular = false;
+							continue;
+						}
+						const Scalar* pivotRow = a + col * lda;
+						parallelFor(col + 1, length, [&](const size_t rowBegin, const size_t rowEnd) {
+							for (size_t row = rowBegin; row < rowEnd; row++) {
+								Scalar* currentRow = a + row * lda;
+								currentRow[col] /= pivotEntry;
+								axpy(blockEnd - col - 1, -currentRow[col], pivotRow + col + 1, currentRow + col + 1);
+							}
+						}, std::max<size_t>(64, 4096 / (blockEnd - col + 1)));
+					}
+					if (blockEnd == length) {
+						break;
+					}
+
+					// 2. U12 = L11^-1 * A12
+					trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::Unit, blockEnd - blockBegin, length - blockEnd,
+						a + blockBegin * lda + blockBegin, lda, a + blockBegin * lda + blockEnd, lda);
+					// 3. A22 -= L21 * U12
+					gemm(Trans::NoTrans, Trans::NoTrans, length - blockEnd, length - blockEnd, blockEnd - blockBegin,
+						Scalar(-1), a + blockEnd * lda + blockBegin, lda, a + blockBegin * lda + blockEnd, lda,
+						Scalar(1), a + blockEnd * lda + blockEnd, lda);
+				}
+				return nonsingular;
+			}
+
+			template <typename Scalar>
+			void luSolveOf(const Trans trans, const size_t length, const Scalar* a, const size_t lda, const size_t* pivots,
+				const size_t width, Scalar* b, const size_t ldb)
+			{
+				if (trans == Trans::NoTrans) {
+					// L * U * x = P * b
+					for (size_t row = 0; row < length; row++) {
+						if (pivots[row] != row) {
+							std::swap_ranges(b + row * ldb, b + row * ldb + width, b + pivots[row] * ldb);
+						}
+					}
+					trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::Unit, length, width, a, lda, b, ldb);
+					trsm(Side::Left, Uplo::Upper, Trans::NoTrans, Diag::NonUnit, length, width, a, lda, b, ldb);
+				}
+				else {
+					// U^T * L^T * (P * x) = b
+					trsm(Side::Left, Uplo::Upper, Trans::Trans, Diag::NonUnit, length, width, a, lda, b, ldb);
+					trsm(Side::Left, Uplo::Lower, Trans::Trans, Diag::Unit, length, width, a, lda, b, ldb);
+					for (size_t row = length; row-- > 0;) {
+						if (pivots[row] != row) {
+							std::swap_ranges(b + row * ldb, b + row * ldb + width, b + pivots[row] * ldb);
+						}
+					}
+				}
+			}
+		}
+
+		bool choleskyFactor(const size_t length, double* a, const size_t lda)
+		{
+			return choleskyFactorOf(length, a, lda);
+		}
+		bool choleskyFactor(const size_t length, float* a, const size_t lda)
+		{
+			return choleskyFactorOf(length, a, lda);
+		}
+		bool luFactor(const size_t length, double* a, const size_t lda, size_t* pivots)
+		{
+			return luFactorOf(length, a, lda, pivots);
+		}
+		bool luFactor(const size_t length, float* a, const size_t lda, size_t* pivots)
+		{
+			return luFactorOf(length, a, lda, pivots);
+		}
+		void luSolve(const Trans trans, const size_t length, const double* a, const size_t lda, const size_t* pivots,
+			const size_t width, double* b, const size_t ldb)
+		{
+			luSolveOf(trans, length, a, lda, pivots, width, b, ldb);
+		}
+		void luSolve(const Trans trans, const size_t length, const float* a, const size_t lda, const size_t* pivots,
+			const size_t width, float* b, const size_t ldb)
+		{
+			luSolveOf(trans, length, a, lda, pivots, width, b, ldb);
+		}
+
+		double luInverseNorm(const size_t length, const double* a, const size_t lda, const size_t* pivots)
+		{
+			Dense inverse(length, length);
+			for (size_t index = 0; index < length; index++) {
+				inverse(index, index) = 1.0;
+			}
+			luSolve(Trans::NoTrans, length, a, lda, pivots, length, inverse.data(), length);
+			return oneNorm(length, length, inverse.data(), length);
+		}
+
+
+
+
+
+		Dense orthonormalColumns(Dense columns)
+		{
+			std::vector<double> tau(columns.width);
+			householderQR(columns.height, columns.width, columns.data(), columns.width, tau.data());
+			Dense basis(columns.height, columns.width);
+			for (size_t index = 0; index < columns.width; index++) {
+				basis(index, index) = 1.0;
+			}
+			applyBidiagonalQ(columns.height, columns.width, columns.data(), columns.width, tau.data(),
+				basis.width, basis.data(), basis.width);
+			return basis;
+		}
+
+		void tridiagonalize(const size_t length, double* a, const size_t lda, double* d, double* e, double* tau)
+		{
+			if (length == 0) {
+				return;
+			}
+			// Panel of reflectors is accumulated as A - V * W^T - W * V^T (rows indexed globally),
+			// so the trailing matrix is touched once per panel with one lower triangular matrix-matrix product
+			Dense reflectors(length, blockSize), updates(length, blockSize);
+			std::vector<double> column(length), work(length), projection(blockSize), projectionUpdate(blockSize);
+			for (size_t panelBegin = 0; panelBegin + 1 < length; panelBegin += blockSize) {
+				const size_t panelCount = std::min(blockSize, length - 1 - panelBegin);
+				std::fill(reflectors.entries.begin(), reflectors.entries.end(), 0.0);
+				std::fill(updates.entries.begin(), updates.entries.end(), 0.0);
+
+				for (size_t index = 0; index < panelCount; index++) {
+					const size_t col = panelBegin + index, tailBegin = col + 1, tailLength = length - tailBegin;
+					// 1. Bring column col up to date with previous reflectors of the panel
+					const size_t columnLength = length - col;
+					for (size_t offset = 0; offset < columnLength; offset++) {
+						column[offset] = a[(col + offset) * lda + col];
+					}
+					if (index > 0) {
+						gemv(Trans::NoTrans, columnLength, index, -1.0, updates.row(col), blockSize,
+							reflectors.row(col), 1.0, column.data());
+						gemv(Trans::NoTrans, columnLength, index, -1.0, reflectors.row(col), blockSize,
+							updates.row(col), 1.0, column.data());
+					}
+					d[col] = column[0];
+
+					// 2. Reflector annihilating column col below subdiagonal, stored in place of those entries
+					double* vector = column.data() + 1;
+					tau[col] = householder(tailLength - 1, vector[0], vector + 1);
+					e[col] = vector[0];
+					vector[0] = 1.0;
+					for (size_t offset = 1; offset < tailLength; offset++) {
+						a[(tailBegin + offset) * lda + col] = vector[offset];
+					}
+					for (size_t offset = 0; offset < tailLength; offset++) {
+						reflectors(tailBegin + offset, index) = vector[offset];
+					}
+					if (tau[col] == 0.0) {
+						continue;
+					}
+
+					// 3. w = tau * A' * v - (tau^2 / 2) * (v^T * A' * v) * v, A' is the trailing matrix with panel updates
+					symv(tailLength, 1.0, a + tailBegin * lda + tailBegin, lda, vector, 0.0, work.data());
+					if (index > 0) {
+						gemv(Trans::Trans, tailLength, index, 1.0, updates.row(tailBegin), blockSize,
+							vector, 0.0, projection.data());
+						gemv(Trans::Trans, tailLength, index, 1.0, reflectors.row(tailBegin), blockSize,
+							vector, 0.0, projectionUpdate.data());
+						gemv(Trans::NoTrans, tailLength, index, -1.0, reflectors.row(tailBegin), blockSize,
+							projection.data(), 1.0, work.data());
+						gemv(Trans::NoTrans, tailLength, index, -1.0, updates.row(tailBegin), blockSize,
+							projectionUpdate.data(), 1.0, work.data());
+					}
+					scale(tailLength, tau[col], work.data());
+					axpy(tailLength, -0.5 * tau[col] * dot(tailLength, work.data(), vector), vector, work.data());
+					for (size_t offset = 0; offset < tailLength; offset++) {
+						updates(tailBegin + offset, index) = work[offset];
+					}
+				}
+
+				// 4. Trailing update A -= [V W] * [W V]^T on lower triangle
+				const size_t trailingBegin = panelBegin + panelCount, trailingLength = length - trailingBegin;
+				Dense left(trailingLength, 2 * panelCount), right(trailingLength, 2 * panelCount);
+				for (size_t row = 0; row < trailingLength; row++) {
+					std::copy(reflectors.row(trailingBegin + row), reflectors.row(trailingBegin + row) + panelCount, left.row(row));
+					std::copy(updates.row(trailingBegin + row), updates.row(trailingBegin + row) + panelCount, left.row(row) + panelCount);
+					std::copy(updates.row(trailingBegin + row), updates.row(trailingBegin + row) + panelCount, right.row(row));
+					std::copy(reflectors.row(trailingBegin + row), reflectors.row(trailingBegin + row) + panelCount, right.row(row) + panelCount);
+				}
+				gemmt(trailingLength, 2 * panelCount, -1.0, left.data(), left.width, right.data(), right.width,
+					1.0, a + trailingBegin * lda + trailingBegin, lda);
+			}
+			d[length - 1] = a[(length - 1) * lda + length - 1];
+		}
+
+		void applyTridiagonalQ(const size_t length, const double* a, const size_t lda, const double* tau,
+			const size_t width, double* b, const size_t ldb)
+		{
+			if (length < 2) {
+				return;
+			}
+			// Reflectors start one row below the diagonal, same layout as QR of the trailing (length - 1) rows
+			applyBidiagonalQ(length - 1, length - 1, a + lda, lda, tau, width, b + ldb, ldb);
+		}
+
+		void bidiagonalize(const size_t height, const size_t width, double* a, const size_t lda,
+			double* d, double* e, double* tauLeft, double* tauRight)
+		{
+			// Panel of reflector pairs is accumulated as A - V * Y^T - X * U^T (rows and columns indexed globally),
+			// so the trailing matrix is touched once per panel with two matrix-matrix products
+			Dense leftReflectors(height, blockSize), leftUpdates(height, blockSize);
+			Dense rightReflectors(width, blockSize), rightUpdates(width, blockSize);
+			std::vector<double> column(height), rowUpdate(width), columnUpdate(height), projection(blockSize), projectionUpdate(blockSize);
+			for (size_t panelBegin = 0; panelBegin < width; panelBegin += blockSize) {
+				const size_t panelCount = std::min(blockSize, width - panelBegin);
+				std::fill(leftReflectors.entries.begin(), leftReflectors.entries.end(), 0.0);
+				std::fill(leftUpdates.entries.begin(), leftUpdates.entries.end(), 0.0);
+				std::fill(rightReflectors.entries.begin(), rightReflectors.entries.end(), 0.0);
+				std::fill(rightUpdates.entries.begin(), rightUpdates.entries.end(), 0.0);
+
+				for (size_t index = 0; index < panelCount; index++) {
+					const size_t col = panelBegin + index, columnLength = height - col, rowLength = width - col - 1;
+					// 1. Bring column col up to date with previous reflector pairs of the panel
+					for (size_t offset = 0; offset < columnLength; offset++) {
+						column[offset] = a[(col + offset) * lda + col];
+					}
+					if (index > 0) {
+						gemv(Trans::NoTrans, columnLength, index, -1.0, leftReflectors.row(col), blockSize,
+							rightUpdates.row(col), 1.0, column.data());
+						gemv(Trans::NoTrans, columnLength, index, -1.0, leftUpdates.row(col), blockSize,
+							rightReflectors.row(col), 1.0, column.data());
+					}
+
+					// 2. Left reflector annihilating column col below diagonal
+					tauLeft[col] = householder(columnLength - 1, column[0], column.data() + 1);
+					d[col] = column[0];
+					column[0] = 1.0;
+					for (size_t offset = 0; offset < columnLength; offset++) {
+						leftReflectors(col + offset, index) = column[offset];
+					}
+					for (size_t offset = 1; offset < columnLength; offset++) {
+						a[(col + offset) * lda + col] = column[offset];
+					}
+					if (rowLength == 0) {
+						break;
+					}
+
+					// 3. y = tau * A'^T * v on columns right of col, A' is the panel updated matrix
+					double* row = a + col * lda + col + 1;
+					double* leftVector = column.data();
+					double* update = rowUpdate.data();
+					gemv(Trans::Trans, columnLength, rowLength, 1.0, row, lda, leftVector, 0.0, update);
+					if (index > 0) {
+						gemv(Trans::Trans, columnLength, index, 1.0, leftReflectors.row(col), blockSize,
+							leftVector, 0.0, projection.data());
+						gemv(Trans::Trans, columnLength, index, 1.0, leftUpdates.row(col), blockSize,
+							leftVector, 0.0, projectionUpdate.data());
+						gemv(Trans::NoTrans, rowLength, index, -1.0, rightUpdates.row(col + 1), blockSize,
+							projection.data(), 1.0, update);
+						gemv(Trans::NoTrans, rowLength, index, -1.0, rightReflectors.row(col + 1), blockSize,
+							projectionUpdate.data(), 1.0, update);
+					}
+					scale(rowLength, tauLeft[col], update);
+					for (size_t offset = 0; offset < rowLength; offset++) {
+						rightUpdates(col + 1 + offset, index) = update[offset];
+					}
+
+					// 4. Bring row col up to date, including the left reflector of this step
+					gemv(Trans::NoTrans, rowLength, index + 1, -1.0, rightUpdates.row(col + 1), blockSize,
+						leftReflectors.row(col), 1.0, row);
+					if (index > 0) {
+						gemv(Trans::NoTrans, rowLength, index, -1.0, rightReflectors.row(col + 1), blockSize,
+							leftUpdates.row(col), 1.0, row);
+					}
+
+					// 5. Right reflector annihilating row col right of superdiagonal
+					tauRight[col] = householder(rowLength - 1, row[0], row + 1);
+					e[col] = row[0];
+					row[0] = 1.0;
+					for (size_t offset = 0; offset < rowLength; offset++) {
+						rightReflectors(col + 1 + offset, index) = row[offset];
+					}
+
+					// 6. x = tau * A'' * u on rows below col, A'' includes the left reflector of this step
+					const size_t tailLength = columnLength - 1;
+					double* tail = columnUpdate.data();
+					gemv(Trans::NoTrans, tailLength, rowLength, 1.0, row + lda, lda, row, 0.0, tail);
+					gemv(Trans::Trans, rowLength, index + 1, 1.0, rightUpdates.row(col + 1), blockSize,
+						row, 0.0, projection.data());
+					gemv(Trans::NoTrans, tailLength, index + 1, -1.0, leftReflectors.row(col + 1), blockSize,
+						projection.data(), 1.0, tail);
+					if (index > 0) {
+						gemv(Trans::Trans, rowLength, index, 1.0, rightReflectors.row(col + 1), blockSize,
+							row, 0.0, projectionUpdate.data());
+						gemv(Trans::NoTrans, tailLength, index, -1.0, leftUpdates.row(col + 1), blockSize,
+							projectionUpdate.data(), 1.0, tail);
+					}
+					scale(tailLength, tauRight[col], tail);
+					for (size_t offset = 0; offset < tailLength; offset++) {
+						leftUpdates(col + 1 + offset, index) = tail[offset];
+					}
+					row[0] = e[col];
+				}
+
+				// 7. Trailing update A -= V * Y^T + X * U^T
+				const size_t trailingBegin = panelBegin + panelCount;
+				if (trailingBegin < width) {
+					const size_t trailingHeight = height - trailingBegin, trailingWidth = width - trailingBegin;
+					double* trailing = a + trailingBegin * lda + trailingBegin;
+					gemm(Trans::NoTrans, Trans::Trans, trailingHeight, trailingWidth, panelCount, -1.0,
+						leftReflectors.row(trailingBegin), blockSize, rightUpdates.row(trailingBegin), blockSize, 1.0, trailing, lda);
+					gemm(Trans::NoTrans, Trans::Trans, trailingHeight, trailingWidth, panelCount, -1.0,
+						leftUpdates.row(trailingBegin), blockSize, rightReflectors.row(trailingBegin), blockSize, 1.0, trailing, lda);
+				}
+			}
+		}
+
+		void applyBidiagonalQ(const size_t height, const size_t width, const double* a, const size_t lda, const double* tau,
+			const size_t count, double* b, const size_t ldb)
+		{
+			// Q * B = H0 * (H1 * ... (Hk-1 * B)), blocks of reflectors from the last one
+			for (size_t blockEnd = width; blockEnd > 0;) {
+				const size_t blockBegin = (blockEnd > blockSize) ? blockEnd - blockSize : 0, blockCount = blockEnd - blockBegin;
+				const double* v = a + blockBegin * lda + blockBegin;
+				const size_t blockHeight = height - blockBegin;
+				const Dense t = reflectorFactor(blockHeight, blockCount, v, lda, tau + blockBegin);
+				applyReflectorBlock(Trans::NoTrans, blockHeight, count, blockCount, v, lda, t, b + blockBegin * ldb, ldb);
+				blockEnd = blockBegin;
+			}
+		}
+
+		void applyBidiagonalP(const size_t width, const double* a, const size_t lda, const double* tau,
+			const size_t count, double* b, const size_t ldb)
+		{
+			if (width < 2) {
+				return;
+			}
+			// Right reflectors lie in rows, transpose them into the column layout of tridiagonalize
+			Dense reflectors(width, width);
+			for (size_t row = 0; row + 1 < width; row++) {
+				for (size_t col = row + 2; col < width; col++) {
+					reflectors(col, row) = a[row * lda + col];
+				}
+			}
+			applyTridiagonalQ(width, reflectors.data(), width, tau, count, b, ldb);
+		}
+
+		void tridiagonalQL(const size_t length, double* d, const double* e, double* vectors, const size_t ldv)
+		{
+			if (length == 0) {
+				return;
+			}
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			std::vector<double> sub(e, e + length - 1);
+			sub.push_back(0.0);
+
+			double shift = 0.0, scaleBound = 0.0;
+			for (size_t first = 0; first < length; first++) {
+				// Find small subdiagonal entry to split
+				scaleBound = std::max(scaleBound, std::abs(d[first]) + std::abs(sub[first]));
+				size_t last = first;
+				while (last + 1 < length && std::abs(sub[last]) > epsilon * scaleBound) {
+					last++;
+				}
+
+				// Implicit QL sweeps on [first, last] until sub[first] vanishes
+				for (size_t iteration = 0; last > first && iteration < 60; iteration++) {
+					double g = d[first];
+					double p = (d[first + 1] - g) / (2.0 * sub[first]);
+					double r = std::hypot(p, 1.0);
+					if (p < 0.0) {
+						r = -r;
+					}
+					d[first] = sub[first] / (p + r);
+					d[first + 1] = sub[first] * (p + r);
+					const double nextDiagonal = d[first + 1];
+					double h = g - d[first];
+					for (size_t index = first + 2; index < length; index++) {
+						d[index] -= h;
+					}
+					shift += h;
+
+					p = d[last];
+					double c = 1.0, c2 = 1.0, c3 = 1.0, s = 0.0, s2 = 0.0;
+					const double nextSub = sub[first + 1];
+					for (size_t index = last; index-- > first;) {
+						c3 = c2;
+						c2 = c;
+						s2 = s;
+						g = c * sub[index];
+						h = c * p;
+						r = std::hypot(p, sub[index]);
+						sub[index + 1] = s * r;
+						s = sub[index] / r;
+						c = p / r;
+						p = c * d[index] - s * g;
+						d[index + 1] = h + s * (c * g + s * d[index]);
+						if (vectors != nullptr) {
+							for (size_t row = 0; row < length; row++) {
+								double* vectorRow = vectors + row * ldv;
+								h = vectorRow[index + 1];
+								vectorRow[index + 1] = s * vectorRow[index] + c * h;
+								vectorRow[index] = c * vectorRow[index] - s * h;
+							}
+						}
+					}
+					p = -s * s2 * c3 * nextSub * sub[first] / nextDiagonal;
+					sub[first] = s * p;
+					d[first] = c * p;
+					if (std::abs(sub[first]) <= epsilon * scaleBound) {
+						break;
+					}
+				}
+				d[first] += shift;
+				sub[first] = 0.0;
+			}
+
+			// Sort ascending with vectors
+			for (size_t index = 0; index + 1 < length; index++) {
+				const size_t smallest = std::min_element(d + index, d + length) - d;
+				if (smallest != index) {
+					std::swap(d[index], d[smallest]);
+					if (vectors != nullptr) {
+						for (size_t row = 0; row < length; row++) {
+							std::swap(vectors[row * ldv + index], vectors[row * ldv + smallest]);
+						}
+					}
+				}
+			}
+		}
+
+		namespace {
+			constexpr size_t divideConquerLeafSize = 32;
+
+			// Roots of secular equation 1 + rho * sum(z_i^2 / (d_i - lambda)) = 0 for ascending distinct d and rho > 0.
+			// Root k is kept as d_origin + shift, and differences(i, k) = d_i - lambda_k are stored without cancellation
+			void solveSecularEquation(const std::vector<double>& d, const std::vector<double>& z, const double rho,
+				std::vector<double>& values, Dense& differences)
+			{
+				constexpr double epsilon = std::numeric_limits<double>::epsilon();
+				const size_t count = d.size();
+				const double squaredNorm = dot(count, z.data(), z.data());
+
+				parallelFor(0, count, [&](const size_t rootBegin, const size_t rootEnd) {
+					std::vector<double> shifted(count);
+					for (size_t root = rootBegin; root < rootEnd; root++) {
+						// 1. Choose the closer pole as origin and bracket the shift
+						const bool last = (root + 1 == count);
+						size_t origin = root;
+						double lower = 0.0, upper = rho * squaredNorm;
+						if (!last) {
+							const double half = 0.5 * (d[root + 1] - d[root]);
+							double value = 1.0;
+							for (size_t index = 0; index < count; index++) {
+								value += rho * z[index] * z[index] / ((d[index] - d[root]) - half);
+							}
+							if (value >= 0.0) {
+								upper = half;
+							}
+							else {
+								origin = root + 1;
+								lower = (d[root] - d[root + 1]) + half;
+								upper = 0.0;
+							}
+						}
+						for (size_t index = 0; index < count; index++) {
+							shifted[index] = d[index] - d[origin];
+						}
+						const double lowerPole = shifted[root], upperPole = last ? 0.0 : shifted[root + 1];
+
+						// 2. Safeguarded rational iteration : each side of the poles is modeled by a + b / (pole - shift)
+						double shift = 0.5 * (lower + upper);
+						for (size_t iteration = 0; iteration < 100; iteration++) {
+							double psi = 0.0, psiDerivative = 0.0, phi = 0.0, phiDerivative = 0.0;
+							for (size_t index = 0; index <= root; index++) {
+								const double term = z[index] / (shifted[index] - shift);
+								psi += z[index] * term;
+								psiDerivative += term * term;
+							}
+							for (size_t index = root + 1; index < count; index++) {
+								const double term = z[index] / (shifted[index] - shift);
+								phi += z[index] * term;
+								phiDerivative += term * term;
+							}
+							const double value = 1.0 + rho * (psi + phi);
+							if (value > 0.0) {
+								upper = shift;
+							}
+							else {
+								lower = shift;
+							}
+							if (std::abs(value) <= 8.0 * epsilon * (1.0 + rho * (std::abs(psi) + std::abs(phi)))
+								|| upper - lower <= 2.0 * epsilon * std::max(std::abs(lower), std::abs(upper))) {
+								break;
+							}
+
+							const double lowerWeight = rho * psiDerivative * (lowerPole - shift) * (lowerPole - shift);
+							const double upperWeight = last ? 0.0 : rho * phiDerivative * (upperPole - shift) * (upperPole - shift);
+							const double constant = 1.0 + rho * (psi + phi)
+								- lowerWeight / (lowerPole - shift) - (last ? 0.0 : upperWeight / (upperPole - shift));
+							double next = std::numeric_limits<double>::quiet_NaN();
+							if (last) {
+								next = lowerPole + lowerWeight / constant;
+							}
+							else {
+								// constant * (p0 - x) * (p1 - x) + b0 * (p1 - x) + b1 * (p0 - x) = 0
+								const double quadratic = constant;
+								const double linear = -(constant * (lowerPole + upperPole) + lowerWeight + upperWeight);
+								const double constantTerm = constant * lowerPole * upperPole + lowerWeight * upperPole + upperWeight * lowerPole;
+								if (std::abs(quadratic) <= epsilon * std::abs(linear)) {
+									next = -constantTerm / linear;
+								}
+								else {
+									const double discriminant = std::max(0.0, linear * linear - 4.0 * quadratic * constantTerm);
+									const double q = -0.5 * (linear + std::copysign(std::sqrt(discriminant), linear));
+									const double first = q / quadratic, second = (q != 0.0) ? constantTerm / q : first;
+									next = (first > lower && first < upper) ? first : second;
+								}
+							}
+							shift = (std::isfinite(next) && next > lower && next < upper) ? next : 0.5 * (lower + upper);
+						}
+
+						values[root] = d[origin] + shift;
+						for (size_t index = 0; index < count; index++) {
+							differences(index, root) = shifted[index] - shift;
+						}
+					}
+				}, std::max<size_t>(1, 4096 / (count + 1)));
+			}
+
+			// Merge two solved halves of (length x length) problem with coupling rho = e[half - 1],
+			// q holds block diagonal eigenvectors of halves and d their eigenvalues, both are replaced by merged result
+			void mergeDivideConquer(const size_t length, const size_t half, const double coupling, double* d, double* q, const size_t ldq)
+			{
+				constexpr double epsilon = std::numeric_limits<double>::epsilon();
+
+				// 1. Rank one modification D + rho * z * z^T in eigenbasis of halves
+				std::vector<double> z(length);
+				for (size_t col = 0; col < half; col++) {
+					z[col] = q[(half - 1) * ldq + col];
+				}
+				for (size_t col = half; col < length; col++) {
+					z[col] = std::copysign(1.0, coupling) * q[half * ldq + col];
+				}
+				const double norm = norm2(length, z.data());
+				const double rho = std::abs(coupling) * norm * norm;
+				scale(length, 1.0 / norm, z.data());
+
+				// 2. Sort poles ascending
+				std::vector<size_t> order(length);
+				for (size_t index = 0; index < length; index++) {
+					order[index] = index;
+				}
+				std::stable_sort(order.begin(), order.end(), [d](const size_t left, const size_t right) { return d[left] < d[right]; });
+				std::vector<double> poles(length), weights(length);
+				for (size_t index = 0; index < length; index++) {
+					poles[index] = d[order[index]];
+					weights[index] = z[order[index]];
+				}
+
+				// 3. Deflation : negligible weight, or close poles merged by Givens rotation
+				double maxAbsolute = 0.0;
+				for (size_t index = 0; index < length; index++) {
+					maxAbsolute = std::max(maxAbsolute, std::abs(poles[index]));
+				}
+				const double tolerance = 8.0 * epsilon * std::max(maxAbsolute, rho);
+				std::vector<size_t> kept, deflated;
+				size_t previous = length;
+				for (size_t index = 0; index < length; index++) {
+					if (rho * std::abs(weights[index]) <= tolerance) {
+						deflated.push_back(index);
+						continue;
+					}
+					if (previous == length) {
+						previous = index;
+						continue;
+					}
+					const double radius = std::hypot(weights[index], weights[previous]);
+					const double c = weights[index] / radius, s = -weights[previous] / radius;
+					if (std::abs((poles[index] - poles[previous]) * c * s) <= tolerance) {
+						weights[index] = radius;
+						weights[previous] = 0.0;
+						const size_t previousCol = order[previous], currentCol = order[index];
+						for (size_t row = 0; row < length; row++) {
+							double* qRow = q + row * ldq;
+							const double x = qRow[previousCol], y = qRow[currentCol];
+							qRow[previousCol] = c * x + s * y;
+							qRow[currentCol] = c * y - s * x;
+						}
+						const double rotated = poles[previous] * c * c + poles[index] * s * s;
+						poles[index] = poles[previous] * s * s + poles[index] * c * c;
+						poles[previous] = rotated;
+						deflated.push_back(previous);
+					}
+					else {
+						kept.push_back(previous);
+					}
+					previous = index;
+				}
+				if (previous != length) {
+					kept.push_back(previous);
+				}
+
+				// 4. Secular equation for kept poles and Gu-Eisenstat weights for orthogonal eigenvectors
+				const size_t keptCount = kept.size();
+				std::vector<double> keptPoles(keptCount), keptWeights(keptCount), keptValues(keptCount);
+				for (size_t index = 0; index < keptCount; index++) {
+					keptPoles[index] = poles[kept[index]];
+					keptWeights[index] = weights[kept[index]];
+				}
+				Dense differences(keptCount, keptCount);
+				solveSecularEquation(keptPoles, keptWeights, rho, keptValues, differences);
+
+				Dense secularVectors(keptCount, keptCount);
+				parallelFor(0, keptCount, [&](const size_t indexBegin, const size_t indexEnd) {
+					for (size_t index = indexBegin; index < indexEnd; index++) {
+						double product = -differences(index, index) / rho;
+						for (size_t other = 0; other < keptCount; other++) {
+							if (other != index) {
+								product *= differences(index, other) / (keptPoles[index] - keptPoles[other]);
+							}
+						}
+						const double weight = std::copysign(std::sqrt(std::max(product, 0.0)), keptWeights[index]);
+						for (size_t root = 0; root < keptCount; root++) {
+							secularVectors(index, root) = weight / differences(index, root);
+						}
+					}
+				}, std::max<size_t>(1, 4096 / (keptCount + 1)));
+				for (size_t root = 0; root < keptCount; root++) {
+					double squaredNorm = 0.0;
+					for (size_t index = 0; index < keptCount; index++) {
+						squaredNorm += secularVectors(index, root) * secularVectors(index, root);
+					}
+					const double inverseNorm = 1.0 / std::sqrt(squaredNorm);
+					for (size_t index = 0; index < keptCount; index++) {
+						secularVectors(index, root) *= inverseNorm;
+					}
+				}
+
+				// 5. Eigenvectors of kept part = Q(:, kept) * secularVectors, deflated ones are columns of Q
+				Dense keptColumns(length, keptCount);
+				for (size_t row = 0; row < length; row++) {
+					for (size_t index = 0; index < keptCount; index++) {
+						keptColumns(row, index) = q[row * ldq + order[kept[index]]];
+					}
+				}
+				const Dense keptVectors = multiply(keptColumns, secularVectors);
+
+				// 6. Merge both parts in ascending order
+				std::vector<std::pair<double, size_t>> merged; // (eigenvalue, source), source < keptCount is a kept root
+				merged.reserve(length);
+				for (size_t index = 0; index < keptCount; index++) {
+					merged.emplace_back(keptValues[index], index);
+				}
+				for (const size_t index : deflated) {
+					merged.emplace_back(poles[index], keptCount + index);
+				}
+				std::stable_sort(merged.begin(), merged.end(),
+					[](const std::pair<double, size_t>& left, const std::pair<double, size_t>& right) { return left.first < right.first; });
+				Dense result(length, length);
+				for (size_t col = 0; col < length; col++) {
+					const size_t source = merged[col].second;
+					d[col] = merged[col].first;
+					for (size_t row = 0; row < length; row++) {
+						result(row, col) = (source < keptCount) ? keptVectors(row, source) : q[row * ldq + order[source - keptCount]];
+					}
+				}
+				for (size_t row = 0; row < length; row++) {
+					std::copy(result.row(row), result.row(row) + length, q + row * ldq);
+				}
+			}
+
+			void divideConquer(const size_t length, double* d, const double* e, double* q, const size_t ldq)
+			{
+				if (length <= divideConquerLeafSize) {
+					for (size_t row = 0; row < length; row++) {
+						std::fill(q + row * ldq, q + row * ldq + length, 0.0);
+						q[row * ldq + row] = 1.0;
+					}
+					tridiagonalQL(length, d, e, q, ldq);
+					return;
+				}
+
+				// T = diag(T1 - |rho| * e_last * e_last^T, T2 - |rho| * e_first * e_first^T) + |rho| * u * u^T
+				const size_t half = length / 2;
+				const double coupling = e[half - 1];
+				d[half - 1] -= std::abs(coupling);
+				d[half] -= std::abs(coupling);
+				divideConquer(half, d, e, q, ldq);
+				divideConquer(length - half, d + half, e + half, q + half * ldq + half, ldq);
+				mergeDivideConquer(length, half, coupling, d, q, ldq);
+			}
+		}
+
+		void tridiagonalDivideConquer(const size_t length, double* d, const double* e, Dense& vectors)
+		{
+			vectors = Dense(length, length);
+			if (length == 0) {
+				return;
+			}
+			// Split where subdiagonal is negligible so that each part is solved independently
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			size_t partBegin = 0;
+			for (size_t index = 0; index < length; index++) {
+				const bool split = (index + 1 == length)
+					|| std::abs(e[index]) <= epsilon * std::sqrt(std::abs(d[index])) * std::sqrt(std::abs(d[index + 1]));
+				if (split) {
+					divideConquer(index + 1 - partBegin, d + partBegin, e + partBegin,
+						vectors.data() + partBegin * length + partBegin, length);
+					partBegin = index + 1;
+				}
+			}
+
+			// Sort ascending across parts
+			std::vector<size_t> order(length);
+			for (size_t index = 0; index < length; index++) {
+				order[index] = index;
+			}
+			std::stable_sort(order.begin(), order.end(), [d](const size_t left, const size_t right) { return d[left] < d[right]; });
+			const std::vector<double> values(d, d + length);
+			const Dense unsorted = vectors;
+			for (size_t col = 0; col < length; col++) {
+				d[col] = values[order[col]];
+				for (size_t row = 0; row < length; row++) {
+					vectors(row, col) = unsorted(row, order[col]);
+				}
+			}
+		}
+
+		std::vector<double> tridiagonalBisection(const size_t length, const double* d, const double* e,
+			const size_t first, const size_t last)
+		{
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			// Gershgorin interval
+			double lowerBound = d[0], upperBound = d[0], maxSquared = 0.0;
+			for (size_t index = 0; index < length; index++) {
+				const double radius = ((index > 0) ? std::abs(e[index - 1]) : 0.0) + ((index + 1 < length) ? std::abs(e[index]) : 0.0);
+				lowerBound = std::min(lowerBound, d[index] - radius);
+				upperBound = std::max(upperBound, d[index] + radius);
+				if (index + 1 < length) {
+					maxSquared = std::max(maxSquared, e[index] * e[index]);
+				}
+			}
+			const double width = upperBound - lowerBound;
+			lowerBound -= 2.0 * epsilon * width + std::numeric_limits<double>::min();
+			upperBound += 2.0 * epsilon * width + std::numeric_limits<double>::min();
+			const double pivotMinimum = std::numeric_limits<double>::min() * std::max(1.0, maxSquared);
+
+			// Number of eigenvalues smaller than x (count of negative pivots of T - x * I)
+			auto countBelow = [&](const double x) {
+				size_t count = 0;
+				double pivot = d[0] - x;
+				for (size_t index = 0;; index++) {
+					if (std::abs(pivot) < pivotMinimum) {
+						pivot = -pivotMinimum;
+					}
+					if (pivot < 0.0) {
+						count++;
+					}
+					if (index + 1 == length) {
+						break;
+					}
+					pivot = (d[index + 1] - x) - e[index] * e[index] / pivot;
+				}
+				return count;
+			};
+
+			std::vector<double> values(last - first);
+			parallelFor(first, last, [&](const size_t valueBegin, const size_t valueEnd) {
+				for (size_t target = valueBegin; target < valueEnd; target++) {
+					double lower = lowerBound, upper = upperBound;
+					while (upper - lower > 2.0 * epsilon * std::max(std::abs(lower), std::abs(upper)) + pivotMinimum) {
+						const double middle = 0.5 * (lower + upper);
+						if (middle <= lower || middle >= upper) {
+							break;
+						}
+						if (countBelow(middle) > target) {
+							upper = middle;
+						}
+						else {
+							lower = middle;
+						}
+					}
+					values[target - first] = 0.5 * (lower + upper);
+				}
+			}, std::max<size_t>(1, 2048 / (length + 1)));
+			return values;
+		}
+
+		Dense tridiagonalInverseIteration(const size_t length, const double* d, const double* e, const std::vector<double>& values)
+		{
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			const size_t count = values.size();
+			Dense vectors(length, count);
+			if (count == 0) {
+				return vectors;
+			}
+
+			double norm = 0.0;
+			for (size_t index = 0; index < length; index++) {
+				norm = std::max(norm, std::abs(d[index]) + ((index > 0) ? std::abs(e[index - 1]) : 0.0)
+					+ ((index + 1 < length) ? std::abs(e[index]) : 0.0));
+			}
+			norm = std::max(norm, std::numeric_limits<double>::min());
+			const double clusterGap = 1e-3 * norm, perturbation = 10.0 * epsilon * norm;
+
+			// Clusters of close eigenvalues are orthogonalized together, different clusters run in parallel
+			std::vector<size_t> clusterBegins{ 0 };
+			for (size_t index = 1; index < count; index++) {
+				if (values[index] - values[index - 1] > clusterGap) {
+					clusterBegins.push_back(index);
+				}
+			}
+			clusterBegins.push_back(count);
+
+			parallelFor(0, clusterBegins.size() - 1, [&](const size_t clusterBegin, const size_t clusterEnd) {
+				std::vector<double> diagonal(length), upper(length), upper2(length), multiplier(length), x(length);
+				std::vector<char> swapped(length);
+				for (size_t cluster = clusterBegin; cluster < clusterEnd; cluster++) {
+					double previousShift = 0.0;
+					for (size_t target = clusterBegins[cluster]; target < clusterBegins[cluster + 1]; target++) {
+						// Separate equal shifts inside cluster so that factorizations differ
+						double shift = values[target];
+						if (target > clusterBegins[cluster] && shift - previousShift < perturbation) {
+							shift = previousShift + perturbation;
+						}
+						previousShift = shift;
+
+						// 1. LU factorization with partial pivoting of T - shift * I
+						double pivot = d[0] - shift, pivotUpper = (length > 1) ? e[0] : 0.0;
+						for (size_t index = 0; index + 1 < length; index++) {
+							const double below = e[index], nextDiagonal = d[index + 1] - shift;
+							const double nextUpper = (index + 2 < length) ? e[index + 1] : 0.0;
+							if (std::abs(pivot) >= std::abs(below)) {
+								const double factor = (pivot != 0.0) ? below / pivot : 0.0;
+								diagonal[index] = pivot;
+								upper[index] = pivotUpper;
+								upper2[index] = 0.0;
+								multiplier[index] = factor;
+								swapped[index] = 0;
+								pivot = nextDiagonal - factor * pivotUpper;
+								pivotUpper = nextUpper;
+							}
+							else {
+								const double factor = pivot / below;
+								diagonal[index] = below;
+								upper[index] = nextDiagonal;
+								upper2[index] = nextUpper;
+								multiplier[index] = factor;
+								swapped[index] = 1;
+								pivot = pivotUpper - factor * nextDiagonal;
+								pivotUpper = -factor * nextUpper;
+							}
+						}
+						diagonal[length - 1] = pivot;
+						for (size_t index = 0; index < length; index++) {
+							if (std::abs(diagonal[index]) < epsilon * norm) {
+								diagonal[index] = std::copysign(epsilon * norm, diagonal[index]);
+							}
+						}
+
+						// 2. Iterate from a fixed start vector, orthogonalized against earlier vectors of the cluster
+						for (size_t index = 0; index < length; index++) {
+							x[index] = 1.0 + 0.1 * std::sin(static_cast<double>(index + target));
+						}
+						for (size_t iteration = 0; iteration < 4; iteration++) {
+							for (size_t index = 0; index + 1 < length; index++) {
+								if (swapped[index]) {
+									std::swap(x[index], x[index + 1]);
+								}
+								x[index + 1] -= multiplier[index] * x[index];
+							}
+							for (size_t index = length; index-- > 0;) {
+								double value = x[index];
+								if (index + 1 < length) {
+									value -= upper[index] * x[index + 1];
+								}
+								if (index + 2 < length) {
+									value -= upper2[index] * x[index + 2];
+								}
+								x[index] = value / diagonal[index];
+							}
+							for (size_t previous = clusterBegins[cluster]; previous < target; previous++) {
+								double projection = 0.0;
+								for (size_t index = 0; index < length; index++) {
+									projection += x[index] * vectors(index, previous);
+								}
+								for (size_t index = 0; index < length; index++) {
+									x[index] -= projection * vectors(index, previous);
+								}
+							}
+							scale(length, 1.0 / norm2(length, x.data()), x.data());
+						}
+						for (size_t index = 0; index < length; index++) {
+							vectors(index, target) = x[index];
+						}
+					}
+				}
+			});
+			return vectors;
+		}
+
+		void generalEigen(const size_t length, double* a, const size_t lda, double* real, double* imaginary,
+			double* vectors, const size_t ldv)
+		{
+			if (length == 0) {
+				return;
+			}
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			const bool wantVectors = (vectors != nullptr);
+			auto h = [a, lda](const size_t row, const size_t col) -> double& { return a[row * lda + col]; };
+			auto vec = [vectors, ldv](const size_t row, const size_t col) -> double& { return vectors[row * ldv + col]; };
+			// Complex division (xr + i * xi) / (yr + i * yi)
+			auto divide = [](const double xr, const double xi, const double yr, const double yi, double& zr, double& zi) {
+				if (std::abs(yr) > std::abs(yi)) {
+					const double ratio = yi / yr, denominator = yr + ratio * yi;
+					zr = (xr + ratio * xi) / denominator;
+					zi = (xi - ratio * xr) / denominator;
+				}
+				else {
+					const double ratio = yr / yi, denominator = yi + ratio * yr;
+					zr = (ratio * xr + xi) / denominator;
+					zi = (ratio * xi - xr) / denominator;
+				}
+			};
+			const int size = static_cast<int>(length), high = size - 1;
+
+			// 1. Householder reduction to upper Hessenberg form, reflector tails stay below the subdiagonal until accumulated
+			std::vector<double> reflector(length);
+			for (int m = 1; m < high; m++) {
+				double columnScale = 0.0;
+				for (int i = m; i <= high; i++) {
+					columnScale += std::abs(h(i, m - 1));
+				}
+				if (columnScale == 0.0) {
+					continue;
+				}
+				double squareSum = 0.0;
+				for (int i = high; i >= m; i--) {
+					reflector[i] = h(i, m - 1) / columnScale;
+					squareSum += reflector[i] * reflector[i];
+				}
+				const double g = (reflector[m] > 0.0) ? -std::sqrt(squareSum) : std::sqrt(squareSum);
+				squareSum -= reflector[m] * g;
+				reflector[m] -= g;
+				for (int j = m; j < size; j++) {
+					double f = 0.0;
+					for (int i = high; i >= m; i--) {
+						f += reflector[i] * h(i, j);
+					}
+					f /= squareSum;
+					for (int i = m; i <= high; i++) {
+						h(i, j) -= f * reflector[i];
+					}
+				}
+				for (int i = 0; i <= high; i++) {
+					double f = 0.0;
+					for (int j = high; j >= m; j--) {
+						f += reflector[j] * h(i, j);
+					}
+					f /= squareSum;
+					for (int j = m; j <= high; j++) {
+						h(i, j) -= f * reflector[j];
+					}
+				}
+				reflector[m] *= columnScale;
+				h(m, m - 1) = columnScale * g;
+			}
+			if (wantVectors) {
+				for (int i = 0; i < size; i++) {
+					for (int j = 0; j < size; j++) {
+						vec(i, j) = (i == j) ? 1.0 : 0.0;
+					}
+				}
+				for (int m = high - 1; m >= 1; m--) {
+					if (h(m, m - 1) == 0.0) {
+						continue;
+					}
+					for (int i = m + 1; i <= high; i++) {
+						reflector[i] = h(i, m - 1);
+					}
+					for (int j = m; j <= high; j++) {
+						double g = 0.0;
+						for (int i = m; i <= high; i++) {
+							g += reflector[i] * vec(i, j);
+						}
+						// Double division avoids possible underflow
+						g = (g / reflector[m]) / h(m, m - 1);
+						for (int i = m; i <= high; i++) {
+							vec(i, j) += g * reflector[i];
+						}
+					}
+				}
+			}
+			for (int row = 2; row < size; row++) {
+				for (int col = 0; col + 1 < row; col++) {
+					h(row, col) = 0.0;
+				}
+			}
+
+			// 2. Shifted double QR iteration on the Hessenberg matrix
+			double norm = 0.0;
+			for (int i = 0; i < size; i++) {
+				for (int j = std::max(i - 1, 0); j < size; j++) {
+					norm += std::abs(h(i, j));
+				}
+			}
+			int n = high, iteration = 0;
+			double exceptionalShift = 0.0;
+			double p = 0.0, q = 0.0, r = 0.0, s = 0.0, z = 0.0, t, w, x, y;
+			while (n >= 0) {
+				// Look for single small subdiagonal entry
+				int l = n;
+				while (l > 0) {
+					s = std::abs(h(l - 1, l - 1)) + std::abs(h(l, l));
+					if (s == 0.0) {
+						s = norm;
+					}
+					if (std::abs(h(l, l - 1)) < epsilon * s) {
+						break;
+					}
+					l--;
+				}
+
+				if (l == n) {
+					// One root found
+					h(n, n) += exceptionalShift;
+					real[n] = h(n, n);
+					imaginary[n] = 0.0;
+					n--;
+					iteration = 0;
+				}
+				else if (l == n - 1) {
+					// Two roots found
+					w = h(n, n - 1) * h(n - 1, n);
+					p = (h(n - 1, n - 1) - h(n, n)) / 2.0;
+					q = p * p + w;
+					z = std::sqrt(std::abs(q));
+					h(n, n) += exceptionalShift;
+					h(n - 1, n - 1) += exceptionalShift;
+					x = h(n, n);
+					if (q >= 0.0) {
+						// Real pair
+						z = (p >= 0.0) ? p + z : p - z;
+						real[n - 1] = x + z;
+						real[n] = (z != 0.0) ? x - w / z : real[n - 1];
+						imaginary[n - 1] = imaginary[n] = 0.0;
+						x = h(n, n - 1);
+						s = std::abs(x) + std::abs(z);
+						p = x / s;
+						q = z / s;
+						r = std::sqrt(p * p + q * q);
+						p /= r;
+						q /= r;
+						for (int j = n - 1; j < size; j++) {
+							z = h(n - 1, j);
+							h(n - 1, j) = q * z + p * h(n, j);
+							h(n, j) = q * h(n, j) - p * z;
+						}
+						for (int i = 0; i <= n; i++) {
+							z = h(i, n - 1);
+							h(i, n - 1) = q * z + p * h(i, n);
+							h(i, n) = q * h(i, n) - p * z;
+						}
+						if (wantVectors) {
+							for (int i = 0; i < size; i++) {
+								z = vec(i, n - 1);
+								vec(i, n - 1) = q * z + p * vec(i, n);
+								vec(i, n) = q * vec(i, n) - p * z;
+							}
+						}
+					}
+					else {
+						// Complex pair
+						real[n - 1] = real[n] = x + p;
+						imaginary[n - 1] = z;
+						imaginary[n] = -z;
+					}
+					n -= 2;
+					iteration = 0;
+				}
+				else {
+					// Form shift
+					x = h(n, n);
+					y = 0.0;
+					w = 0.0;
+					if (l < n) {
+						y = h(n - 1, n - 1);
+						w = h(n, n - 1) * h(n - 1, n);
+					}
+					// Wilkinson's original ad hoc shift
+					if (iteration == 10) {
+						exceptionalShift += x;
+						for (int i = 0; i <= n; i++) {
+							h(i, i) -= x;
+						}
+						s = std::abs(h(n, n - 1)) + std::abs(h(n - 1, n - 2));
+						x = y = 0.75 * s;
+						w = -0.4375 * s * s;
+					}
+					// MATLAB's ad hoc shift
+					if (iteration == 30) {
+						s = (y - x) / 2.0;
+						s = s * s + w;
+						if (s > 0.0) {
+							s = std::sqrt(s);
+							if (y < x) {
+								s = -s;
+							}
+							s = x - w / ((y - x) / 2.0 + s);
+							for (int i = 0; i <= n; i++) {
+								h(i, i) -= s;
+							}
+							exceptionalShift += s;
+							x = y = w = 0.964;
+						}
+					}
+					iteration++;
+
+					// Look for two consecutive small subdiagonal entries
+					int m = n - 2;
+					while (m >= l) {
+						z = h(m, m);
+						r = x - z;
+						s = y - z;
+						p = (r * s - w) / h(m + 1, m) + h(m, m + 1);
+						q = h(m + 1, m + 1) - z - r - s;
+						r = h(m + 2, m + 1);
+						s = std::abs(p) + std::abs(q) + std::abs(r);
+						p /= s;
+						q /= s;
+						r /= s;
+						if (m == l) {
+							break;
+						}
+						if (std::abs(h(m, m - 1)) * (std::abs(q) + std::abs(r))
+							< epsilon * (std::abs(p) * (std::abs(h(m - 1, m - 1)) + std::abs(z) + std::abs(h(m + 1, m + 1))))) {
+							break;
+						}
+						m--;
+					}
+					for (int i = m + 2; i <= n; i++) {
+						h(i, i - 2) = 0.0;
+						if (i > m + 2) {
+							h(i, i - 3) = 0.0;
+						}
+					}
+
+					// Double QR step involving rows l:n and columns m:n
+					for (int k = m; k <= n - 1; k++) {
+						const bool notLast = (k != n - 1);
+						if (k != m) {
+							p = h(k, k - 1);
+							q = h(k + 1, k - 1);
+							r = notLast ? h(k + 2, k - 1) : 0.0;
+							x = std::abs(p) + std::abs(q) + std::abs(r);
+							if (x == 0.0) {
+								continue;
+							}
+							p /= x;
+							q /= x;
+							r /= x;
+						}
+						s = std::sqrt(p * p + q * q + r * r);
+						if (p < 0.0) {
+							s = -s;
+						}
+						if (s == 0.0) {
+							continue;
+						}
+						if (k != m) {
+							h(k, k - 1) = -s * x;
+						}
+						else if (l != m) {
+							h(k, k - 1) = -h(k, k - 1);
+						}
+						p += s;
+						x = p / s;
+						y = q / s;
+						z = r / s;
+						q /= p;
+						r /= p;
+						for (int j = k; j < size; j++) {
+							p = h(k, j) + q * h(k + 1, j);
+							if (notLast) {
+								p += r * h(k + 2, j);
+								h(k + 2, j) -= p * z;
+							}
+							h(k, j) -= p * x;
+							h(k + 1, j) -= p * y;
+						}
+						for (int i = 0; i <= std::min(n, k + 3); i++) {
+							p = x * h(i, k) + y * h(i, k + 1);
+							if (notLast) {
+								p += z * h(i, k + 2);
+								h(i, k + 2) -= p * r;
+							}
+							h(i, k) -= p;
+							h(i, k + 1) -= p * q;
+						}
+						if (wantVectors) {
+							for (int i = 0; i < size; i++) {
+								p = x * vec(i, k) + y * vec(i, k + 1);
+								if (notLast) {
+									p += z * vec(i, k + 2);
+									vec(i, k + 2) -= p * r;
+								}
+								vec(i, k) -= p;
+								vec(i, k + 1) -= p * q;
+							}
+						}
+					}
+				}
+			}
+			if (!wantVectors || norm == 0.0) {
+				return;
+			}
+
+			// 3. Back substitution for eigenvectors of the quasi-triangular form
+			for (n = high; n >= 0; n--) {
+				p = real[n];
+				q = imaginary[n];
+				if (q == 0.0) {
+					// Real vector
+					int l = n;
+					h(n, n) = 1.0;
+					for (int i = n - 1; i >= 0; i--) {
+						w = h(i, i) - p;
+						r = 0.0;
+						for (int j = l; j <= n; j++) {
+							r += h(i, j) * h(j, n);
+						}
+						if (imaginary[i] < 0.0) {
+							z = w;
+							s = r;
+							continue;
+						}
+						l = i;
+						if (imaginary[i] == 0.0) {
+							h(i, n) = (w != 0.0) ? -r / w : -r / (epsilon * norm);
+						}
+						else {
+							x = h(i, i + 1);
+							y = h(i + 1, i);
+							q = (real[i] - p) * (real[i] - p) + imaginary[i] * imaginary[i];
+							t = (x * s - z * r) / q;
+							h(i, n) = t;
+							h(i + 1, n) = (std::abs(x) > std::abs(z)) ? (-r - w * t) / x : (-s - y * t) / z;
+						}
+						// Overflow control
+						t = std::abs(h(i, n));
+						if ((epsilon * t) * t > 1.0) {
+							for (int j = i; j <= n; j++) {
+								h(j, n) /= t;
+							}
+						}
+					}
+				}
+				else if (q < 0.0) {
+					// Complex vector, last component imaginary so that the matrix is triangular
+					int l = n - 1;
+					if (std::abs(h(n, n - 1)) > std::abs(h(n - 1, n))) {
+						h(n - 1, n - 1) = q / h(n, n - 1);
+						h(n - 1, n) = -(h(n, n) - p) / h(n, n - 1);
+					}
+					else {
+						divide(0.0, -h(n - 1, n), h(n - 1, n - 1) - p, q, h(n - 1, n - 1), h(n - 1, n));
+					}
+					h(n, n - 1) = 0.0;
+					h(n, n) = 1.0;
+					for (int i = n - 2; i >= 0; i--) {
+						double ra = 0.0, sa = 0.0;
+						for (int j = l; j <= n; j++) {
+							ra += h(i, j) * h(j, n - 1);
+							sa += h(i, j) * h(j, n);
+						}
+						w = h(i, i) - p;
+						if (imaginary[i] < 0.0) {
+							z = w;
+							r = ra;
+							s = sa;
+							continue;
+						}
+						l = i;
+						if (imaginary[i] == 0.0) {
+							divide(-ra, -sa, w, q, h(i, n - 1), h(i, n));
+						}
+						else {
+							x = h(i, i + 1);
+							y = h(i + 1, i);
+							double vr = (real[i] - p) * (real[i] - p) + imaginary[i] * imaginary[i] - q * q;
+							const double vi = (real[i] - p) * 2.0 * q;
+							if (vr == 0.0 && vi == 0.0) {
+								vr = epsilon * norm * (std::abs(w) + std::abs(q) + std::abs(x) + std::abs(y) + std::abs(z));
+							}
+							divide(x * r - z * ra + q * sa, x * s - z * sa - q * ra, vr, vi, h(i, n - 1), h(i, n));
+							if (std::abs(x) > (std::abs(z) + std::abs(q))) {
+								h(i + 1, n - 1) = (-ra - w * h(i, n - 1) + q * h(i, n)) / x;
+								h(i + 1, n) = (-sa - w * h(i, n) - q * h(i, n - 1)) / x;
+							}
+							else {
+								divide(-r - y * h(i, n - 1), -s - y * h(i, n), z, q, h(i + 1, n - 1), h(i + 1, n));
+							}
+						}
+						// Overflow control
+						t = std::max(std::abs(h(i, n - 1)), std::abs(h(i, n)));
+						if ((epsilon * t) * t > 1.0) {
+							for (int j = i; j <= n; j++) {
+								h(j, n - 1) /= t;
+								h(j, n) /= t;
+							}
+						}
+					}
+				}
+			}
+
+			// 4. Back transformation to eigenvectors of A
+			for (int j = high; j >= 0; j--) {
+				for (int i = 0; i < size; i++) {
+					z = 0.0;
+					for (int k = 0; k <= j; k++) {
+						z += vec(i, k) * h(k, j);
+					}
+					vec(i, j) = z;
+				}
+			}
+		}
+
+		void bidiagonalSVD(const size_t length, double* d, const double* e, double* ut, const size_t ldu, double* vt, const size_t ldv)
+		{
+			if (length == 0) {
+				return;
+			}
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			const double tiny = std::numeric_limits<double>::min() / epsilon;
+			std::vector<double> sub(e, e + length - 1);
+			sub.push_back(0.0);
+
+			// Rotation of rows (first, second) : x_first <- c * x_first + s * x_second, x_second <- c * x_second - s * x_first
+			struct Rotation {
+				size_t first, second;
+				double c, s;
+			};
+			std::vector<Rotation> leftRotations, rightRotations;
+			// Rotations of several QR steps are applied together, tile by tile of columns so that touched rows stay in cache
+			auto applyRotations = [length](std::vector<Rotation>& rotations, double* vectors, const size_t ldVectors) {
+				if (vectors == nullptr || rotations.empty()) {
+					rotations.clear();
+					return;
+				}
+				constexpr size_t tileWidth = 64;
+				parallelFor(0, (length + tileWidth - 1) / tileWidth, [&](const size_t tileBegin, const size_t tileEnd) {
+					for (size_t tile = tileBegin; tile < tileEnd; tile++) {
+						const size_t colBegin = tile * tileWidth, colEnd = std::min(length, colBegin + tileWidth);
+						for (const Rotation& rotation : rotations) {
+							double* firstRow = vectors + rotation.first * ldVectors;
+							double* secondRow = vectors + rotation.second * ldVectors;
+							for (size_t col = colBegin; col < colEnd; col++) {
+								const double firstEntry = firstRow[col], secondEntry = secondRow[col];
+								firstRow[col] = rotation.c * firstEntry + rotation.s * secondEntry;
+								secondRow[col] = rotation.c * secondEntry - rotation.s * firstEntry;
+							}
+						}
+					}
+				});
+				rotations.clear();
+			};
+
+			// Golub-Kahan iteration on the trailing unreduced block [first, last), as in LINPACK dsvdc
+			size_t last = length;
+			while (last > 0) {
+				// Find negligible superdiagonal entry above the block
+				size_t first = last - 1;
+				while (first > 0 && std::abs(sub[first - 1]) > tiny + epsilon * (std::abs(d[first - 1]) + std::abs(d[first]))) {
+					first--;
+				}
+				if (first > 0) {
+					sub[first - 1] = 0.0;
+				}
+				if (first == last - 1) {
+					last--;
+					continue;
+				}
+
+				// Find negligible diagonal entry inside the block
+				size_t zero = last;
+				for (size_t index = last; index-- > first;) {
+					const double neighbor = ((index + 1 < last) ? std::abs(sub[index]) : 0.0) + ((index > first) ? std::abs(sub[index - 1]) : 0.0);
+					if (std::abs(d[index]) <= tiny + epsilon * neighbor) {
+						d[index] = 0.0;
+						zero = index;
+						break;
+					}
+				}
+
+				if (zero == last - 1) {
+					// Last diagonal entry is zero : chase sub[last - 2] up the column with rotations from the right
+					double f = sub[last - 2];
+					sub[last - 2] = 0.0;
+					for (size_t index = last - 1; index-- > first;) {
+						const double t = std::hypot(d[index], f), c = d[index] / t, s = f / t;
+						d[index] = t;
+						if (index > first) {
+							f = -s * sub[index - 1];
+							sub[index - 1] = c * sub[index - 1];
+						}
+						rightRotations.push_back({ index, last - 1, c, s });
+					}
+				}
+				else if (zero < last) {
+					// Diagonal entry zero inside the block : split by chasing sub[zero] along the row with rotations from the left
+					double f = sub[zero];
+					sub[zero] = 0.0;
+					for (size_t index = zero + 1; index < last; index++) {
+						const double t = std::hypot(d[index], f), c = d[index] / t, s = f / t;
+						d[index] = t;
+						f = -s * sub[index];
+						sub[index] = c * sub[index];
+						leftRotations.push_back({ index, zero, c, s });
+					}
+				}
+				else {
+					// Implicit QR step with shift from the trailing 2 x 2 block of B^T * B
+					const double scaleFactor = std::max({ std::abs(d[last - 1]), std::abs(d[last - 2]), std::abs(sub[last - 2]),
+						std::abs(d[first]), std::abs(sub[first]) });
+					const double lastValue = d[last - 1] / scaleFactor, previousValue = d[last - 2] / scaleFactor;
+					const double previousSub = sub[last - 2] / scaleFactor;
+					const double firstValue = d[first] / scaleFactor, firstSub = sub[first] / scaleFactor;
+					const double b = ((previousValue + lastValue) * (previousValue - lastValue) + previousSub * previousSub) / 2.0;
+					const double c = (lastValue * previousSub) * (lastValue * previousSub);
+					double shift = 0.0;
+					if (b != 0.0 || c != 0.0) {
+						shift = std::copysign(std::sqrt(b * b + c), b);
+						shift = c / (b + shift);
+					}
+					double f = (firstValue + lastValue) * (firstValue - lastValue) + shift;
+					double g = firstValue * firstSub;
+					for (size_t index = first; index + 1 < last; index++) {
+						double t = std::hypot(f, g);
+						double cosine = f / t, sine = g / t;
+						if (index > first) {
+							sub[index - 1] = t;
+						}
+						f = cosine * d[index] + sine * sub[index];
+						sub[index] = cosine * sub[index] - sine * d[index];
+						g = sine * d[index + 1];
+						d[index + 1] = cosine * d[index + 1];
+						rightRotations.push_back({ index, index + 1, cosine, sine });
+
+						t = std::hypot(f, g);
+						cosine = f / t;
+						sine = g / t;
+						d[index] = t;
+						f = cosine * sub[index] + sine * d[index + 1];
+						d[index + 1] = cosine * d[index + 1] - sine * sub[index];
+						g = sine * sub[index + 1];
+						sub[index + 1] = cosine * sub[index + 1];
+						leftRotations.push_back({ index, index + 1, cosine, sine });
+					}
+					sub[last - 2] = f;
+				}
+				if (leftRotations.size() + rightRotations.size() >= 16 * length) {
+					applyRotations(leftRotations, ut, ldu);
+					applyRotations(rightRotations, vt, ldv);
+				}
+			}
+			applyRotations(leftRotations, ut, ldu);
+			applyRotations(rightRotations, vt, ldv);
+
+			// Singular values made nonnegative and sorted descending, rows of singular vectors follow
+			for (size_t index = 0; index < length; index++) {
+				if (d[index] < 0.0) {
+					d[index] = -d[index];
+					if (vt != nullptr) {
+						scale(length, -1.0, vt + index * ldv);
+					}
+				}
+			}
+			std::vector<size_t> order(length);
+			for (size_t index = 0; index < length; index++) {
+				order[index] = index;
+			}
+			std::stable_sort(order.begin(), order.end(), [d](const size_t left, const size_t right) { return d[left] > d[right]; });
+			const std::vector<double> values(d, d + length);
+			for (size_t index = 0; index < length; index++) {
+				d[index] = values[order[index]];
+			}
+			auto permuteRows = [&order, length](double* vectors, const size_t ldVectors) {
+				if (vectors == nullptr) {
+					return;
+				}
+				Dense rows(length, length);
+				for (size_t index = 0; index < length; index++) {
+					std::copy(vectors + order[index] * ldVectors, vectors + order[index] * ldVectors + length, rows.row(index));
+				}
+				for (size_t index = 0; index < length; index++) {
+					std::copy(rows.row(index), rows.row(index) + length, vectors + index * ldVectors);
+				}
+			};
+			permuteRows(ut, ldu);
+			permuteRows(vt, ldv);
+		}
+
+
+
+
+
+		size_t nextPowerOfTwo(const size_t length)
+		{
+			size_t power = 1;
+			while (power < length) {
+				power <<= 1;
+			}
+			return power;
+		}
+
+		namespace {
+			// Iterative radix-2 transform of power-of-two length with twiddles exp(-2 * pi * i * k / length)
+			void radix2Transform(const size_t length, const std::complex<double>* twiddles, std::complex<double>* data, const bool inverse)
+			{
+				for (size_t index = 1, reversed = 0; index < length; index++) {
+					size_t bit = length >> 1;
+					for (; reversed & bit; bit >>= 1) {
+						reversed ^= bit;
+					}
+					reversed ^= bit;
+					if (index < reversed) {
+						std::swap(data[index], data[reversed]);
+					}
+				}
+				for (size_t half = 1; half < length; half <<= 1) {
+					const size_t stride = length / (2 * half);
+					for (size_t begin = 0; begin < length; begin += 2 * half) {
+						for (size_t index = 0; index < half; index++) {
+							const std::complex<double> twiddle = inverse ? std::conj(twiddles[index * stride]) : twiddles[index * stride];
+							const std::complex<double> odd = data[begin + index + half] * twiddle;
+							data[begin + index + half] = data[begin + index] - odd;
+							data[begin + index] += odd;
+						}
+					}
+				}
+			}
+		}
+
+		FourierPlan::FourierPlan(const size_t length)
+			: length(length), power(nextPowerOfTwo(length))
+		{
+			const double pi = std::acos(-1.0);
+			if (power != length) {
+				// X[k] = w[k] * sum_j (x[j] * w[j]) * conj(w[k - j]) with w[k] = exp(-pi * i * k^2 / length) is a convolution
+				// of length 2 * length - 1, done by power-of-two transforms
+				power = nextPowerOfTwo(2 * length - 1);
+				chirp.resize(length);
+				for (size_t index = 0; index < length; index++) {
+					const size_t square = (index * index) % (2 * length); // k^2 mod 2n keeps the angle accurate
+					chirp[index] = std::polar(1.0, -pi * static_cast<double>(square) / static_cast<double>(length));
+				}
+			}
+			twiddles.resize(power / 2);
+			for (size_t index = 0; index < power / 2; index++) {
+				twiddles[index] = std::polar(1.0, -2.0 * pi * static_cast<double>(index) / static_cast<double>(power));
+			}
+			if (!chirp.empty()) {
+				chirpSpectrum.assign(power, 0.0);
+				chirpSpectrum[0] = std::conj(chirp[0]);
+				for (size_t index = 1; index < length; index++) {
+					chirpSpectrum[index] = chirpSpectrum[power - index] = std::conj(chirp[index]);
+				}
+				radix2Transform(power, twiddles.data(), chirpSpectrum.data(), false);
+			}
+		}
+
+		void FourierPlan::transform(std::complex<double>* data, const bool inverse) const
+		{
+			if (chirp.empty()) {
+				radix2Transform(power, twiddles.data(), data, inverse);
+				return;
+			}
+
+			// Inverse transform is conj(DFT(conj(x)))
+			std::vector<std::complex<double>> buffer(power, 0.0);
+			for (size_t index = 0; index < length; index++) {
+				buffer[index] = (inverse ? std::conj(data[index]) : data[index]) * chirp[index];
+			}
+			radix2Transform(power, twiddles.data(), buffer.data(), false);
+			for (size_t index = 0; index < power; index++) {
+				buffer[index] *= chirpSpectrum[index];
+			}
+			radix2Transform(power, twiddles.data(), buffer.data(), true);
+			const double normalization = 1.0 / static_cast<double>(power);
+			for (size_t index = 0; index < length; index++) {
+				const std::complex<double> value = buffer[index] * chirp[index] * normalization;
+				data[index] = inverse ? std::conj(value) : value;
+			}
+		}
+	}
+}
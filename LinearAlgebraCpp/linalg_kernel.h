@@ -0,0 +1,252 @@
+#pragma once
+
+#include "linalg.h"
+#include "linalg_exception.h"
+
+#include <vector>
+#include <complex>
+#include <functional>
+#include <cstdint>
+
+namespace linalg {
+	/*
+	* Internal computation kernels shared by decompositions and structured matrix classes.
+	* User interface containers(Matrixx, Vectorr) are converted into contiguous row-major buffers once,
+	* and every O(n^3) loop runs on the raw buffer with blocked, multi-threaded kernels.
+	*
+	* Kernel functions follow BLAS convention :
+	* matrices are given by (pointer, leading dimension) so that sub-blocks can be passed without copy.
+	*/
+	namespace kernel {
+		enum class Side { Left, Right };
+		enum class Uplo { Lower, Upper };
+		enum class Trans { NoTrans, Trans };
+		enum class Diag { NonUnit, Unit };
+
+		constexpr size_t blockSize = 64; // Cache block length of blocked algorithms
+
+		// Contiguous row-major storage, instantiated for float and double (linalg_kernel.cpp)
+		template <typename Scalar>
+		struct BasicDense {
+			BasicDense(const size_t height = 0, const size_t width = 0, const Scalar value = Scalar(0));
+
+			Scalar& operator()(const size_t row, const size_t col) { return entries[row * width + col]; }
+			const Scalar& operator()(const size_t row, const size_t col) const { return entries[row * width + col]; }
+
+			Scalar* data() { return entries.data(); }
+			const Scalar* data() const { return entries.data(); }
+			Scalar* row(const size_t row) { return entries.data() + row * width; }
+			const Scalar* row(const size_t row) const { return entries.data() + row * width; }
+
+			BasicDense transpose() const;
+
+			size_t height, width;
+			std::vector<Scalar> entries;
+		};
+		using Dense = BasicDense<double>;
+		using DenseF = BasicDense<float>;
+
+		// Compressed sparse row storage, column indices are ascending within each row
+		struct Compressed {
+			Compressed(const size_t height = 0, const size_t width = 0);
+
+			Compressed transpose() const;
+
+			size_t height, width;
+			std::vector<size_t> offsets; // Row i occupies [offsets[i], offsets[i + 1])
+			std::vector<size_t> indices;
+			std::vector<double> values;
+		};
+
+		// Exception shortcuts following ExceptionHandlerr order (check -> argument -> handle)
+		void handleEtcException(const std::string& what); // throws std::logic_error
+		void handleOperationException(const int exceptNum, const char operation,
+			const LengthArgument& leftLengthArg, const LengthArgument& rightLengthArg); // throws std::logic_error when exceptNum > 0
+		void handleIndexException(const size_t row, const size_t col, const size_t height, const size_t width); // throws std::out_of_range
+
+		// Conversion between user interface containers and raw buffers
+		Dense fromMatrix(const Matrixx& matrix);
+		Dense fromColumns(const Vectorr& vector); // n x 1 buffer
+		Matrixx toMatrix(const Dense& dense); // throws std::length_error on empty buffer
+		std::vector<double> fromVector(const Vectorr& vector);
+		Vectorr toVector(const std::vector<double>& entries); // throws std::length_error on empty buffer
+		Vectorr toVector(const double* entries, const size_t size);
+		bool isSymmetric(const Dense& dense); // Square and symmetric up to 1e-12 of largest entry
+		Compressed compress(const Dense& dense, const bool keepDiagonal = false); // Nonzero entries, and every diagonal entry when keepDiagonal
+		Compressed fromSparse(const SparseMatrix& sparse);
+		SparseMatrix toSparse(const Compressed& compressed);
+
+		// Conversion between precisions, rounds to nearest float (parallel over chunks, contiguous loops vectorize)
+		void convert(const size_t length, const double* x, float* y);
+		void convert(const size_t length, const float* x, double* y);
+		DenseF toSingle(const Dense& dense);
+		Dense toDouble(const DenseF& dense);
+
+		// Thread pool-less parallel loop : splits [begin, end) into contiguous chunks of at least grain indices,
+		// an exception thrown by body is rethrown on the calling thread after every chunk has finished
+		size_t threadCount();
+		void setThreadCount(const size_t count); // 0 restores hardware concurrency
+		void parallelFor(const size_t begin, const size_t end,
+			const std::function<void(const size_t, const size_t)>& body, const size_t grain = 1);
+
+		// Level 1
+		double dot(const size_t length, const double* x, const double* y);
+		void axpy(const size_t length, const double alpha, const double* x, double* y); // y += alpha * x
+		void scale(const size_t length, const double alpha, double* x);
+		double norm2(const size_t length, const double* x); // Overflow safe euclidean norm
+		double oneNorm(const size_t height, const size_t width, const double* a, const size_t lda); // Maximum column sum
+		float dot(const size_t length, const float* x, const float* y);
+		void axpy(const size_t length, const float alpha, const float* x, float* y);
+		void scale(const size_t length, const float alpha, float* x);
+
+		// Level 2 : y = alpha * op(A) * x + beta * y, A is (height x width)
+		void gemv(const Trans trans, const size_t height, const size_t width,
+			const double alpha, const double* a, const size_t lda,
+			const double* x, const double beta, double* y);
+		void gemv(const Trans trans, const size_t height, const size_t width,
+			const float alpha, const float* a, const size_t lda,
+			const float* x, const float beta, float* y);
+		// y = alpha * A * x + beta * y, A is symmetric (length x length) and only its lower triangle is referenced
+		void symv(const size_t length, const double alpha, const double* a, const size_t lda,
+			const double* x, const double beta, double* y);
+		// Solve op(A) * x = b in place, A is triangular (length x length), blocked with gemv updates
+		void trsv(const Uplo uplo, const Trans trans, const Diag diag, const size_t length,
+			const double* a, const size_t lda, double* x);
+
+		// Level 3 : C = alpha * op(A) * op(B) + beta * C, C is (height x width), join is the inner length
+		void gemm(const Trans transA, const Trans transB, const size_t height, const size_t width, const size_t join,
+			const double alpha, const double* a, const size_t lda, const double* b, const size_t ldb,
+			const double beta, double* c, const size_t ldc);
+		void gemm(const Trans transA, const Trans transB,
+			const double alpha, const Dense& a, const Dense& b, const double beta, Dense& c);
+		Dense multiply(const Dense& a, const Dense& b, const Trans transA = Trans::NoTrans, const Trans transB = Trans::NoTrans);
+		// Single precision : same blocking, twice the entries per cache line and vector register
+		void gemm(const Trans transA, const Trans transB, const size_t height, const size_t width, const size_t join,
+			const float alpha, const float* a, const size_t lda, const float* b, const size_t ldb,
+			const float beta, float* c, const size_t ldc);
+		void gemm(const Trans transA, const Trans transB,
+			const float alpha, const DenseF& a, const DenseF& b, const float beta, DenseF& c);
+		DenseF multiply(const DenseF& a, const DenseF& b, const Trans transA = Trans::NoTrans, const Trans transB = Trans::NoTrans);
+		// C = alpha * A * A^T + beta * C on lower triangle only, A is (length x join)
+		void syrk(const size_t length, const size_t join,
+			const double alpha, const double* a, const size_t lda, const double beta, double* c, const size_t ldc);
+		void syrk(const size_t length, const size_t join,
+			const float alpha, const float* a, const size_t lda, const float beta, float* c, const size_t ldc);
+		// C = alpha * A * B^T + beta * C on lower triangle only, A and B are (length x join)
+		void gemmt(const size_t length, const size_t join, const double alpha, const double* a, const size_t lda,
+			const double* b, const size_t ldb, const double beta, double* c, const size_t ldc);
+		// Solve op(A) * X = B (Left) or X * op(A) = B (Right) in place, B is (height x width)
+		void trsm(const Side side, const Uplo uplo, const Trans trans, const Diag diag,
+			const size_t height, const size_t width,
+			const double* a, const size_t lda, double* b, const size_t ldb);
+		void trsm(const Side side, const Uplo uplo, const Trans trans, const Diag diag,
+			const size_t height, const size_t width,
+			const float* a, const size_t lda, float* b, const size_t ldb);
+
+		// Integer kernels on int8 entries : products are summed in int32 over blocks short enough not to overflow,
+		// block sums in int64. Plain loops over contiguous int8 are vectorized by the compiler (widening multiply-add)
+		int64_t dot(const size_t length, const int8_t* x, const int8_t* y);
+		// C = A * B^T, A is (height x join) and B is (width x join), rows of both are contiguous, parallel over rows of A
+		void gemmInt8(const size_t height, const size_t width, const size_t join,
+			const int8_t* a, const size_t lda, const int8_t* b, const size_t ldb, int64_t* c, const size_t ldc);
+
+		// Sparse kernels on compressed A, parallel over row chunks of about equal nonzero count
+		// Sort column indices of every row and sum duplicate entries in place
+		void sortCompressed(Compressed& a);
+		// y = alpha * A * x + beta * y
+		void spmv(const double alpha, const Compressed& a, const double* x, const double beta, double* y);
+		// C = alpha * A * B + beta * C, B is (A.width x width) and C is (A.height x width)
+		void spmm(const size_t width, const double alpha, const Compressed& a, const double* b, const size_t ldb,
+			const double beta, double* c, const size_t ldc);
+		// A * B by row-wise accumulation (Gustavson), entries cancelling to zero are kept
+		Compressed spgemm(const Compressed& a, const Compressed& b);
+
+		// Blocked Cholesky factorization A = L * L^T in place on lower triangle (upper triangle is not referenced).
+		// Returns false when a non-positive pivot is met.
+		bool choleskyFactor(const size_t length, double* a, const size_t lda);
+		bool choleskyFactor(const size_t length, float* a, const size_t lda);
+		// Blocked LU factorization with partial pivoting P * A = L * U in place (L has unit diagonal),
+		// row of step i was swapped with pivots[i]. Returns false when an exactly zero pivot is met.
+		bool luFactor(const size_t length, double* a, const size_t lda, size_t* pivots);
+		bool luFactor(const size_t length, float* a, const size_t lda, size_t* pivots);
+		// Solve op(A) * X = B with LU factor, B is (length x width)
+		void luSolve(const Trans trans, const size_t length, const double* a, const size_t lda, const size_t* pivots,
+			const size_t width, double* b, const size_t ldb);
+		void luSolve(const Trans trans, const size_t length, const float* a, const size_t lda, const size_t* pivots,
+			const size_t width, float* b, const size_t ldb);
+		// 1-norm of A^-1 from LU factor (forms the inverse, for small matrices)
+		double luInverseNorm(const size_t length, const double* a, const size_t lda, const size_t* pivots);
+
+		// Householder reflector H = I - tau * v * v^T with H * (alpha, x) = (beta, 0), v = (1, x') :
+		// alpha is overwritten by beta, x by x' (strided by increment) and tau is returned
+		double householder(const size_t length, double& alpha, double* x, const size_t increment = 1);
+		// Upper triangular T of compact WY form H1 * ... * Hk = I - V * T * V^T, V is (height x count) unit lower trapezoidal
+		Dense reflectorFactor(const size_t height, const size_t count, const double* v, const size_t ldv, const double* tau);
+		// B = (I - V * op(T) * V^T) * B, B is (height x width)
+		void applyReflectorBlock(const Trans trans, const size_t height, const size_t width, const size_t count,
+			const double* v, const size_t ldv, const Dense& t, double* b, const size_t ldb);
+		// Blocked Householder QR in place : R on and above diagonal, reflectors below diagonal, tau is (min(height, width))
+		void householderQR(const size_t height, const size_t width, double* a, const size_t lda, double* tau);
+		// Orthonormal basis of the columns (thin Q of Householder QR), height >= width
+		Dense orthonormalColumns(Dense columns);
+
+		// Blocked Householder tridiagonalization Q^T * A * Q = T of symmetric A (lower triangle referenced) in place :
+		// diagonal goes to d (length), subdiagonal to e and reflector factors to tau (length - 1),
+		// reflector j is stored below the subdiagonal of column j with implicit unit entry on row j + 1
+		void tridiagonalize(const size_t length, double* a, const size_t lda, double* d, double* e, double* tau);
+		// B = Q * B with Q from tridiagonalize, B is (length x width)
+		void applyTridiagonalQ(const size_t length, const double* a, const size_t lda, const double* tau,
+			const size_t width, double* b, const size_t ldb);
+
+		// Blocked Householder bidiagonalization Q^T * A * P = B of (height x width) A, height >= width, in place :
+		// diagonal goes to d (width), superdiagonal to e (width - 1), reflector factors to tauLeft (width) and tauRight (width - 1).
+		// Left reflector j is stored below the diagonal of column j (implicit unit on row j),
+		// right reflector j is stored right of the superdiagonal of row j (implicit unit on column j + 1)
+		void bidiagonalize(const size_t height, const size_t width, double* a, const size_t lda,
+			double* d, double* e, double* tauLeft, double* tauRight);
+		// B = Q * B with Q from bidiagonalize (or householderQR), B is (height x count)
+		void applyBidiagonalQ(const size_t height, const size_t width, const double* a, const size_t lda, const double* tau,
+			const size_t count, double* b, const size_t ldb);
+		// B = P * B with P from bidiagonalize, B is (width x count)
+		void applyBidiagonalP(const size_t width, const double* a, const size_t lda, const double* tau,
+			const size_t count, double* b, const size_t ldb);
+
+		// Symmetric tridiagonal eigenproblem : d is diagonal (length), e is subdiagonal (length - 1),
+		// eigenvalues are in ascending order and eigenvectors are columns of (length x count) buffer
+		// Implicit QL iteration, d is overwritten by eigenvalues, vectors (may be nullptr) are rotated in place
+		void tridiagonalQL(const size_t length, double* d, const double* e, double* vectors, const size_t ldv);
+		// Divide and conquer, d is overwritten by eigenvalues
+		void tridiagonalDivideConquer(const size_t length, double* d, const double* e, Dense& vectors);
+		// Eigenvalues of index [first, last) by bisection with Sturm sequence count
+		std::vector<double> tridiagonalBisection(const size_t length, const double* d, const double* e,
+			const size_t first, const size_t last);
+		// Eigenvectors of given ascending eigenvalues by inverse iteration, orthogonalized within clusters
+		Dense tridiagonalInverseIteration(const size_t length, const double* d, const double* e, const std::vector<double>& values);
+
+		// Eigenproblem of general (length x length) A (overwritten) by Hessenberg reduction and shifted double QR, as in JAMA hqr2 :
+		// eigenvalue j is real[j] + i * imaginary[j] (unordered, conjugate pairs adjacent with positive imaginary part first).
+		// Unless vectors is nullptr, column j of vectors is the real eigenvector, and a conjugate pair (j, j + 1) holds
+		// real and imaginary parts of the eigenvector of real[j] + i * imaginary[j] (not normalized)
+		void generalEigen(const size_t length, double* a, const size_t lda, double* real, double* imaginary,
+			double* vectors, const size_t ldv);
+
+		// Upper bidiagonal SVD B = U * diag(d) * V^T by implicit shifted QR : d is diagonal (length), e is superdiagonal (length - 1).
+		// d is overwritten by singular values in descending order, rows of ut and vt (length x length, may be nullptr)
+		// are rotated in place, so that identity input gives U^T and V^T
+		void bidiagonalSVD(const size_t length, double* d, const double* e, double* ut, const size_t ldu, double* vt, const size_t ldv);
+
+		// Discrete Fourier transform X[k] = sum_j x[j] * exp(-2 * pi * i * j * k / length) in place, inverse uses exp(+...) and is unscaled.
+		// Power-of-two lengths run iterative radix-2, other lengths run Bluestein's chirp-z transform on a power-of-two plan.
+		// Twiddle factors are computed once per plan, transform is const and may run from many threads.
+		struct FourierPlan {
+			explicit FourierPlan(const size_t length = 1);
+
+			void transform(std::complex<double>* data, const bool inverse = false) const;
+
+			size_t length, power; // power is the radix-2 length (length itself when it is a power of two)
+			std::vector<std::complex<double>> twiddles; // exp(-2 * pi * i * k / power), k < power / 2
+			std::vector<std::complex<double>> chirp, chirpSpectrum; // Bluestein : exp(-pi * i * k^2 / length) and transform of its conjugate
+		};
+		size_t nextPowerOfTwo(const size_t length);
+	}
+}
@@ -0,0 +1,600 @@
+#include "linalg_precondition.h"
+#include "linalg_sparse.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		constexpr size_t levelGrain = 256; // Rows per thread chunk of a level, smaller levels run on calling thread
+		constexpr size_t blockGrain = 16; // Diagonal blocks per thread chunk of block-Jacobi
+
+		void checkSquare(const Compressed& matrix)
+		{
+			if (matrix.height != matrix.width) {
+				handleEtcException("Cannot build preconditioner of non-square matrix.");
+			}
+		}
+
+		// Check argument length and size result, no allocation when result already has size entries
+		void prepareApply(const size_t size, const std::vector<double>& vector, std::vector<double>& result)
+		{
+			handleOperationException(ExceptionHandlerr::checkHeight(size, vector.size()), '\\',
+				LengthArgument(size, size), LengthArgument(vector.size(), 1));
+			result.resize(size);
+		}
+
+		// Position of diagonal entry in each row, every row must have one
+		std::vector<size_t> diagonalPositions(const Compressed& matrix)
+		{
+			std::vector<size_t> positions(matrix.height);
+			for (size_t row = 0; row < matrix.height; row++) {
+				const auto first = matrix.indices.begin() + matrix.offsets[row];
+				const auto last = matrix.indices.begin() + matrix.offsets[row + 1];
+				const auto found = std::lower_bound(first, last, row);
+				if (found == last || *found != row) {
+					handleEtcException("Diagonal entry is missing from sparse pattern.");
+				}
+				positions[row] = static_cast<size_t>(found - matrix.indices.begin());
+			}
+			return positions;
+		}
+
+		/*
+		* Level scheduled sparse triangular solve : level of a row is one more than the deepest row it depends on,
+		* so rows of a level are independent once earlier levels are solved.
+		* The triangle is the lower (entries left of diagonal) or upper (entries right of diagonal) part of a compressed factor.
+		*/
+		class LevelSchedule {
+		public:
+			LevelSchedule() : mUplo(Uplo::Lower), mOffsets(1, 0) {}
+			LevelSchedule(const Compressed& factor, const std::vector<size_t>& diagonal, const Uplo uplo);
+
+			// x = T^-1 * x in place
+			void solve(const Compressed& factor, const std::vector<size_t>& diagonal, const Diag diag, double* x) const;
+			size_t levelCount() const { return mOffsets.size() - 1; }
+		private:
+			Uplo mUplo;
+			std::vector<size_t> mOffsets, mRows; // Level l holds rows mRows[mOffsets[l]] ... mRows[mOffsets[l + 1] - 1]
+		};
+
+		LevelSchedule::LevelSchedule(const Compressed& factor, const std::vector<size_t>& diagonal, const Uplo uplo)
+			: mUplo(uplo), mRows(factor.height)
+		{
+			const size_t size = factor.height;
+			const bool lower = (uplo == Uplo::Lower);
+			std::vector<size_t> levels(size, 0);
+			size_t count = 0;
+			for (size_t step = 0; step < size; step++) {
+				const size_t row = lower ? step : size - 1 - step;
+				const size_t begin = lower ? factor.offsets[row] : diagonal[row] + 1;
+				const size_t end = lower ? diagonal[row] : factor.offsets[row + 1];
+				size_t level = 0;
+				for (size_t index = begin; index < end; index++) {
+					level = std::max(level, levels[factor.indices[index]] + 1);
+				}
+				levels[row] = level;
+				count = std::max(count, level + 1);
+			}
+
+			// Counting sort of rows by level
+			mOffsets.assign(count + 1, 0);
+			for (size_t row = 0; row < size; row++) {
+				mOffsets[levels[row] + 1]++;
+			}
+			for (size_t level = 0; level < count; level++) {
+				mOffsets[level + 1] += mOffsets[level];
+			}
+			std::vector<size_t> next(mOffsets.begin(), mOffsets.end() - 1);
+			for (size_t row = 0; row < size; row++) {
+				mRows[next[levels[row]]++] = row;
+			}
+		}
+
+		void LevelSchedule::solve(const Compressed& factor, const std::vector<size_t>& diagonal, const Diag diag, double* x) const
+		{
+			const bool lower = (mUplo == Uplo::Lower), unit = (diag == Diag::Unit);
+			auto solveRows = [this, &factor, &diagonal, lower, unit, x](const size_t first, const size_t last) {
+				for (size_t position = first; position < last; position++) {
+					const size_t row = mRows[position];
+					const size_t begin = lower ? factor.offsets[row] : diagonal[row] + 1;
+					const size_t end = lower ? diagonal[row] : factor.offsets[row + 1];
+					double sum = x[row];
+					for (size_t index = begin; index < end; index++) {
+						sum -= factor.values[index] * x[factor.indices[index]];
+					}
+					x[row] = unit ? sum : sum / factor.values[diagonal[row]];
+				}
+			};
+
+			for (size_t level = 0; level < levelCount(); level++) {
+				const size_t begin = mOffsets[level], end = mOffsets[level + 1];
+				if (end - begin < 2 * levelGrain) {
+					solveRows(begin, end);
+				}
+				else {
+					// Single reference capture keeps the task inside std::function's local buffer
+					parallelFor(begin, end, [&solveRows](const size_t first, const size_t last) { solveRows(first, last); }, levelGrain);
+				}
+			}
+		}
+	}
+
+
+
+
+
+	Vectorr Preconditioner::solve(const Vectorr& vector) const
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(size(), vector.size()), '\\',
+			LengthArgument(size(), size()), LengthArgument(vector.size(), 1));
+		std::vector<double> result(size());
+		apply(fromVector(vector), result);
+		return toVector(result);
+	}
+
+
+
+
+
+	class JacobiPreconditioner::Impl {
+	public:
+		Impl(const Compressed& matrix); // throws std::logic_error
+
+		std::vector<double> mInverseDiagonal;
+	};
+
+	JacobiPreconditioner::Impl::Impl(const Compressed& matrix)
+		: mInverseDiagonal(matrix.height)
+	{
+		checkSquare(matrix);
+		const std::vector<size_t> diagonal = diagonalPositions(matrix);
+		for (size_t row = 0; row < matrix.height; row++) {
+			if (matrix.values[diagonal[row]] == 0.0) {
+				handleEtcException("Cannot build Jacobi preconditioner with zero diagonal entry.");
+			}
+			mInverseDiagonal[row] = 1.0 / matrix.values[diagonal[row]];
+		}
+	}
+
+
+
+
+
+	JacobiPreconditioner::JacobiPreconditioner(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(compress(fromMatrix(matrix), true)))
+	{
+	}
+	JacobiPreconditioner::JacobiPreconditioner(const SparseMatrix& matrix)
+		: impl(std::make_unique<Impl>(fromSparse(matrix)))
+	{
+	}
+	JacobiPreconditioner::JacobiPreconditioner(const JacobiPreconditioner& copyPreconditioner)
+		: impl(std::make_unique<Impl>(*(copyPreconditioner.impl)))
+	{
+	}
+	JacobiPreconditioner::~JacobiPreconditioner() = default;
+
+	void JacobiPreconditioner::apply(const std::vector<double>& vector, std::vector<double>& result) const
+	{
+		prepareApply(size(), vector, result);
+		for (size_t index = 0; index < result.size(); index++) {
+			result[index] = vector[index] * impl->mInverseDiagonal[index];
+		}
+	}
+	const size_t JacobiPreconditioner::size() const
+	{
+		return impl->mInverseDiagonal.size();
+	}
+
+	JacobiPreconditioner& JacobiPreconditioner::operator=(const JacobiPreconditioner& rightPreconditioner)
+	{
+		if (this == &rightPreconditioner) {
+			return *this;
+		}
+
+		*impl = *(rightPreconditioner.impl);
+		return *this;
+	}
+
+
+
+
+
+	class BlockJacobiPreconditioner::Impl {
+	public:
+		Impl(const Compressed& matrix, const size_t blockSize); // throws std::logic_error
+
+		size_t blockCount() const { return (mSize + mBlockSize - 1) / mBlockSize; }
+		size_t blockLength(const size_t block) const { return std::min(mBlockSize, mSize - block * mBlockSize); }
+		void solveBlocks(const size_t first, const size_t last, double* x) const; // Blocks [first, last) in place
+
+		size_t mSize, mBlockSize;
+		std::vector<double> mFactors; // LU factor of block k starts at k * blockSize * blockSize, leading dimension is its length
+		std::vector<size_t> mPivots; // Pivots of block k start at k * blockSize, relative to block
+	};
+
+	BlockJacobiPreconditioner::Impl::Impl(const Compressed& matrix, const size_t blockSize)
+		: mSize(matrix.height), mBlockSize(std::min(std::max<size_t>(blockSize, 1), matrix.height))
+	{
+		checkSquare(matrix);
+		mFactors.assign(blockCount() * mBlockSize * mBlockSize, 0.0);
+		mPivots.assign(mSize, 0);
+		for (size_t block = 0; block < blockCount(); block++) {
+			const size_t begin = block * mBlockSize, length = blockLength(block);
+			double* factor = mFactors.data() + block * mBlockSize * mBlockSize;
+			for (size_t row = begin; row < begin + length; row++) {
+				for (size_t index = matrix.offsets[row]; index < matrix.offsets[row + 1]; index++) {
+					const size_t col = matrix.indices[index];
+					if (col >= begin && col < begin + length) {
+						factor[(row - begin) * length + col - begin] = matrix.values[index];
+					}
+				}
+			}
+			if (!luFactor(length, factor, length, mPivots.data() + begin)) {
+				handleEtcException("Cannot build block-Jacobi preconditioner with singular diagonal block.");
+			}
+		}
+	}
+
+	void BlockJacobiPreconditioner::Impl::solveBlocks(const size_t first, const size_t last, double* x) const
+	{
+		for (size_t block = first; block < last; block++) {
+			const size_t begin = block * mBlockSize, length = blockLength(block);
+			const double* factor = mFactors.data() + block * mBlockSize * mBlockSize;
+			const size_t* pivots = mPivots.data() + begin;
+			double* segment = x + begin;
+
+			// P * b, then unit lower and upper substitution
+			for (size_t row = 0; row < length; row++) {
+				std::swap(segment[row], segment[pivots[row]]);
+			}
+			for (size_t row = 1; row < length; row++) {
+				segment[row] -= dot(row, factor + row * length, segment);
+			}
+			for (size_t row = length; row-- > 0;) {
+				const double* factorRow = factor + row * length;
+				segment[row] = (segment[row] - dot(length - row - 1, factorRow + row + 1, segment + row + 1)) / factorRow[row];
+			}
+		}
+	}
+
+
+
+
+
+	BlockJacobiPreconditioner::BlockJacobiPreconditioner(const Matrixx& matrix, const size_t blockSize)
+		: impl(std::make_unique<Impl>(compress(fromMatrix(matrix)), blockSize))
+	{
+	}
+	BlockJacobiPreconditioner::BlockJacobiPreconditioner(const SparseMatrix& matrix, const size_t blockSize)
+		: impl(std::make_unique<Impl>(fromSparse(matrix), blockSize))
+	{
+	}
+	BlockJacobiPreconditioner::BlockJacobiPreconditioner(const BlockJacobiPreconditioner& copyPreconditioner)
+		: impl(std::make_unique<Impl>(*(copyPreconditioner.impl)))
+	{
+	}
+	BlockJacobiPreconditioner::~BlockJacobiPreconditioner() = default;
+
+	void BlockJacobiPreconditioner::apply(const std::vector<double>& vector, std::vector<double>& result) const
+	{
+		prepareApply(size(), vector, result);
+		std::copy(vector.begin(), vector.end(), result.begin());
+		const size_t count = impl->blockCount();
+		double* x = result.data();
+		if (count < 2 * blockGrain) {
+			impl->solveBlocks(0, count, x);
+			return;
+		}
+		const Impl* blocks = impl.get();
+		parallelFor(0, count, [blocks, x](const size_t first, const size_t last) { blocks->solveBlocks(first, last, x); }, blockGrain);
+	}
+	const size_t BlockJacobiPreconditioner::size() const
+	{
+		return impl->mSize;
+	}
+	const size_t BlockJacobiPreconditioner::blockSize() const
+	{
+		return impl->mBlockSize;
+	}
+
+	BlockJacobiPreconditioner& BlockJacobiPreconditioner::operator=(const BlockJacobiPreconditioner& rightPreconditioner)
+	{
+		if (this == &rightPreconditioner) {
+			return *this;
+		}
+
+		*impl = *(rightPreconditioner.impl);
+		return *this;
+	}
+
+
+
+
+
+	class SSORPreconditioner::Impl {
+	public:
+		Impl(const Compressed& matrix, const double relaxation); // throws std::logic_error
+
+		// Off-diagonal entries are scaled by relaxation : lower part is D + w * L, upper part is D + w * U
+		Compressed mFactor;
+		std::vector<size_t> mDiagonalPositions;
+		LevelSchedule mLower, mUpper;
+		double mScale; // w * (2 - w)
+	};
+
+	SSORPreconditioner::Impl::Impl(const Compressed& matrix, const double relaxation)
+		: mFactor(matrix), mScale(relaxation * (2.0 - relaxation))
+	{
+		checkSquare(matrix);
+		if (!(relaxation > 0.0 && relaxation < 2.0)) {
+			handleEtcException("Relaxation factor must be in range (0, 2).");
+		}
+		mDiagonalPositions = diagonalPositions(mFactor);
+		for (size_t row = 0; row < mFactor.height; row++) {
+			if (mFactor.values[mDiagonalPositions[row]] == 0.0) {
+				handleEtcException("Cannot build SSOR preconditioner with zero diagonal entry.");
+			}
+			for (size_t index = mFactor.offsets[row]; index < mFactor.offsets[row + 1]; index++) {
+				if (index != mDiagonalPositions[row]) {
+					mFactor.values[index] *= relaxation;
+				}
+			}
+		}
+		mLower = LevelSchedule(mFactor, mDiagonalPositions, Uplo::Lower);
+		mUpper = LevelSchedule(mFactor, mDiagonalPositions, Uplo::Upper);
+	}
+
+
+
+
+
+	SSORPreconditioner::SSORPreconditioner(const Matrixx& matrix, const double relaxation)
+		: impl(std::make_unique<Impl>(compress(fromMatrix(matrix), true), relaxation))
+	{
+	}
+	SSORPreconditioner::SSORPreconditioner(const SparseMatrix& matrix, const double relaxation)
+		: impl(std::make_unique<Impl>(fromSparse(matrix), relaxation))
+	{
+	}
+	SSORPreconditioner::SSORPreconditioner(const SSORPreconditioner& copyPreconditioner)
+		: impl(std::make_unique<Impl>(*(copyPreconditioner.impl)))
+	{
+	}
+	SSORPreconditioner::~SSORPreconditioner() = default;
+
+	void SSORPreconditioner::apply(const std::vector<double>& vector, std::vector<double>& result) const
+	{
+		// M^-1 = w * (2 - w) * (D + w * U)^-1 * D * (D + w * L)^-1
+		prepareApply(size(), vector, result);
+		std::copy(vector.begin(), vector.end(), result.begin());
+		impl->mLower.solve(impl->mFactor, impl->mDiagonalPositions, Diag::NonUnit, result.data());
+		for (size_t row = 0; row < result.size(); row++) {
+			result[row] *= impl->mFactor.values[impl->mDiagonalPositions[row]];
+		}
+		impl->mUpper.solve(impl->mFactor, impl->mDiagonalPositions, Diag::NonUnit, result.data());
+		scale(result.size(), impl->mScale, result.data());
+	}
+	const size_t SSORPreconditioner::size() const
+	{
+		return impl->mFactor.height;
+	}
+	const size_t SSORPreconditioner::levelCount() const
+	{
+		return std::max(impl->mLower.levelCount(), impl->mUpper.levelCount());
+	}
+
+	SSORPreconditioner& SSORPreconditioner::operator=(const SSORPreconditioner& rightPreconditioner)
+	{
+		if (this == &rightPreconditioner) {
+			return *this;
+		}
+
+		*impl = *(rightPreconditioner.impl);
+		return *this;
+	}
+
+
+
+
+
+	class ILUPreconditioner::Impl {
+	public:
+		Impl(const Compressed& matrix); // throws std::logic_error
+
+		Compressed mFactor; // L below diagonal (unit diagonal implied), U on and above diagonal
+		std::vector<size_t> mDiagonalPositions;
+		LevelSchedule mLower, mUpper;
+	};
+
+	ILUPreconditioner::Impl::Impl(const Compressed& matrix)
+		: mFactor(matrix)
+	{
+		checkSquare(matrix);
+		mDiagonalPositions = diagonalPositions(mFactor);
+
+		// Row-wise (IKJ) elimination restricted to the pattern, position maps columns of current row to entries
+		const size_t none = std::numeric_limits<size_t>::max();
+		std::vector<size_t> position(mFactor.width, none);
+		for (size_t row = 0; row < mFactor.height; row++) {
+			for (size_t index = mFactor.offsets[row]; index < mFactor.offsets[row + 1]; index++) {
+				position[mFactor.indices[index]] = index;
+			}
+			for (size_t index = mFactor.offsets[row]; index < mDiagonalPositions[row]; index++) {
+				const size_t pivotRow = mFactor.indices[index];
+				mFactor.values[index] /= mFactor.values[mDiagonalPositions[pivotRow]];
+				const double multiplier = mFactor.values[index];
+				for (size_t inner = mDiagonalPositions[pivotRow] + 1; inner < mFactor.offsets[pivotRow + 1]; inner++) {
+					const size_t target = position[mFactor.indices[inner]];
+					if (target != none) {
+						mFactor.values[target] -= multiplier * mFactor.values[inner];
+					}
+				}
+			}
+			if (mFactor.values[mDiagonalPositions[row]] == 0.0) {
+				handleEtcException("Incomplete LU factorization met zero pivot.");
+			}
+			for (size_t index = mFactor.offsets[row]; index < mFactor.offsets[row + 1]; index++) {
+				position[mFactor.indices[index]] = none;
+			}
+		}
+		mLower = LevelSchedule(mFactor, mDiagonalPositions, Uplo::Lower);
+		mUpper = LevelSchedule(mFactor, mDiagonalPositions, Uplo::Upper);
+	}
+
+
+
+
+
+	ILUPreconditioner::ILUPreconditioner(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(compress(fromMatrix(matrix), true)))
+	{
+	}
+	ILUPreconditioner::ILUPreconditioner(const SparseMatrix& matrix)
+		: impl(std::make_unique<Impl>(fromSparse(matrix)))
+	{
+	}
+	ILUPreconditioner::ILUPreconditioner(const ILUPreconditioner& copyPreconditioner)
+		: impl(std::make_unique<Impl>(*(copyPreconditioner.impl)))
+	{
+	}
+	ILUPreconditioner::~ILUPreconditioner() = default;
+
+	void ILUPreconditioner::apply(const std::vector<double>& vector, std::vector<double>& result) const
+	{
+		prepareApply(size(), vector, result);
+		std::copy(vector.begin(), vector.end(), result.begin());
+		impl->mLower.solve(impl->mFactor, impl->mDiagonalPositions, Diag::Unit, result.data());
+		impl->mUpper.solve(impl->mFactor, impl->mDiagonalPositions, Diag::NonUnit, result.data());
+	}
+	const size_t ILUPreconditioner::size() const
+	{
+		return impl->mFactor.height;
+	}
+	const size_t ILUPreconditioner::levelCount() const
+	{
+		return std::max(impl->mLower.levelCount(), impl->mUpper.levelCount());
+	}
+
+	ILUPreconditioner& ILUPreconditioner::operator=(const ILUPreconditioner& rightPreconditioner)
+	{
+		if (this == &rightPreconditioner) {
+			return *this;
+		}
+
+		*impl = *(rightPreconditioner.impl);
+		return *this;
+	}
+
+
+
+
+
+	class IncompleteCholeskyPreconditioner::Impl {
+	public:
+		Impl(const Compressed& matrix); // throws std::logic_error
+
+		Compressed mFactor, mTransposed; // L and L^T
+		std::vector<size_t> mDiagonalPositions, mTransposedDiagonalPositions;
+		LevelSchedule mLower, mUpper;
+	};
+
+	IncompleteCholeskyPreconditioner::Impl::Impl(const Compressed& matrix)
+		: mFactor(matrix.height, matrix.width)
+	{
+		checkSquare(matrix);
+
+		// Lower triangle of the pattern, diagonal is the last entry of each row
+		for (size_t row = 0; row < matrix.height; row++) {
+			for (size_t index = matrix.offsets[row]; index < matrix.offsets[row + 1] && matrix.indices[index] <= row; index++) {
+				mFactor.indices.push_back(matrix.indices[index]);
+				mFactor.values.push_back(matrix.values[index]);
+			}
+			mFactor.offsets[row + 1] = mFactor.indices.size();
+		}
+		mDiagonalPositions = diagonalPositions(mFactor);
+
+		// Row-wise factorization : l_ij = (a_ij - sum_k l_ik * l_jk) / l_jj over the pattern of row i
+		const size_t none = std::numeric_limits<size_t>::max();
+		std::vector<size_t> position(mFactor.width, none);
+		for (size_t row = 0; row < mFactor.height; row++) {
+			for (size_t index = mFactor.offsets[row]; index < mFactor.offsets[row + 1]; index++) {
+				position[mFactor.indices[index]] = index;
+			}
+			double pivot = mFactor.values[mDiagonalPositions[row]];
+			for (size_t index = mFactor.offsets[row]; index < mDiagonalPositions[row]; index++) {
+				const size_t col = mFactor.indices[index];
+				double sum = mFactor.values[index];
+				for (size_t inner = mFactor.offsets[col]; inner < mDiagonalPositions[col]; inner++) {
+					const size_t source = position[mFactor.indices[inner]];
+					if (source != none) {
+						sum -= mFactor.values[source] * mFactor.values[inner];
+					}
+				}
+				mFactor.values[index] = sum / mFactor.values[mDiagonalPositions[col]];
+				pivot -= mFactor.values[index] * mFactor.values[index];
+			}
+			if (!(pivot > 0.0)) {
+				handleEtcException("Incomplete Cholesky factorization met non-positive pivot.");
+			}
+			mFactor.values[mDiagonalPositions[row]] = std::sqrt(pivot);
+			for (size_t index = mFactor.offsets[row]; index < mFactor.offsets[row + 1]; index++) {
+				position[mFactor.indices[index]] = none;
+			}
+		}
+
+		mTransposed = mFactor.transpose();
+		mTransposedDiagonalPositions = diagonalPositions(mTransposed);
+		mLower = LevelSchedule(mFactor, mDiagonalPositions, Uplo::Lower);
+		mUpper = LevelSchedule(mTransposed, mTransposedDiagonalPositions, Uplo::Upper);
+	}
+
+
+
+
+
+	IncompleteCholeskyPreconditioner::IncompleteCholeskyPreconditioner(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(compress(fromMatrix(matrix), true)))
+	{
+	}
+	IncompleteCholeskyPreconditioner::IncompleteCholeskyPreconditioner(const SparseMatrix& matrix)
+		: impl(std::make_unique<Impl>(fromSparse(matrix)))
+	{
+	}
+	IncompleteCholeskyPreconditioner::IncompleteCholeskyPreconditioner(const IncompleteCholeskyPreconditioner& copyPreconditioner)
+		: impl(std::make_unique<Impl>(*(copyPreconditioner.impl)))
+	{
+	}
+	IncompleteCholeskyPreconditioner::~IncompleteCholeskyPreconditioner() = default;
+
+	void IncompleteCholeskyPreconditioner::apply(const std::vector<double>& vector, std::vector<double>& result) const
+	{
+		prepareApply(size(), vector, result);
+		std::copy(vector.begin(), vector.end(), result.begin());
+		impl->mLower.solve(impl->mFactor, impl->mDiagonalPositions, Diag::NonUnit, result.data());
+		impl->mUpper.solve(impl->mTransposed, impl->mTransposedDiagonalPositions, Diag::NonUnit, result.data());
+	}
+	const size_t IncompleteCholeskyPreconditioner::size() const
+	{
+		return impl->mFactor.height;
+	}
+	const size_t IncompleteCholeskyPreconditioner::levelCount() const
+	{
+		return std::max(impl->mLower.levelCount(), impl->mUpper.levelCount());
+	}
+
+	IncompleteCholeskyPreconditioner& IncompleteCholeskyPreconditioner::operator=(const IncompleteCholeskyPreconditioner& rightPreconditioner)
+	{
+		if (this == &rightPreconditioner) {
+			return *this;
+		}
+
+		*impl = *(rightPreconditioner.impl);
+		return *this;
+	}
+}
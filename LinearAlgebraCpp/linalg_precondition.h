@@ -0,0 +1,183 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <vector>
+
+namespace linalg {
+	// Preconditioners of iterative solvers
+	// Implementations are in linalg_precondition.cpp, HMatrixPreconditioner is in linalg_hmatrix.cpp
+	class Preconditioner;
+	class JacobiPreconditioner;
+	class BlockJacobiPreconditioner;
+	class SSORPreconditioner;
+	class ILUPreconditioner;
+	class IncompleteCholeskyPreconditioner;
+	class HMatrixPreconditioner;
+	class SparseMatrix; // linalg_sparse.h
+	class HMatrix; // linalg_hmatrix.h
+
+	/*
+	* Preconditioner M ~ A of iterative solvers, apply gives z = M^-1 * r.
+	*
+	* apply writes into caller's buffer and is called once or twice per iteration, so implementations
+	* prepare everything on construction and do not allocate there. Used by KrylovSolver.
+	*/
+	class Preconditioner {
+	public:
+		virtual ~Preconditioner() = default;
+
+		// result = M^-1 * vector, result is resized to size() entries (no allocation when it already has them)
+		virtual void apply(const std::vector<double>& vector, std::vector<double>& result) const = 0; // throws std::logic_error
+		Vectorr solve(const Vectorr& vector) const; // throws std::logic_error, M^-1 * vector
+
+		virtual const size_t size() const = 0;
+	};
+
+	/*
+	* Jacobi (diagonal) preconditioner M = diag(A).
+	*/
+	class JacobiPreconditioner : public Preconditioner {
+	public:
+		explicit JacobiPreconditioner(const Matrixx& matrix); // throws std::logic_error : non-square or zero diagonal entry
+		explicit JacobiPreconditioner(const SparseMatrix& matrix); // throws std::logic_error : non-square or zero diagonal entry
+		JacobiPreconditioner(const JacobiPreconditioner& copyPreconditioner);
+		virtual ~JacobiPreconditioner();
+
+		void apply(const std::vector<double>& vector, std::vector<double>& result) const override; // throws std::logic_error
+		const size_t size() const override;
+
+		JacobiPreconditioner& operator=(const JacobiPreconditioner& rightPreconditioner);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Block-Jacobi preconditioner : M is the block diagonal of A with (blockSize x blockSize) blocks (last one may be smaller).
+	*
+	* Every diagonal block is LU factorized with partial pivoting on construction, and apply solves the blocks in parallel.
+	*/
+	class BlockJacobiPreconditioner : public Preconditioner {
+	public:
+		explicit BlockJacobiPreconditioner(const Matrixx& matrix, const size_t blockSize = 64); // throws std::logic_error : non-square or singular block
+		explicit BlockJacobiPreconditioner(const SparseMatrix& matrix, const size_t blockSize = 64); // throws std::logic_error : non-square or singular block
+		BlockJacobiPreconditioner(const BlockJacobiPreconditioner& copyPreconditioner);
+		virtual ~BlockJacobiPreconditioner();
+
+		void apply(const std::vector<double>& vector, std::vector<double>& result) const override; // throws std::logic_error
+		const size_t size() const override;
+		const size_t blockSize() const;
+
+		BlockJacobiPreconditioner& operator=(const BlockJacobiPreconditioner& rightPreconditioner);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Sparse triangular preconditioners below work on the nonzero pattern of A in compressed rows, so a Matrixx
+	* with mostly zero entries costs O(nonzeros) to set up and to apply. A SparseMatrix is taken with its stored pattern,
+	* which must contain the diagonal.
+	*
+	* Their triangular solves are level scheduled : rows are grouped by dependency depth on construction,
+	* rows of one level only depend on earlier levels and are solved in parallel.
+	* levelCount() is the number of sequential steps of each triangular solve.
+	*/
+
+	/*
+	* Symmetric successive over-relaxation : M = w / (2 - w) * (D / w + L) * D^-1 * (D / w + U),
+	* with A = L + D + U and relaxation w in (0, 2). Symmetric positive-definite for symmetric positive-definite A.
+	*/
+	class SSORPreconditioner : public Preconditioner {
+	public:
+		explicit SSORPreconditioner(const Matrixx& matrix, const double relaxation = 1.0); // throws std::logic_error : non-square, zero diagonal entry or relaxation out of (0, 2)
+		explicit SSORPreconditioner(const SparseMatrix& matrix, const double relaxation = 1.0); // throws std::logic_error : non-square, zero or missing diagonal entry or relaxation out of (0, 2)
+		SSORPreconditioner(const SSORPreconditioner& copyPreconditioner);
+		virtual ~SSORPreconditioner();
+
+		void apply(const std::vector<double>& vector, std::vector<double>& result) const override; // throws std::logic_error
+		const size_t size() const override;
+		const size_t levelCount() const;
+
+		SSORPreconditioner& operator=(const SSORPreconditioner& rightPreconditioner);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Incomplete LU factorization without fill-in, ILU(0) : M = L * U where L (unit lower) and U (upper)
+	* keep the nonzero pattern of A and match A on it.
+	*/
+	class ILUPreconditioner : public Preconditioner {
+	public:
+		explicit ILUPreconditioner(const Matrixx& matrix); // throws std::logic_error : non-square or zero pivot
+		explicit ILUPreconditioner(const SparseMatrix& matrix); // throws std::logic_error : non-square, zero pivot or missing diagonal entry
+		ILUPreconditioner(const ILUPreconditioner& copyPreconditioner);
+		virtual ~ILUPreconditioner();
+
+		void apply(const std::vector<double>& vector, std::vector<double>& result) const override; // throws std::logic_error
+		const size_t size() const override;
+		const size_t levelCount() const;
+
+		ILUPreconditioner& operator=(const ILUPreconditioner& rightPreconditioner);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Incomplete Cholesky factorization without fill-in, IC(0) : M = L * L^T where L keeps the nonzero pattern of
+	* the lower triangle of symmetric A (only the lower triangle is referenced).
+	*/
+	class IncompleteCholeskyPreconditioner : public Preconditioner {
+	public:
+		explicit IncompleteCholeskyPreconditioner(const Matrixx& matrix); // throws std::logic_error : non-square or non-positive pivot
+		explicit IncompleteCholeskyPreconditioner(const SparseMatrix& matrix); // throws std::logic_error : non-square, non-positive pivot or missing diagonal entry
+		IncompleteCholeskyPreconditioner(const IncompleteCholeskyPreconditioner& copyPreconditioner);
+		virtual ~IncompleteCholeskyPreconditioner();
+
+		void apply(const std::vector<double>& vector, std::vector<double>& result) const override; // throws std::logic_error
+		const size_t size() const override;
+		const size_t levelCount() const;
+
+		IncompleteCholeskyPreconditioner& operator=(const IncompleteCholeskyPreconditioner& rightPreconditioner);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Approximate LU factorization of HMatrix on its cluster tree.
+	*
+	* Each cluster splits A into blkdiag(A11, A22) plus its two off-diagonal blocks, which are compressed by ACA
+	* to at most maxRank (tolerance relative to each block). The inverse follows from the children's inverses
+	* by the Woodbury identity, so factorization costs O(maxRank^2 * n * log(n)^2) and apply is one sweep of
+	* dense leaf LU solves and low-rank corrections, clusters of each level in parallel.
+	* With isSymmetric, A(second, first) is taken as the transpose of A(first, second) so that M is symmetric (CG, MINRES),
+	* otherwise truncation makes M nonsymmetric in general (GMRES, BiCGSTAB).
+	* M is accurate where the off-diagonal blocks of the cluster tree are of low rank (HMatrix built with points).
+	*/
+	class HMatrixPreconditioner : public Preconditioner {
+	public:
+		explicit HMatrixPreconditioner(const HMatrix& matrix, const double tolerance = 1e-4, const size_t maxRank = 32,
+			const bool isSymmetric = false); // throws std::logic_error : non-positive tolerance or singular diagonal block, exception of generator
+		HMatrixPreconditioner(const HMatrixPreconditioner& copyPreconditioner);
+		virtual ~HMatrixPreconditioner();
+
+		void apply(const std::vector<double>& vector, std::vector<double>& result) const override; // throws std::logic_error
+		const size_t size() const override;
+
+		HMatrixPreconditioner& operator=(const HMatrixPreconditioner& rightPreconditioner);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
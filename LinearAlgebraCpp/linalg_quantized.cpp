@@ -0,0 +1,236 @@
+#include "linalg_quantized.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		constexpr int quantizedMin = -128, quantizedMax = 127;
+		constexpr size_t rowGrain = 64; // Minimum rows per parallel chunk of quantization
+
+		int8_t quantize(const double value, const double scale, const int zeroPoint)
+		{
+			const double level = std::round(value / scale) + zeroPoint;
+			return static_cast<int8_t>(std::min<double>(std::max<double>(level, quantizedMin), quantizedMax));
+		}
+
+		// Columns of right (width x count) quantized symmetrically into rows of packed (count x width),
+		// multipliers (may be empty) are applied to entries first
+		void quantizeColumns(const Dense& right, const std::vector<double>& multipliers,
+			std::vector<int8_t>& packed, std::vector<double>& scales)
+		{
+			const size_t width = right.height, count = right.width;
+			packed.assign(count * width, 0);
+			scales.assign(count, 0.0);
+			parallelFor(0, count, [&](const size_t colBegin, const size_t colEnd) {
+				std::vector<double> column(width);
+				for (size_t col = colBegin; col < colEnd; col++) {
+					double maxAbsolute = 0.0;
+					for (size_t row = 0; row < width; row++) {
+						column[row] = multipliers.empty() ? right(row, col) : multipliers[row] * right(row, col);
+						maxAbsolute = std::max(maxAbsolute, std::abs(column[row]));
+					}
+					if (maxAbsolute == 0.0) {
+						continue;
+					}
+					scales[col] = maxAbsolute / quantizedMax;
+					int8_t* target = packed.data() + col * width;
+					for (size_t row = 0; row < width; row++) {
+						target[row] = quantize(column[row], scales[col], 0);
+					}
+				}
+			}, std::max<size_t>(1, 8192 / (width + 1)));
+		}
+	}
+
+
+
+
+
+	class QuantizedMatrix::Impl {
+	public:
+		Impl(const Dense& dense, const Axis axis); // throws std::logic_error
+
+		Dense multiply(const Dense& right) const;
+		void checkIndex(const size_t index) const; // throws std::out_of_range
+
+		size_t mHeight, mWidth;
+		Axis mAxis;
+		std::vector<int8_t> mValues; // Row-major
+		std::vector<double> mScales;
+		std::vector<int> mZeroPoints;
+	};
+
+	QuantizedMatrix::Impl::Impl(const Dense& dense, const Axis axis)
+		: mHeight(dense.height), mWidth(dense.width), mAxis(axis), mValues(dense.entries.size())
+	{
+		for (const double entry : dense.entries) {
+			if (!std::isfinite(entry)) {
+				handleEtcException("Cannot quantize non-finite entry.");
+			}
+		}
+
+		// Range of each row (column) including zero is mapped onto [quantizedMin, quantizedMax]
+		const size_t count = (mAxis == Axis::Row) ? mHeight : mWidth;
+		std::vector<double> lows(count, 0.0), highs(count, 0.0);
+		for (size_t row = 0; row < mHeight; row++) {
+			for (size_t col = 0; col < mWidth; col++) {
+				const size_t index = (mAxis == Axis::Row) ? row : col;
+				lows[index] = std::min(lows[index], dense(row, col));
+				highs[index] = std::max(highs[index], dense(row, col));
+			}
+		}
+		mScales.resize(count);
+		mZeroPoints.resize(count);
+		for (size_t index = 0; index < count; index++) {
+			if (highs[index] == lows[index]) {
+				mScales[index] = 1.0;
+				mZeroPoints[index] = 0;
+				continue;
+			}
+			mScales[index] = (highs[index] - lows[index]) / (quantizedMax - quantizedMin);
+			const double zeroPoint = std::round(quantizedMin - lows[index] / mScales[index]);
+			mZeroPoints[index] = static_cast<int>(std::min<double>(std::max<double>(zeroPoint, quantizedMin), quantizedMax));
+		}
+
+		parallelFor(0, mHeight, [&](const size_t rowBegin, const size_t rowEnd) {
+			for (size_t row = rowBegin; row < rowEnd; row++) {
+				for (size_t col = 0; col < mWidth; col++) {
+					const size_t index = (mAxis == Axis::Row) ? row : col;
+					mValues[row * mWidth + col] = quantize(dense(row, col), mScales[index], mZeroPoints[index]);
+				}
+			}
+		}, rowGrain);
+	}
+
+	void QuantizedMatrix::Impl::checkIndex(const size_t index) const
+	{
+		if (mAxis == Axis::Row) {
+			handleIndexException(index, 0, mHeight, mWidth);
+		}
+		else {
+			handleIndexException(0, index, mHeight, mWidth);
+		}
+	}
+
+	Dense QuantizedMatrix::Impl::multiply(const Dense& right) const
+	{
+		// 1. Quantize right columns (scaled by column scales of A when quantized per column)
+		const size_t count = right.width;
+		std::vector<int8_t> packed;
+		std::vector<double> rightScales;
+		quantizeColumns(right, (mAxis == Axis::Column) ? mScales : std::vector<double>(), packed, rightScales);
+
+		// 2. Zero-point terms : sum_j p(j) per row, sum_j zeroPoint(j) * p(j) per column
+		std::vector<int64_t> corrections(count, 0);
+		for (size_t col = 0; col < count; col++) {
+			const int8_t* column = packed.data() + col * mWidth;
+			for (size_t index = 0; index < mWidth; index++) {
+				corrections[col] += static_cast<int64_t>(column[index]) * ((mAxis == Axis::Row) ? 1 : mZeroPoints[index]);
+			}
+		}
+
+		// 3. Integer products and rescaling
+		std::vector<int64_t> sums(mHeight * count);
+		gemmInt8(mHeight, count, mWidth, mValues.data(), mWidth, packed.data(), mWidth, sums.data(), count);
+		Dense product(mHeight, count);
+		for (size_t row = 0; row < mHeight; row++) {
+			for (size_t col = 0; col < count; col++) {
+				const int64_t sum = sums[row * count + col];
+				if (mAxis == Axis::Row) {
+					product(row, col) = mScales[row] * rightScales[col] * static_cast<double>(sum - mZeroPoints[row] * corrections[col]);
+				}
+				else {
+					product(row, col) = rightScales[col] * static_cast<double>(sum - corrections[col]);
+				}
+			}
+		}
+		return product;
+	}
+
+
+
+
+
+	QuantizedMatrix::QuantizedMatrix(const Matrixx& matrix, const Axis axis)
+		: impl(std::make_unique<Impl>(fromMatrix(matrix), axis))
+	{
+	}
+	QuantizedMatrix::QuantizedMatrix(const QuantizedMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	QuantizedMatrix::~QuantizedMatrix() = default;
+
+	const int8_t QuantizedMatrix::operator()(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, impl->mHeight, impl->mWidth);
+		return impl->mValues[row * impl->mWidth + col];
+	}
+	const double QuantizedMatrix::scale(const size_t index) const
+	{
+		impl->checkIndex(index);
+		return impl->mScales[index];
+	}
+	const int QuantizedMatrix::zeroPoint(const size_t index) const
+	{
+		impl->checkIndex(index);
+		return impl->mZeroPoints[index];
+	}
+
+	Matrixx QuantizedMatrix::toMatrix() const
+	{
+		Dense dense(impl->mHeight, impl->mWidth);
+		for (size_t row = 0; row < impl->mHeight; row++) {
+			for (size_t col = 0; col < impl->mWidth; col++) {
+				const size_t index = (impl->mAxis == Axis::Row) ? row : col;
+				dense(row, col) = impl->mScales[index] * (impl->mValues[row * impl->mWidth + col] - impl->mZeroPoints[index]);
+			}
+		}
+		return kernel::toMatrix(dense);
+	}
+	const QuantizedMatrix::Axis QuantizedMatrix::axis() const
+	{
+		return impl->mAxis;
+	}
+	const size_t QuantizedMatrix::storage() const
+	{
+		return impl->mValues.size() * sizeof(int8_t) + impl->mScales.size() * sizeof(double) + impl->mZeroPoints.size() * sizeof(int);
+	}
+	const size_t QuantizedMatrix::height() const
+	{
+		return impl->mHeight;
+	}
+	const size_t QuantizedMatrix::width() const
+	{
+		return impl->mWidth;
+	}
+
+	QuantizedMatrix& QuantizedMatrix::operator=(const QuantizedMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	Vectorr QuantizedMatrix::operator*(const Vectorr& rightVector) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(impl->mWidth, rightVector.size()), '*',
+			LengthArgument(impl->mHeight, impl->mWidth), LengthArgument(rightVector.size(), 1));
+
+		const Dense product = impl->multiply(fromColumns(rightVector));
+		return toVector(product.entries);
+	}
+	Matrixx QuantizedMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(impl->mWidth, rightMatrix.height()), '*',
+			LengthArgument(impl->mHeight, impl->mWidth), LengthArgument(rightMatrix.height(), rightMatrix.width()));
+
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+}
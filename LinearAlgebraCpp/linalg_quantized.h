@@ -0,0 +1,49 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <cstdint>
+
+namespace linalg {
+	// Quantized matrix class
+	// Implementations are in linalg_quantized.cpp
+	class QuantizedMatrix;
+
+	/*
+	* Matrix of int8 values with a scale and zero-point per row or per column (affine quantization) :
+	* A(i, j) ~ scale * (q(i, j) - zeroPoint), the range of every row (column) including 0 is mapped onto [-128, 127],
+	* so zero is exact and the rounding error of an entry is at most scale / 2. Values take 1/8 of the memory of Matrixx.
+	*
+	* Products quantize the right operand on the fly, symmetrically to [-127, 127] with one scale per column,
+	* multiply the int8 values with int32 accumulation and apply scales and zero-points to the integer sums :
+	* per row, y(i) = scale(i) * scale(x) * (sum_j q(i, j) * p(j) - zeroPoint(i) * sum_j p(j)),
+	* per column, x is multiplied by the column scales before quantization and the zero-points are removed the same way.
+	* The result is an approximation for scoring, relative error is about 1% of |A| * |x|.
+	*/
+	class QuantizedMatrix {
+	public:
+		enum class Axis { Row, Column };
+
+		explicit QuantizedMatrix(const Matrixx& matrix, const Axis axis = Axis::Row); // throws std::logic_error : non-finite entry
+		QuantizedMatrix(const QuantizedMatrix& copyMatrix);
+		virtual ~QuantizedMatrix();
+
+		const int8_t operator()(const size_t row, const size_t col) const; // throws std::out_of_range, quantized value
+		const double scale(const size_t index) const; // throws std::out_of_range, index of row or column along axis
+		const int zeroPoint(const size_t index) const; // throws std::out_of_range
+
+		Matrixx toMatrix() const; // Dequantized entries
+		const Axis axis() const;
+		const size_t storage() const; // Bytes of values, scales and zero-points
+		const size_t height() const;
+		const size_t width() const;
+
+		QuantizedMatrix& operator=(const QuantizedMatrix& rightMatrix);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,399 @@
+#include "linalg_scalar.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		void checkValidLength(const size_t height, const size_t width) // throws std::length_error
+		{
+			int exceptNum = ExceptionHandlerr::checkValidHeight(height);
+			exceptNum += ExceptionHandlerr::checkValidWidth(width);
+			if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+				LengthArgument lengthArg(height, width);
+				ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+				handler.addArgument(lengthArg);
+				handler.handleException();
+			}
+		}
+
+		void checkSum(const char operation, const size_t leftHeight, const size_t leftWidth,
+			const size_t rightHeight, const size_t rightWidth) // throws std::logic_error
+		{
+			const LengthArgument leftLengthArg(leftHeight, leftWidth), rightLengthArg(rightHeight, rightWidth);
+			handleOperationException(ExceptionHandlerr::checkHeight(leftHeight, rightHeight), operation, leftLengthArg, rightLengthArg);
+			handleOperationException(ExceptionHandlerr::checkWidth(leftWidth, rightWidth), operation, leftLengthArg, rightLengthArg);
+		}
+
+		// Same precision copies, other precisions round in one vectorized pass
+		template <typename Scalar>
+		void convertEntries(const size_t length, const Scalar* x, Scalar* y)
+		{
+			std::copy(x, x + length, y);
+		}
+		void convertEntries(const size_t length, const double* x, float* y)
+		{
+			convert(length, x, y);
+		}
+		void convertEntries(const size_t length, const float* x, double* y)
+		{
+			convert(length, x, y);
+		}
+
+		template <typename To, typename From>
+		BasicDense<To> convertedDense(const BasicDense<From>& dense)
+		{
+			BasicDense<To> converted(dense.height, dense.width);
+			convertEntries(dense.entries.size(), dense.data(), converted.data());
+			return converted;
+		}
+		template <typename To, typename From>
+		std::vector<To> convertedEntries(const std::vector<From>& entries)
+		{
+			std::vector<To> converted(entries.size());
+			convertEntries(entries.size(), entries.data(), converted.data());
+			return converted;
+		}
+	}
+
+
+
+
+
+	template <typename Scalar>
+	class ScalarMatrix<Scalar>::Impl {
+	public:
+		Impl(const BasicDense<Scalar>& dense) : mDense(dense) {}
+
+		BasicDense<Scalar> mDense;
+	};
+
+	template <typename Scalar>
+	ScalarMatrix<Scalar>::ScalarMatrix(const size_t height, const size_t width)
+	{
+		checkValidLength(height, width);
+		impl = std::make_unique<Impl>(BasicDense<Scalar>(height, width));
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar>::ScalarMatrix(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(convertedDense<Scalar>(fromMatrix(matrix))))
+	{
+	}
+	template <typename Scalar>
+	template <typename Other>
+	ScalarMatrix<Scalar>::ScalarMatrix(const ScalarMatrix<Other>& convertMatrix)
+		: impl(std::make_unique<Impl>(convertedDense<Scalar>(convertMatrix.impl->mDense)))
+	{
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar>::ScalarMatrix(const ScalarMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar>::~ScalarMatrix() = default;
+
+	template <typename Scalar>
+	ScalarMatrix<Scalar> ScalarMatrix<Scalar>::identity(const size_t length)
+	{
+		ScalarMatrix identity(length, length);
+		for (size_t index = 0; index < length; index++) {
+			identity.impl->mDense(index, index) = Scalar(1);
+		}
+		return identity;
+	}
+
+	template <typename Scalar>
+	const Scalar& ScalarMatrix<Scalar>::operator()(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, impl->mDense.height, impl->mDense.width);
+		return impl->mDense(row, col);
+	}
+	template <typename Scalar>
+	Scalar& ScalarMatrix<Scalar>::operator()(const size_t row, const size_t col)
+	{
+		handleIndexException(row, col, impl->mDense.height, impl->mDense.width);
+		return impl->mDense(row, col);
+	}
+
+	template <typename Scalar>
+	ScalarMatrix<Scalar> ScalarMatrix<Scalar>::transpose() const
+	{
+		ScalarMatrix transposed(*this);
+		transposed.impl->mDense = impl->mDense.transpose();
+		return transposed;
+	}
+	template <typename Scalar>
+	Matrixx ScalarMatrix<Scalar>::toMatrix() const
+	{
+		return kernel::toMatrix(convertedDense<double>(impl->mDense));
+	}
+	template <typename Scalar>
+	const size_t ScalarMatrix<Scalar>::height() const
+	{
+		return impl->mDense.height;
+	}
+	template <typename Scalar>
+	const size_t ScalarMatrix<Scalar>::width() const
+	{
+		return impl->mDense.width;
+	}
+
+	template <typename Scalar>
+	ScalarMatrix<Scalar>& ScalarMatrix<Scalar>::operator=(const ScalarMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar>& ScalarMatrix<Scalar>::operator+=(const ScalarMatrix& rightMatrix)
+	{
+		BasicDense<Scalar>& left = impl->mDense;
+		const BasicDense<Scalar>& right = rightMatrix.impl->mDense;
+		checkSum('+', left.height, left.width, right.height, right.width);
+
+		axpy(left.entries.size(), Scalar(1), right.data(), left.data());
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar>& ScalarMatrix<Scalar>::operator-=(const ScalarMatrix& rightMatrix)
+	{
+		BasicDense<Scalar>& left = impl->mDense;
+		const BasicDense<Scalar>& right = rightMatrix.impl->mDense;
+		checkSum('-', left.height, left.width, right.height, right.width);
+
+		axpy(left.entries.size(), Scalar(-1), right.data(), left.data());
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar>& ScalarMatrix<Scalar>::operator*=(const Scalar multiplier)
+	{
+		kernel::scale(impl->mDense.entries.size(), multiplier, impl->mDense.data());
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar> ScalarMatrix<Scalar>::operator+(const ScalarMatrix& rightMatrix) const
+	{
+		ScalarMatrix sum(*this);
+		sum += rightMatrix;
+		return sum;
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar> ScalarMatrix<Scalar>::operator-(const ScalarMatrix& rightMatrix) const
+	{
+		ScalarMatrix difference(*this);
+		difference -= rightMatrix;
+		return difference;
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar> ScalarMatrix<Scalar>::operator*(const ScalarMatrix& rightMatrix) const
+	{
+		const BasicDense<Scalar>& left = impl->mDense;
+		const BasicDense<Scalar>& right = rightMatrix.impl->mDense;
+		handleOperationException(ExceptionHandlerr::checkJoinLength(left.width, right.height), '*',
+			LengthArgument(left.height, left.width), LengthArgument(right.height, right.width));
+
+		ScalarMatrix product(*this);
+		product.impl->mDense = multiply(left, right);
+		return product;
+	}
+	template <typename Scalar>
+	ScalarMatrix<Scalar> ScalarMatrix<Scalar>::operator*(const Scalar multiplier) const
+	{
+		ScalarMatrix product(*this);
+		product *= multiplier;
+		return product;
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar> ScalarMatrix<Scalar>::operator*(const ScalarVector<Scalar>& rightVector) const
+	{
+		const BasicDense<Scalar>& left = impl->mDense;
+		const std::vector<Scalar>& right = rightVector.impl->mEntries;
+		handleOperationException(ExceptionHandlerr::checkJoinLength(left.width, right.size()), '*',
+			LengthArgument(left.height, left.width), LengthArgument(right.size(), 1));
+
+		ScalarVector<Scalar> product(rightVector);
+		product.impl->mEntries.assign(left.height, Scalar(0));
+		gemv(Trans::NoTrans, left.height, left.width, Scalar(1), left.data(), left.width,
+			right.data(), Scalar(0), product.impl->mEntries.data());
+		return product;
+	}
+
+	template <typename Scalar>
+	bool ScalarMatrix<Scalar>::operator==(const ScalarMatrix& rightMatrix) const
+	{
+		const BasicDense<Scalar>& left = impl->mDense;
+		const BasicDense<Scalar>& right = rightMatrix.impl->mDense;
+		return left.height == right.height && left.width == right.width && left.entries == right.entries;
+	}
+	template <typename Scalar>
+	bool ScalarMatrix<Scalar>::operator!=(const ScalarMatrix& rightMatrix) const
+	{
+		return !(*this == rightMatrix);
+	}
+
+
+
+
+
+	template <typename Scalar>
+	class ScalarVector<Scalar>::Impl {
+	public:
+		Impl(const std::vector<Scalar>& entries) : mEntries(entries) {}
+
+		void checkLength(const char operation, const size_t length) const; // throws std::logic_error
+
+		std::vector<Scalar> mEntries;
+	};
+
+	template <typename Scalar>
+	void ScalarVector<Scalar>::Impl::checkLength(const char operation, const size_t length) const
+	{
+		checkSum(operation, mEntries.size(), 1, length, 1);
+	}
+
+	template <typename Scalar>
+	ScalarVector<Scalar>::ScalarVector(const size_t size)
+	{
+		checkValidLength(size, 1);
+		impl = std::make_unique<Impl>(std::vector<Scalar>(size, Scalar(0)));
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar>::ScalarVector(const Vectorr& vector)
+		: impl(std::make_unique<Impl>(convertedEntries<Scalar>(fromVector(vector))))
+	{
+	}
+	template <typename Scalar>
+	template <typename Other>
+	ScalarVector<Scalar>::ScalarVector(const ScalarVector<Other>& convertVector)
+		: impl(std::make_unique<Impl>(convertedEntries<Scalar>(convertVector.impl->mEntries)))
+	{
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar>::ScalarVector(const ScalarVector& copyVector)
+		: impl(std::make_unique<Impl>(*(copyVector.impl)))
+	{
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar>::~ScalarVector() = default;
+
+	template <typename Scalar>
+	const Scalar& ScalarVector<Scalar>::operator[](const size_t index) const
+	{
+		handleIndexException(index, 0, impl->mEntries.size(), 1);
+		return impl->mEntries[index];
+	}
+	template <typename Scalar>
+	Scalar& ScalarVector<Scalar>::operator[](const size_t index)
+	{
+		handleIndexException(index, 0, impl->mEntries.size(), 1);
+		return impl->mEntries[index];
+	}
+
+	template <typename Scalar>
+	Scalar ScalarVector<Scalar>::dot(const ScalarVector& rightVector) const
+	{
+		const std::vector<Scalar>& right = rightVector.impl->mEntries;
+		handleOperationException(ExceptionHandlerr::checkJoinLength(impl->mEntries.size(), right.size()), '*',
+			LengthArgument(1, impl->mEntries.size()), LengthArgument(right.size(), 1));
+
+		return kernel::dot(right.size(), impl->mEntries.data(), right.data());
+	}
+	template <typename Scalar>
+	Vectorr ScalarVector<Scalar>::toVector() const
+	{
+		return kernel::toVector(convertedEntries<double>(impl->mEntries));
+	}
+	template <typename Scalar>
+	const size_t ScalarVector<Scalar>::size() const
+	{
+		return impl->mEntries.size();
+	}
+
+	template <typename Scalar>
+	ScalarVector<Scalar>& ScalarVector<Scalar>::operator=(const ScalarVector& rightVector)
+	{
+		if (this == &rightVector) {
+			return *this;
+		}
+
+		*impl = *(rightVector.impl);
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar>& ScalarVector<Scalar>::operator+=(const ScalarVector& rightVector)
+	{
+		const std::vector<Scalar>& right = rightVector.impl->mEntries;
+		impl->checkLength('+', right.size());
+
+		axpy(right.size(), Scalar(1), right.data(), impl->mEntries.data());
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar>& ScalarVector<Scalar>::operator-=(const ScalarVector& rightVector)
+	{
+		const std::vector<Scalar>& right = rightVector.impl->mEntries;
+		impl->checkLength('-', right.size());
+
+		axpy(right.size(), Scalar(-1), right.data(), impl->mEntries.data());
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar>& ScalarVector<Scalar>::operator*=(const Scalar multiplier)
+	{
+		kernel::scale(impl->mEntries.size(), multiplier, impl->mEntries.data());
+		return *this;
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar> ScalarVector<Scalar>::operator+(const ScalarVector& rightVector) const
+	{
+		ScalarVector sum(*this);
+		sum += rightVector;
+		return sum;
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar> ScalarVector<Scalar>::operator-(const ScalarVector& rightVector) const
+	{
+		ScalarVector difference(*this);
+		difference -= rightVector;
+		return difference;
+	}
+	template <typename Scalar>
+	ScalarVector<Scalar> ScalarVector<Scalar>::operator*(const Scalar multiplier) const
+	{
+		ScalarVector product(*this);
+		product *= multiplier;
+		return product;
+	}
+
+	template <typename Scalar>
+	bool ScalarVector<Scalar>::operator==(const ScalarVector& rightVector) const
+	{
+		return impl->mEntries == rightVector.impl->mEntries;
+	}
+	template <typename Scalar>
+	bool ScalarVector<Scalar>::operator!=(const ScalarVector& rightVector) const
+	{
+		return !(*this == rightVector);
+	}
+
+
+
+
+
+	template class ScalarMatrix<float>;
+	template class ScalarMatrix<double>;
+	template class ScalarVector<float>;
+	template class ScalarVector<double>;
+
+	template ScalarMatrix<float>::ScalarMatrix(const ScalarMatrix<double>& convertMatrix);
+	template ScalarMatrix<double>::ScalarMatrix(const ScalarMatrix<float>& convertMatrix);
+	template ScalarVector<float>::ScalarVector(const ScalarVector<double>& convertVector);
+	template ScalarVector<double>::ScalarVector(const ScalarVector<float>& convertVector);
+}
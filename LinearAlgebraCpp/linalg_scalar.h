@@ -0,0 +1,99 @@
+#pragma once
+
+#include "linalg.h"
+
+namespace linalg {
+	// Scalar templated matrix and vector classes
+	// Implementations are in linalg_scalar.cpp, instantiated for float and double
+	template <typename Scalar> class ScalarMatrix;
+	template <typename Scalar> class ScalarVector;
+
+	using MatrixF = ScalarMatrix<float>;
+	using VectorF = ScalarVector<float>;
+	using MatrixD = ScalarMatrix<double>;
+	using VectorD = ScalarVector<double>;
+
+	/*
+	* Dense (height x width) matrix of Scalar entries in one contiguous row-major buffer.
+	*
+	* Products run the scalar templated kernels (gemm, gemv), so float halves memory traffic of double
+	* and doubles entries per vector register. Entries are accumulated in Scalar, float results carry float rounding.
+	* Conversions between precisions and from/to Matrixx are explicit, they round to nearest and run as one vectorized pass.
+	*/
+	template <typename Scalar>
+	class ScalarMatrix {
+		template <typename Other> friend class ScalarMatrix;
+	public:
+		explicit ScalarMatrix(const size_t height = 1, const size_t width = 1); // throws std::length_error, zero matrix
+		explicit ScalarMatrix(const Matrixx& matrix);
+		template <typename Other>
+		explicit ScalarMatrix(const ScalarMatrix<Other>& convertMatrix);
+		ScalarMatrix(const ScalarMatrix& copyMatrix);
+		virtual ~ScalarMatrix();
+
+		static ScalarMatrix identity(const size_t length); // throws std::length_error
+
+		const Scalar& operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		Scalar& operator()(const size_t row, const size_t col); // throws std::out_of_range
+
+		ScalarMatrix transpose() const;
+		Matrixx toMatrix() const;
+		const size_t height() const;
+		const size_t width() const;
+
+		ScalarMatrix& operator=(const ScalarMatrix& rightMatrix);
+		ScalarMatrix& operator+=(const ScalarMatrix& rightMatrix); // throws std::logic_error
+		ScalarMatrix& operator-=(const ScalarMatrix& rightMatrix); // throws std::logic_error
+		ScalarMatrix& operator*=(const Scalar multiplier);
+		ScalarMatrix operator+(const ScalarMatrix& rightMatrix) const; // throws std::logic_error
+		ScalarMatrix operator-(const ScalarMatrix& rightMatrix) const; // throws std::logic_error
+		ScalarMatrix operator*(const ScalarMatrix& rightMatrix) const; // throws std::logic_error
+		ScalarMatrix operator*(const Scalar multiplier) const;
+		ScalarVector<Scalar> operator*(const ScalarVector<Scalar>& rightVector) const; // throws std::logic_error
+
+		bool operator==(const ScalarMatrix& rightMatrix) const;
+		bool operator!=(const ScalarMatrix& rightMatrix) const;
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Vector of Scalar entries, conversions follow ScalarMatrix.
+	*/
+	template <typename Scalar>
+	class ScalarVector {
+		friend class ScalarMatrix<Scalar>;
+		template <typename Other> friend class ScalarVector;
+	public:
+		explicit ScalarVector(const size_t size = 1); // throws std::length_error, zero vector
+		explicit ScalarVector(const Vectorr& vector);
+		template <typename Other>
+		explicit ScalarVector(const ScalarVector<Other>& convertVector);
+		ScalarVector(const ScalarVector& copyVector);
+		virtual ~ScalarVector();
+
+		const Scalar& operator[](const size_t index) const; // throws std::out_of_range
+		Scalar& operator[](const size_t index); // throws std::out_of_range
+
+		Scalar dot(const ScalarVector& rightVector) const; // throws std::logic_error
+		Vectorr toVector() const;
+		const size_t size() const;
+
+		ScalarVector& operator=(const ScalarVector& rightVector);
+		ScalarVector& operator+=(const ScalarVector& rightVector); // throws std::logic_error
+		ScalarVector& operator-=(const ScalarVector& rightVector); // throws std::logic_error
+		ScalarVector& operator*=(const Scalar multiplier);
+		ScalarVector operator+(const ScalarVector& rightVector) const; // throws std::logic_error
+		ScalarVector operator-(const ScalarVector& rightVector) const; // throws std::logic_error
+		ScalarVector operator*(const Scalar multiplier) const;
+
+		bool operator==(const ScalarVector& rightVector) const;
+		bool operator!=(const ScalarVector& rightVector) const;
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
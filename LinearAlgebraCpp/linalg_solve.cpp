@@ -0,0 +1,1033 @@
+#include "linalg_solve.h"
+#include "linalg_decompose.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace linalg {
+	using namespace kernel;
+
+	class TSQR::Impl {
+	public:
+		Impl(const size_t width, const size_t rightWidth); // throws std::length_error
+
+		void append(const Matrixx& rowBlock, const Matrixx& rightBlock); // throws std::logic_error
+		void append(const Roww& row, const double rightValue); // throws std::logic_error
+		void append(const Dense& augmentedRows);
+		void merge(const Impl& lowerImpl); // throws std::logic_error
+
+		void reduce(Dense& upper, const double* rows, const size_t count) const; // upper = R of [upper; rows]
+		Dense finalFactor() const; // Triangular factor including buffered rows
+		Dense solve() const; // throws std::logic_error
+
+		void checkBlock(const size_t height, const size_t width, const size_t rightHeight, const size_t rightWidth) const; // throws std::logic_error
+
+		const size_t length() const; // width + rightWidth
+
+		size_t mWidth, mRightWidth, mRowCount;
+		size_t mChunkRows; // Rows reduced at once by a worker, bounds memory per worker
+		Dense mUpper; // R of augmented system
+		Dense mBuffer; // Rows appended one by one
+		size_t mBufferCount;
+	};
+
+	TSQR::Impl::Impl(const size_t width, const size_t rightWidth)
+		: mWidth(width), mRightWidth(rightWidth), mRowCount(0), mBufferCount(0)
+	{
+		int exceptNum = ExceptionHandlerr::checkValidWidth(width);
+		exceptNum += ExceptionHandlerr::checkValidHeight(rightWidth);
+		if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+			LengthArgument lengthArg(rightWidth, width);
+			ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+			handler.addArgument(lengthArg);
+			handler.handleException();
+		}
+
+		mChunkRows = std::max<size_t>(4 * length(), 256);
+		mUpper = Dense(length(), length());
+		mBuffer = Dense(mChunkRows, length());
+	}
+
+	const size_t TSQR::Impl::length() const
+	{
+		return mWidth + mRightWidth;
+	}
+
+	void TSQR::Impl::reduce(Dense& upper, const double* rows, const size_t count) const
+	{
+		const size_t length = upper.width;
+		Dense stacked(length + std::min(count, mChunkRows), length);
+		std::vector<double> tau(length);
+		for (size_t rowBegin = 0; rowBegin < count; rowBegin += mChunkRows) {
+			const size_t rowEnd = std::min(rowBegin + mChunkRows, count);
+			stacked.height = length + rowEnd - rowBegin;
+			std::copy(upper.entries.begin(), upper.entries.end(), stacked.entries.begin());
+			std::copy(rows + rowBegin * length, rows + rowEnd * length, stacked.row(length));
+
+			householderQR(stacked.height, length, stacked.data(), length, tau.data());
+			for (size_t row = 0; row < length; row++) {
+				std::fill(upper.row(row), upper.row(row) + row, 0.0);
+				std::copy(stacked.row(row) + row, stacked.row(row) + length, upper.row(row) + row);
+			}
+		}
+	}
+
+	void TSQR::Impl::append(const Matrixx& rowBlock, const Matrixx& rightBlock)
+	{
+		checkBlock(rowBlock.height(), rowBlock.width(), rightBlock.height(), rightBlock.width());
+
+		Dense augmentedRows(rowBlock.height(), length());
+		for (size_t row = 0; row < augmentedRows.height; row++) {
+			const Roww& matrixRow = rowBlock[row];
+			const Roww& rightRow = rightBlock[row];
+			double* augmentedRow = augmentedRows.row(row);
+			for (size_t col = 0; col < mWidth; col++) {
+				augmentedRow[col] = matrixRow[col];
+			}
+			for (size_t col = 0; col < mRightWidth; col++) {
+				augmentedRow[mWidth + col] = rightRow[col];
+			}
+		}
+		append(augmentedRows);
+	}
+	void TSQR::Impl::append(const Roww& row, const double rightValue)
+	{
+		checkBlock(1, row.size(), 1, 1);
+
+		double* bufferRow = mBuffer.row(mBufferCount);
+		for (size_t col = 0; col < mWidth; col++) {
+			bufferRow[col] = row[col];
+		}
+		bufferRow[mWidth] = rightValue;
+		mBufferCount++;
+		mRowCount++;
+
+		if (mBufferCount == mBuffer.height) {
+			reduce(mUpper, mBuffer.data(), mBufferCount);
+			mBufferCount = 0;
+		}
+	}
+	void TSQR::Impl::append(const Dense& augmentedRows)
+	{
+		const size_t count = augmentedRows.height;
+		mRowCount += count;
+
+		const size_t partCount = std::min(threadCount(), count / mChunkRows);
+		if (partCount <= 1) {
+			reduce(mUpper, augmentedRows.data(), count);
+			return;
+		}
+
+		// 1. Each worker reduces its own contiguous rows into a partial factor
+		std::vector<Dense> partials(partCount, Dense(length(), length()));
+		const size_t partRows = (count + partCount - 1) / partCount;
+		parallelFor(0, partCount, [&](const size_t partBegin, const size_t partEnd) {
+			for (size_t part = partBegin; part < partEnd; part++) {
+				const size_t rowBegin = part * partRows;
+				const size_t rowEnd = std::min(rowBegin + partRows, count);
+				if (rowBegin < rowEnd) {
+					reduce(partials[part], augmentedRows.row(rowBegin), rowEnd - rowBegin);
+				}
+			}
+		});
+
+		// 2. Combine partial factors pairwise up the reduction tree
+		for (size_t stride = 1; stride < partCount; stride *= 2) {
+			const size_t pairCount = (partCount + 2 * stride - 1) / (2 * stride);
+			parallelFor(0, pairCount, [&](const size_t pairBegin, const size_t pairEnd) {
+				for (size_t pair = pairBegin; pair < pairEnd; pair++) {
+					const size_t upper = 2 * stride * pair, lower = upper + stride;
+					if (lower < partCount) {
+						reduce(partials[upper], partials[lower].data(), length());
+					}
+				}
+			});
+		}
+		reduce(mUpper, partials[0].data(), length());
+	}
+
+	void TSQR::Impl::merge(const Impl& lowerImpl)
+	{
+		int exceptNum = ExceptionHandlerr::checkWidth(mWidth, lowerImpl.mWidth);
+		exceptNum += ExceptionHandlerr::checkHeight(mRightWidth, lowerImpl.mRightWidth);
+		handleOperationException(exceptNum, '|',
+			LengthArgument(mRightWidth, mWidth), LengthArgument(lowerImpl.mRightWidth, lowerImpl.mWidth));
+
+		const Dense lowerUpper = lowerImpl.finalFactor();
+		reduce(mUpper, lowerUpper.data(), length());
+		mRowCount += lowerImpl.mRowCount;
+	}
+
+	Dense TSQR::Impl::finalFactor() const
+	{
+		Dense upper(mUpper);
+		reduce(upper, mBuffer.data(), mBufferCount);
+		return upper;
+	}
+
+	Dense TSQR::Impl::solve() const
+	{
+		const Dense upper = finalFactor();
+
+		double maxDiagonal = 0.0;
+		for (size_t index = 0; index < mWidth; index++) {
+			maxDiagonal = std::max(maxDiagonal, std::abs(upper(index, index)));
+		}
+		const double tolerance = mWidth * std::numeric_limits<double>::epsilon() * maxDiagonal;
+		for (size_t index = 0; index < mWidth; index++) {
+			if (!(std::abs(upper(index, index)) > tolerance)) {
+				handleEtcException("Cannot solve rank deficient least squares problem.");
+			}
+		}
+
+		// R11 * X = R12
+		Dense solution(mWidth, mRightWidth);
+		for (size_t row = 0; row < mWidth; row++) {
+			std::copy(upper.row(row) + mWidth, upper.row(row) + length(), solution.row(row));
+		}
+		trsm(Side::Left, Uplo::Upper, Trans::NoTrans, Diag::NonUnit, mWidth, mRightWidth,
+			upper.data(), upper.width, solution.data(), solution.width);
+		return solution;
+	}
+
+	void TSQR::Impl::checkBlock(const size_t height, const size_t width, const size_t rightHeight, const size_t rightWidth) const
+	{
+		handleOperationException(ExceptionHandlerr::checkWidth(mWidth, width), '|',
+			LengthArgument(mRowCount, mWidth), LengthArgument(height, width));
+		int exceptNum = ExceptionHandlerr::checkHeight(height, rightHeight);
+		exceptNum += ExceptionHandlerr::checkWidth(mRightWidth, rightWidth);
+		handleOperationException(exceptNum, '&',
+			LengthArgument(height, width), LengthArgument(rightHeight, rightWidth));
+	}
+
+
+
+
+
+	TSQR::TSQR(const size_t width, const size_t rightWidth)
+		: impl(std::make_unique<Impl>(width, rightWidth))
+	{
+	}
+	TSQR::TSQR(const TSQR& copyTSQR)
+		: impl(std::make_unique<Impl>(*(copyTSQR.impl)))
+	{
+	}
+	TSQR::~TSQR() = default;
+
+	void TSQR::append(const Matrixx& rowBlock, const Vectorr& rightBlock)
+	{
+		append(rowBlock, Matrixx(rightBlock));
+	}
+	void TSQR::append(const Matrixx& rowBlock, const Matrixx& rightBlock)
+	{
+		impl->append(rowBlock, rightBlock);
+	}
+	void TSQR::append(const Roww& row, const double rightValue)
+	{
+		impl->append(row, rightValue);
+	}
+
+	Vectorr TSQR::solve(const size_t rightCol) const
+	{
+		int exceptNum = ExceptionHandlerr::checkColumnIndex(rightCol, impl->mRightWidth);
+		if (exceptNum > static_cast<int>(IndexState::NoExcept)) {
+			ColumnIndexArgument colIndexArg(rightCol, impl->mRightWidth);
+			ExceptionHandlerr handler(ExceptionState::OutOfRange, exceptNum);
+			handler.addArgument(colIndexArg);
+			handler.handleException();
+		}
+
+		const Dense solution = impl->solve();
+		Vectorr solutionVector(impl->mWidth);
+		for (size_t row = 0; row < impl->mWidth; row++) {
+			solutionVector[row] = solution(row, rightCol);
+		}
+		return solutionVector;
+	}
+	Matrixx TSQR::solveAll() const
+	{
+		return toMatrix(impl->solve());
+	}
+	double TSQR::residualNorm(const size_t rightCol) const
+	{
+		int exceptNum = ExceptionHandlerr::checkColumnIndex(rightCol, impl->mRightWidth);
+		if (exceptNum > static_cast<int>(IndexState::NoExcept)) {
+			ColumnIndexArgument colIndexArg(rightCol, impl->mRightWidth);
+			ExceptionHandlerr handler(ExceptionState::OutOfRange, exceptNum);
+			handler.addArgument(colIndexArg);
+			handler.handleException();
+		}
+
+		// Residual of column j lives in R22(0:j, j)
+		const Dense upper = impl->finalFactor();
+		std::vector<double> residual(rightCol + 1);
+		for (size_t row = 0; row <= rightCol; row++) {
+			residual[row] = upper(impl->mWidth + row, impl->mWidth + rightCol);
+		}
+		return norm2(residual.size(), residual.data());
+	}
+	Matrixx TSQR::R() const
+	{
+		const Dense upper = impl->finalFactor();
+		Dense leading(impl->mWidth, impl->mWidth);
+		for (size_t row = 0; row < leading.height; row++) {
+			std::copy(upper.row(row), upper.row(row) + leading.width, leading.row(row));
+		}
+		return toMatrix(leading);
+	}
+
+	const size_t TSQR::rowCount() const
+	{
+		return impl->mRowCount;
+	}
+	const size_t TSQR::width() const
+	{
+		return impl->mWidth;
+	}
+	const size_t TSQR::rightWidth() const
+	{
+		return impl->mRightWidth;
+	}
+
+	TSQR& TSQR::operator=(const TSQR& rightTSQR)
+	{
+		if (this == &rightTSQR) {
+			return *this;
+		}
+
+		*impl = *(rightTSQR.impl);
+		return *this;
+	}
+	TSQR& TSQR::operator|=(const TSQR& lowerTSQR)
+	{
+		impl->merge(*(lowerTSQR.impl));
+		return *this;
+	}
+
+
+
+
+
+	class RecursiveLeastSquares::Impl {
+	public:
+		Impl(const size_t width, const double forgettingFactor, const double initialVariance); // throws std::length_error, std::logic_error
+		Impl(const Matrixx& rows, const Vectorr& targets, const double forgettingFactor); // throws std::logic_error
+
+		void append(const Roww& row, const double target); // throws std::logic_error
+		double predict(const Roww& row) const; // throws std::logic_error
+
+		void setForgettingFactor(const double forgettingFactor); // throws std::logic_error
+		void checkRow(const size_t width) const; // throws std::logic_error
+
+		Dense mCovariance; // P
+		std::vector<double> mCoefficients; // x
+		double mForgettingFactor;
+		size_t mRowCount;
+	};
+
+	RecursiveLeastSquares::Impl::Impl(const size_t width, const double forgettingFactor, const double initialVariance)
+		: mCovariance(width, width), mCoefficients(width, 0.0), mRowCount(0)
+	{
+		int exceptNum = ExceptionHandlerr::checkValidWidth(width);
+		if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+			LengthArgument lengthArg(1, width);
+			ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+			handler.addArgument(lengthArg);
+			handler.handleException();
+		}
+		if (!(initialVariance > 0.0)) {
+			handleEtcException("Initial variance must be positive.");
+		}
+		setForgettingFactor(forgettingFactor);
+
+		for (size_t index = 0; index < width; index++) {
+			mCovariance(index, index) = initialVariance;
+		}
+	}
+	RecursiveLeastSquares::Impl::Impl(const Matrixx& rows, const Vectorr& targets, const double forgettingFactor)
+		: mRowCount(rows.height())
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(rows.height(), targets.size()), '\\',
+			LengthArgument(rows.height(), rows.width()), LengthArgument(targets.size(), 1));
+		setForgettingFactor(forgettingFactor);
+
+		// P = (A^T * A)^-1 and x = P * A^T * b through Cholesky of normal matrix
+		const Dense dense = fromMatrix(rows);
+		Dense normal(dense.width, dense.width);
+		syrk(dense.width, dense.height, 1.0, dense.transpose().data(), dense.height, 0.0, normal.data(), normal.width);
+		for (size_t row = 0; row < normal.height; row++) {
+			for (size_t col = row + 1; col < normal.width; col++) {
+				normal(row, col) = normal(col, row);
+			}
+		}
+		const Cholesky normalCholesky(toMatrix(normal)); // Not positive-definite when rows are rank deficient
+		mCovariance = fromMatrix(normalCholesky.inverse());
+
+		std::vector<double> projected(dense.width);
+		gemv(Trans::Trans, dense.height, dense.width, 1.0, dense.data(), dense.width,
+			fromVector(targets).data(), 0.0, projected.data());
+		mCoefficients = fromVector(normalCholesky.solve(toVector(projected)));
+	}
+
+	void RecursiveLeastSquares::Impl::setForgettingFactor(const double forgettingFactor)
+	{
+		if (!(forgettingFactor > 0.0 && forgettingFactor <= 1.0)) {
+			handleEtcException("Forgetting factor must be in range (0, 1].");
+		}
+		mForgettingFactor = forgettingFactor;
+	}
+
+	void RecursiveLeastSquares::Impl::checkRow(const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(width, mCoefficients.size()), '*',
+			LengthArgument(1, width), LengthArgument(mCoefficients.size(), 1));
+	}
+
+	void RecursiveLeastSquares::Impl::append(const Roww& row, const double target)
+	{
+		checkRow(row.size());
+
+		const size_t width = mCoefficients.size();
+		std::vector<double> entries(width);
+		for (size_t col = 0; col < width; col++) {
+			entries[col] = row[col];
+		}
+
+		// 1. Gain k = P * r / (lambda + r^T * P * r)
+		std::vector<double> projected(width);
+		gemv(Trans::NoTrans, width, width, 1.0, mCovariance.data(), width, entries.data(), 0.0, projected.data());
+		const double denominator = mForgettingFactor + dot(width, entries.data(), projected.data());
+
+		// 2. x += k * (y - r^T * x)
+		const double error = target - dot(width, entries.data(), mCoefficients.data());
+		axpy(width, error / denominator, projected.data(), mCoefficients.data());
+
+		// 3. P = (P - k * (P * r)^T) / lambda
+		// Each entry is computed as (p_i * p_j) so that P stays exactly symmetric,
+		// otherwise rounding asymmetry grows by 1 / lambda on every step
+		const double inverseDenominator = 1.0 / denominator, inverseForgetting = 1.0 / mForgettingFactor;
+		parallelFor(0, width, [&](const size_t rowBegin, const size_t rowEnd) {
+			for (size_t index = rowBegin; index < rowEnd; index++) {
+				double* covarianceRow = mCovariance.row(index);
+				for (size_t col = 0; col < width; col++) {
+					covarianceRow[col] = (covarianceRow[col] - (projected[index] * projected[col]) * inverseDenominator) * inverseForgetting;
+				}
+			}
+		}, std::max<size_t>(1, 8192 / (width + 1)));
+
+		mRowCount++;
+	}
+
+	double RecursiveLeastSquares::Impl::predict(const Roww& row) const
+	{
+		checkRow(row.size());
+
+		double prediction = 0.0;
+		for (size_t col = 0; col < mCoefficients.size(); col++) {
+			prediction += row[col] * mCoefficients[col];
+		}
+		return prediction;
+	}
+
+
+
+
+
+	RecursiveLeastSquares::RecursiveLeastSquares(const size_t width, const double forgettingFactor, const double initialVariance)
+		: impl(std::make_unique<Impl>(width, forgettingFactor, initialVariance))
+	{
+	}
+	RecursiveLeastSquares::RecursiveLeastSquares(const Matrixx& rows, const Vectorr& targets, const double forgettingFactor)
+		: impl(std::make_unique<Impl>(rows, targets, forgettingFactor))
+	{
+	}
+	RecursiveLeastSquares::RecursiveLeastSquares(const RecursiveLeastSquares& copyRLS)
+		: impl(std::make_unique<Impl>(*(copyRLS.impl)))
+	{
+	}
+	RecursiveLeastSquares::~RecursiveLeastSquares() = default;
+
+	void RecursiveLeastSquares::append(const Roww& row, const double target)
+	{
+		impl->append(row, target);
+	}
+	double RecursiveLeastSquares::predict(const Roww& row) const
+	{
+		return impl->predict(row);
+	}
+
+	Vectorr RecursiveLeastSquares::coefficients() const
+	{
+		return toVector(impl->mCoefficients);
+	}
+	Matrixx RecursiveLeastSquares::covariance() const
+	{
+		return toMatrix(impl->mCovariance);
+	}
+
+	void RecursiveLeastSquares::setForgettingFactor(const double forgettingFactor)
+	{
+		impl->setForgettingFactor(forgettingFactor);
+	}
+	const double RecursiveLeastSquares::forgettingFactor() const
+	{
+		return impl->mForgettingFactor;
+	}
+	const size_t RecursiveLeastSquares::rowCount() const
+	{
+		return impl->mRowCount;
+	}
+	const size_t RecursiveLeastSquares::width() const
+	{
+		return impl->mCoefficients.size();
+	}
+
+	RecursiveLeastSquares& RecursiveLeastSquares::operator=(const RecursiveLeastSquares& rightRLS)
+	{
+		if (this == &rightRLS) {
+			return *this;
+		}
+
+		*impl = *(rightRLS.impl);
+		return *this;
+	}
+
+
+
+
+
+	class WoodburyInverse::Impl {
+	public:
+		Impl(const Matrixx& matrix); // throws std::logic_error
+		Impl(const Matrixx& matrix, const Matrixx& inverseMatrix); // throws std::logic_error
+
+		bool update(const Dense& leftFactor, const Dense& rightFactor); // throws std::logic_error
+		Dense solve(const Dense& rightDense) const; // throws std::logic_error
+
+		void refactorize(const Dense& matrix); // throws std::logic_error
+		void setConditionLimit(const double conditionLimit); // throws std::logic_error
+
+		// Woodbury formula on inverse in place, inverse is kept and false is returned when capacitance matrix is ill-conditioned
+		static bool updateInverse(Dense& inverse, const Dense& leftFactor, const Dense& rightFactor, const double conditionLimit);
+		static void checkSquare(const Dense& dense); // throws std::logic_error
+		static void checkFactors(const size_t length, const Dense& leftFactor, const Dense& rightFactor); // throws std::logic_error
+
+		Dense mMatrix; // A
+		Dense mInverse; // A^-1
+		double mConditionLimit;
+		size_t mRefactorCount;
+	};
+
+	WoodburyInverse::Impl::Impl(const Matrixx& matrix)
+		: mConditionLimit(1e-8), mRefactorCount(0)
+	{
+		const Dense dense = fromMatrix(matrix);
+		checkSquare(dense);
+		refactorize(dense);
+	}
+	WoodburyInverse::Impl::Impl(const Matrixx& matrix, const Matrixx& inverseMatrix)
+		: mMatrix(fromMatrix(matrix)), mInverse(fromMatrix(inverseMatrix)), mConditionLimit(1e-8), mRefactorCount(0)
+	{
+		checkSquare(mMatrix);
+		handleOperationException(ExceptionHandlerr::checkHeight(mMatrix.height, mInverse.height)
+			+ ExceptionHandlerr::checkWidth(mMatrix.width, mInverse.width), '=',
+			LengthArgument(mMatrix.height, mMatrix.width), LengthArgument(mInverse.height, mInverse.width));
+	}
+
+	void WoodburyInverse::Impl::checkSquare(const Dense& dense)
+	{
+		if (dense.height != dense.width) {
+			handleEtcException("Cannot get inverse of non-square matrix.");
+		}
+	}
+
+	void WoodburyInverse::Impl::checkFactors(const size_t length, const Dense& leftFactor, const Dense& rightFactor)
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(length, leftFactor.height), '+',
+			LengthArgument(length, length), LengthArgument(leftFactor.height, leftFactor.width));
+		handleOperationException(ExceptionHandlerr::checkHeight(length, rightFactor.height)
+			+ ExceptionHandlerr::checkWidth(leftFactor.width, rightFactor.width), '+',
+			LengthArgument(leftFactor.height, leftFactor.width), LengthArgument(rightFactor.height, rightFactor.width));
+	}
+
+	void WoodburyInverse::Impl::setConditionLimit(const double conditionLimit)
+	{
+		if (!(conditionLimit >= 0.0 && conditionLimit < 1.0)) {
+			handleEtcException("Condition limit must be in range [0, 1).");
+		}
+		mConditionLimit = conditionLimit;
+	}
+
+	void WoodburyInverse::Impl::refactorize(const Dense& matrix)
+	{
+		const size_t length = matrix.height;
+		Dense factor = matrix;
+		std::vector<size_t> pivots(length);
+		if (!luFactor(length, factor.data(), length, pivots.data())) {
+			handleEtcException("The matrix is singular.");
+		}
+
+		Dense inverse(length, length);
+		for (size_t index = 0; index < length; index++) {
+			inverse(index, index) = 1.0;
+		}
+		luSolve(Trans::NoTrans, length, factor.data(), length, pivots.data(), length, inverse.data(), length);
+
+		mMatrix = matrix;
+		mInverse = std::move(inverse);
+	}
+
+	bool WoodburyInverse::Impl::updateInverse(Dense& inverse, const Dense& leftFactor, const Dense& rightFactor, const double conditionLimit)
+	{
+		const size_t length = inverse.height, rank = leftFactor.width;
+
+		// 1. W = A^-1 * U (n x k), Z = V^T * A^-1 (k x n)
+		Dense projectedLeft(length, rank), projectedRight(rank, length);
+		gemm(Trans::NoTrans, Trans::NoTrans, 1.0, inverse, leftFactor, 0.0, projectedLeft);
+		gemm(Trans::Trans, Trans::NoTrans, 1.0, rightFactor, inverse, 0.0, projectedRight);
+
+		// 2. Capacitance matrix C = I + V^T * W
+		// Its rounding error is relative to |V^T * W|, so the reciprocal condition is measured against
+		// (1 + |V^T * W|) instead of |C| to catch cancellation
+		Dense capacitance(rank, rank);
+		gemm(Trans::Trans, Trans::NoTrans, 1.0, rightFactor, projectedLeft, 0.0, capacitance);
+		const double productNorm = oneNorm(rank, rank, capacitance.data(), rank);
+		for (size_t index = 0; index < rank; index++) {
+			capacitance(index, index) += 1.0;
+		}
+		std::vector<size_t> pivots(rank);
+		if (!luFactor(rank, capacitance.data(), rank, pivots.data())) {
+			return false;
+		}
+		const double inverseNorm = luInverseNorm(rank, capacitance.data(), rank, pivots.data());
+		if (!std::isfinite(inverseNorm) || 1.0 / (inverseNorm * (1.0 + productNorm)) <= conditionLimit) {
+			return false;
+		}
+
+		// 3. A^-1 -= W * (C^-1 * Z)
+		luSolve(Trans::NoTrans, rank, capacitance.data(), rank, pivots.data(), length, projectedRight.data(), length);
+		gemm(Trans::NoTrans, Trans::NoTrans, -1.0, projectedLeft, projectedRight, 1.0, inverse);
+		return true;
+	}
+
+	bool WoodburyInverse::Impl::update(const Dense& leftFactor, const Dense& rightFactor)
+	{
+		checkFactors(mMatrix.height, leftFactor, rightFactor);
+
+		Dense matrix = mMatrix;
+		gemm(Trans::NoTrans, Trans::Trans, 1.0, leftFactor, rightFactor, 1.0, matrix);
+		if (updateInverse(mInverse, leftFactor, rightFactor, mConditionLimit)) {
+			mMatrix = std::move(matrix);
+			return true;
+		}
+		refactorize(matrix);
+		mRefactorCount++;
+		return false;
+	}
+
+	Dense WoodburyInverse::Impl::solve(const Dense& rightDense) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mInverse.width, rightDense.height), '\\',
+			LengthArgument(mMatrix.height, mMatrix.width), LengthArgument(rightDense.height, rightDense.width));
+		return multiply(mInverse, rightDense);
+	}
+
+
+
+
+
+	WoodburyInverse::WoodburyInverse(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(matrix))
+	{
+	}
+	WoodburyInverse::WoodburyInverse(const Matrixx& matrix, const Matrixx& inverseMatrix)
+		: impl(std::make_unique<Impl>(matrix, inverseMatrix))
+	{
+	}
+	WoodburyInverse::WoodburyInverse(const WoodburyInverse& copyWoodbury)
+		: impl(std::make_unique<Impl>(*(copyWoodbury.impl)))
+	{
+	}
+	WoodburyInverse::~WoodburyInverse() = default;
+
+	bool WoodburyInverse::update(const Matrixx& leftFactor, const Matrixx& rightFactor)
+	{
+		return impl->update(fromMatrix(leftFactor), fromMatrix(rightFactor));
+	}
+	bool WoodburyInverse::update(const Vectorr& leftVector, const Vectorr& rightVector)
+	{
+		return impl->update(fromColumns(leftVector), fromColumns(rightVector));
+	}
+
+	Vectorr WoodburyInverse::solve(const Vectorr& rightVector) const
+	{
+		const Dense solution = impl->solve(fromColumns(rightVector));
+		return toVector(solution.entries);
+	}
+	Matrixx WoodburyInverse::solve(const Matrixx& rightMatrix) const
+	{
+		return toMatrix(impl->solve(fromMatrix(rightMatrix)));
+	}
+	Matrixx WoodburyInverse::inverse() const
+	{
+		return toMatrix(impl->mInverse);
+	}
+	Matrixx WoodburyInverse::matrix() const
+	{
+		return toMatrix(impl->mMatrix);
+	}
+
+	void WoodburyInverse::setConditionLimit(const double conditionLimit)
+	{
+		impl->setConditionLimit(conditionLimit);
+	}
+	const double WoodburyInverse::conditionLimit() const
+	{
+		return impl->mConditionLimit;
+	}
+	const size_t WoodburyInverse::refactorCount() const
+	{
+		return impl->mRefactorCount;
+	}
+	const size_t WoodburyInverse::size() const
+	{
+		return impl->mMatrix.height;
+	}
+
+	Matrixx WoodburyInverse::updateInverse(const Matrixx& inverseMatrix, const Matrixx& leftFactor, const Matrixx& rightFactor,
+		const double conditionLimit)
+	{
+		Dense inverse = fromMatrix(inverseMatrix);
+		const Dense leftDense = fromMatrix(leftFactor), rightDense = fromMatrix(rightFactor);
+		Impl::checkSquare(inverse);
+		Impl::checkFactors(inverse.height, leftDense, rightDense);
+		if (!Impl::updateInverse(inverse, leftDense, rightDense, conditionLimit)) {
+			handleEtcException("Capacitance matrix of the update is ill-conditioned.");
+		}
+		return toMatrix(inverse);
+	}
+
+	WoodburyInverse& WoodburyInverse::operator=(const WoodburyInverse& rightWoodbury)
+	{
+		if (this == &rightWoodbury) {
+			return *this;
+		}
+
+		*impl = *(rightWoodbury.impl);
+		return *this;
+	}
+
+
+
+
+
+	class MixedPrecisionSolver::Impl {
+	public:
+		Impl(const Matrixx& matrix, const Method method, const size_t maxIterations); // throws std::logic_error
+
+		Dense solve(const Dense& rightDense); // throws std::logic_error
+
+		bool factorSingle(); // false when A does not fit in float (overflow or float subnormal entries) or the factorization fails
+		void factorDouble(); // throws std::logic_error
+		Dense solveSingle(const Dense& rightDense) const; // Columns are scaled to unit maximum before rounding to float
+		void solveDouble(Dense& rightDense) const;
+		double backwardError(const Dense& rightDense, const Dense& solution, Dense& residual) const; // residual = b - A * x
+
+		void setTolerance(const double tolerance); // throws std::logic_error
+
+		Dense mMatrix;
+		Method mMethod;
+		DenseF mSingleFactor;
+		Dense mDoubleFactor; // Empty until fallback
+		std::vector<size_t> mPivots;
+		double mNorm; // Infinity norm of A
+		double mTolerance;
+		size_t mMaxIterations;
+		bool mIsDoubleFactor;
+
+		bool mIsRefined;
+		size_t mIterationCount;
+		double mBackwardError;
+	};
+
+	MixedPrecisionSolver::Impl::Impl(const Matrixx& matrix, const Method method, const size_t maxIterations)
+		: mMatrix(fromMatrix(matrix)), mMethod(method), mMaxIterations(maxIterations), mIsDoubleFactor(false),
+		mIsRefined(false), mIterationCount(0), mBackwardError(0.0)
+	{
+		if (mMatrix.height != mMatrix.width) {
+			handleEtcException("Cannot solve with non-square matrix.");
+		}
+		if (mMethod == Method::Cholesky && !isSymmetric(mMatrix)) {
+			handleEtcException("Cannot get Cholesky factor from non-symmetric matrix.");
+		}
+
+		const size_t length = mMatrix.height;
+		mNorm = 0.0;
+		for (size_t row = 0; row < length; row++) {
+			double rowSum = 0.0;
+			for (size_t col = 0; col < length; col++) {
+				rowSum += std::abs(mMatrix(row, col));
+			}
+			mNorm = std::max(mNorm, rowSum);
+		}
+		mTolerance = std::sqrt(static_cast<double>(length)) * std::numeric_limits<double>::epsilon();
+		if (!factorSingle()) {
+			factorDouble();
+		}
+	}
+
+	bool MixedPrecisionSolver::Impl::factorSingle()
+	{
+		const size_t length = mMatrix.height;
+		for (const double entry : mMatrix.entries) {
+			const double absolute = std::abs(entry);
+			if (!(absolute <= std::numeric_limits<float>::max()) || (absolute > 0.0 && absolute < std::numeric_limits<float>::min())) {
+				return false;
+			}
+		}
+
+		mSingleFactor = toSingle(mMatrix);
+		if (mMethod == Method::LU) {
+			mPivots.resize(length);
+			if (!luFactor(length, mSingleFactor.data(), length, mPivots.data())) {
+				return false;
+			}
+		}
+		else if (!choleskyFactor(length, mSingleFactor.data(), length)) {
+			return false;
+		}
+		// Tiny pivots are not exactly zero but overflow their inverses
+		for (const float entry : mSingleFactor.entries) {
+			if (!std::isfinite(entry)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void MixedPrecisionSolver::Impl::factorDouble()
+	{
+		const size_t length = mMatrix.height;
+		mDoubleFactor = mMatrix;
+		if (mMethod == Method::LU) {
+			mPivots.resize(length);
+			if (!luFactor(length, mDoubleFactor.data(), length, mPivots.data())) {
+				handleEtcException("The matrix is singular.");
+			}
+		}
+		else if (!choleskyFactor(length, mDoubleFactor.data(), length)) {
+			handleEtcException("The matrix is not positive-definite.");
+		}
+		mSingleFactor = DenseF();
+		mIsDoubleFactor = true;
+	}
+
+	Dense MixedPrecisionSolver::Impl::solveSingle(const Dense& rightDense) const
+	{
+		// Residuals shrink every step, scaling keeps them away from float underflow
+		const size_t length = mMatrix.height, width = rightDense.width;
+		std::vector<double> scales(width, 0.0);
+		for (size_t row = 0; row < length; row++) {
+			const double* rightRow = rightDense.row(row);
+			for (size_t col = 0; col < width; col++) {
+				scales[col] = std::max(scales[col], std::abs(rightRow[col]));
+			}
+		}
+		for (double& scale : scales) {
+			scale = (scale > 0.0 && std::isfinite(scale)) ? scale : 1.0;
+		}
+
+		DenseF single(length, width);
+		for (size_t row = 0; row < length; row++) {
+			const double* rightRow = rightDense.row(row);
+			float* singleRow = single.row(row);
+			for (size_t col = 0; col < width; col++) {
+				singleRow[col] = static_cast<float>(rightRow[col] / scales[col]);
+			}
+		}
+		if (mMethod == Method::LU) {
+			luSolve(Trans::NoTrans, length, mSingleFactor.data(), length, mPivots.data(), width, single.data(), width);
+		}
+		else {
+			trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::NonUnit, length, width, mSingleFactor.data(), length, single.data(), width);
+			trsm(Side::Left, Uplo::Lower, Trans::Trans, Diag::NonUnit, length, width, mSingleFactor.data(), length, single.data(), width);
+		}
+
+		Dense solution(length, width);
+		for (size_t row = 0; row < length; row++) {
+			const float* singleRow = single.row(row);
+			double* solutionRow = solution.row(row);
+			for (size_t col = 0; col < width; col++) {
+				solutionRow[col] = singleRow[col] * scales[col];
+			}
+		}
+		return solution;
+	}
+
+	void MixedPrecisionSolver::Impl::solveDouble(Dense& rightDense) const
+	{
+		const size_t length = mMatrix.height, width = rightDense.width;
+		if (mMethod == Method::LU) {
+			luSolve(Trans::NoTrans, length, mDoubleFactor.data(), length, mPivots.data(), width, rightDense.data(), width);
+		}
+		else {
+			trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::NonUnit, length, width, mDoubleFactor.data(), length, rightDense.data(), width);
+			trsm(Side::Left, Uplo::Lower, Trans::Trans, Diag::NonUnit, length, width, mDoubleFactor.data(), length, rightDense.data(), width);
+		}
+	}
+
+	double MixedPrecisionSolver::Impl::backwardError(const Dense& rightDense, const Dense& solution, Dense& residual) const
+	{
+		residual = rightDense;
+		gemm(Trans::NoTrans, Trans::NoTrans, -1.0, mMatrix, solution, 1.0, residual);
+
+		// std::max(norm, NaN) keeps norm, so NaN entries are carried into the norm explicitly
+		const auto updateNorm = [](double& norm, const double entry) {
+			if (!(std::abs(entry) <= norm) && !std::isnan(norm)) {
+				norm = std::abs(entry);
+			}
+		};
+		const size_t width = rightDense.width;
+		std::vector<double> residualNorms(width, 0.0), solutionNorms(width, 0.0), rightNorms(width, 0.0);
+		for (size_t row = 0; row < mMatrix.height; row++) {
+			for (size_t col = 0; col < width; col++) {
+				updateNorm(residualNorms[col], residual(row, col));
+				updateNorm(solutionNorms[col], solution(row, col));
+				updateNorm(rightNorms[col], rightDense(row, col));
+			}
+		}
+		double error = 0.0;
+		for (size_t col = 0; col < width; col++) {
+			// NaN fails every comparison, so overflowed or NaN solutions count as neither converged nor improving
+			if (!std::isfinite(residualNorms[col]) || !std::isfinite(solutionNorms[col])) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			if (residualNorms[col] > 0.0) {
+				error = std::max(error, residualNorms[col] / (mNorm * solutionNorms[col] + rightNorms[col]));
+			}
+		}
+		return error;
+	}
+
+	Dense MixedPrecisionSolver::Impl::solve(const Dense& rightDense)
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mMatrix.width, rightDense.height), '\\',
+			LengthArgument(mMatrix.height, mMatrix.width), LengthArgument(rightDense.height, rightDense.width));
+
+		Dense residual;
+		mIsRefined = false;
+		mIterationCount = 0;
+		if (!mIsDoubleFactor) {
+			Dense solution = solveSingle(rightDense);
+			double error = backwardError(rightDense, solution, residual);
+			while (!(error <= mTolerance) && mIterationCount < mMaxIterations) {
+				const Dense correction = solveSingle(residual);
+				axpy(solution.entries.size(), 1.0, correction.data(), solution.data());
+				mIterationCount++;
+
+				const double nextError = backwardError(rightDense, solution, residual);
+				if (!(nextError <= 0.5 * error) && !(nextError <= mTolerance)) {
+					break;
+				}
+				error = nextError;
+			}
+			if (error <= mTolerance) {
+				mIsRefined = true;
+				mBackwardError = error;
+				return solution;
+			}
+			factorDouble();
+		}
+
+		Dense solution = rightDense;
+		solveDouble(solution);
+		mBackwardError = backwardError(rightDense, solution, residual);
+		return solution;
+	}
+
+	void MixedPrecisionSolver::Impl::setTolerance(const double tolerance)
+	{
+		if (!(tolerance >= 0.0)) {
+			handleEtcException("Tolerance must not be negative.");
+		}
+		mTolerance = tolerance;
+	}
+
+
+
+
+
+	MixedPrecisionSolver::MixedPrecisionSolver(const Matrixx& matrix, const Method method, const size_t maxIterations)
+		: impl(std::make_unique<Impl>(matrix, method, maxIterations))
+	{
+	}
+	MixedPrecisionSolver::MixedPrecisionSolver(const MixedPrecisionSolver& copySolver)
+		: impl(std::make_unique<Impl>(*(copySolver.impl)))
+	{
+	}
+	MixedPrecisionSolver::~MixedPrecisionSolver() = default;
+
+	Vectorr MixedPrecisionSolver::solve(const Vectorr& rightVector)
+	{
+		const Dense solution = impl->solve(fromColumns(rightVector));
+		return toVector(solution.entries);
+	}
+	Matrixx MixedPrecisionSolver::solve(const Matrixx& rightMatrix)
+	{
+		return toMatrix(impl->solve(fromMatrix(rightMatrix)));
+	}
+
+	bool MixedPrecisionSolver::isRefined() const
+	{
+		return impl->mIsRefined;
+	}
+	const size_t MixedPrecisionSolver::iterationCount() const
+	{
+		return impl->mIterationCount;
+	}
+	double MixedPrecisionSolver::backwardError() const
+	{
+		return impl->mBackwardError;
+	}
+
+	void MixedPrecisionSolver::setTolerance(const double tolerance)
+	{
+		impl->setTolerance(tolerance);
+	}
+	void MixedPrecisionSolver::setMaxIterations(const size_t maxIterations)
+	{
+		impl->mMaxIterations = maxIterations;
+	}
+	const MixedPrecisionSolver::Method MixedPrecisionSolver::method() const
+	{
+		return impl->mMethod;
+	}
+	const double MixedPrecisionSolver::tolerance() const
+	{
+		return impl->mTolerance;
+	}
+	const size_t MixedPrecisionSolver::maxIterations() const
+	{
+		return impl->mMaxIterations;
+	}
+	bool MixedPrecisionSolver::isDoubleFactor() const
+	{
+		return impl->mIsDoubleFactor;
+	}
+	const size_t MixedPrecisionSolver::size() const
+	{
+		return impl->mMatrix.height;
+	}
+
+	MixedPrecisionSolver& MixedPrecisionSolver::operator=(const MixedPrecisionSolver& rightSolver)
+	{
+		if (this == &rightSolver) {
+			return *this;
+		}
+
+		*impl = *(rightSolver.impl);
+		return *this;
+	}
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "linalg.h"
+
+namespace linalg {
+	// Incremental and streaming solver classes
+	// Implementations are in linalg_solve.cpp
+	class TSQR;
+	class RecursiveLeastSquares;
+	class WoodburyInverse;
+	class MixedPrecisionSolver;
+
+	/*
+	* Tall-skinny QR (TSQR) least squares engine for systems with huge row count.
+	*
+	* Rows of the augmented system [A | B] are consumed block by block and only the
+	* (width + rightWidth) square triangular factor is kept, so memory does not grow with row count.
+	* Each appended block is split into row chunks reduced in parallel, and the partial factors
+	* are combined pairwise in a reduction tree.
+	*
+	* '|=' merges two engines fed with disjoint rows, as vertical append of their systems.
+	*/
+	class TSQR {
+	public:
+		explicit TSQR(const size_t width = 1, const size_t rightWidth = 1); // throws std::length_error
+		TSQR(const TSQR& copyTSQR);
+		virtual ~TSQR();
+
+		void append(const Matrixx& rowBlock, const Vectorr& rightBlock); // throws std::logic_error
+		void append(const Matrixx& rowBlock, const Matrixx& rightBlock); // throws std::logic_error
+		void append(const Roww& row, const double rightValue); // throws std::logic_error, buffered until a block is filled
+
+		Vectorr solve(const size_t rightCol = 0) const; // throws std::logic_error : rank deficient
+		Matrixx solveAll() const; // throws std::logic_error : rank deficient
+		double residualNorm(const size_t rightCol = 0) const; // |A * x - b| of solution
+		Matrixx R() const; // width x width
+
+		const size_t rowCount() const;
+		const size_t width() const;
+		const size_t rightWidth() const;
+
+		TSQR& operator=(const TSQR& rightTSQR);
+		// Vertical append operation
+		TSQR& operator|=(const TSQR& lowerTSQR); // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Recursive least squares : online solution update on each appended observation.
+	*
+	* Keeps inverse covariance P = (A^T * A)^-1 and coefficients x, so each appended row
+	* costs O(n^2) instead of re-solving. With forgetting factor 0 < lambda <= 1,
+	* past observations are weighted by lambda^age to track drifting systems.
+	*/
+	class RecursiveLeastSquares {
+	public:
+		// Start from prior x = 0, P = initialVariance * I
+		explicit RecursiveLeastSquares(const size_t width = 1, const double forgettingFactor = 1.0,
+			const double initialVariance = 1e6); // throws std::length_error, std::logic_error : forgetting factor out of (0, 1]
+		// Start from exact batch solution of rows * x = targets
+		RecursiveLeastSquares(const Matrixx& rows, const Vectorr& targets,
+			const double forgettingFactor = 1.0); // throws std::logic_error : rank deficient rows
+		RecursiveLeastSquares(const RecursiveLeastSquares& copyRLS);
+		virtual ~RecursiveLeastSquares();
+
+		void append(const Roww& row, const double target); // throws std::logic_error
+		double predict(const Roww& row) const; // throws std::logic_error, row * x
+
+		Vectorr coefficients() const; // x
+		Matrixx covariance() const; // P
+
+		void setForgettingFactor(const double forgettingFactor); // throws std::logic_error
+		const double forgettingFactor() const;
+		const size_t rowCount() const;
+		const size_t width() const;
+
+		RecursiveLeastSquares& operator=(const RecursiveLeastSquares& rightRLS);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Sherman-Morrison-Woodbury inverse update for low-rank modification A + U * V^T (U, V are n x k).
+	*
+	* (A + U * V^T)^-1 = A^-1 - A^-1 * U * (I + V^T * A^-1 * U)^-1 * V^T * A^-1 costs O(n^2 * k) instead of O(n^3).
+	* Reciprocal condition of the small (k x k) capacitance matrix I + V^T * A^-1 * U is checked on every update,
+	* and the inverse is refactorized from updated A when it is below conditionLimit().
+	*/
+	class WoodburyInverse {
+	public:
+		explicit WoodburyInverse(const Matrixx& matrix); // throws std::logic_error : non-square or singular
+		WoodburyInverse(const Matrixx& matrix, const Matrixx& inverseMatrix); // throws std::logic_error, reuse known inverse of matrix
+		WoodburyInverse(const WoodburyInverse& copyWoodbury);
+		virtual ~WoodburyInverse();
+
+		// Returns false when the update fell back to refactorization
+		bool update(const Matrixx& leftFactor, const Matrixx& rightFactor); // throws std::logic_error : A + U * V^T is singular
+		bool update(const Vectorr& leftVector, const Vectorr& rightVector); // throws std::logic_error, A + u * v^T
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error, A^-1 * b
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error, A^-1 * B
+		Matrixx inverse() const; // A^-1
+		Matrixx matrix() const; // A
+
+		void setConditionLimit(const double conditionLimit); // throws std::logic_error : out of [0, 1)
+		const double conditionLimit() const;
+		const size_t refactorCount() const;
+		const size_t size() const;
+
+		// A^-1 -> (A + U * V^T)^-1 without keeping A, throws std::logic_error when capacitance matrix is ill-conditioned
+		static Matrixx updateInverse(const Matrixx& inverseMatrix, const Matrixx& leftFactor, const Matrixx& rightFactor,
+			const double conditionLimit = 1e-8);
+
+		WoodburyInverse& operator=(const WoodburyInverse& rightWoodbury);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Mixed-precision solver of square A * x = b : A is factorized once in float (LU with partial pivoting, or Cholesky),
+	* and every solution is refined in double as x += A_float^-1 * (b - A * x), the residual being computed in double.
+	*
+	* Each refinement step gains about -log10(cond(A) * 6e-8) digits, so double accuracy is reached in a few
+	* O(n^2) steps when cond(A) is well below 1e7, while the O(n^3) factorization runs at float speed.
+	* Refinement stops when the backward error |b - A * x| / (|A| * |x| + |b|) (infinity norms, largest over columns)
+	* is below tolerance (sqrt(n) * double epsilon by default).
+	*
+	* The solver falls back to a double factorization when A does not fit in float (entries overflow or become float subnormals),
+	* its float factorization fails or has non-finite entries, or refinement stalls (backward error not halved by a step,
+	* NaN included) or runs out of iterations.
+	* The double factor is kept, so later solves use it directly.
+	*/
+	class MixedPrecisionSolver {
+	public:
+		enum class Method { LU, Cholesky };
+
+		explicit MixedPrecisionSolver(const Matrixx& matrix, const Method method = Method::LU,
+			const size_t maxIterations = 30); // throws std::logic_error : non-square, singular or not positive-definite (for Cholesky)
+		MixedPrecisionSolver(const MixedPrecisionSolver& copySolver);
+		virtual ~MixedPrecisionSolver();
+
+		Vectorr solve(const Vectorr& rightVector); // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix); // throws std::logic_error
+
+		// Result of last solve
+		bool isRefined() const; // Tolerance was met by refinement of float solution
+		const size_t iterationCount() const; // Refinement steps, including those before fallback
+		double backwardError() const;
+
+		void setTolerance(const double tolerance); // throws std::logic_error : negative
+		void setMaxIterations(const size_t maxIterations);
+		const Method method() const;
+		const double tolerance() const;
+		const size_t maxIterations() const;
+		bool isDoubleFactor() const; // Fallback to double factorization took place
+		const size_t size() const;
+
+		MixedPrecisionSolver& operator=(const MixedPrecisionSolver& rightSolver);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,1580 @@
+#include "linalg_sparse.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace linalg {
+	using namespace kernel;
+
+	class SparseMatrix::Impl {
+	public:
+		Impl(const size_t height, const size_t width); // throws std::length_error
+
+		void assignTriplets(const std::vector<size_t>& rows, const std::vector<size_t>& cols,
+			const std::vector<double>& values); // throws std::out_of_range, std::logic_error
+		void assignCompressed(const std::vector<size_t>& offsets, const std::vector<size_t>& indices,
+			const std::vector<double>& values); // throws std::logic_error
+		double get(const size_t row, const size_t col) const; // throws std::out_of_range
+		void checkJoin(const size_t height, const size_t width) const; // throws std::logic_error
+
+		Compressed mMatrix;
+	};
+
+	SparseMatrix::Impl::Impl(const size_t height, const size_t width)
+		: mMatrix(height, width)
+	{
+		int exceptNum = std::max(ExceptionHandlerr::checkValidHeight(height), ExceptionHandlerr::checkValidWidth(width));
+		if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+			LengthArgument lengthArg(height, width);
+			ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+			handler.addArgument(lengthArg);
+			handler.handleException();
+		}
+	}
+
+	void SparseMatrix::Impl::assignTriplets(const std::vector<size_t>& rows, const std::vector<size_t>& cols,
+		const std::vector<double>& values)
+	{
+		if (rows.size() != cols.size() || rows.size() != values.size()) {
+			handleEtcException("Triplet arrays must have equal length.");
+		}
+		for (size_t index = 0; index < rows.size(); index++) {
+			if (rows[index] >= mMatrix.height || cols[index] >= mMatrix.width) {
+				handleIndexException(rows[index], cols[index], mMatrix.height, mMatrix.width);
+			}
+		}
+
+		// Bucket by row with counting sort, then sort and merge each row in parallel
+		std::fill(mMatrix.offsets.begin(), mMatrix.offsets.end(), 0);
+		for (const size_t row : rows) {
+			mMatrix.offsets[row + 1]++;
+		}
+		for (size_t row = 0; row < mMatrix.height; row++) {
+			mMatrix.offsets[row + 1] += mMatrix.offsets[row];
+		}
+		mMatrix.indices.resize(rows.size());
+		mMatrix.values.resize(rows.size());
+		std::vector<size_t> next(mMatrix.offsets.begin(), mMatrix.offsets.end() - 1);
+		for (size_t index = 0; index < rows.size(); index++) {
+			const size_t position = next[rows[index]]++;
+			mMatrix.indices[position] = cols[index];
+			mMatrix.values[position] = values[index];
+		}
+		sortCompressed(mMatrix);
+	}
+	void SparseMatrix::Impl::assignCompressed(const std::vector<size_t>& offsets, const std::vector<size_t>& indices,
+		const std::vector<double>& values)
+	{
+		bool isValid = offsets.size() == mMatrix.height + 1 && offsets.front() == 0
+			&& offsets.back() == indices.size() && indices.size() == values.size()
+			&& std::is_sorted(offsets.begin(), offsets.end());
+		for (size_t index = 0; isValid && index < indices.size(); index++) {
+			isValid = indices[index] < mMatrix.width;
+		}
+		if (!isValid) {
+			handleEtcException("Invalid compressed sparse arrays.");
+		}
+
+		mMatrix.offsets = offsets;
+		mMatrix.indices = indices;
+		mMatrix.values = values;
+		sortCompressed(mMatrix);
+	}
+	double SparseMatrix::Impl::get(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, mMatrix.height, mMatrix.width);
+		const auto rowBegin = mMatrix.indices.begin() + mMatrix.offsets[row];
+		const auto rowEnd = mMatrix.indices.begin() + mMatrix.offsets[row + 1];
+		const auto found = std::lower_bound(rowBegin, rowEnd, col);
+		return (found != rowEnd && *found == col) ? mMatrix.values[found - mMatrix.indices.begin()] : 0.0;
+	}
+	void SparseMatrix::Impl::checkJoin(const size_t height, const size_t width) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mMatrix.width, height), '*',
+			LengthArgument(mMatrix.height, mMatrix.width), LengthArgument(height, width));
+	}
+
+
+
+
+
+	SparseMatrix::SparseMatrix(const size_t height, const size_t width)
+		: impl(std::make_unique<Impl>(height, width))
+	{
+	}
+	SparseMatrix::SparseMatrix(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(matrix.height(), matrix.width()))
+	{
+		impl->mMatrix = compress(fromMatrix(matrix));
+	}
+	SparseMatrix::SparseMatrix(const size_t height, const size_t width, const std::vector<size_t>& rows, const std::vector<size_t>& cols,
+		const std::vector<double>& values)
+		: impl(std::make_unique<Impl>(height, width))
+	{
+		impl->assignTriplets(rows, cols, values);
+	}
+	SparseMatrix::SparseMatrix(const SparseMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	SparseMatrix::~SparseMatrix() = default;
+
+	SparseMatrix SparseMatrix::fromCompressedRows(const size_t height, const size_t width, const std::vector<size_t>& offsets,
+		const std::vector<size_t>& colIndices, const std::vector<double>& values)
+	{
+		SparseMatrix sparse(height, width);
+		sparse.impl->assignCompressed(offsets, colIndices, values);
+		return sparse;
+	}
+	SparseMatrix SparseMatrix::fromCompressedColumns(const size_t height, const size_t width, const std::vector<size_t>& offsets,
+		const std::vector<size_t>& rowIndices, const std::vector<double>& values)
+	{
+		SparseMatrix transposed(width, height);
+		transposed.impl->assignCompressed(offsets, rowIndices, values);
+		return transposed.transpose();
+	}
+
+	const double SparseMatrix::operator()(const size_t row, const size_t col) const
+	{
+		return impl->get(row, col);
+	}
+
+	std::vector<size_t> SparseMatrix::rowOffsets() const
+	{
+		return impl->mMatrix.offsets;
+	}
+	std::vector<size_t> SparseMatrix::columnIndices() const
+	{
+		return impl->mMatrix.indices;
+	}
+	std::vector<double> SparseMatrix::values() const
+	{
+		return impl->mMatrix.values;
+	}
+	void SparseMatrix::toCompressedColumns(std::vector<size_t>& offsets, std::vector<size_t>& rowIndices, std::vector<double>& values) const
+	{
+		Compressed columns = impl->mMatrix.transpose();
+		offsets.swap(columns.offsets);
+		rowIndices.swap(columns.indices);
+		values.swap(columns.values);
+	}
+
+	SparseMatrix SparseMatrix::transpose() const
+	{
+		SparseMatrix transposed(impl->mMatrix.width, impl->mMatrix.height);
+		transposed.impl->mMatrix = impl->mMatrix.transpose();
+		return transposed;
+	}
+	Matrixx SparseMatrix::toMatrix() const
+	{
+		const Compressed& matrix = impl->mMatrix;
+		Dense dense(matrix.height, matrix.width);
+		for (size_t row = 0; row < matrix.height; row++) {
+			for (size_t index = matrix.offsets[row]; index < matrix.offsets[row + 1]; index++) {
+				dense(row, matrix.indices[index]) = matrix.values[index];
+			}
+		}
+		return kernel::toMatrix(dense);
+	}
+	const size_t SparseMatrix::nonZeroCount() const
+	{
+		return impl->mMatrix.indices.size();
+	}
+	const size_t SparseMatrix::height() const
+	{
+		return impl->mMatrix.height;
+	}
+	const size_t SparseMatrix::width() const
+	{
+		return impl->mMatrix.width;
+	}
+
+	SparseMatrix& SparseMatrix::operator=(const SparseMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	Vectorr SparseMatrix::operator*(const Vectorr& rightVector) const
+	{
+		impl->checkJoin(rightVector.size(), 1);
+		const std::vector<double> entries = fromVector(rightVector);
+		std::vector<double> product(impl->mMatrix.height);
+		spmv(1.0, impl->mMatrix, entries.data(), 0.0, product.data());
+		return toVector(product);
+	}
+	Matrixx SparseMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		impl->checkJoin(rightMatrix.height(), rightMatrix.width());
+		const Dense right = fromMatrix(rightMatrix);
+		Dense product(impl->mMatrix.height, right.width);
+		spmm(right.width, 1.0, impl->mMatrix, right.data(), right.width, 0.0, product.data(), product.width);
+		return kernel::toMatrix(product);
+	}
+	SparseMatrix SparseMatrix::operator*(const SparseMatrix& rightMatrix) const
+	{
+		impl->checkJoin(rightMatrix.height(), rightMatrix.width());
+		SparseMatrix product(impl->mMatrix.height, rightMatrix.width());
+		product.impl->mMatrix = spgemm(impl->mMatrix, rightMatrix.impl->mMatrix);
+		return product;
+	}
+
+
+
+
+
+	namespace {
+		constexpr size_t none = std::numeric_limits<size_t>::max();
+		constexpr size_t dissectionLeaf = 256; // Parts of nested dissection up to this size are ordered by minimum degree
+		constexpr size_t refinementSteps = 2; // Iterative refinement steps of SparseLU after perturbed pivots
+
+		// Symmetric adjacency without self loops : neighbors of node i are [offsets[i], offsets[i + 1]) of nodes
+		struct Graph {
+			size_t size() const { return offsets.size() - 1; }
+
+			std::vector<size_t> offsets, nodes;
+		};
+
+		// Pattern of A + A^T without diagonal
+		Graph symmetricGraph(const Compressed& matrix)
+		{
+			const Compressed transposed = matrix.transpose();
+			Graph graph;
+			graph.offsets.assign(matrix.height + 1, 0);
+			graph.nodes.reserve(2 * matrix.indices.size());
+			for (size_t row = 0; row < matrix.height; row++) {
+				size_t index = matrix.offsets[row], transposedIndex = transposed.offsets[row];
+				while (index < matrix.offsets[row + 1] || transposedIndex < transposed.offsets[row + 1]) {
+					size_t node;
+					if (transposedIndex == transposed.offsets[row + 1]
+						|| (index < matrix.offsets[row + 1] && matrix.indices[index] < transposed.indices[transposedIndex])) {
+						node = matrix.indices[index++];
+					}
+					else {
+						node = transposed.indices[transposedIndex++];
+						if (index < matrix.offsets[row + 1] && matrix.indices[index] == node) {
+							index++;
+						}
+					}
+					if (node != row) {
+						graph.nodes.push_back(node);
+					}
+				}
+				graph.offsets[row + 1] = graph.nodes.size();
+			}
+			return graph;
+		}
+
+		// Subgraph induced by nodes, node i of result is nodes[i] (position is scratch of graph size, left dirty)
+		Graph inducedGraph(const Graph& graph, const std::vector<size_t>& nodes, std::vector<size_t>& position)
+		{
+			for (size_t index = 0; index < nodes.size(); index++) {
+				position[nodes[index]] = index;
+			}
+			Graph subgraph;
+			subgraph.offsets.assign(nodes.size() + 1, 0);
+			for (size_t index = 0; index < nodes.size(); index++) {
+				for (size_t edge = graph.offsets[nodes[index]]; edge < graph.offsets[nodes[index] + 1]; edge++) {
+					const size_t neighbor = graph.nodes[edge];
+					if (position[neighbor] < nodes.size() && nodes[position[neighbor]] == neighbor) {
+						subgraph.nodes.push_back(position[neighbor]);
+					}
+				}
+				subgraph.offsets[index + 1] = subgraph.nodes.size();
+			}
+			return subgraph;
+		}
+
+		/*
+		* Approximate minimum degree on the quotient graph : an eliminated node becomes an element whose members are its
+		* remaining neighbors, and the elements it touched are absorbed. Degree of a variable i next to new element p is bounded
+		* by |A_i| + |L_p \ i| + sum of |L_e \ L_p| over its other elements e, as in AMD (without supervariable detection).
+		* Elements covered by L_p are absorbed as well (aggressive absorption).
+		* Returns elimination order, dense nodes (degree above 10 * sqrt(n)) are placed last.
+		*/
+		std::vector<size_t> minimumDegree(const Graph& graph)
+		{
+			enum class State : char { Variable, Element, Absorbed, Dense };
+			const size_t size = graph.size();
+			const size_t denseDegree = std::max<size_t>(16, static_cast<size_t>(10.0 * std::sqrt(static_cast<double>(size))));
+
+			std::vector<State> state(size, State::Variable);
+			std::vector<std::vector<size_t>> adjacency(size), elements(size), members(size);
+			std::vector<size_t> denseNodes;
+			for (size_t node = 0; node < size; node++) {
+				if (graph.offsets[node + 1] - graph.offsets[node] > denseDegree) {
+					state[node] = State::Dense;
+					denseNodes.push_back(node);
+				}
+			}
+			for (size_t node = 0; node < size; node++) {
+				for (size_t edge = graph.offsets[node]; edge < graph.offsets[node + 1]; edge++) {
+					if (state[graph.nodes[edge]] == State::Variable) {
+						adjacency[node].push_back(graph.nodes[edge]);
+					}
+				}
+			}
+
+			// Doubly linked lists of variables by degree
+			std::vector<size_t> degree(size), head(size + 1, none), next(size, none), previous(size, none);
+			auto insert = [&](const size_t node) {
+				next[node] = head[degree[node]];
+				previous[node] = none;
+				if (head[degree[node]] != none) {
+					previous[head[degree[node]]] = node;
+				}
+				head[degree[node]] = node;
+			};
+			auto remove = [&](const size_t node) {
+				if (previous[node] != none) {
+					next[previous[node]] = next[node];
+				}
+				else {
+					head[degree[node]] = next[node];
+				}
+				if (next[node] != none) {
+					previous[next[node]] = previous[node];
+				}
+			};
+			size_t minDegree = size;
+			for (size_t node = 0; node < size; node++) {
+				if (state[node] == State::Variable) {
+					degree[node] = adjacency[node].size();
+					minDegree = std::min(minDegree, degree[node]);
+					insert(node);
+				}
+			}
+
+			std::vector<size_t> order, pivotElement, mark(size, none), weightMark(size, none), weight(size);
+			order.reserve(size);
+			const size_t variableCount = size - denseNodes.size();
+			while (order.size() < variableCount) {
+				while (head[minDegree] == none) {
+					minDegree++;
+				}
+				const size_t pivot = head[minDegree];
+				remove(pivot);
+				order.push_back(pivot);
+
+				// 1. New element L_p : variables of absorbed elements and of adjacency
+				pivotElement.clear();
+				mark[pivot] = pivot;
+				for (const size_t element : elements[pivot]) {
+					for (const size_t member : members[element]) {
+						if (state[member] == State::Variable && mark[member] != pivot) {
+							mark[member] = pivot;
+							pivotElement.push_back(member);
+						}
+					}
+					state[element] = State::Absorbed;
+					std::vector<size_t>().swap(members[element]);
+				}
+				for (const size_t neighbor : adjacency[pivot]) {
+					if (state[neighbor] == State::Variable && mark[neighbor] != pivot) {
+						mark[neighbor] = pivot;
+						pivotElement.push_back(neighbor);
+					}
+				}
+				state[pivot] = State::Element;
+				std::vector<size_t>().swap(adjacency[pivot]);
+				std::vector<size_t>().swap(elements[pivot]);
+
+				// 2. |L_e \ L_p| of every other element next to L_p
+				for (const size_t member : pivotElement) {
+					for (const size_t element : elements[member]) {
+						if (state[element] == State::Element) {
+							if (weightMark[element] != pivot) {
+								weightMark[element] = pivot;
+								weight[element] = members[element].size();
+							}
+							weight[element]--;
+						}
+					}
+				}
+
+				// 3. Prune quotient graph around L_p and update approximate degrees
+				const size_t remaining = variableCount - order.size();
+				for (const size_t member : pivotElement) {
+					remove(member);
+					size_t externalDegree = 0;
+					std::vector<size_t>& memberElements = elements[member];
+					size_t kept = 0;
+					for (const size_t element : memberElements) {
+						if (state[element] != State::Element) {
+							continue;
+						}
+						if (weight[element] == 0) {
+							state[element] = State::Absorbed;
+							std::vector<size_t>().swap(members[element]);
+							continue;
+						}
+						externalDegree += weight[element];
+						memberElements[kept++] = element;
+					}
+					memberElements.resize(kept);
+					memberElements.push_back(pivot);
+
+					std::vector<size_t>& memberAdjacency = adjacency[member];
+					kept = 0;
+					for (const size_t neighbor : memberAdjacency) {
+						if (state[neighbor] == State::Variable && mark[neighbor] != pivot) {
+							memberAdjacency[kept++] = neighbor;
+						}
+					}
+					memberAdjacency.resize(kept);
+
+					degree[member] = std::min({ remaining - 1, degree[member] + pivotElement.size() - 1,
+						memberAdjacency.size() + pivotElement.size() - 1 + externalDegree });
+					minDegree = std::min(minDegree, degree[member]);
+					insert(member);
+				}
+				members[pivot] = pivotElement;
+			}
+			order.insert(order.end(), denseNodes.begin(), denseNodes.end());
+			return order;
+		}
+
+		/*
+		* Nested dissection : nodes are split by a level structure rooted at a pseudo-peripheral node,
+		* the middle level (only its nodes touching the far side) is the separator and is ordered after both parts.
+		* part marks membership of current node set, level is scratch, both of graph size.
+		*/
+		void nestedDissection(const Graph& graph, const std::vector<size_t>& nodes, std::vector<size_t>& part, const size_t partId,
+			size_t& nextPartId, std::vector<size_t>& level, std::vector<size_t>& order)
+		{
+			if (nodes.size() <= dissectionLeaf) {
+				const Graph subgraph = inducedGraph(graph, nodes, level);
+				for (const size_t node : minimumDegree(subgraph)) {
+					order.push_back(nodes[node]);
+				}
+				return;
+			}
+
+			// 1. Level structure from pseudo-peripheral node (repeated breadth-first search from a farthest node)
+			std::vector<size_t> queue;
+			queue.reserve(nodes.size());
+			auto breadthFirst = [&](const size_t root) {
+				queue.clear();
+				queue.push_back(root);
+				for (const size_t node : nodes) {
+					level[node] = none;
+				}
+				level[root] = 0;
+				for (size_t front = 0; front < queue.size(); front++) {
+					const size_t node = queue[front];
+					for (size_t edge = graph.offsets[node]; edge < graph.offsets[node + 1]; edge++) {
+						const size_t neighbor = graph.nodes[edge];
+						if (part[neighbor] == partId && level[neighbor] == none) {
+							level[neighbor] = level[node] + 1;
+							queue.push_back(neighbor);
+						}
+					}
+				}
+			};
+			size_t root = nodes.front(), depth = 0;
+			for (size_t attempt = 0; attempt < 4; attempt++) {
+				breadthFirst(root);
+				const size_t lastLevel = level[queue.back()];
+				if (attempt > 0 && lastLevel <= depth) {
+					break;
+				}
+				depth = lastLevel;
+				size_t farthest = queue.back();
+				for (size_t index = queue.size(); index-- > 0 && level[queue[index]] == lastLevel;) {
+					if (graph.offsets[queue[index] + 1] - graph.offsets[queue[index]]
+						< graph.offsets[farthest + 1] - graph.offsets[farthest]) {
+						farthest = queue[index];
+					}
+				}
+				root = farthest;
+			}
+			breadthFirst(root);
+			depth = level[queue.back()];
+
+			// 2. Split : unreachable nodes form the second part, otherwise cut at the level holding the median node
+			std::vector<size_t> first, second, separator;
+			if (queue.size() < nodes.size()) {
+				first = queue;
+				for (const size_t node : nodes) {
+					if (level[node] == none) {
+						second.push_back(node);
+					}
+				}
+			}
+			else {
+				if (depth < 2) {
+					const Graph subgraph = inducedGraph(graph, nodes, level);
+					for (const size_t node : minimumDegree(subgraph)) {
+						order.push_back(nodes[node]);
+					}
+					return;
+				}
+				const size_t cut = std::max<size_t>(1, std::min(level[queue[queue.size() / 2]], depth - 1));
+				for (const size_t node : queue) {
+					if (level[node] < cut) {
+						first.push_back(node);
+					}
+					else if (level[node] > cut) {
+						second.push_back(node);
+					}
+					else {
+						bool touchesFarSide = false;
+						for (size_t edge = graph.offsets[node]; edge < graph.offsets[node + 1] && !touchesFarSide; edge++) {
+							touchesFarSide = part[graph.nodes[edge]] == partId && level[graph.nodes[edge]] == cut + 1;
+						}
+						(touchesFarSide ? separator : first).push_back(node);
+					}
+				}
+			}
+
+			// 3. Parts first, separator last
+			for (const std::vector<size_t>* piece : { &first, &second }) {
+				const size_t pieceId = nextPartId++;
+				for (const size_t node : *piece) {
+					part[node] = pieceId;
+				}
+				nestedDissection(graph, *piece, part, pieceId, nextPartId, level, order);
+			}
+			order.insert(order.end(), separator.begin(), separator.end());
+		}
+
+		/*
+		* Maximum product transversal (as MC64) : row matching[j] is moved to row j so that the product of |diagonal entries|
+		* is maximal. Minimum cost perfect matching with cost log(max_i |a_ij|) - log|a_ij| by shortest augmenting paths
+		* (Dijkstra on reduced costs with dual potentials), after greedy matching of zero reduced cost entries.
+		* Columns without augmenting path (structurally singular) take remaining rows in order.
+		*/
+		std::vector<size_t> maximumProductMatching(const Compressed& matrix)
+		{
+			const size_t size = matrix.height;
+			const double infinity = std::numeric_limits<double>::infinity();
+			const Compressed columns = matrix.transpose();
+			std::vector<double> costs(columns.indices.size(), infinity), rowDuals(size, infinity), colDuals(size, 0.0);
+			for (size_t col = 0; col < size; col++) {
+				double maxAbsolute = 0.0;
+				for (size_t index = columns.offsets[col]; index < columns.offsets[col + 1]; index++) {
+					maxAbsolute = std::max(maxAbsolute, std::abs(columns.values[index]));
+				}
+				for (size_t index = columns.offsets[col]; index < columns.offsets[col + 1]; index++) {
+					if (columns.values[index] != 0.0) {
+						costs[index] = std::log(maxAbsolute) - std::log(std::abs(columns.values[index]));
+						rowDuals[columns.indices[index]] = std::min(rowDuals[columns.indices[index]], costs[index]);
+					}
+				}
+			}
+			for (double& rowDual : rowDuals) {
+				rowDual = std::isfinite(rowDual) ? rowDual : 0.0;
+			}
+
+			std::vector<size_t> rowMatch(size, none), colMatch(size, none);
+			for (size_t col = 0; col < size; col++) {
+				for (size_t index = columns.offsets[col]; index < columns.offsets[col + 1]; index++) {
+					const size_t row = columns.indices[index];
+					if (rowMatch[row] == none && costs[index] - rowDuals[row] <= 0.0) {
+						rowMatch[row] = col;
+						colMatch[col] = row;
+						break;
+					}
+				}
+			}
+
+			std::vector<double> distances(size, infinity);
+			std::vector<size_t> previous(size, none), finished, touched;
+			std::vector<char> done(size, 0);
+			std::priority_queue<std::pair<double, size_t>, std::vector<std::pair<double, size_t>>, std::greater<std::pair<double, size_t>>> queue;
+			for (size_t start = 0; start < size; start++) {
+				if (colMatch[start] != none) {
+					continue;
+				}
+				auto relax = [&](const size_t col, const double distance) {
+					for (size_t index = columns.offsets[col]; index < columns.offsets[col + 1]; index++) {
+						const size_t row = columns.indices[index];
+						const double reached = distance + costs[index] - rowDuals[row] - colDuals[col];
+						if (!done[row] && reached < distances[row]) {
+							if (distances[row] == infinity) {
+								touched.push_back(row);
+							}
+							distances[row] = reached;
+							previous[row] = col;
+							queue.emplace(reached, row);
+						}
+					}
+				};
+				relax(start, 0.0);
+				size_t freeRow = none;
+				while (!queue.empty()) {
+					const std::pair<double, size_t> top = queue.top();
+					queue.pop();
+					if (done[top.second] || top.first > distances[top.second]) {
+						continue;
+					}
+					done[top.second] = 1;
+					finished.push_back(top.second);
+					if (rowMatch[top.second] == none) {
+						freeRow = top.second;
+						break;
+					}
+					relax(rowMatch[top.second], top.first);
+				}
+
+				if (freeRow != none) {
+					// Keep reduced costs non-negative and zero on matched entries, then flip the path
+					const double length = distances[freeRow];
+					for (const size_t row : finished) {
+						const double delta = length - distances[row];
+						rowDuals[row] -= delta;
+						if (rowMatch[row] != none) {
+							colDuals[rowMatch[row]] += delta;
+						}
+					}
+					colDuals[start] += length;
+					for (size_t row = freeRow;;) {
+						const size_t col = previous[row], nextRow = colMatch[col];
+						rowMatch[row] = col;
+						colMatch[col] = row;
+						if (col == start) {
+							break;
+						}
+						row = nextRow;
+					}
+				}
+				for (const size_t row : touched) {
+					distances[row] = infinity;
+					done[row] = 0;
+				}
+				touched.clear();
+				finished.clear();
+				queue = decltype(queue)();
+			}
+
+			size_t freeRow = 0;
+			for (size_t col = 0; col < size; col++) {
+				while (colMatch[col] == none) {
+					if (rowMatch[freeRow] == none) {
+						rowMatch[freeRow] = col;
+						colMatch[col] = freeRow;
+					}
+					freeRow++;
+				}
+			}
+			return colMatch;
+		}
+
+		// Stored entry of A and its position in the front of supernode owning min(row, col) after permutation
+		struct Assembly {
+			size_t entry, row, col;
+			bool lower; // Entry is on or below diagonal of A
+		};
+
+		/*
+		* Supernodal structure of L for P * (A + A^T) * P^T, columns in postorder of the elimination tree.
+		* Supernode s owns columns [columnBegin[s], columnBegin[s + 1]), its row indices (ascending, own columns first)
+		* are [rowOffsets[s], rowOffsets[s + 1]) of rows. Row rows[i] below own columns is relative[i]-th row of the parent front.
+		*/
+		struct Symbolic {
+			size_t columnCount(const size_t supernode) const { return columnBegin[supernode + 1] - columnBegin[supernode]; }
+			size_t rowCount(const size_t supernode) const { return rowOffsets[supernode + 1] - rowOffsets[supernode]; }
+			size_t supernodeCount() const { return columnBegin.size() - 1; }
+
+			size_t size = 0;
+			std::vector<size_t> patternOffsets, patternIndices; // Analyzed pattern of A
+			std::vector<size_t> matching; // Row matching[j] of A is row j of factored matrix, empty without row matching
+			std::vector<size_t> permutation, inverse, rightPermutation; // Permuted right-hand side row i is row rightPermutation[i]
+			std::vector<size_t> columnBegin, parent, childOffsets, children;
+			std::vector<size_t> rowOffsets, rows, relative;
+			std::vector<size_t> assemblyOffsets;
+			std::vector<Assembly> assembly;
+			std::vector<size_t> levelOffsets, levels; // Supernodes grouped by height in supernodal tree
+		};
+
+		// Nonzero pattern of permuted column j below diagonal
+		template <typename Visit>
+		void visitLower(const Graph& graph, const Symbolic& symbolic, const size_t col, const Visit& visit)
+		{
+			const size_t node = symbolic.permutation[col];
+			for (size_t edge = graph.offsets[node]; edge < graph.offsets[node + 1]; edge++) {
+				const size_t row = symbolic.inverse[graph.nodes[edge]];
+				if (row > col) {
+					visit(row);
+				}
+			}
+		}
+
+		// Rows of matrix reordered by matching, row j is row matching[j] of matrix
+		Compressed matchRows(const Compressed& matrix, const std::vector<size_t>& matching)
+		{
+			Compressed matched(matrix.height, matrix.width);
+			matched.indices.reserve(matrix.indices.size());
+			matched.values.reserve(matrix.values.size());
+			for (size_t row = 0; row < matrix.height; row++) {
+				const size_t begin = matrix.offsets[matching[row]], end = matrix.offsets[matching[row] + 1];
+				matched.indices.insert(matched.indices.end(), matrix.indices.begin() + begin, matrix.indices.begin() + end);
+				matched.values.insert(matched.values.end(), matrix.values.begin() + begin, matrix.values.begin() + end);
+				matched.offsets[row + 1] = matched.indices.size();
+			}
+			return matched;
+		}
+
+		Symbolic analyze(const Compressed& matrix, const SparseAnalysis::Ordering ordering, const bool rowMatching)
+		{
+			Symbolic symbolic;
+			const size_t size = matrix.height;
+			symbolic.size = size;
+			symbolic.patternOffsets = matrix.offsets;
+			symbolic.patternIndices = matrix.indices;
+			if (rowMatching) {
+				symbolic.matching = maximumProductMatching(matrix);
+			}
+			const Compressed pattern = rowMatching ? matchRows(matrix, symbolic.matching) : matrix;
+			const Graph graph = symmetricGraph(pattern);
+
+			// 1. Fill-reducing ordering
+			std::vector<size_t> order(size);
+			if (ordering == SparseAnalysis::Ordering::MinimumDegree) {
+				order = minimumDegree(graph);
+			}
+			else if (ordering == SparseAnalysis::Ordering::NestedDissection) {
+				std::vector<size_t> nodes(size), part(size, 0), level(size);
+				for (size_t node = 0; node < size; node++) {
+					nodes[node] = node;
+				}
+				size_t nextPartId = 1;
+				order.clear();
+				nestedDissection(graph, nodes, part, 0, nextPartId, level, order);
+			}
+			else {
+				for (size_t node = 0; node < size; node++) {
+					order[node] = node;
+				}
+			}
+
+			// 2. Elimination tree (Liu's algorithm with path compression), then relabel columns in postorder
+			std::vector<size_t> inverseOrder(size), parent(size, none), ancestor(size, none);
+			for (size_t col = 0; col < size; col++) {
+				inverseOrder[order[col]] = col;
+			}
+			for (size_t col = 0; col < size; col++) {
+				for (size_t edge = graph.offsets[order[col]]; edge < graph.offsets[order[col] + 1]; edge++) {
+					for (size_t row = inverseOrder[graph.nodes[edge]]; row != none && row < col;) {
+						const size_t nextRow = ancestor[row];
+						ancestor[row] = col;
+						if (nextRow == none) {
+							parent[row] = col;
+						}
+						row = nextRow;
+					}
+				}
+			}
+			std::vector<size_t> firstChild(size, none), nextSibling(size, none), postorder;
+			postorder.reserve(size);
+			for (size_t col = size; col-- > 0;) {
+				if (parent[col] != none) {
+					nextSibling[col] = firstChild[parent[col]];
+					firstChild[parent[col]] = col;
+				}
+			}
+			std::vector<size_t> stack;
+			for (size_t root = 0; root < size; root++) {
+				if (parent[root] != none) {
+					continue;
+				}
+				stack.push_back(root);
+				while (!stack.empty()) {
+					const size_t top = stack.back();
+					const size_t child = firstChild[top];
+					if (child == none) {
+						stack.pop_back();
+						postorder.push_back(top);
+					}
+					else {
+						firstChild[top] = nextSibling[child];
+						stack.push_back(child);
+					}
+				}
+			}
+			symbolic.permutation.resize(size);
+			symbolic.inverse.resize(size);
+			std::vector<size_t> postParent(size, none);
+			for (size_t col = 0; col < size; col++) {
+				symbolic.permutation[col] = order[postorder[col]];
+				inverseOrder[postorder[col]] = col;
+			}
+			for (size_t col = 0; col < size; col++) {
+				symbolic.inverse[symbolic.permutation[col]] = col;
+				if (parent[postorder[col]] != none) {
+					postParent[col] = inverseOrder[parent[postorder[col]]];
+				}
+			}
+			parent.swap(postParent);
+
+			// 3. Column counts of L by traversing row subtrees, O(nonzeros of L)
+			std::vector<size_t> columnCounts(size, 1), childCounts(size, 0), mark(size, none);
+			for (size_t row = 0; row < size; row++) {
+				mark[row] = row;
+				const size_t node = symbolic.permutation[row];
+				for (size_t edge = graph.offsets[node]; edge < graph.offsets[node + 1]; edge++) {
+					for (size_t col = symbolic.inverse[graph.nodes[edge]]; col < row && mark[col] != row; col = parent[col]) {
+						mark[col] = row;
+						columnCounts[col]++;
+					}
+				}
+				if (parent[row] != none) {
+					childCounts[parent[row]]++;
+				}
+			}
+
+			// 4. Fundamental supernodes : column j + 1 joins j when it is the only child and structures nest
+			std::vector<size_t> supernodeOf(size), fundamentalBegin(1, 0);
+			for (size_t col = 1; col < size; col++) {
+				if (parent[col - 1] != col || columnCounts[col - 1] != columnCounts[col] + 1 || childCounts[col] != 1) {
+					fundamentalBegin.push_back(col);
+				}
+			}
+			fundamentalBegin.push_back(size);
+			const size_t fundamentalCount = fundamentalBegin.size() - 1;
+			for (size_t supernode = 0; supernode < fundamentalCount; supernode++) {
+				std::fill(supernodeOf.begin() + fundamentalBegin[supernode], supernodeOf.begin() + fundamentalBegin[supernode + 1], supernode);
+			}
+
+			// Relaxed amalgamation : supernode absorbs its child ending right before it when few explicit zeros are stored
+			std::vector<size_t> mergedBegin(fundamentalBegin.begin(), fundamentalBegin.end() - 1), columnTotals(fundamentalCount);
+			std::vector<size_t> rowTotals(fundamentalCount), zeroTotals(fundamentalCount, 0);
+			std::vector<char> alive(fundamentalCount, 1);
+			for (size_t supernode = 0; supernode < fundamentalCount; supernode++) {
+				columnTotals[supernode] = fundamentalBegin[supernode + 1] - fundamentalBegin[supernode];
+				rowTotals[supernode] = columnCounts[fundamentalBegin[supernode]];
+				while (mergedBegin[supernode] > 0) {
+					const size_t child = supernodeOf[mergedBegin[supernode] - 1];
+					if (parent[fundamentalBegin[child + 1] - 1] == none || supernodeOf[parent[fundamentalBegin[child + 1] - 1]] != supernode) {
+						break;
+					}
+					const size_t columns = columnTotals[child] + columnTotals[supernode], rows = columnTotals[child] + rowTotals[supernode];
+					const double zeros = static_cast<double>(zeroTotals[child] + zeroTotals[supernode] + columnTotals[child] * (rows - rowTotals[child]));
+					const double stored = static_cast<double>(columns * rows - columns * (columns - 1) / 2);
+					if (!(columns <= 4 || (columns <= 16 && zeros < 0.8 * stored) || (columns <= 48 && zeros < 0.1 * stored) || zeros < 0.05 * stored)) {
+						break;
+					}
+					mergedBegin[supernode] = mergedBegin[child];
+					columnTotals[supernode] = columns;
+					rowTotals[supernode] = rows;
+					zeroTotals[supernode] += zeroTotals[child] + columnTotals[child] * (rows - rowTotals[child]);
+					alive[child] = 0;
+				}
+			}
+			std::vector<size_t> supernodeRows;
+			for (size_t supernode = 0; supernode < fundamentalCount; supernode++) {
+				if (alive[supernode]) {
+					symbolic.columnBegin.push_back(mergedBegin[supernode]);
+					supernodeRows.push_back(rowTotals[supernode]);
+				}
+			}
+			symbolic.columnBegin.push_back(size);
+			const size_t count = symbolic.supernodeCount();
+			symbolic.parent.assign(count, none);
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				for (size_t col = symbolic.columnBegin[supernode]; col < symbolic.columnBegin[supernode + 1]; col++) {
+					supernodeOf[col] = supernode;
+				}
+			}
+			symbolic.childOffsets.assign(count + 1, 0);
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				const size_t lastParent = parent[symbolic.columnBegin[supernode + 1] - 1];
+				if (lastParent != none) {
+					symbolic.parent[supernode] = supernodeOf[lastParent];
+					symbolic.childOffsets[symbolic.parent[supernode] + 1]++;
+				}
+			}
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				symbolic.childOffsets[supernode + 1] += symbolic.childOffsets[supernode];
+			}
+			symbolic.children.resize(symbolic.childOffsets[count]);
+			std::vector<size_t> next(symbolic.childOffsets.begin(), symbolic.childOffsets.end() - 1);
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				if (symbolic.parent[supernode] != none) {
+					symbolic.children[next[symbolic.parent[supernode]]++] = supernode;
+				}
+			}
+
+			// 5. Row structure : own columns, entries of A below them, and rows of children below own columns
+			symbolic.rowOffsets.assign(count + 1, 0);
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				symbolic.rowOffsets[supernode + 1] = symbolic.rowOffsets[supernode] + supernodeRows[supernode];
+			}
+			symbolic.rows.resize(symbolic.rowOffsets[count]);
+			std::fill(mark.begin(), mark.end(), none);
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				const size_t begin = symbolic.columnBegin[supernode], end = symbolic.columnBegin[supernode + 1];
+				size_t* rows = symbolic.rows.data() + symbolic.rowOffsets[supernode];
+				size_t length = 0;
+				auto add = [&](const size_t row) {
+					if (mark[row] != supernode) {
+						mark[row] = supernode;
+						rows[length++] = row;
+					}
+				};
+				for (size_t col = begin; col < end; col++) {
+					add(col);
+				}
+				for (size_t col = begin; col < end; col++) {
+					visitLower(graph, symbolic, col, [&](const size_t row) { if (row >= end) add(row); });
+				}
+				for (size_t index = symbolic.childOffsets[supernode]; index < symbolic.childOffsets[supernode + 1]; index++) {
+					const size_t child = symbolic.children[index];
+					for (size_t position = symbolic.rowOffsets[child] + symbolic.columnCount(child);
+						position < symbolic.rowOffsets[child + 1]; position++) {
+						add(symbolic.rows[position]);
+					}
+				}
+				std::sort(rows + (end - begin), rows + length);
+			}
+
+			// 6. Relative positions of child rows in parent fronts
+			symbolic.relative.assign(symbolic.rows.size(), 0);
+			std::vector<size_t>& position = mark;
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				for (size_t index = symbolic.rowOffsets[supernode]; index < symbolic.rowOffsets[supernode + 1]; index++) {
+					position[symbolic.rows[index]] = index - symbolic.rowOffsets[supernode];
+				}
+				for (size_t index = symbolic.childOffsets[supernode]; index < symbolic.childOffsets[supernode + 1]; index++) {
+					const size_t child = symbolic.children[index];
+					for (size_t row = symbolic.rowOffsets[child] + symbolic.columnCount(child); row < symbolic.rowOffsets[child + 1]; row++) {
+						symbolic.relative[row] = position[symbolic.rows[row]];
+					}
+				}
+			}
+
+			// 7. Front positions of stored entries, grouped by supernode
+			symbolic.assemblyOffsets.assign(count + 1, 0);
+			std::vector<size_t> entrySupernodes(pattern.indices.size());
+			for (size_t row = 0; row < size; row++) {
+				for (size_t index = pattern.offsets[row]; index < pattern.offsets[row + 1]; index++) {
+					entrySupernodes[index] = supernodeOf[std::min(symbolic.inverse[row], symbolic.inverse[pattern.indices[index]])];
+					symbolic.assemblyOffsets[entrySupernodes[index] + 1]++;
+				}
+			}
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				symbolic.assemblyOffsets[supernode + 1] += symbolic.assemblyOffsets[supernode];
+			}
+			symbolic.assembly.resize(pattern.indices.size());
+			next.assign(symbolic.assemblyOffsets.begin(), symbolic.assemblyOffsets.end() - 1);
+			for (size_t row = 0; row < size; row++) {
+				for (size_t index = pattern.offsets[row]; index < pattern.offsets[row + 1]; index++) {
+					const size_t supernode = entrySupernodes[index];
+					const auto first = symbolic.rows.begin() + symbolic.rowOffsets[supernode];
+					const auto last = symbolic.rows.begin() + symbolic.rowOffsets[supernode + 1];
+					const size_t frontRow = std::lower_bound(first, last, symbolic.inverse[row]) - first;
+					const size_t frontCol = std::lower_bound(first, last, symbolic.inverse[pattern.indices[index]]) - first;
+					symbolic.assembly[next[supernode]++] = { index, frontRow, frontCol, pattern.indices[index] <= row };
+				}
+			}
+
+			symbolic.rightPermutation = symbolic.permutation;
+			if (rowMatching) {
+				for (size_t& row : symbolic.rightPermutation) {
+					row = symbolic.matching[row];
+				}
+			}
+
+			// 8. Levels of supernodal tree, supernodes of one level are independent
+			std::vector<size_t> height(count, 0);
+			size_t levelCount = 0;
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				if (symbolic.parent[supernode] != none) {
+					height[symbolic.parent[supernode]] = std::max(height[symbolic.parent[supernode]], height[supernode] + 1);
+				}
+				levelCount = std::max(levelCount, height[supernode] + 1);
+			}
+			symbolic.levelOffsets.assign(levelCount + 1, 0);
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				symbolic.levelOffsets[height[supernode] + 1]++;
+			}
+			for (size_t level = 0; level < levelCount; level++) {
+				symbolic.levelOffsets[level + 1] += symbolic.levelOffsets[level];
+			}
+			symbolic.levels.resize(count);
+			next.assign(symbolic.levelOffsets.begin(), symbolic.levelOffsets.end() - 1);
+			for (size_t supernode = 0; supernode < count; supernode++) {
+				symbolic.levels[next[height[supernode]]++] = supernode;
+			}
+			return symbolic;
+		}
+
+		/*
+		* Multifrontal factorization, level by level from leaves. Front of supernode s is (rows x rows) with entries of A
+		* and update matrices of children assembled (lower triangle only when symmetric), factorFront factors its own columns
+		* and its trailing block is the update matrix passed to the parent. Returns false when factorFront does.
+		*/
+		bool multifrontal(const Symbolic& symbolic, const std::vector<double>& values, const bool symmetric,
+			const std::function<bool(const size_t, Dense&)>& factorFront)
+		{
+			const size_t count = symbolic.supernodeCount();
+			std::vector<Dense> updates(count);
+			std::vector<char> succeeded(count, 1);
+			auto factorSupernodes = [&](const size_t levelBegin, const size_t levelEnd) {
+				for (size_t index = levelBegin; index < levelEnd; index++) {
+					const size_t supernode = symbolic.levels[index];
+					const size_t rowCount = symbolic.rowCount(supernode), columnCount = symbolic.columnCount(supernode);
+					Dense front(rowCount, rowCount);
+					for (size_t position = symbolic.assemblyOffsets[supernode]; position < symbolic.assemblyOffsets[supernode + 1]; position++) {
+						const Assembly& entry = symbolic.assembly[position];
+						if (!symmetric) {
+							front(entry.row, entry.col) += values[entry.entry];
+						}
+						else if (entry.lower) {
+							front(std::max(entry.row, entry.col), std::min(entry.row, entry.col)) += values[entry.entry];
+						}
+					}
+					for (size_t childIndex = symbolic.childOffsets[supernode]; childIndex < symbolic.childOffsets[supernode + 1]; childIndex++) {
+						const size_t child = symbolic.children[childIndex];
+						const size_t* relative = symbolic.relative.data() + symbolic.rowOffsets[child] + symbolic.columnCount(child);
+						Dense& update = updates[child];
+						for (size_t row = 0; row < update.height; row++) {
+							double* frontRow = front.row(relative[row]);
+							const double* updateRow = update.row(row);
+							for (size_t col = 0, colEnd = symmetric ? row + 1 : update.width; col < colEnd; col++) {
+								frontRow[relative[col]] += updateRow[col];
+							}
+						}
+						update = Dense();
+					}
+
+					if (!factorFront(supernode, front)) {
+						succeeded[supernode] = 0;
+						continue;
+					}
+					if (rowCount > columnCount) {
+						Dense& update = updates[supernode];
+						update = Dense(rowCount - columnCount, rowCount - columnCount);
+						for (size_t row = 0; row < update.height; row++) {
+							std::copy_n(front.row(columnCount + row) + columnCount, update.width, update.row(row));
+						}
+					}
+				}
+			};
+			for (size_t level = 0; level + 1 < symbolic.levelOffsets.size(); level++) {
+				parallelFor(symbolic.levelOffsets[level], symbolic.levelOffsets[level + 1],
+					[&factorSupernodes](const size_t levelBegin, const size_t levelEnd) { factorSupernodes(levelBegin, levelEnd); });
+				if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end()) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Rows of supernode below its own columns, gathered from or scattered into (size x width) solution
+		void gatherRows(const Symbolic& symbolic, const size_t supernode, const Dense& solution, std::vector<double>& rows)
+		{
+			const size_t width = solution.width, first = symbolic.rowOffsets[supernode] + symbolic.columnCount(supernode);
+			rows.resize((symbolic.rowOffsets[supernode + 1] - first) * width);
+			for (size_t index = first; index < symbolic.rowOffsets[supernode + 1]; index++) {
+				std::copy_n(solution.row(symbolic.rows[index]), width, rows.data() + (index - first) * width);
+			}
+		}
+		void scatterSubtractRows(const Symbolic& symbolic, const size_t supernode, const std::vector<double>& rows, Dense& solution)
+		{
+			const size_t width = solution.width, first = symbolic.rowOffsets[supernode] + symbolic.columnCount(supernode);
+			for (size_t index = first; index < symbolic.rowOffsets[supernode + 1]; index++) {
+				axpy(width, -1.0, rows.data() + (index - first) * width, solution.row(symbolic.rows[index]));
+			}
+		}
+
+		// Right-hand side rows in factored order, and solution rows back in original order
+		Dense permuteRows(const Symbolic& symbolic, const Dense& right)
+		{
+			Dense permuted(right.height, right.width);
+			for (size_t row = 0; row < right.height; row++) {
+				std::copy_n(right.row(symbolic.rightPermutation[row]), right.width, permuted.row(row));
+			}
+			return permuted;
+		}
+		Dense unpermuteRows(const Symbolic& symbolic, const Dense& permuted)
+		{
+			Dense right(permuted.height, permuted.width);
+			for (size_t row = 0; row < permuted.height; row++) {
+				std::copy_n(permuted.row(row), permuted.width, right.row(symbolic.permutation[row]));
+			}
+			return right;
+		}
+	}
+
+
+
+
+
+	class SparseAnalysis::Impl {
+	public:
+		Impl(const SparseMatrix& pattern, const Ordering ordering, const bool rowMatching); // throws std::logic_error
+
+		bool matches(const SparseMatrix& matrix) const;
+		void checkMatch(const SparseMatrix& matrix) const; // throws std::logic_error
+		std::vector<double> factoredValues(const SparseMatrix& matrix) const; // Values in analyzed entry order
+
+		Symbolic mSymbolic;
+	};
+
+	SparseAnalysis::Impl::Impl(const SparseMatrix& pattern, const Ordering ordering, const bool rowMatching)
+	{
+		if (pattern.height() != pattern.width()) {
+			handleEtcException("Cannot analyze sparse factorization of non-square matrix.");
+		}
+		mSymbolic = analyze(fromSparse(pattern), ordering, rowMatching);
+	}
+
+	bool SparseAnalysis::Impl::matches(const SparseMatrix& matrix) const
+	{
+		return matrix.height() == mSymbolic.size && matrix.width() == mSymbolic.size
+			&& matrix.rowOffsets() == mSymbolic.patternOffsets && matrix.columnIndices() == mSymbolic.patternIndices;
+	}
+	void SparseAnalysis::Impl::checkMatch(const SparseMatrix& matrix) const
+	{
+		if (!matches(matrix)) {
+			handleEtcException("Sparse pattern differs from analyzed pattern.");
+		}
+	}
+	std::vector<double> SparseAnalysis::Impl::factoredValues(const SparseMatrix& matrix) const
+	{
+		if (mSymbolic.matching.empty()) {
+			return matrix.values();
+		}
+		return matchRows(fromSparse(matrix), mSymbolic.matching).values;
+	}
+
+
+
+
+
+	SparseAnalysis::SparseAnalysis(const SparseMatrix& pattern, const Ordering ordering, const bool rowMatching)
+		: impl(std::make_unique<Impl>(pattern, ordering, rowMatching))
+	{
+	}
+	SparseAnalysis::SparseAnalysis(const SparseAnalysis& copyAnalysis)
+		: impl(std::make_unique<Impl>(*(copyAnalysis.impl)))
+	{
+	}
+	SparseAnalysis::~SparseAnalysis() = default;
+
+	bool SparseAnalysis::matches(const SparseMatrix& matrix) const
+	{
+		return impl->matches(matrix);
+	}
+
+	bool SparseAnalysis::hasRowMatching() const
+	{
+		return !impl->mSymbolic.matching.empty();
+	}
+	std::vector<size_t> SparseAnalysis::permutation() const
+	{
+		return impl->mSymbolic.permutation;
+	}
+	const size_t SparseAnalysis::factorNonZeroCount() const
+	{
+		const Symbolic& symbolic = impl->mSymbolic;
+		size_t count = 0;
+		for (size_t supernode = 0; supernode < symbolic.supernodeCount(); supernode++) {
+			const size_t columnCount = symbolic.columnCount(supernode);
+			count += symbolic.rowCount(supernode) * columnCount - columnCount * (columnCount - 1) / 2;
+		}
+		return count;
+	}
+	const size_t SparseAnalysis::supernodeCount() const
+	{
+		return impl->mSymbolic.supernodeCount();
+	}
+	const size_t SparseAnalysis::size() const
+	{
+		return impl->mSymbolic.size;
+	}
+
+	SparseAnalysis& SparseAnalysis::operator=(const SparseAnalysis& rightAnalysis)
+	{
+		if (this == &rightAnalysis) {
+			return *this;
+		}
+
+		*impl = *(rightAnalysis.impl);
+		return *this;
+	}
+
+
+
+
+
+	class SparseCholesky::Impl {
+	public:
+		Impl(const SparseAnalysis& analysis, const SparseMatrix& matrix); // throws std::logic_error
+
+		void factor(const SparseMatrix& matrix); // throws std::logic_error
+		void solve(Dense& solution) const; // In place on permuted rows
+		void checkLength(const size_t height, const size_t width) const; // throws std::logic_error
+
+		SparseAnalysis mAnalysis;
+		std::vector<Dense> mFactors; // Supernode s : (rows x columns) block of L, diagonal block on top
+	};
+
+	SparseCholesky::Impl::Impl(const SparseAnalysis& analysis, const SparseMatrix& matrix)
+		: mAnalysis(analysis)
+	{
+		factor(matrix);
+	}
+
+	void SparseCholesky::Impl::factor(const SparseMatrix& matrix)
+	{
+		const Symbolic& symbolic = mAnalysis.impl->mSymbolic;
+		mAnalysis.impl->checkMatch(matrix);
+		if (!symbolic.matching.empty()) {
+			handleEtcException("Cannot get Cholesky factor with row matching analysis.");
+		}
+
+		std::vector<Dense> factors(symbolic.supernodeCount());
+		const bool positiveDefinite = multifrontal(symbolic, matrix.values(), true, [&](const size_t supernode, Dense& front) {
+			const size_t rowCount = front.height, columnCount = symbolic.columnCount(supernode);
+			if (!choleskyFactor(columnCount, front.data(), rowCount)) {
+				return false;
+			}
+			if (rowCount > columnCount) {
+				trsm(Side::Right, Uplo::Lower, Trans::Trans, Diag::NonUnit, rowCount - columnCount, columnCount,
+					front.data(), rowCount, front.row(columnCount), rowCount);
+				syrk(rowCount - columnCount, columnCount, -1.0, front.row(columnCount), rowCount,
+					1.0, front.row(columnCount) + columnCount, rowCount);
+			}
+			Dense& block = factors[supernode];
+			block = Dense(rowCount, columnCount);
+			for (size_t row = 0; row < rowCount; row++) {
+				std::copy_n(front.row(row), std::min(row + 1, columnCount), block.row(row));
+			}
+			return true;
+		});
+		if (!positiveDefinite) {
+			handleEtcException("The matrix is not positive-definite.");
+		}
+		mFactors.swap(factors);
+	}
+	void SparseCholesky::Impl::solve(Dense& solution) const
+	{
+		const Symbolic& symbolic = mAnalysis.impl->mSymbolic;
+		const size_t width = solution.width;
+		std::vector<double> rows;
+
+		// L * y = b, then L^T * x = y, supernode by supernode
+		for (size_t supernode = 0; supernode < symbolic.supernodeCount(); supernode++) {
+			const Dense& block = mFactors[supernode];
+			double* own = solution.row(symbolic.columnBegin[supernode]);
+			trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::NonUnit, block.width, width, block.data(), block.width, own, width);
+			if (block.height > block.width) {
+				rows.resize((block.height - block.width) * width);
+				gemm(Trans::NoTrans, Trans::NoTrans, block.height - block.width, width, block.width,
+					1.0, block.row(block.width), block.width, own, width, 0.0, rows.data(), width);
+				scatterSubtractRows(symbolic, supernode, rows, solution);
+			}
+		}
+		for (size_t supernode = symbolic.supernodeCount(); supernode-- > 0;) {
+			const Dense& block = mFactors[supernode];
+			double* own = solution.row(symbolic.columnBegin[supernode]);
+			if (block.height > block.width) {
+				gatherRows(symbolic, supernode, solution, rows);
+				gemm(Trans::Trans, Trans::NoTrans, block.width, width, block.height - block.width,
+					-1.0, block.row(block.width), block.width, rows.data(), width, 1.0, own, width);
+			}
+			trsm(Side::Left, Uplo::Lower, Trans::Trans, Diag::NonUnit, block.width, width, block.data(), block.width, own, width);
+		}
+	}
+	void SparseCholesky::Impl::checkLength(const size_t height, const size_t width) const
+	{
+		const size_t size = mAnalysis.impl->mSymbolic.size;
+		handleOperationException(ExceptionHandlerr::checkHeight(size, height), '\\',
+			LengthArgument(size, size), LengthArgument(height, width));
+	}
+
+
+
+
+
+	SparseCholesky::SparseCholesky(const SparseMatrix& matrix, const SparseAnalysis::Ordering ordering)
+		: impl(std::make_unique<Impl>(SparseAnalysis(matrix, ordering), matrix))
+	{
+	}
+	SparseCholesky::SparseCholesky(const SparseAnalysis& analysis, const SparseMatrix& matrix)
+		: impl(std::make_unique<Impl>(analysis, matrix))
+	{
+	}
+	SparseCholesky::SparseCholesky(const SparseCholesky& copyCholesky)
+		: impl(std::make_unique<Impl>(*(copyCholesky.impl)))
+	{
+	}
+	SparseCholesky::~SparseCholesky() = default;
+
+	void SparseCholesky::refactor(const SparseMatrix& matrix)
+	{
+		impl->factor(matrix);
+	}
+
+	Vectorr SparseCholesky::solve(const Vectorr& rightVector) const
+	{
+		impl->checkLength(rightVector.size(), 1);
+		const Symbolic& symbolic = impl->mAnalysis.impl->mSymbolic;
+		Dense solution = permuteRows(symbolic, fromColumns(rightVector));
+		impl->solve(solution);
+		return toVector(unpermuteRows(symbolic, solution).entries);
+	}
+	Matrixx SparseCholesky::solve(const Matrixx& rightMatrix) const
+	{
+		impl->checkLength(rightMatrix.height(), rightMatrix.width());
+		const Symbolic& symbolic = impl->mAnalysis.impl->mSymbolic;
+		Dense solution = permuteRows(symbolic, fromMatrix(rightMatrix));
+		impl->solve(solution);
+		return toMatrix(unpermuteRows(symbolic, solution));
+	}
+	double SparseCholesky::logDeterminant() const
+	{
+		double logDeterminant = 0.0;
+		for (const Dense& block : impl->mFactors) {
+			for (size_t col = 0; col < block.width; col++) {
+				logDeterminant += 2.0 * std::log(block(col, col));
+			}
+		}
+		return logDeterminant;
+	}
+
+	SparseAnalysis SparseCholesky::analysis() const
+	{
+		return impl->mAnalysis;
+	}
+	const size_t SparseCholesky::size() const
+	{
+		return impl->mAnalysis.impl->mSymbolic.size;
+	}
+
+	SparseCholesky& SparseCholesky::operator=(const SparseCholesky& rightCholesky)
+	{
+		if (this == &rightCholesky) {
+			return *this;
+		}
+
+		*impl = *(rightCholesky.impl);
+		return *this;
+	}
+
+
+
+
+
+	class SparseLU::Impl {
+	public:
+		Impl(const SparseAnalysis& analysis, const SparseMatrix& matrix); // throws std::logic_error
+
+		void factor(const SparseMatrix& matrix); // throws std::logic_error
+		void solve(Dense& solution) const; // In place on permuted rows
+		// A^-1 * right, refined by x += A^-1 * (b - A * x) when factor has perturbed pivots
+		Dense solveRefined(const Dense& right) const;
+		void checkLength(const size_t height, const size_t width) const; // throws std::logic_error
+
+		SparseAnalysis mAnalysis;
+		Compressed mMatrix; // A, for iterative refinement
+		std::vector<Dense> mLower, mUpper; // Supernode s : (rows x columns) block of L and (columns x rows) block of U
+		std::vector<size_t> mPivots; // Row col was swapped with row mPivots[col] inside its supernode (local index)
+		size_t mPerturbedCount;
+	};
+
+	SparseLU::Impl::Impl(const SparseAnalysis& analysis, const SparseMatrix& matrix)
+		: mAnalysis(analysis), mPerturbedCount(0)
+	{
+		factor(matrix);
+	}
+
+	void SparseLU::Impl::factor(const SparseMatrix& matrix)
+	{
+		const Symbolic& symbolic = mAnalysis.impl->mSymbolic;
+		mAnalysis.impl->checkMatch(matrix);
+
+		mMatrix = fromSparse(matrix);
+		const std::vector<double> values = mAnalysis.impl->factoredValues(matrix);
+		double maxAbsoluteEntry = 0.0;
+		for (const double value : values) {
+			maxAbsoluteEntry = std::max(maxAbsoluteEntry, std::abs(value));
+		}
+		const double threshold = std::sqrt(std::numeric_limits<double>::epsilon()) * std::max(maxAbsoluteEntry, std::numeric_limits<double>::min());
+
+		const size_t count = symbolic.supernodeCount();
+		mLower.assign(count, Dense());
+		mUpper.assign(count, Dense());
+		mPivots.assign(symbolic.size, 0);
+		std::vector<size_t> perturbedCounts(count, 0);
+		multifrontal(symbolic, values, false, [&](const size_t supernode, Dense& front) {
+			// Blocked right-looking LU of own columns, pivot rows are searched among own rows only
+			const size_t rowCount = front.height, columnCount = symbolic.columnCount(supernode);
+			size_t* pivots = mPivots.data() + symbolic.columnBegin[supernode];
+			for (size_t blockBegin = 0; blockBegin < columnCount; blockBegin += blockSize) {
+				const size_t blockEnd = std::min(blockBegin + blockSize, columnCount);
+				for (size_t col = blockBegin; col < blockEnd; col++) {
+					size_t pivot = col;
+					for (size_t row = col + 1; row < columnCount; row++) {
+						if (std::abs(front(row, col)) > std::abs(front(pivot, col))) {
+							pivot = row;
+						}
+					}
+					pivots[col] = pivot;
+					if (pivot != col) {
+						std::swap_ranges(front.row(col), front.row(col) + rowCount, front.row(pivot));
+					}
+					double& pivotEntry = front(col, col);
+					if (std::abs(pivotEntry) < threshold) {
+						pivotEntry = (pivotEntry < 0.0) ? -threshold : threshold;
+						perturbedCounts[supernode]++;
+					}
+					const double* pivotRow = front.row(col);
+					for (size_t row = col + 1; row < rowCount; row++) {
+						double* currentRow = front.row(row);
+						currentRow[col] /= pivotEntry;
+						axpy(blockEnd - col - 1, -currentRow[col], pivotRow + col + 1, currentRow + col + 1);
+					}
+				}
+				if (blockEnd == rowCount) {
+					break;
+				}
+				trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::Unit, blockEnd - blockBegin, rowCount - blockEnd,
+					front.row(blockBegin) + blockBegin, rowCount, front.row(blockBegin) + blockEnd, rowCount);
+				gemm(Trans::NoTrans, Trans::NoTrans, rowCount - blockEnd, rowCount - blockEnd, blockEnd - blockBegin,
+					-1.0, front.row(blockEnd) + blockBegin, rowCount, front.row(blockBegin) + blockEnd, rowCount,
+					1.0, front.row(blockEnd) + blockEnd, rowCount);
+			}
+
+			Dense& lower = mLower[supernode];
+			Dense& upper = mUpper[supernode];
+			lower = Dense(rowCount, columnCount);
+			upper = Dense(columnCount, rowCount);
+			for (size_t row = 0; row < rowCount; row++) {
+				std::copy_n(front.row(row), std::min(row, columnCount), lower.row(row));
+				if (row < columnCount) {
+					lower(row, row) = 1.0;
+					std::copy(front.row(row) + row, front.row(row) + rowCount, upper.row(row) + row);
+				}
+			}
+			return true;
+		});
+		mPerturbedCount = 0;
+		for (const size_t perturbedCount : perturbedCounts) {
+			mPerturbedCount += perturbedCount;
+		}
+	}
+	void SparseLU::Impl::solve(Dense& solution) const
+	{
+		const Symbolic& symbolic = mAnalysis.impl->mSymbolic;
+		const size_t width = solution.width;
+		std::vector<double> rows;
+
+		// L * y = P_s * b with row swaps of each supernode, then U * x = y
+		for (size_t supernode = 0; supernode < symbolic.supernodeCount(); supernode++) {
+			const Dense& lower = mLower[supernode];
+			const size_t begin = symbolic.columnBegin[supernode];
+			for (size_t col = 0; col < lower.width; col++) {
+				if (mPivots[begin + col] != col) {
+					std::swap_ranges(solution.row(begin + col), solution.row(begin + col) + width, solution.row(begin + mPivots[begin + col]));
+				}
+			}
+			double* own = solution.row(begin);
+			trsm(Side::Left, Uplo::Lower, Trans::NoTrans, Diag::Unit, lower.width, width, lower.data(), lower.width, own, width);
+			if (lower.height > lower.width) {
+				rows.resize((lower.height - lower.width) * width);
+				gemm(Trans::NoTrans, Trans::NoTrans, lower.height - lower.width, width, lower.width,
+					1.0, lower.row(lower.width), lower.width, own, width, 0.0, rows.data(), width);
+				scatterSubtractRows(symbolic, supernode, rows, solution);
+			}
+		}
+		for (size_t supernode = symbolic.supernodeCount(); supernode-- > 0;) {
+			const Dense& upper = mUpper[supernode];
+			double* own = solution.row(symbolic.columnBegin[supernode]);
+			if (upper.width > upper.height) {
+				gatherRows(symbolic, supernode, solution, rows);
+				gemm(Trans::NoTrans, Trans::NoTrans, upper.height, width, upper.width - upper.height,
+					-1.0, upper.data() + upper.height, upper.width, rows.data(), width, 1.0, own, width);
+			}
+			trsm(Side::Left, Uplo::Upper, Trans::NoTrans, Diag::NonUnit, upper.height, width, upper.data(), upper.width, own, width);
+		}
+	}
+	void SparseLU::Impl::checkLength(const size_t height, const size_t width) const
+	{
+		const size_t size = mAnalysis.impl->mSymbolic.size;
+		handleOperationException(ExceptionHandlerr::checkHeight(size, height), '\\',
+			LengthArgument(size, size), LengthArgument(height, width));
+	}
+
+	Dense SparseLU::Impl::solveRefined(const Dense& right) const
+	{
+		const Symbolic& symbolic = mAnalysis.impl->mSymbolic;
+		Dense solution = permuteRows(symbolic, right);
+		solve(solution);
+		solution = unpermuteRows(symbolic, solution);
+		for (size_t step = 0; step < refinementSteps && mPerturbedCount > 0; step++) {
+			Dense residual = right;
+			spmm(right.width, -1.0, mMatrix, solution.data(), solution.width, 1.0, residual.data(), residual.width);
+			Dense correction = permuteRows(symbolic, residual);
+			solve(correction);
+			correction = unpermuteRows(symbolic, correction);
+			axpy(solution.entries.size(), 1.0, correction.data(), solution.data());
+		}
+		return solution;
+	}
+
+
+
+
+
+	SparseLU::SparseLU(const SparseMatrix& matrix, const SparseAnalysis::Ordering ordering)
+		: impl(std::make_unique<Impl>(SparseAnalysis(matrix, ordering, true), matrix))
+	{
+	}
+	SparseLU::SparseLU(const SparseAnalysis& analysis, const SparseMatrix& matrix)
+		: impl(std::make_unique<Impl>(analysis, matrix))
+	{
+	}
+	SparseLU::SparseLU(const SparseLU& copyLU)
+		: impl(std::make_unique<Impl>(*(copyLU.impl)))
+	{
+	}
+	SparseLU::~SparseLU() = default;
+
+	void SparseLU::refactor(const SparseMatrix& matrix)
+	{
+		impl->factor(matrix);
+	}
+
+	Vectorr SparseLU::solve(const Vectorr& rightVector) const
+	{
+		impl->checkLength(rightVector.size(), 1);
+		return toVector(impl->solveRefined(fromColumns(rightVector)).entries);
+	}
+	Matrixx SparseLU::solve(const Matrixx& rightMatrix) const
+	{
+		impl->checkLength(rightMatrix.height(), rightMatrix.width());
+		return toMatrix(impl->solveRefined(fromMatrix(rightMatrix)));
+	}
+
+	const size_t SparseLU::perturbedPivotCount() const
+	{
+		return impl->mPerturbedCount;
+	}
+	SparseAnalysis SparseLU::analysis() const
+	{
+		return impl->mAnalysis;
+	}
+	const size_t SparseLU::size() const
+	{
+		return impl->mAnalysis.impl->mSymbolic.size;
+	}
+
+	SparseLU& SparseLU::operator=(const SparseLU& rightLU)
+	{
+		if (this == &rightLU) {
+			return *this;
+		}
+
+		*impl = *(rightLU.impl);
+		return *this;
+	}
+}
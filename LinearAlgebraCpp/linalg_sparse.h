@@ -0,0 +1,171 @@
+#pragma once
+
+#include "linalg.h"
+
+#include <vector>
+
+namespace linalg {
+	// Sparse matrix classes
+	// Implementations are in linalg_sparse.cpp
+	class SparseMatrix;
+	class SparseAnalysis;
+	class SparseCholesky;
+	class SparseLU;
+
+	/*
+	* Sparse matrix in compressed sparse row (CSR) storage, memory is O(height + nonzeros).
+	*
+	* Triplets (COO) are bucketed by row, then every row is sorted by column and its duplicates are summed,
+	* rows in parallel. Explicitly given zeros stay in the pattern, conversion from Matrixx keeps nonzero entries only.
+	* Products run in parallel over row chunks of about equal nonzero count :
+	* sparse * vector and sparse * dense read each stored entry once, sparse * sparse accumulates product rows (Gustavson).
+	* Compressed sparse column (CSC) arrays are the compressed rows of the transpose, given by toCompressedColumns.
+	*/
+	class SparseMatrix {
+	public:
+		explicit SparseMatrix(const size_t height = 1, const size_t width = 1); // throws std::length_error, zero matrix
+		explicit SparseMatrix(const Matrixx& matrix);
+		// Entry (rows[i], cols[i]) is values[i], duplicated positions are summed
+		SparseMatrix(const size_t height, const size_t width, const std::vector<size_t>& rows, const std::vector<size_t>& cols,
+			const std::vector<double>& values); // throws std::length_error, std::out_of_range, std::logic_error : triplet lengths differ
+		SparseMatrix(const SparseMatrix& copyMatrix);
+		virtual ~SparseMatrix();
+
+		// Row i occupies [offsets[i], offsets[i + 1]) of colIndices and values, unsorted or duplicated columns are allowed
+		static SparseMatrix fromCompressedRows(const size_t height, const size_t width, const std::vector<size_t>& offsets,
+			const std::vector<size_t>& colIndices, const std::vector<double>& values); // throws std::length_error, std::logic_error : invalid arrays
+		// Column j occupies [offsets[j], offsets[j + 1]) of rowIndices and values
+		static SparseMatrix fromCompressedColumns(const size_t height, const size_t width, const std::vector<size_t>& offsets,
+			const std::vector<size_t>& rowIndices, const std::vector<double>& values); // throws std::length_error, std::logic_error : invalid arrays
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range, binary search in row
+
+		// Compressed rows, column indices are ascending in each row
+		std::vector<size_t> rowOffsets() const;
+		std::vector<size_t> columnIndices() const;
+		std::vector<double> values() const;
+		// Compressed columns, row indices are ascending in each column
+		void toCompressedColumns(std::vector<size_t>& offsets, std::vector<size_t>& rowIndices, std::vector<double>& values) const;
+
+		SparseMatrix transpose() const;
+		Matrixx toMatrix() const;
+		const size_t nonZeroCount() const; // Stored entries
+		const size_t height() const;
+		const size_t width() const;
+
+		SparseMatrix& operator=(const SparseMatrix& rightMatrix);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+		SparseMatrix operator*(const SparseMatrix& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Symbolic analysis of sparse direct factorization, which depends only on the nonzero pattern of A + A^T.
+	*
+	* Rows and columns are symmetrically permuted by a fill-reducing ordering :
+	* approximate minimum degree on the quotient graph (rows denser than 10 * sqrt(n) are ordered last),
+	* or nested dissection by level-structure bisection with minimum degree on small parts.
+	* The elimination tree is postordered and columns of L with nested structure are grouped into supernodes,
+	* so numeric factorization runs dense blocked kernels on one frontal matrix per supernode.
+	* Assembly positions of every stored entry are resolved here, once per pattern.
+	*
+	* With rowMatching (for SparseLU only), rows are first reordered by a maximum product matching of |A| (as MC64)
+	* so that large entries lie on the diagonal, the only step which reads values. Refactorization keeps the matching.
+	* An analysis can be passed to any number of SparseCholesky/SparseLU with the analyzed pattern.
+	*/
+	class SparseAnalysis {
+		friend class SparseCholesky;
+		friend class SparseLU;
+	public:
+		enum class Ordering { Natural, MinimumDegree, NestedDissection };
+
+		explicit SparseAnalysis(const SparseMatrix& pattern, const Ordering ordering = Ordering::MinimumDegree,
+			const bool rowMatching = false); // throws std::logic_error : non-square
+		SparseAnalysis(const SparseAnalysis& copyAnalysis);
+		virtual ~SparseAnalysis();
+
+		bool matches(const SparseMatrix& matrix) const; // Same size and stored pattern as analyzed one
+
+		bool hasRowMatching() const;
+		std::vector<size_t> permutation() const; // Row and column i of P * A * P^T are row and column permutation()[i] of A (after row matching)
+		const size_t factorNonZeroCount() const; // Entries of L on and below diagonal
+		const size_t supernodeCount() const;
+		const size_t size() const;
+
+		SparseAnalysis& operator=(const SparseAnalysis& rightAnalysis);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Sparse Cholesky factorization P * A * P^T = L * L^T of symmetric positive-definite matrix,
+	* only the lower triangle of A is referenced.
+	*
+	* Multifrontal : each supernode assembles entries of A and update matrices of its children into a dense front,
+	* factors its columns with dense Cholesky and passes the Schur complement to its parent.
+	* Independent subtrees are factored in parallel, and large fronts near the root use parallel kernels.
+	* refactor computes new values on the analyzed pattern without repeating symbolic analysis.
+	*/
+	class SparseCholesky {
+	public:
+		explicit SparseCholesky(const SparseMatrix& matrix,
+			const SparseAnalysis::Ordering ordering = SparseAnalysis::Ordering::MinimumDegree); // throws std::logic_error : non-square or not positive-definite
+		SparseCholesky(const SparseAnalysis& analysis, const SparseMatrix& matrix); // throws std::logic_error : pattern mismatch, row matching or not positive-definite
+		SparseCholesky(const SparseCholesky& copyCholesky);
+		virtual ~SparseCholesky();
+
+		void refactor(const SparseMatrix& matrix); // throws std::logic_error : pattern mismatch or not positive-definite (factor is kept)
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+		double logDeterminant() const;
+
+		SparseAnalysis analysis() const;
+		const size_t size() const;
+
+		SparseCholesky& operator=(const SparseCholesky& rightCholesky);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Sparse LU factorization P * Q * A * P^T = L * U of square matrix, on the symmetric pattern of Q * A + (Q * A)^T.
+	*
+	* Rows are matched by Q (SparseAnalysis with rowMatching, always when analysis is done here) to bring large entries
+	* to the diagonal. Multifrontal with the same supernodes as SparseCholesky. Partial pivoting is restricted to the diagonal block
+	* of each supernode so that the analyzed structure holds, and a pivot below sqrt(epsilon) * max|A| is replaced by
+	* that threshold (static pivoting). When any pivot was perturbed, solve applies iterative refinement with A.
+	* refactor computes new values on the analyzed pattern without repeating symbolic analysis.
+	*/
+	class SparseLU {
+	public:
+		explicit SparseLU(const SparseMatrix& matrix,
+			const SparseAnalysis::Ordering ordering = SparseAnalysis::Ordering::MinimumDegree); // throws std::logic_error : non-square
+		SparseLU(const SparseAnalysis& analysis, const SparseMatrix& matrix); // throws std::logic_error : pattern mismatch
+		SparseLU(const SparseLU& copyLU);
+		virtual ~SparseLU();
+
+		void refactor(const SparseMatrix& matrix); // throws std::logic_error : pattern mismatch
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error
+
+		const size_t perturbedPivotCount() const;
+		SparseAnalysis analysis() const;
+		const size_t size() const;
+
+		SparseLU& operator=(const SparseLU& rightLU);
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,358 @@
+#include "linalg_symmetric.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace linalg {
+	using namespace kernel;
+
+	/*
+	* Row block [begin, end) is one dense (height x end) rectangle over columns [0, end) at mOffsets[block],
+	* which holds the lower triangle and the whole diagonal block. Upper half of a diagonal block mirrors its lower half,
+	* so kernels can read diagonal blocks as full symmetric squares.
+	*/
+	class SymmetricMatrix::Impl {
+	public:
+		Impl(const size_t size); // throws std::length_error
+
+		size_t blockCount() const { return (mSize + blockSize - 1) / blockSize; }
+		size_t blockBegin(const size_t block) const { return block * blockSize; }
+		size_t blockEnd(const size_t block) const { return std::min((block + 1) * blockSize, mSize); }
+		double* blockData(const size_t block) { return mEntries.data() + mOffsets[block]; }
+		const double* blockData(const size_t block) const { return mEntries.data() + mOffsets[block]; }
+		double* rowData(const size_t row) { return blockData(row / blockSize) + (row % blockSize) * blockEnd(row / blockSize); }
+		const double* rowData(const size_t row) const { return blockData(row / blockSize) + (row % blockSize) * blockEnd(row / blockSize); }
+
+		double get(const size_t row, const size_t col) const; // throws std::out_of_range
+		void set(const size_t row, const size_t col, const double value); // throws std::out_of_range
+
+		void assign(const Dense& dense); // Lower triangle is referenced
+		void copyLower(double* entries) const;
+		Dense toDense() const;
+		void mirrorDiagonalBlocks();
+
+		void forEachBlock(const std::function<void(const size_t)>& body) const;
+		void rankUpdate(const double alpha, const Dense& left, const Dense& right, const bool symmetric); // throws std::logic_error
+		void add(const double alpha, const Impl& right); // throws std::logic_error
+		Dense multiply(const Dense& rightDense) const; // throws std::logic_error
+
+		size_t mSize;
+		std::vector<size_t> mOffsets; // Offset of each row block
+		std::vector<double> mEntries;
+	};
+
+	SymmetricMatrix::Impl::Impl(const size_t size)
+		: mSize(size)
+	{
+		int exceptNum = ExceptionHandlerr::checkValidHeight(size);
+		if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+			LengthArgument lengthArg(size, size);
+			ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+			handler.addArgument(lengthArg);
+			handler.handleException();
+		}
+
+		mOffsets.resize(blockCount());
+		size_t offset = 0;
+		for (size_t block = 0; block < blockCount(); block++) {
+			mOffsets[block] = offset;
+			offset += (blockEnd(block) - blockBegin(block)) * blockEnd(block);
+		}
+		mEntries.assign(offset, 0.0);
+	}
+
+	double SymmetricMatrix::Impl::get(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, mSize, mSize);
+		return (col <= row) ? rowData(row)[col] : rowData(col)[row];
+	}
+	void SymmetricMatrix::Impl::set(const size_t row, const size_t col, const double value)
+	{
+		handleIndexException(row, col, mSize, mSize);
+		rowData(std::max(row, col))[std::min(row, col)] = value;
+		if (row / blockSize == col / blockSize) {
+			rowData(std::min(row, col))[std::max(row, col)] = value;
+		}
+	}
+
+	void SymmetricMatrix::Impl::assign(const Dense& dense)
+	{
+		for (size_t row = 0; row < mSize; row++) {
+			std::copy(dense.row(row), dense.row(row) + row + 1, rowData(row));
+		}
+		mirrorDiagonalBlocks();
+	}
+
+	void SymmetricMatrix::Impl::copyLower(double* entries) const
+	{
+		for (size_t row = 0; row < mSize; row++) {
+			std::copy(rowData(row), rowData(row) + row + 1, entries + row * mSize);
+		}
+	}
+
+	Dense SymmetricMatrix::Impl::toDense() const
+	{
+		Dense dense(mSize, mSize);
+		copyLower(dense.data());
+		for (size_t row = 0; row < mSize; row++) {
+			for (size_t col = 0; col < row; col++) {
+				dense(col, row) = dense(row, col);
+			}
+		}
+		return dense;
+	}
+
+	void SymmetricMatrix::Impl::mirrorDiagonalBlocks()
+	{
+		for (size_t row = 0; row < mSize; row++) {
+			const size_t begin = blockBegin(row / blockSize);
+			for (size_t col = begin; col < row; col++) {
+				rowData(col)[row] = rowData(row)[col];
+			}
+		}
+	}
+
+	// Row blocks have growing width, so blocks are dealt to threads in pairs (i, count - 1 - i) of about equal area
+	void SymmetricMatrix::Impl::forEachBlock(const std::function<void(const size_t)>& body) const
+	{
+		const size_t count = blockCount();
+		parallelFor(0, (count + 1) / 2, [&](const size_t pairBegin, const size_t pairEnd) {
+			for (size_t pair = pairBegin; pair < pairEnd; pair++) {
+				body(pair);
+				if (count - 1 - pair != pair) {
+					body(count - 1 - pair);
+				}
+			}
+		});
+	}
+
+	void SymmetricMatrix::Impl::rankUpdate(const double alpha, const Dense& left, const Dense& right, const bool symmetric)
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(mSize, left.height), '+',
+			LengthArgument(mSize, mSize), LengthArgument(left.height, left.width));
+		if (!symmetric) {
+			handleOperationException(ExceptionHandlerr::checkHeight(left.height, right.height), '+',
+				LengthArgument(left.height, left.width), LengthArgument(right.height, right.width));
+			handleOperationException(ExceptionHandlerr::checkWidth(left.width, right.width), '+',
+				LengthArgument(left.height, left.width), LengthArgument(right.height, right.width));
+		}
+
+		// Row block [begin, end) of the stored half gets alpha * L[begin, end) * R[0, end)^T (+ alpha * R[begin, end) * L[0, end)^T)
+		const size_t join = left.width;
+		forEachBlock([&](const size_t block) {
+			const size_t begin = blockBegin(block), end = blockEnd(block);
+			gemm(Trans::NoTrans, Trans::Trans, end - begin, end, join, alpha, left.row(begin), join,
+				right.data(), join, 1.0, blockData(block), end);
+			if (!symmetric) {
+				gemm(Trans::NoTrans, Trans::Trans, end - begin, end, join, alpha, right.row(begin), join,
+					left.data(), join, 1.0, blockData(block), end);
+			}
+		});
+		mirrorDiagonalBlocks();
+	}
+
+	void SymmetricMatrix::Impl::add(const double alpha, const Impl& right)
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(mSize, right.mSize), '+',
+			LengthArgument(mSize, mSize), LengthArgument(right.mSize, right.mSize));
+
+		axpy(mEntries.size(), alpha, right.mEntries.data(), mEntries.data());
+	}
+
+	Dense SymmetricMatrix::Impl::multiply(const Dense& rightDense) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mSize, rightDense.height), '*',
+			LengthArgument(mSize, mSize), LengthArgument(rightDense.height, rightDense.width));
+
+		const size_t width = rightDense.width, count = blockCount();
+		Dense product(mSize, width);
+		if (width == 1) {
+			// SYMV : each stored entry left of its diagonal block is read once for (row, col) and (col, row),
+			// contributions to earlier rows go to a buffer per part and are summed afterwards
+			const double* x = rightDense.data();
+			const size_t partCount = std::min(threadCount(), (count + 1) / 2);
+			std::vector<std::vector<double>> buffers(partCount, std::vector<double>(mSize, 0.0));
+			parallelFor(0, partCount, [&](const size_t partBegin, const size_t partEnd) {
+				for (size_t part = partBegin; part < partEnd; part++) {
+					double* buffer = buffers[part].data();
+					for (size_t pair = part; pair < (count + 1) / 2; pair += partCount) {
+						const size_t blocks[2] = { pair, count - 1 - pair };
+						for (size_t index = 0; index < ((blocks[0] == blocks[1]) ? 1u : 2u); index++) {
+							const size_t begin = blockBegin(blocks[index]), end = blockEnd(blocks[index]);
+							for (size_t row = begin; row < end; row++) {
+								const double* aRow = rowData(row);
+								const double xRow = x[row];
+								double sum = 0.0;
+								for (size_t col = 0; col < begin; col++) {
+									sum += aRow[col] * x[col];
+									buffer[col] += aRow[col] * xRow;
+								}
+								for (size_t col = begin; col < end; col++) {
+									sum += aRow[col] * x[col];
+								}
+								buffer[row] += sum;
+							}
+						}
+					}
+				}
+			});
+			for (size_t row = 0; row < mSize; row++) {
+				double sum = 0.0;
+				for (size_t part = 0; part < partCount; part++) {
+					sum += buffers[part][row];
+				}
+				product(row, 0) = sum;
+			}
+			return product;
+		}
+
+		// SYMM : row block i of the result is stored row block i times rows [0, end) of B,
+		// plus the transposed column block i of every later row block times its rows of B
+		parallelFor(0, count, [&](const size_t firstBlock, const size_t lastBlock) {
+			for (size_t block = firstBlock; block < lastBlock; block++) {
+				const size_t begin = blockBegin(block), end = blockEnd(block);
+				gemm(Trans::NoTrans, Trans::NoTrans, end - begin, width, end, 1.0, blockData(block), end,
+					rightDense.data(), width, 0.0, product.row(begin), width);
+				for (size_t later = block + 1; later < count; later++) {
+					const size_t laterBegin = blockBegin(later), laterEnd = blockEnd(later);
+					gemm(Trans::Trans, Trans::NoTrans, end - begin, width, laterEnd - laterBegin, 1.0, blockData(later) + begin, laterEnd,
+						rightDense.row(laterBegin), width, 1.0, product.row(begin), width);
+				}
+			}
+		});
+		return product;
+	}
+
+
+
+
+
+	SymmetricMatrix::SymmetricMatrix(const size_t size)
+		: impl(std::make_unique<Impl>(size))
+	{
+	}
+	SymmetricMatrix::SymmetricMatrix(const Matrixx& matrix)
+	{
+		const Dense dense = fromMatrix(matrix);
+		if (dense.height != dense.width) {
+			handleEtcException("Cannot make symmetric matrix from non-square matrix.");
+		}
+		if (!isSymmetric(dense)) {
+			handleEtcException("Cannot make symmetric matrix from non-symmetric matrix.");
+		}
+
+		impl = std::make_unique<Impl>(dense.height);
+		impl->assign(dense);
+	}
+	SymmetricMatrix::SymmetricMatrix(const SymmetricMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	SymmetricMatrix::~SymmetricMatrix() = default;
+
+	SymmetricMatrix SymmetricMatrix::fromLower(const Matrixx& matrix)
+	{
+		const Dense dense = fromMatrix(matrix);
+		if (dense.height != dense.width) {
+			handleEtcException("Cannot make symmetric matrix from non-square matrix.");
+		}
+
+		SymmetricMatrix symmetric(dense.height);
+		symmetric.impl->assign(dense);
+		return symmetric;
+	}
+
+	const double SymmetricMatrix::operator()(const size_t row, const size_t col) const
+	{
+		return impl->get(row, col);
+	}
+	void SymmetricMatrix::set(const size_t row, const size_t col, const double value)
+	{
+		impl->set(row, col, value);
+	}
+
+	void SymmetricMatrix::rankUpdate(const Vectorr& vector, const double alpha)
+	{
+		const Dense column = fromColumns(vector);
+		impl->rankUpdate(alpha, column, column, true);
+	}
+	void SymmetricMatrix::rankUpdate(const Matrixx& matrix, const double alpha)
+	{
+		const Dense dense = fromMatrix(matrix);
+		impl->rankUpdate(alpha, dense, dense, true);
+	}
+	void SymmetricMatrix::rank2Update(const Vectorr& leftVector, const Vectorr& rightVector, const double alpha)
+	{
+		impl->rankUpdate(alpha, fromColumns(leftVector), fromColumns(rightVector), false);
+	}
+	void SymmetricMatrix::rank2Update(const Matrixx& leftMatrix, const Matrixx& rightMatrix, const double alpha)
+	{
+		impl->rankUpdate(alpha, fromMatrix(leftMatrix), fromMatrix(rightMatrix), false);
+	}
+
+	Matrixx SymmetricMatrix::toMatrix() const
+	{
+		return kernel::toMatrix(impl->toDense());
+	}
+	const size_t SymmetricMatrix::size() const
+	{
+		return impl->mSize;
+	}
+
+	SymmetricMatrix& SymmetricMatrix::operator=(const SymmetricMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	SymmetricMatrix& SymmetricMatrix::operator+=(const SymmetricMatrix& rightMatrix)
+	{
+		impl->add(1.0, *(rightMatrix.impl));
+		return *this;
+	}
+	SymmetricMatrix& SymmetricMatrix::operator-=(const SymmetricMatrix& rightMatrix)
+	{
+		impl->add(-1.0, *(rightMatrix.impl));
+		return *this;
+	}
+	SymmetricMatrix& SymmetricMatrix::operator*=(const double multiplier)
+	{
+		scale(impl->mEntries.size(), multiplier, impl->mEntries.data());
+		return *this;
+	}
+	SymmetricMatrix SymmetricMatrix::operator+(const SymmetricMatrix& rightMatrix) const
+	{
+		SymmetricMatrix sum(*this);
+		sum += rightMatrix;
+		return sum;
+	}
+	SymmetricMatrix SymmetricMatrix::operator-(const SymmetricMatrix& rightMatrix) const
+	{
+		SymmetricMatrix difference(*this);
+		difference -= rightMatrix;
+		return difference;
+	}
+	SymmetricMatrix SymmetricMatrix::operator*(const double multiplier) const
+	{
+		SymmetricMatrix product(*this);
+		product *= multiplier;
+		return product;
+	}
+	Vectorr SymmetricMatrix::operator*(const Vectorr& rightVector) const
+	{
+		return toVector(impl->multiply(fromColumns(rightVector)).entries);
+	}
+	Matrixx SymmetricMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+
+	void SymmetricMatrix::copyLower(double* entries) const
+	{
+		impl->copyLower(entries);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "linalg.h"
+
+namespace linalg {
+	// Symmetric matrix classes
+	// Implementations are in linalg_symmetric.cpp
+	class SymmetricMatrix;
+
+	/*
+	* Symmetric matrix with half storage, memory is about n^2 / 2 entries.
+	*
+	* Rows are stored in blocks as the lower triangle of LowerTriangular, and each diagonal block is kept full,
+	* so products and rank updates run as blocked matrix-matrix kernels over the stored half only.
+	* Product with a vector (SYMV) reads every stored entry once for both of its positions, rows in parallel,
+	* and product with a matrix (SYMM) computes row blocks of the result in parallel.
+	* Rank updates (SYRK, SYR2K) compute only the stored half.
+	* Cholesky and SymmetricEigen take a SymmetricMatrix directly, without symmetry check.
+	*/
+	class SymmetricMatrix {
+		friend class Cholesky;
+		friend class SymmetricEigen;
+	public:
+		explicit SymmetricMatrix(const size_t size = 1); // throws std::length_error, zero matrix
+		explicit SymmetricMatrix(const Matrixx& matrix); // throws std::logic_error : non-square or non-symmetric
+		SymmetricMatrix(const SymmetricMatrix& copyMatrix);
+		virtual ~SymmetricMatrix();
+
+		static SymmetricMatrix fromLower(const Matrixx& matrix); // throws std::logic_error : non-square, only lower triangle is referenced
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		void set(const size_t row, const size_t col, const double value); // throws std::out_of_range, sets (row, col) and (col, row)
+
+		void rankUpdate(const Vectorr& vector, const double alpha = 1.0); // throws std::logic_error, A + alpha * v * v^T
+		void rankUpdate(const Matrixx& matrix, const double alpha = 1.0); // throws std::logic_error, A + alpha * M * M^T
+		void rank2Update(const Vectorr& leftVector, const Vectorr& rightVector,
+			const double alpha = 1.0); // throws std::logic_error, A + alpha * (x * y^T + y * x^T)
+		void rank2Update(const Matrixx& leftMatrix, const Matrixx& rightMatrix,
+			const double alpha = 1.0); // throws std::logic_error, A + alpha * (X * Y^T + Y * X^T)
+
+		Matrixx toMatrix() const;
+		const size_t size() const;
+
+		SymmetricMatrix& operator=(const SymmetricMatrix& rightMatrix);
+		SymmetricMatrix& operator+=(const SymmetricMatrix& rightMatrix); // throws std::logic_error
+		SymmetricMatrix& operator-=(const SymmetricMatrix& rightMatrix); // throws std::logic_error
+		SymmetricMatrix& operator*=(const double multiplier);
+		SymmetricMatrix operator+(const SymmetricMatrix& rightMatrix) const; // throws std::logic_error
+		SymmetricMatrix operator-(const SymmetricMatrix& rightMatrix) const; // throws std::logic_error
+		SymmetricMatrix operator*(const double multiplier) const;
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		void copyLower(double* entries) const; // Lower triangle into row-major (size x size) buffer, upper triangle is untouched
+
+		std::unique_ptr<Impl> impl;
+	};
+}
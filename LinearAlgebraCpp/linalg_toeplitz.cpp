@@ -0,0 +1,430 @@
+#include "linalg_toeplitz.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		constexpr size_t fourierGrain = 1 << 16; // Minimum transformed entries per parallel chunk
+
+		/*
+		* target[:, j] = first target.height entries of IFFT(FFT(source[:, j] zero padded) * spectrum) / length.
+		* spectrum is the transform of a real sequence, so two real columns share one complex transform
+		* as its real and imaginary parts, and column pairs run in parallel.
+		*/
+		void applySpectrum(const FourierPlan& plan, const std::vector<std::complex<double>>& spectrum, const Dense& source, Dense& target)
+		{
+			const size_t width = source.width, length = plan.length;
+			const double normalization = 1.0 / static_cast<double>(length);
+			parallelFor(0, (width + 1) / 2, [&](const size_t pairBegin, const size_t pairEnd) {
+				std::vector<std::complex<double>> buffer(length);
+				for (size_t pair = pairBegin; pair < pairEnd; pair++) {
+					const size_t col = 2 * pair;
+					const bool hasSecond = (col + 1 < width);
+					std::fill(buffer.begin(), buffer.end(), 0.0);
+					for (size_t row = 0; row < source.height; row++) {
+						buffer[row] = std::complex<double>(source(row, col), hasSecond ? source(row, col + 1) : 0.0);
+					}
+					plan.transform(buffer.data());
+					for (size_t index = 0; index < length; index++) {
+						buffer[index] *= spectrum[index];
+					}
+					plan.transform(buffer.data(), true);
+					for (size_t row = 0; row < target.height; row++) {
+						target(row, col) = buffer[row].real() * normalization;
+						if (hasSecond) {
+							target(row, col + 1) = buffer[row].imag() * normalization;
+						}
+					}
+				}
+			}, std::max<size_t>(1, fourierGrain / length));
+		}
+
+		std::vector<std::complex<double>> realSpectrum(const FourierPlan& plan, const std::vector<double>& sequence)
+		{
+			std::vector<std::complex<double>> spectrum(sequence.begin(), sequence.end());
+			plan.transform(spectrum.data());
+			return spectrum;
+		}
+
+		/*
+		* Levinson recursion (Golub and Van Loan, Algorithm 4.7.2) for T * X = B with symmetric Toeplitz T = t[0] * (I + offdiag(r)),
+		* columns [colBegin, colEnd) of B are solved together. y holds the Yule-Walker solution of the current order (Durbin),
+		* so each order costs O(k) per column. Returns false when a leading principal submatrix is singular.
+		*/
+		bool levinsonSolve(const std::vector<double>& t, Dense& rightDense, const size_t colBegin, const size_t colEnd)
+		{
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			const size_t length = t.size(), width = colEnd - colBegin;
+			if (t[0] == 0.0) {
+				return false;
+			}
+
+			std::vector<double> r(length), y(length), mu(width);
+			for (size_t index = 0; index + 1 < length; index++) {
+				r[index] = t[index + 1] / t[0];
+			}
+			Dense x(length, width);
+			for (size_t row = 0; row < length; row++) {
+				for (size_t col = 0; col < width; col++) {
+					x(row, col) = rightDense(row, colBegin + col) / t[0];
+				}
+			}
+
+			y[0] = -r[0];
+			double alpha = -r[0], beta = 1.0;
+			for (size_t order = 1; order < length; order++) {
+				beta *= 1.0 - alpha * alpha;
+				if (!(std::abs(beta) > epsilon)) {
+					return false;
+				}
+
+				// x(0 : order + 1) = [x(0 : order) + mu * reverse(y(0 : order)); mu]
+				double* xOrder = x.row(order);
+				for (size_t index = 0; index < order; index++) {
+					axpy(width, -r[index], x.row(order - 1 - index), xOrder);
+				}
+				for (size_t col = 0; col < width; col++) {
+					mu[col] = xOrder[col] / beta;
+					xOrder[col] = mu[col];
+				}
+				for (size_t index = 0; index < order; index++) {
+					double* xRow = x.row(index);
+					const double yReversed = y[order - 1 - index];
+					for (size_t col = 0; col < width; col++) {
+						xRow[col] += mu[col] * yReversed;
+					}
+				}
+
+				// y(0 : order + 1) = [y(0 : order) + alpha * reverse(y(0 : order)); alpha]
+				if (order + 1 < length) {
+					double sum = r[order];
+					for (size_t index = 0; index < order; index++) {
+						sum += r[index] * y[order - 1 - index];
+					}
+					alpha = -sum / beta;
+					for (size_t index = 0; index < order / 2; index++) {
+						const double front = y[index], back = y[order - 1 - index];
+						y[index] = front + alpha * back;
+						y[order - 1 - index] = back + alpha * front;
+					}
+					if (order % 2 == 1) {
+						y[order / 2] *= 1.0 + alpha;
+					}
+					y[order] = alpha;
+				}
+			}
+
+			for (size_t row = 0; row < length; row++) {
+				std::copy(x.row(row), x.row(row) + width, &rightDense(row, colBegin));
+			}
+			return true;
+		}
+	}
+
+
+
+
+
+	class ToeplitzMatrix::Impl {
+	public:
+		Impl(const std::vector<double>& column, const std::vector<double>& row); // throws std::logic_error
+
+		double get(const size_t row, const size_t col) const; // throws std::out_of_range
+		bool isSymmetric() const;
+		Dense multiply(const Dense& rightDense) const; // throws std::logic_error
+		void solve(Dense& rightDense) const; // throws std::logic_error
+
+		std::vector<double> mColumn, mRow; // mColumn[i] = T(i, 0), mRow[j] = T(0, j)
+		FourierPlan mPlan; // Power-of-two length >= height + width - 1
+		std::vector<std::complex<double>> mSpectrum; // Transform of the first column of the embedding circulant matrix
+	};
+
+	ToeplitzMatrix::Impl::Impl(const std::vector<double>& column, const std::vector<double>& row)
+		: mColumn(column), mRow(row), mPlan(nextPowerOfTwo(column.size() + row.size() - 1))
+	{
+		if (column[0] != row[0]) {
+			handleEtcException("First column and first row of Toeplitz matrix must start with the same entry.");
+		}
+
+		// Circulant first column (t[0], ..., t[height - 1], 0, ..., 0, t[-(width - 1)], ..., t[-1])
+		std::vector<double> circulant(mPlan.length, 0.0);
+		std::copy(mColumn.begin(), mColumn.end(), circulant.begin());
+		for (size_t index = 1; index < mRow.size(); index++) {
+			circulant[mPlan.length - index] = mRow[index];
+		}
+		mSpectrum = realSpectrum(mPlan, circulant);
+	}
+
+	double ToeplitzMatrix::Impl::get(const size_t row, const size_t col) const
+	{
+		handleIndexException(row, col, mColumn.size(), mRow.size());
+		return (row >= col) ? mColumn[row - col] : mRow[col - row];
+	}
+
+	bool ToeplitzMatrix::Impl::isSymmetric() const
+	{
+		return mColumn == mRow;
+	}
+
+	Dense ToeplitzMatrix::Impl::multiply(const Dense& rightDense) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mRow.size(), rightDense.height), '*',
+			LengthArgument(mColumn.size(), mRow.size()), LengthArgument(rightDense.height, rightDense.width));
+
+		Dense product(mColumn.size(), rightDense.width);
+		applySpectrum(mPlan, mSpectrum, rightDense, product);
+		return product;
+	}
+
+	void ToeplitzMatrix::Impl::solve(Dense& rightDense) const
+	{
+		if (!isSymmetric()) {
+			handleEtcException("Cannot solve non-symmetric Toeplitz system with Levinson recursion.");
+		}
+		handleOperationException(ExceptionHandlerr::checkHeight(mColumn.size(), rightDense.height), '\\',
+			LengthArgument(mColumn.size(), mRow.size()), LengthArgument(rightDense.height, rightDense.width));
+
+		// Column chunks run independent recursions, failure is recorded and thrown on calling thread
+		const size_t length = mColumn.size();
+		std::vector<char> isRegular(rightDense.width, 1);
+		parallelFor(0, rightDense.width, [&](const size_t colBegin, const size_t colEnd) {
+			isRegular[colBegin] = levinsonSolve(mColumn, rightDense, colBegin, colEnd);
+		}, std::max<size_t>(1, fourierGrain / (length * length)));
+		if (std::find(isRegular.begin(), isRegular.end(), 0) != isRegular.end()) {
+			handleEtcException("Cannot solve Toeplitz system with singular leading principal submatrix.");
+		}
+	}
+
+	class CirculantMatrix::Impl {
+	public:
+		Impl(const std::vector<double>& column);
+
+		Dense multiply(const Dense& rightDense) const; // throws std::logic_error
+		Dense solve(const Dense& rightDense) const; // throws std::logic_error
+
+		std::vector<double> mColumn;
+		FourierPlan mPlan;
+		std::vector<std::complex<double>> mSpectrum; // Eigenvalues FFT(mColumn)
+	};
+
+	CirculantMatrix::Impl::Impl(const std::vector<double>& column)
+		: mColumn(column), mPlan(column.size()), mSpectrum(realSpectrum(mPlan, column))
+	{
+	}
+
+	Dense CirculantMatrix::Impl::multiply(const Dense& rightDense) const
+	{
+		handleOperationException(ExceptionHandlerr::checkJoinLength(mColumn.size(), rightDense.height), '*',
+			LengthArgument(mColumn.size(), mColumn.size()), LengthArgument(rightDense.height, rightDense.width));
+
+		Dense product(mColumn.size(), rightDense.width);
+		applySpectrum(mPlan, mSpectrum, rightDense, product);
+		return product;
+	}
+
+	Dense CirculantMatrix::Impl::solve(const Dense& rightDense) const
+	{
+		handleOperationException(ExceptionHandlerr::checkHeight(mColumn.size(), rightDense.height), '\\',
+			LengthArgument(mColumn.size(), mColumn.size()), LengthArgument(rightDense.height, rightDense.width));
+
+		// Eigenvalues below size * epsilon * max|eigenvalue| are treated as zero
+		constexpr double epsilon = std::numeric_limits<double>::epsilon();
+		double maxEigenvalue = 0.0;
+		for (const std::complex<double>& eigenvalue : mSpectrum) {
+			maxEigenvalue = std::max(maxEigenvalue, std::abs(eigenvalue));
+		}
+		std::vector<std::complex<double>> inverseSpectrum(mSpectrum.size());
+		for (size_t index = 0; index < mSpectrum.size(); index++) {
+			if (std::abs(mSpectrum[index]) <= static_cast<double>(mColumn.size()) * epsilon * maxEigenvalue || maxEigenvalue == 0.0) {
+				handleEtcException("Cannot solve with singular circulant matrix.");
+			}
+			inverseSpectrum[index] = 1.0 / mSpectrum[index];
+		}
+
+		Dense solution(rightDense.height, rightDense.width);
+		applySpectrum(mPlan, inverseSpectrum, rightDense, solution);
+		return solution;
+	}
+
+
+
+
+
+	ToeplitzMatrix::ToeplitzMatrix(const Vectorr& firstColumn)
+		: impl(std::make_unique<Impl>(fromVector(firstColumn), fromVector(firstColumn)))
+	{
+	}
+	ToeplitzMatrix::ToeplitzMatrix(const Vectorr& firstColumn, const Vectorr& firstRow)
+		: impl(std::make_unique<Impl>(fromVector(firstColumn), fromVector(firstRow)))
+	{
+	}
+	ToeplitzMatrix::ToeplitzMatrix(const ToeplitzMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	ToeplitzMatrix::~ToeplitzMatrix() = default;
+
+	const double ToeplitzMatrix::operator()(const size_t row, const size_t col) const
+	{
+		return impl->get(row, col);
+	}
+	Vectorr ToeplitzMatrix::firstColumn() const
+	{
+		return toVector(impl->mColumn);
+	}
+	Vectorr ToeplitzMatrix::firstRow() const
+	{
+		return toVector(impl->mRow);
+	}
+	bool ToeplitzMatrix::isSymmetric() const
+	{
+		return impl->isSymmetric();
+	}
+
+	Vectorr ToeplitzMatrix::solve(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(solution);
+		return toVector(solution.entries);
+	}
+	Matrixx ToeplitzMatrix::solve(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(solution);
+		return kernel::toMatrix(solution);
+	}
+
+	ToeplitzMatrix ToeplitzMatrix::transpose() const
+	{
+		return ToeplitzMatrix(toVector(impl->mRow), toVector(impl->mColumn));
+	}
+	Matrixx ToeplitzMatrix::toMatrix() const
+	{
+		Dense dense(impl->mColumn.size(), impl->mRow.size());
+		for (size_t row = 0; row < dense.height; row++) {
+			for (size_t col = 0; col < dense.width; col++) {
+				dense(row, col) = (row >= col) ? impl->mColumn[row - col] : impl->mRow[col - row];
+			}
+		}
+		return kernel::toMatrix(dense);
+	}
+	const size_t ToeplitzMatrix::height() const
+	{
+		return impl->mColumn.size();
+	}
+	const size_t ToeplitzMatrix::width() const
+	{
+		return impl->mRow.size();
+	}
+
+	ToeplitzMatrix& ToeplitzMatrix::operator=(const ToeplitzMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	Vectorr ToeplitzMatrix::operator*(const Vectorr& rightVector) const
+	{
+		return toVector(impl->multiply(fromColumns(rightVector)).entries);
+	}
+	Matrixx ToeplitzMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+
+
+
+
+
+	CirculantMatrix::CirculantMatrix(const Vectorr& firstColumn)
+		: impl(std::make_unique<Impl>(fromVector(firstColumn)))
+	{
+	}
+	CirculantMatrix::CirculantMatrix(const CirculantMatrix& copyMatrix)
+		: impl(std::make_unique<Impl>(*(copyMatrix.impl)))
+	{
+	}
+	CirculantMatrix::~CirculantMatrix() = default;
+
+	const double CirculantMatrix::operator()(const size_t row, const size_t col) const
+	{
+		const size_t size = impl->mColumn.size();
+		handleIndexException(row, col, size, size);
+		return impl->mColumn[(row + size - col) % size];
+	}
+	Vectorr CirculantMatrix::firstColumn() const
+	{
+		return toVector(impl->mColumn);
+	}
+
+	Vectorr CirculantMatrix::solve(const Vectorr& rightVector) const
+	{
+		return toVector(impl->solve(fromColumns(rightVector)).entries);
+	}
+	Matrixx CirculantMatrix::solve(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->solve(fromMatrix(rightMatrix)));
+	}
+
+	CirculantMatrix CirculantMatrix::transpose() const
+	{
+		const size_t size = impl->mColumn.size();
+		std::vector<double> column(size);
+		for (size_t index = 0; index < size; index++) {
+			column[index] = impl->mColumn[(size - index) % size];
+		}
+		return CirculantMatrix(toVector(column));
+	}
+	ToeplitzMatrix CirculantMatrix::toToeplitz() const
+	{
+		return ToeplitzMatrix(toVector(impl->mColumn), transpose().firstColumn());
+	}
+	Matrixx CirculantMatrix::toMatrix() const
+	{
+		const size_t size = impl->mColumn.size();
+		Dense dense(size, size);
+		for (size_t row = 0; row < size; row++) {
+			for (size_t col = 0; col < size; col++) {
+				dense(row, col) = impl->mColumn[(row + size - col) % size];
+			}
+		}
+		return kernel::toMatrix(dense);
+	}
+	const size_t CirculantMatrix::size() const
+	{
+		return impl->mColumn.size();
+	}
+
+	CirculantMatrix& CirculantMatrix::operator=(const CirculantMatrix& rightMatrix)
+	{
+		if (this == &rightMatrix) {
+			return *this;
+		}
+
+		*impl = *(rightMatrix.impl);
+		return *this;
+	}
+	CirculantMatrix CirculantMatrix::operator*(const CirculantMatrix& rightMatrix) const
+	{
+		// Product of circulant matrices is circulant, its first column is C * c
+		Dense column(rightMatrix.size(), 1);
+		column.entries = rightMatrix.impl->mColumn;
+		return CirculantMatrix(toVector(impl->multiply(column).entries));
+	}
+	Vectorr CirculantMatrix::operator*(const Vectorr& rightVector) const
+	{
+		return toVector(impl->multiply(fromColumns(rightVector)).entries);
+	}
+	Matrixx CirculantMatrix::operator*(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "linalg.h"
+
+namespace linalg {
+	// Toeplitz and circulant matrix classes
+	// Implementations are in linalg_toeplitz.cpp
+	class ToeplitzMatrix;
+	class CirculantMatrix;
+
+	/*
+	* Toeplitz matrix T(i, j) = t[i - j], stored by its first column (t[0], t[1], ...) and first row (t[0], t[-1], ...).
+	*
+	* T is embedded in a circulant matrix of power-of-two size >= height + width - 1, whose spectrum is computed once,
+	* so a product with a vector costs two FFTs, O((m + n) log(m + n)). Columns of a matrix are transformed two at a time
+	* (as real and imaginary parts of one complex transform), pairs in parallel.
+	* solve runs Levinson recursion for symmetric Toeplitz systems in O(n^2), which needs every leading principal
+	* submatrix to be nonsingular (always true for positive-definite T, as autocorrelation matrices).
+	*/
+	class ToeplitzMatrix {
+	public:
+		explicit ToeplitzMatrix(const Vectorr& firstColumn); // Symmetric Toeplitz matrix
+		ToeplitzMatrix(const Vectorr& firstColumn, const Vectorr& firstRow); // throws std::logic_error : first entries differ
+		ToeplitzMatrix(const ToeplitzMatrix& copyMatrix);
+		virtual ~ToeplitzMatrix();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		Vectorr firstColumn() const;
+		Vectorr firstRow() const;
+		bool isSymmetric() const;
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error : non-symmetric or singular leading principal submatrix
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error : non-symmetric or singular leading principal submatrix
+
+		ToeplitzMatrix transpose() const;
+		Matrixx toMatrix() const;
+		const size_t height() const;
+		const size_t width() const;
+
+		ToeplitzMatrix& operator=(const ToeplitzMatrix& rightMatrix);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Circulant matrix C(i, j) = c[(i - j) mod n], stored by its first column c.
+	*
+	* C is diagonalized by the discrete Fourier transform with eigenvalues FFT(c), computed once on construction,
+	* so products and solves cost O(n log n) for any n (Bluestein transform when n is not a power of two).
+	*/
+	class CirculantMatrix {
+	public:
+		explicit CirculantMatrix(const Vectorr& firstColumn);
+		CirculantMatrix(const CirculantMatrix& copyMatrix);
+		virtual ~CirculantMatrix();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		Vectorr firstColumn() const;
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error : singular matrix
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error : singular matrix
+
+		CirculantMatrix transpose() const;
+		ToeplitzMatrix toToeplitz() const;
+		Matrixx toMatrix() const;
+		const size_t size() const;
+
+		CirculantMatrix& operator=(const CirculantMatrix& rightMatrix);
+		CirculantMatrix operator*(const CirculantMatrix& rightMatrix) const; // throws std::logic_error
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,463 @@
+#include "linalg_triangular.h"
+#include "linalg_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace linalg {
+	using namespace kernel;
+
+	namespace {
+		/*
+		* Staircase storage shared by triangular classes :
+		* row block [begin, end) is one dense rectangle over its nonzero columns, [0, end) for lower and [begin, size) for upper.
+		* Only the zero half of each diagonal block is stored on top of the triangle,
+		* and every block is passed to kernels as (pointer, leading dimension).
+		*/
+		class TriangularStorage {
+		public:
+			TriangularStorage(const Uplo uplo, const size_t size); // throws std::length_error
+
+			size_t blockCount() const { return (mSize + blockSize - 1) / blockSize; }
+			size_t blockBegin(const size_t block) const { return block * blockSize; }
+			size_t blockEnd(const size_t block) const { return std::min((block + 1) * blockSize, mSize); }
+			size_t columnBegin(const size_t block) const { return (mUplo == Uplo::Lower) ? 0 : blockBegin(block); }
+			size_t columnEnd(const size_t block) const { return (mUplo == Uplo::Lower) ? blockEnd(block) : mSize; }
+			size_t leading(const size_t block) const { return columnEnd(block) - columnBegin(block); }
+			double* blockData(const size_t block) { return mEntries.data() + mOffsets[block]; }
+			const double* blockData(const size_t block) const { return mEntries.data() + mOffsets[block]; }
+
+			bool inTriangle(const size_t row, const size_t col) const { return (mUplo == Uplo::Lower) ? col <= row : col >= row; }
+			double& entry(const size_t row, const size_t col); // (row, col) must be in triangle
+			double entry(const size_t row, const size_t col) const;
+
+			double get(const size_t row, const size_t col) const; // throws std::out_of_range
+			void set(const size_t row, const size_t col, const double value); // throws std::out_of_range, std::logic_error
+
+			void assign(const Dense& dense); // throws std::logic_error
+			Dense toDense() const;
+			TriangularStorage transpose() const;
+
+			void solve(const Trans trans, Dense& rightDense) const; // throws std::logic_error
+			Dense multiply(const Dense& rightDense) const; // throws std::logic_error
+			double determinant() const;
+			bool isSingular() const;
+
+			Uplo mUplo;
+			size_t mSize;
+			std::vector<size_t> mOffsets; // Offset of each row block
+			std::vector<double> mEntries;
+		};
+
+		TriangularStorage::TriangularStorage(const Uplo uplo, const size_t size)
+			: mUplo(uplo), mSize(size)
+		{
+			int exceptNum = ExceptionHandlerr::checkValidHeight(size);
+			if (exceptNum > static_cast<int>(LengthState::NoExcept)) {
+				LengthArgument lengthArg(size, size);
+				ExceptionHandlerr handler(ExceptionState::LengthError, exceptNum);
+				handler.addArgument(lengthArg);
+				handler.handleException();
+			}
+
+			mOffsets.resize(blockCount());
+			size_t offset = 0;
+			for (size_t block = 0; block < blockCount(); block++) {
+				mOffsets[block] = offset;
+				offset += (blockEnd(block) - blockBegin(block)) * leading(block);
+			}
+			mEntries.assign(offset, 0.0);
+		}
+
+		double& TriangularStorage::entry(const size_t row, const size_t col)
+		{
+			const size_t block = row / blockSize;
+			return blockData(block)[(row - blockBegin(block)) * leading(block) + (col - columnBegin(block))];
+		}
+		double TriangularStorage::entry(const size_t row, const size_t col) const
+		{
+			const size_t block = row / blockSize;
+			return blockData(block)[(row - blockBegin(block)) * leading(block) + (col - columnBegin(block))];
+		}
+
+		double TriangularStorage::get(const size_t row, const size_t col) const
+		{
+			handleIndexException(row, col, mSize, mSize);
+			return inTriangle(row, col) ? entry(row, col) : 0.0;
+		}
+		void TriangularStorage::set(const size_t row, const size_t col, const double value)
+		{
+			handleIndexException(row, col, mSize, mSize);
+			if (!inTriangle(row, col)) {
+				handleEtcException("Cannot set entry in zero half of triangular matrix.");
+			}
+			entry(row, col) = value;
+		}
+
+		void TriangularStorage::assign(const Dense& dense)
+		{
+			if (dense.height != dense.width) {
+				handleEtcException("Cannot make triangular matrix from non-square matrix.");
+			}
+
+			// Zero half is compared with the same epsilon as Matrixx entries
+			constexpr double epsilon = std::numeric_limits<double>::epsilon();
+			for (size_t row = 0; row < mSize; row++) {
+				for (size_t col = 0; col < mSize; col++) {
+					if (inTriangle(row, col)) {
+						entry(row, col) = dense(row, col);
+					}
+					else if (std::abs(dense(row, col)) >= epsilon) {
+						handleEtcException("Cannot make triangular matrix from matrix with nonzero entry in zero half.");
+					}
+				}
+			}
+		}
+
+		Dense TriangularStorage::toDense() const
+		{
+			Dense dense(mSize, mSize);
+			for (size_t block = 0; block < blockCount(); block++) {
+				for (size_t row = blockBegin(block); row < blockEnd(block); row++) {
+					const double* source = blockData(block) + (row - blockBegin(block)) * leading(block);
+					std::copy(source, source + leading(block), dense.row(row) + columnBegin(block));
+				}
+			}
+			return dense;
+		}
+
+		TriangularStorage TriangularStorage::transpose() const
+		{
+			TriangularStorage transposed(mUplo == Uplo::Lower ? Uplo::Upper : Uplo::Lower, mSize);
+			for (size_t row = 0; row < mSize; row++) {
+				const size_t colBegin = (mUplo == Uplo::Lower) ? 0 : row, colEnd = (mUplo == Uplo::Lower) ? row + 1 : mSize;
+				for (size_t col = colBegin; col < colEnd; col++) {
+					transposed.entry(col, row) = entry(row, col);
+				}
+			}
+			return transposed;
+		}
+
+		void TriangularStorage::solve(const Trans trans, Dense& rightDense) const
+		{
+			handleOperationException(ExceptionHandlerr::checkHeight(mSize, rightDense.height), '\\',
+				LengthArgument(mSize, mSize), LengthArgument(rightDense.height, rightDense.width));
+			if (isSingular()) {
+				handleEtcException("Cannot solve with singular triangular matrix.");
+			}
+
+			const size_t width = rightDense.width;
+			double* b = rightDense.data();
+			// Single right-hand side runs level 2 kernels, many right-hand sides run level 3 kernels
+			auto solveDiagonal = [&](const size_t block) {
+				const size_t begin = blockBegin(block), height = blockEnd(block) - begin;
+				const double* diagonal = blockData(block) + (begin - columnBegin(block));
+				if (width == 1) {
+					trsv(mUplo, trans, Diag::NonUnit, height, diagonal, leading(block), b + begin);
+				}
+				else {
+					trsm(Side::Left, mUplo, trans, Diag::NonUnit, height, width, diagonal, leading(block), b + begin * width, width);
+				}
+			};
+			// B[target] -= op(A[block, source]) * X[source], source is the off-diagonal column range of the row block
+			auto update = [&](const size_t block, const size_t sourceBegin, const size_t sourceEnd, const Trans opTrans,
+				const size_t targetBegin, const size_t targetEnd, const size_t xBegin) {
+				const double* offDiagonal = blockData(block) + (sourceBegin - columnBegin(block));
+				const size_t height = targetEnd - targetBegin, join = (opTrans == Trans::NoTrans) ? sourceEnd - sourceBegin : blockEnd(block) - blockBegin(block);
+				if (height == 0 || join == 0) {
+					return;
+				}
+				if (width == 1) {
+					if (opTrans == Trans::NoTrans) {
+						gemv(Trans::NoTrans, height, join, -1.0, offDiagonal, leading(block), b + xBegin, 1.0, b + targetBegin);
+					}
+					else {
+						gemv(Trans::Trans, join, height, -1.0, offDiagonal, leading(block), b + xBegin, 1.0, b + targetBegin);
+					}
+				}
+				else {
+					gemm(opTrans, Trans::NoTrans, height, width, join, -1.0, offDiagonal, leading(block),
+						b + xBegin * width, width, 1.0, b + targetBegin * width, width);
+				}
+			};
+
+			const size_t count = blockCount();
+			if (trans == Trans::NoTrans) {
+				// Left looking : each row block gathers solved blocks through its own off-diagonal part
+				if (mUplo == Uplo::Lower) {
+					for (size_t block = 0; block < count; block++) {
+						update(block, 0, blockBegin(block), Trans::NoTrans, blockBegin(block), blockEnd(block), 0);
+						solveDiagonal(block);
+					}
+				}
+				else {
+					for (size_t block = count; block-- > 0;) {
+						update(block, blockEnd(block), mSize, Trans::NoTrans, blockBegin(block), blockEnd(block), blockEnd(block));
+						solveDiagonal(block);
+					}
+				}
+			}
+			else {
+				// Right looking : off-diagonal part of a row block is a column block of op(A), scattered after its solve
+				if (mUplo == Uplo::Lower) {
+					for (size_t block = count; block-- > 0;) {
+						solveDiagonal(block);
+						update(block, 0, blockBegin(block), Trans::Trans, 0, blockBegin(block), blockBegin(block));
+					}
+				}
+				else {
+					for (size_t block = 0; block < count; block++) {
+						solveDiagonal(block);
+						update(block, blockEnd(block), mSize, Trans::Trans, blockEnd(block), mSize, blockBegin(block));
+					}
+				}
+			}
+		}
+
+		Dense TriangularStorage::multiply(const Dense& rightDense) const
+		{
+			handleOperationException(ExceptionHandlerr::checkJoinLength(mSize, rightDense.height), '*',
+				LengthArgument(mSize, mSize), LengthArgument(rightDense.height, rightDense.width));
+
+			// Each row block multiplies only its stored columns
+			const size_t width = rightDense.width;
+			Dense product(mSize, width);
+			for (size_t block = 0; block < blockCount(); block++) {
+				const size_t begin = blockBegin(block), height = blockEnd(block) - begin;
+				if (width == 1) {
+					gemv(Trans::NoTrans, height, leading(block), 1.0, blockData(block), leading(block),
+						rightDense.data() + columnBegin(block), 0.0, product.data() + begin);
+				}
+				else {
+					gemm(Trans::NoTrans, Trans::NoTrans, height, width, leading(block), 1.0, blockData(block), leading(block),
+						rightDense.row(columnBegin(block)), width, 0.0, product.row(begin), width);
+				}
+			}
+			return product;
+		}
+
+		double TriangularStorage::determinant() const
+		{
+			double determinant = 1.0;
+			for (size_t index = 0; index < mSize; index++) {
+				determinant *= entry(index, index);
+			}
+			return determinant;
+		}
+
+		bool TriangularStorage::isSingular() const
+		{
+			for (size_t index = 0; index < mSize; index++) {
+				if (entry(index, index) == 0.0) {
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+
+
+
+
+	class LowerTriangular::Impl : public TriangularStorage {
+	public:
+		Impl(const size_t size) : TriangularStorage(Uplo::Lower, size) {} // throws std::length_error
+		Impl(const TriangularStorage& storage) : TriangularStorage(storage) {}
+	};
+
+	class UpperTriangular::Impl : public TriangularStorage {
+	public:
+		Impl(const size_t size) : TriangularStorage(Uplo::Upper, size) {} // throws std::length_error
+		Impl(const TriangularStorage& storage) : TriangularStorage(storage) {}
+	};
+
+
+
+
+
+	LowerTriangular::LowerTriangular(const size_t size)
+		: impl(std::make_unique<Impl>(size))
+	{
+	}
+	LowerTriangular::LowerTriangular(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(matrix.height()))
+	{
+		impl->assign(fromMatrix(matrix));
+	}
+	LowerTriangular::LowerTriangular(const LowerTriangular& copyTriangular)
+		: impl(std::make_unique<Impl>(*(copyTriangular.impl)))
+	{
+	}
+	LowerTriangular::~LowerTriangular() = default;
+
+	const double LowerTriangular::operator()(const size_t row, const size_t col) const
+	{
+		return impl->get(row, col);
+	}
+	void LowerTriangular::set(const size_t row, const size_t col, const double value)
+	{
+		impl->set(row, col, value);
+	}
+
+	Vectorr LowerTriangular::solve(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(Trans::NoTrans, solution);
+		return toVector(solution.entries);
+	}
+	Matrixx LowerTriangular::solve(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(Trans::NoTrans, solution);
+		return kernel::toMatrix(solution);
+	}
+	Vectorr LowerTriangular::solveTranspose(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(Trans::Trans, solution);
+		return toVector(solution.entries);
+	}
+	Matrixx LowerTriangular::solveTranspose(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(Trans::Trans, solution);
+		return kernel::toMatrix(solution);
+	}
+
+	double LowerTriangular::determinant() const
+	{
+		return impl->determinant();
+	}
+	bool LowerTriangular::isSingular() const
+	{
+		return impl->isSingular();
+	}
+	UpperTriangular LowerTriangular::transpose() const
+	{
+		UpperTriangular transposed(impl->mSize);
+		*(transposed.impl) = UpperTriangular::Impl(impl->transpose());
+		return transposed;
+	}
+	Matrixx LowerTriangular::toMatrix() const
+	{
+		return kernel::toMatrix(impl->toDense());
+	}
+	const size_t LowerTriangular::size() const
+	{
+		return impl->mSize;
+	}
+
+	LowerTriangular& LowerTriangular::operator=(const LowerTriangular& rightTriangular)
+	{
+		if (this == &rightTriangular) {
+			return *this;
+		}
+
+		*impl = *(rightTriangular.impl);
+		return *this;
+	}
+	Vectorr LowerTriangular::operator*(const Vectorr& rightVector) const
+	{
+		return toVector(impl->multiply(fromColumns(rightVector)).entries);
+	}
+	Matrixx LowerTriangular::operator*(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+
+
+
+
+
+	UpperTriangular::UpperTriangular(const size_t size)
+		: impl(std::make_unique<Impl>(size))
+	{
+	}
+	UpperTriangular::UpperTriangular(const Matrixx& matrix)
+		: impl(std::make_unique<Impl>(matrix.height()))
+	{
+		impl->assign(fromMatrix(matrix));
+	}
+	UpperTriangular::UpperTriangular(const UpperTriangular& copyTriangular)
+		: impl(std::make_unique<Impl>(*(copyTriangular.impl)))
+	{
+	}
+	UpperTriangular::~UpperTriangular() = default;
+
+	const double UpperTriangular::operator()(const size_t row, const size_t col) const
+	{
+		return impl->get(row, col);
+	}
+	void UpperTriangular::set(const size_t row, const size_t col, const double value)
+	{
+		impl->set(row, col, value);
+	}
+
+	Vectorr UpperTriangular::solve(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(Trans::NoTrans, solution);
+		return toVector(solution.entries);
+	}
+	Matrixx UpperTriangular::solve(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(Trans::NoTrans, solution);
+		return kernel::toMatrix(solution);
+	}
+	Vectorr UpperTriangular::solveTranspose(const Vectorr& rightVector) const
+	{
+		Dense solution = fromColumns(rightVector);
+		impl->solve(Trans::Trans, solution);
+		return toVector(solution.entries);
+	}
+	Matrixx UpperTriangular::solveTranspose(const Matrixx& rightMatrix) const
+	{
+		Dense solution = fromMatrix(rightMatrix);
+		impl->solve(Trans::Trans, solution);
+		return kernel::toMatrix(solution);
+	}
+
+	double UpperTriangular::determinant() const
+	{
+		return impl->determinant();
+	}
+	bool UpperTriangular::isSingular() const
+	{
+		return impl->isSingular();
+	}
+	LowerTriangular UpperTriangular::transpose() const
+	{
+		LowerTriangular transposed(impl->mSize);
+		*(transposed.impl) = LowerTriangular::Impl(impl->transpose());
+		return transposed;
+	}
+	Matrixx UpperTriangular::toMatrix() const
+	{
+		return kernel::toMatrix(impl->toDense());
+	}
+	const size_t UpperTriangular::size() const
+	{
+		return impl->mSize;
+	}
+
+	UpperTriangular& UpperTriangular::operator=(const UpperTriangular& rightTriangular)
+	{
+		if (this == &rightTriangular) {
+			return *this;
+		}
+
+		*impl = *(rightTriangular.impl);
+		return *this;
+	}
+	Vectorr UpperTriangular::operator*(const Vectorr& rightVector) const
+	{
+		return toVector(impl->multiply(fromColumns(rightVector)).entries);
+	}
+	Matrixx UpperTriangular::operator*(const Matrixx& rightMatrix) const
+	{
+		return kernel::toMatrix(impl->multiply(fromMatrix(rightMatrix)));
+	}
+}
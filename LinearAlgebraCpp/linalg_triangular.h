@@ -0,0 +1,86 @@
+#pragma once
+
+#include "linalg.h"
+
+namespace linalg {
+	// Triangular matrix classes
+	// Implementations are in linalg_triangular.cpp
+	class LowerTriangular;
+	class UpperTriangular;
+
+	/*
+	* Square lower triangular matrix with half storage.
+	*
+	* Rows are stored in blocks, and each row block keeps only the columns up to its diagonal block,
+	* so triangular solves and products run as blocked matrix-matrix kernels over the nonzero half.
+	* solve handles many right-hand sides at once (columns of rightMatrix) with blocked parallel substitution.
+	*/
+	class LowerTriangular {
+		friend class UpperTriangular;
+	public:
+		explicit LowerTriangular(const size_t size = 1); // throws std::length_error, zero matrix
+		explicit LowerTriangular(const Matrixx& matrix); // throws std::logic_error : non-square or nonzero entry above diagonal
+		LowerTriangular(const LowerTriangular& copyTriangular);
+		virtual ~LowerTriangular();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		void set(const size_t row, const size_t col, const double value); // throws std::out_of_range, std::logic_error : above diagonal
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error, L^-1 * b
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error, L^-1 * B
+		Vectorr solveTranspose(const Vectorr& rightVector) const; // throws std::logic_error, L^-T * b
+		Matrixx solveTranspose(const Matrixx& rightMatrix) const; // throws std::logic_error, L^-T * B
+
+		double determinant() const;
+		bool isSingular() const;
+		UpperTriangular transpose() const;
+		Matrixx toMatrix() const;
+		const size_t size() const;
+
+		LowerTriangular& operator=(const LowerTriangular& rightTriangular);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+
+	/*
+	* Square upper triangular matrix with half storage.
+	*
+	* Same layout as LowerTriangular, each row block keeps the columns from its diagonal block.
+	* Echelon form of a square matrix (Matrixx::toEchelonForm) can be wrapped directly,
+	* and back substitution with solve replaces toReducedEchelonForm.
+	*/
+	class UpperTriangular {
+		friend class LowerTriangular;
+	public:
+		explicit UpperTriangular(const size_t size = 1); // throws std::length_error, zero matrix
+		explicit UpperTriangular(const Matrixx& matrix); // throws std::logic_error : non-square or nonzero entry below diagonal
+		UpperTriangular(const UpperTriangular& copyTriangular);
+		virtual ~UpperTriangular();
+
+		const double operator()(const size_t row, const size_t col) const; // throws std::out_of_range
+		void set(const size_t row, const size_t col, const double value); // throws std::out_of_range, std::logic_error : below diagonal
+
+		Vectorr solve(const Vectorr& rightVector) const; // throws std::logic_error, U^-1 * b
+		Matrixx solve(const Matrixx& rightMatrix) const; // throws std::logic_error, U^-1 * B
+		Vectorr solveTranspose(const Vectorr& rightVector) const; // throws std::logic_error, U^-T * b
+		Matrixx solveTranspose(const Matrixx& rightMatrix) const; // throws std::logic_error, U^-T * B
+
+		double determinant() const;
+		bool isSingular() const;
+		LowerTriangular transpose() const;
+		Matrixx toMatrix() const;
+		const size_t size() const;
+
+		UpperTriangular& operator=(const UpperTriangular& rightTriangular);
+		Vectorr operator*(const Vectorr& rightVector) const; // throws std::logic_error
+		Matrixx operator*(const Matrixx& rightMatrix) const; // throws std::logic_error
+	private:
+		class Impl;
+
+		std::unique_ptr<Impl> impl;
+	};
+}
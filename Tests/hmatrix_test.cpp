@@ -0,0 +1,76 @@
+// Exceptions of HMatrix generators thrown on worker threads
+// Built and run by Tests/run_tests.sh, or by hand from the repository root :
+// g++ -std=c++14 -pthread -ILinearAlgebraCpp Tests/hmatrix_test.cpp $(ls LinearAlgebraCpp/*.cpp | grep -v main.cpp)
+
+#include "linalg.h"
+#include "linalg_kernel.h"
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+using namespace linalg;
+
+namespace {
+	int failures = 0;
+
+	void check(const bool condition, const char* message)
+	{
+		if (!condition) {
+			std::cout << "FAILED : " << message << std::endl;
+			failures++;
+		}
+	}
+
+	// Smooth kernel on 1D points, throws for every entry of rejected rows once isRejecting is set
+	HMatrix::Generator rejectingGenerator(const std::shared_ptr<std::atomic<bool>>& isRejecting, const size_t rejectedFrom)
+	{
+		return [isRejecting, rejectedFrom](const size_t row, const size_t col) {
+			if (*isRejecting && row >= rejectedFrom) {
+				throw std::domain_error("point outside of domain");
+			}
+			return 1.0 / (1.0 + std::abs(static_cast<double>(row) - static_cast<double>(col)));
+		};
+	}
+}
+
+int main()
+{
+	kernel::setThreadCount(8);
+	const size_t size = 512;
+	Matrixx points(size, 1);
+	for (size_t index = 0; index < size; index++) {
+		points(index, 0) = static_cast<double>(index);
+	}
+
+	// Constructor of HMatrix
+	auto isRejecting = std::make_shared<std::atomic<bool>>(true);
+	try {
+		HMatrix matrix(points, rejectingGenerator(isRejecting, size / 2), 1e-8, 32);
+		check(false, "HMatrix rethrows exception of generator");
+	}
+	catch (const std::domain_error&) {
+	}
+
+	// Constructor of HMatrixPreconditioner, generator starts throwing after compression
+	isRejecting->store(false);
+	HMatrix matrix(points, rejectingGenerator(isRejecting, size / 2), 1e-8, 32);
+	isRejecting->store(true);
+	try {
+		HMatrixPreconditioner preconditioner(matrix);
+		check(false, "HMatrixPreconditioner rethrows exception of generator");
+	}
+	catch (const std::domain_error&) {
+	}
+
+	// Both still work once the generator accepts every point
+	isRejecting->store(false);
+	HMatrixPreconditioner preconditioner(matrix);
+	check(preconditioner.size() == size, "HMatrixPreconditioner is built after a failed attempt");
+
+	kernel::setThreadCount(0);
+	std::cout << (failures == 0 ? "hmatrix_test passed" : "hmatrix_test failed") << std::endl;
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// MixedPrecisionSolver on matrices outside the normal range of float
+// Built and run by Tests/run_tests.sh, or by hand from the repository root :
+// g++ -std=c++14 -pthread -ILinearAlgebraCpp Tests/mixed_precision_test.cpp $(ls LinearAlgebraCpp/*.cpp | grep -v main.cpp)
+
+#include "linalg.h"
+
+#include <cmath>
+#include <iostream>
+
+using namespace linalg;
+
+namespace {
+	int failures = 0;
+
+	void check(const bool condition, const char* message)
+	{
+		if (!condition) {
+			std::cout << "FAILED : " << message << std::endl;
+			failures++;
+		}
+	}
+
+	// Well-conditioned SPD matrix : 5 on the diagonal, 1 elsewhere
+	Matrixx spdMatrix(const size_t length)
+	{
+		Matrixx matrix(length, length);
+		for (size_t row = 0; row < length; row++) {
+			for (size_t col = 0; col < length; col++) {
+				matrix(row, col) = (row == col) ? 5.0 : 1.0;
+			}
+		}
+		return matrix;
+	}
+
+	// Largest |A * x - b| relative to |b|, NaN when x has a NaN entry
+	double relativeResidual(const Matrixx& matrix, const Vectorr& solution, const Vectorr& right)
+	{
+		double residual = 0.0, rightNorm = 0.0;
+		for (size_t row = 0; row < matrix.height(); row++) {
+			double sum = -right(row);
+			for (size_t col = 0; col < matrix.width(); col++) {
+				sum += matrix(row, col) * solution(col);
+			}
+			if (std::isnan(sum)) {
+				return sum;
+			}
+			residual = std::max(residual, std::abs(sum));
+			rightNorm = std::max(rightNorm, std::abs(right(row)));
+		}
+		return residual / rightNorm;
+	}
+
+	void checkSolve(const Matrixx& matrix, const MixedPrecisionSolver::Method method, const char* message)
+	{
+		const size_t length = matrix.height();
+		Vectorr right(length);
+		for (size_t row = 0; row < length; row++) {
+			right(row) = 0.0;
+			for (size_t col = 0; col < length; col++) {
+				right(row) += matrix(row, col) * (col + 1.0);
+			}
+		}
+
+		MixedPrecisionSolver solver(matrix, method);
+		const Vectorr solution = solver.solve(right);
+		bool isFinite = true;
+		for (size_t row = 0; row < length; row++) {
+			isFinite = isFinite && std::isfinite(solution(row));
+		}
+		check(isFinite, message);
+		check(relativeResidual(matrix, solution, right) <= 1e-12, message);
+		check(solver.isDoubleFactor() && !solver.isRefined(), message);
+		check(solver.backwardError() <= 1e-14, message);
+	}
+}
+
+int main()
+{
+	// Last row (and column, to keep symmetry for Cholesky) is nonzero in double but subnormal in float
+	const size_t length = 5;
+	Matrixx scaledRow = spdMatrix(length);
+	for (size_t col = 0; col < length; col++) {
+		scaledRow(length - 1, col) *= 1e-41;
+	}
+	checkSolve(scaledRow, MixedPrecisionSolver::Method::LU, "row of float subnormals falls back to double (LU)");
+
+	Matrixx scaledRowColumn = spdMatrix(length);
+	for (size_t index = 0; index < length; index++) {
+		scaledRowColumn(length - 1, index) *= 1e-21;
+		scaledRowColumn(index, length - 1) *= 1e-21;
+	}
+	checkSolve(scaledRowColumn, MixedPrecisionSolver::Method::Cholesky, "row and column of float subnormals fall back to double (Cholesky)");
+
+	for (const double scale : { 1e-40, 1e-41, 1e-42 }) {
+		Matrixx scaled = spdMatrix(length);
+		for (size_t row = 0; row < length; row++) {
+			for (size_t col = 0; col < length; col++) {
+				scaled(row, col) *= scale;
+			}
+		}
+		checkSolve(scaled, MixedPrecisionSolver::Method::LU, "matrix of float subnormals falls back to double (LU)");
+		checkSolve(scaled, MixedPrecisionSolver::Method::Cholesky, "matrix of float subnormals falls back to double (Cholesky)");
+	}
+
+	// Normal range still refines the float solution
+	MixedPrecisionSolver solver(spdMatrix(length));
+	Vectorr right(length);
+	for (size_t row = 0; row < length; row++) {
+		right(row) = 1.0;
+	}
+	solver.solve(right);
+	check(solver.isRefined() && !solver.isDoubleFactor(), "well-scaled matrix is refined from float factor");
+
+	std::cout << (failures == 0 ? "mixed_precision_test passed" : "mixed_precision_test failed") << std::endl;
+	return (failures == 0) ? 0 : 1;
+}
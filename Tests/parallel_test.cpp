@@ -0,0 +1,74 @@
+// Exception propagation of kernel::parallelFor
+// Built and run by Tests/run_tests.sh, or by hand from the repository root :
+// g++ -std=c++14 -pthread -ILinearAlgebraCpp Tests/parallel_test.cpp $(ls LinearAlgebraCpp/*.cpp | grep -v main.cpp)
+
+#include "linalg_kernel.h"
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace linalg;
+
+namespace {
+	int failures = 0;
+
+	void check(const bool condition, const char* message)
+	{
+		if (!condition) {
+			std::cout << "FAILED : " << message << std::endl;
+			failures++;
+		}
+	}
+
+	// Throws from the chunk starting at throwAt, returns whether the exception reached the caller
+	bool throwsFromChunk(const size_t throwAt)
+	{
+		try {
+			kernel::parallelFor(0, 800, [throwAt](const size_t begin, const size_t end) {
+				if (begin <= throwAt && throwAt < end) {
+					throw std::runtime_error("chunk failed");
+				}
+			}, 100);
+		}
+		catch (const std::runtime_error& exception) {
+			return std::string(exception.what()) == "chunk failed";
+		}
+		return false;
+	}
+}
+
+int main()
+{
+	kernel::setThreadCount(8);
+
+	check(throwsFromChunk(0), "exception of the calling thread's chunk is rethrown");
+	check(throwsFromChunk(750), "exception of a worker thread's chunk is rethrown");
+
+	// Every chunk still runs to completion when one of them throws
+	std::atomic<size_t> visited(0);
+	try {
+		kernel::parallelFor(0, 800, [&visited](const size_t begin, const size_t end) {
+			visited += end - begin;
+			if (begin == 0) {
+				throw std::bad_alloc();
+			}
+		}, 100);
+		check(false, "std::bad_alloc is rethrown");
+	}
+	catch (const std::bad_alloc&) {
+	}
+	check(visited == 800, "every chunk finishes before the exception is rethrown");
+
+	// The calling thread is not left marked as inside a parallel region
+	std::atomic<size_t> chunks(0);
+	kernel::parallelFor(0, 800, [&chunks](const size_t, const size_t) {
+		chunks++;
+	}, 100);
+	check(chunks == 8, "later loops run in parallel again");
+
+	kernel::setThreadCount(0);
+	std::cout << (failures == 0 ? "parallel_test passed" : "parallel_test failed") << std::endl;
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+#!/bin/sh
+# Builds every Tests/*_test.cpp against the sources of LinearAlgebraCpp (main.cpp excluded) and runs it
+# Usage : Tests/run_tests.sh [compiler flags], CXX selects the compiler (g++ by default)
+cd "$(dirname "$0")/.." || exit 1
+compiler=${CXX:-g++}
+output=$(mktemp -d) || exit 1
+trap 'rm -rf "$output"' EXIT
+
+for source in LinearAlgebraCpp/*.cpp; do
+	name=$(basename "$source" .cpp)
+	if [ "$name" != main ]; then
+		$compiler -std=c++14 -O2 -pthread "$@" -c "$source" -o "$output/$name.o" || exit 1
+	fi
+done
+
+status=0
+for test in Tests/*_test.cpp; do
+	name=$(basename "$test" .cpp)
+	if ! $compiler -std=c++14 -O2 -pthread -ILinearAlgebraCpp "$@" "$test" "$output"/linalg*.o -o "$output/$name"; then
+		echo "$name failed to build"
+		status=1
+	elif ! "$output/$name"; then
+		status=1
+	fi
+done
+exit $status